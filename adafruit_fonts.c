@@ -1,3 +1,6 @@
+// Source font tables for tools/font_subset.py - NOT compiled into the firmware.
+// The build generates fonts_subset.c from this file, keeping only the glyphs the
+// UI uses, pre-rasterized in the SH1106 page-major layout (see font.h).
 #include "font.h"
 
 // FreeSansBold12pt7b font data
@@ -0,0 +1,80 @@
+/**
+ * Live data broadcast implementation
+ */
+
+#include "adv_broadcast.h"
+
+// Manufacturer specific data AD type
+#define AD_TYPE_MANUFACTURER_DATA 0xFF
+
+static uint8_t *put_16(uint8_t *out, uint16_t value)
+{
+    *out++ = (uint8_t)value;
+    *out++ = (uint8_t)(value >> 8);
+    return out;
+}
+
+static uint8_t *put_32(uint8_t *out, uint32_t value)
+{
+    out = put_16(out, (uint16_t)value);
+    return put_16(out, (uint16_t)(value >> 16));
+}
+
+static uint16_t get_16(const uint8_t *in)
+{
+    return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+static uint32_t get_32(const uint8_t *in)
+{
+    return get_16(in) | ((uint32_t)get_16(in + 2) << 16);
+}
+
+size_t adv_broadcast_encode(const adv_broadcast_t *data, uint8_t *out)
+{
+    uint8_t *p = out;
+    *p++ = 1 + ADV_BROADCAST_PAYLOAD_SIZE; // Length counts the type byte
+    *p++ = AD_TYPE_MANUFACTURER_DATA;
+    p = put_16(p, ADV_BROADCAST_COMPANY_ID);
+    *p++ = ADV_BROADCAST_VERSION;
+    *p++ = data->sequence;
+    p = put_32(p, data->session_rotations);
+    p = put_32(p, data->session_time_seconds);
+    p = put_16(p, data->running_speed_centi);
+    *p++ = data->metric ? ADV_BROADCAST_FLAG_METRIC : 0;
+    return (size_t)(p - out);
+}
+
+bool adv_broadcast_decode(const uint8_t *adv, size_t len, adv_broadcast_t *data)
+{
+    size_t pos = 0;
+
+    while (pos < len)
+    {
+        uint8_t ad_len = adv[pos];
+        if (ad_len == 0)
+        {
+            return false; // Early end of the data (rest is padding)
+        }
+        if (pos + 1 + ad_len > len)
+        {
+            return false; // Structure runs past the end
+        }
+
+        const uint8_t *ad = &adv[pos + 1];
+        // Newer versions may append fields: only the known ones are read
+        if (ad[0] == AD_TYPE_MANUFACTURER_DATA && ad_len - 1 >= ADV_BROADCAST_PAYLOAD_SIZE &&
+            get_16(&ad[1]) == ADV_BROADCAST_COMPANY_ID && ad[3] == ADV_BROADCAST_VERSION)
+        {
+            const uint8_t *p = &ad[4];
+            data->sequence = p[0];
+            data->session_rotations = get_32(&p[1]);
+            data->session_time_seconds = get_32(&p[5]);
+            data->running_speed_centi = get_16(&p[9]);
+            data->metric = (p[11] & ADV_BROADCAST_FLAG_METRIC) != 0;
+            return true;
+        }
+        pos += 1 + ad_len;
+    }
+    return false;
+}
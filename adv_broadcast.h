@@ -0,0 +1,68 @@
+/**
+ * Live data broadcast in advertising manufacturer data
+ *
+ * With the ADV_BROADCAST build option the advertising data carries the live
+ * session values, refreshed every second, so a scanner (a watch, say) can
+ * show them without connecting. One manufacturer specific AD structure:
+ *
+ *   [length][0xFF][company id u16 LE][version u8][sequence u8]
+ *   [session rotations u32 LE][session time s u32 LE][running speed u16 LE][flags u8]
+ *
+ * Speed is hundredths of mph, or km/h with flag bit 0 (metric) set. Distance
+ * is sent as rotations (34.56 cm each, see fmt.h) so no rounding happens here.
+ * The sequence number changes with every refresh: a scanner sees the same
+ * advertisement many times a second and can skip repeats.
+ *
+ * Nothing here touches hardware; the decoder is what a scanner would run,
+ * and the host tests check the round trip with it.
+ */
+
+#ifndef ADV_BROADCAST_H
+#define ADV_BROADCAST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Firmware build option: advertise with the broadcast (CMake option of the same name)
+#ifndef ADV_BROADCAST
+#define ADV_BROADCAST 0
+#endif
+
+#ifndef ADV_BROADCAST_INTERVAL_MS
+#define ADV_BROADCAST_INTERVAL_MS 1000     // Refresh of the advertised values
+#endif
+
+#ifndef ADV_BROADCAST_COMPANY_ID
+#define ADV_BROADCAST_COMPANY_ID 0xFFFF    // Reserved for unassigned/test use
+#endif
+
+#define ADV_BROADCAST_VERSION 1
+
+#define ADV_BROADCAST_FLAG_METRIC 0x01
+
+// Manufacturer data after the AD type: company id and the fields
+#define ADV_BROADCAST_PAYLOAD_SIZE 15
+
+// Whole AD structure: length and type bytes, then the payload
+#define ADV_BROADCAST_AD_SIZE (2 + ADV_BROADCAST_PAYLOAD_SIZE)
+
+typedef struct
+{
+    uint8_t sequence;
+    uint32_t session_rotations;
+    uint32_t session_time_seconds;
+    uint16_t running_speed_centi;
+    bool metric;
+} adv_broadcast_t;
+
+// Write the AD structure (ADV_BROADCAST_AD_SIZE bytes) into out
+// Returns its size
+size_t adv_broadcast_encode(const adv_broadcast_t *data, uint8_t *out);
+
+// Find the broadcast among the AD structures of advertising or scan response
+// data and decode it. Returns false if there is none (other company or
+// version, too short), or the data is malformed
+bool adv_broadcast_decode(const uint8_t *adv, size_t len, adv_broadcast_t *data);
+
+#endif // ADV_BROADCAST_H
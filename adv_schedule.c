@@ -0,0 +1,135 @@
+/**
+ * Advertising interval schedule implementation
+ */
+
+#include "adv_schedule.h"
+#include <string.h>
+
+typedef struct
+{
+    uint16_t interval;                     // 0.625 ms units
+    uint32_t duration_ms;                  // 0 = last step, stays
+} adv_step_t;
+
+static const adv_step_t steps[ADV_SCHEDULE_STEP_COUNT] = {
+    {0x0030, 30000},                       // 30 ms
+    {0x00A0, 60000},                       // 100 ms
+    {0x0320, 300000},                      // 500 ms
+    {0x0800, 0},                           // 1.28 s
+};
+
+// Charge the time since the last call to the current step
+static void account(adv_schedule_t *sched, uint32_t now_ms)
+{
+    if (sched->active)
+    {
+        sched->time_in_step_ms[sched->step] += now_ms - sched->accounted_ms;
+    }
+    sched->accounted_ms = now_ms;
+}
+
+static void go_to_step(adv_schedule_t *sched, uint8_t step, uint32_t now_ms)
+{
+    account(sched, now_ms);
+    sched->step = step;
+    sched->step_start_ms = now_ms;
+}
+
+// Move on over any steps that ended by now_ms, each at its own end time
+static void advance(adv_schedule_t *sched, uint32_t now_ms)
+{
+    while (sched->active && steps[sched->step].duration_ms != 0 &&
+           (now_ms - sched->step_start_ms) >= steps[sched->step].duration_ms)
+    {
+        go_to_step(sched, sched->step + 1, sched->step_start_ms + steps[sched->step].duration_ms);
+    }
+}
+
+void adv_schedule_init(adv_schedule_t *sched)
+{
+    memset(sched, 0, sizeof(*sched));
+}
+
+void adv_schedule_start(adv_schedule_t *sched, uint32_t now_ms)
+{
+    go_to_step(sched, 0, now_ms);
+    sched->active = true;
+}
+
+void adv_schedule_stop(adv_schedule_t *sched, uint32_t now_ms)
+{
+    advance(sched, now_ms);
+    account(sched, now_ms);
+    sched->active = false;
+}
+
+void adv_schedule_kick(adv_schedule_t *sched, uint32_t now_ms)
+{
+    if (!sched->active)
+    {
+        return; // Starting again begins at the first step anyway
+    }
+    advance(sched, now_ms);
+    go_to_step(sched, 0, now_ms);
+    sched->kicks++;
+}
+
+void adv_schedule_walking(adv_schedule_t *sched, bool walking, uint32_t now_ms)
+{
+    if (!walking)
+    {
+        sched->walking = false;
+        sched->walking_kicked = false;
+        return;
+    }
+    if (!sched->walking)
+    {
+        sched->walking = true;
+        sched->walking_since_ms = now_ms;
+    }
+    if (!sched->walking_kicked && (now_ms - sched->walking_since_ms) >= ADV_SCHEDULE_WALKING_MS)
+    {
+        sched->walking_kicked = true;
+        adv_schedule_kick(sched, now_ms);
+    }
+}
+
+void adv_schedule_sessions(adv_schedule_t *sched, uint32_t sessions_closed, uint32_t now_ms)
+{
+    if (sessions_closed != sched->sessions_closed)
+    {
+        sched->sessions_closed = sessions_closed;
+        adv_schedule_kick(sched, now_ms);
+    }
+}
+
+bool adv_schedule_update(adv_schedule_t *sched, uint32_t now_ms)
+{
+    advance(sched, now_ms);
+    account(sched, now_ms);
+
+    uint16_t interval = adv_schedule_interval(sched);
+    if (interval == sched->applied_interval)
+    {
+        return false;
+    }
+    sched->applied_interval = interval;
+    return true;
+}
+
+uint16_t adv_schedule_interval(const adv_schedule_t *sched)
+{
+    return steps[sched->step].interval;
+}
+
+uint16_t adv_schedule_step_interval(uint8_t step)
+{
+    return (step < ADV_SCHEDULE_STEP_COUNT) ? steps[step].interval : 0;
+}
+
+void adv_schedule_time_in_step(adv_schedule_t *sched, uint32_t now_ms, uint32_t *time_ms)
+{
+    advance(sched, now_ms);
+    account(sched, now_ms);
+    memcpy(time_ms, sched->time_in_step_ms, sizeof(sched->time_in_step_ms));
+}
@@ -0,0 +1,75 @@
+/**
+ * Advertising interval schedule
+ *
+ * Advertising fast makes the device quick to find, and is one of the largest
+ * power draws while nothing is connected. The schedule starts at the fastest
+ * interval and backs off in steps the longer nobody connects:
+ *
+ *   30 ms for 30 s, 100 ms for 1 min, 500 ms for 5 min, then 1.28 s
+ *
+ * Events that make a connection likely go back to the first step: advertising
+ * (re)starting, e.g. after a disconnect, a session closing, and walking for
+ * ADV_SCHEDULE_WALKING_MS. Time spent at each interval is counted for the
+ * stats. Pure logic: the caller applies the interval and feeds the events.
+ */
+
+#ifndef ADV_SCHEDULE_H
+#define ADV_SCHEDULE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ADV_SCHEDULE_STEP_COUNT 4
+
+#ifndef ADV_SCHEDULE_WALKING_MS
+#define ADV_SCHEDULE_WALKING_MS 10000      // Walking this long counts as an event
+#endif
+
+typedef struct
+{
+    bool active;                           // Advertising (started, not connected)
+    uint8_t step;
+    uint32_t step_start_ms;
+    uint16_t applied_interval;             // Last interval returned by update (0 = none)
+    uint32_t accounted_ms;                 // Time in step counted up to here
+    uint32_t time_in_step_ms[ADV_SCHEDULE_STEP_COUNT];
+    uint32_t kicks;                        // Events that went back to the first step
+    bool walking;
+    bool walking_kicked;                   // This stretch of walking already kicked
+    uint32_t walking_since_ms;
+    uint32_t sessions_closed;              // Last count passed to adv_schedule_sessions
+} adv_schedule_t;
+
+void adv_schedule_init(adv_schedule_t *sched);
+
+// Advertising starts (or resumes after a disconnect): first step
+void adv_schedule_start(adv_schedule_t *sched, uint32_t now_ms);
+
+// Advertising stops (a central connected): time is no longer counted
+void adv_schedule_stop(adv_schedule_t *sched, uint32_t now_ms);
+
+// An event worth quick discovery: back to the first step (while advertising)
+void adv_schedule_kick(adv_schedule_t *sched, uint32_t now_ms);
+
+// Whether the user is walking now; kicks once per stretch of walking that
+// lasts ADV_SCHEDULE_WALKING_MS
+void adv_schedule_walking(adv_schedule_t *sched, bool walking, uint32_t now_ms);
+
+// Count of sessions that ended so far (odometer_get_sessions_closed); kicks
+// when it changes
+void adv_schedule_sessions(adv_schedule_t *sched, uint32_t sessions_closed, uint32_t now_ms);
+
+// Move on to the step due at now_ms. Returns true if the interval to use has
+// changed since the last call that returned true: apply adv_schedule_interval()
+bool adv_schedule_update(adv_schedule_t *sched, uint32_t now_ms);
+
+// Interval of the current step, in 0.625 ms units (BLE advertising interval)
+uint16_t adv_schedule_interval(const adv_schedule_t *sched);
+
+// Interval of a step in 0.625 ms units, for reporting
+uint16_t adv_schedule_step_interval(uint8_t step);
+
+// Time spent advertising at each step so far (ADV_SCHEDULE_STEP_COUNT values)
+void adv_schedule_time_in_step(adv_schedule_t *sched, uint32_t now_ms, uint32_t *time_ms);
+
+#endif // ADV_SCHEDULE_H
@@ -0,0 +1,185 @@
+package com.mypeople.walkolutionodometer
+
+import android.content.Context
+import android.util.Log
+import org.json.JSONObject
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.util.Locale
+
+// Decodes the binary log records written by firmware built with LOG_BINARY=1
+// (record format in log_binary.h, same rules as tools/log_decode.py).
+// The string table is log_strings.json from the firmware build, which CMake
+// copies into this app's assets.
+class BinaryLogDecoder(private val table: JSONObject?) {
+
+    companion object {
+        private const val TAG = "BinaryLogDecoder"
+        const val SYNC: Byte = 0xFE.toByte()
+        private const val HEADER_SIZE = 9
+        private const val SITE_BOOT = 1
+        private const val SITE_DROPPED = 2
+
+        private val CONVERSION = Regex("%([-+ #0]*)(\\*|\\d+)?(?:\\.(\\*|\\d*))?(hh|h|ll|l|j|z|t|L)?([diouxXeEfFgGaAcsp%])")
+
+        fun fromAssets(context: Context): BinaryLogDecoder {
+            val table = try {
+                context.assets.open("log_strings.json").bufferedReader().use { JSONObject(it.readText()) }
+            } catch (e: Exception) {
+                Log.w(TAG, "No log string table in assets: ${e.message}")
+                null
+            }
+            return BinaryLogDecoder(table)
+        }
+
+        // Binary records start with a byte that never occurs in UTF-8 text
+        fun looksBinary(data: ByteArray): Boolean = data.isNotEmpty() && data[0] == SYNC
+    }
+
+    private var pending = ByteArray(0)
+    private var lastRawTime: Long? = null
+    private var timeBase = 0L
+    private var atLineStart = true
+
+    // Decode a chunk of the stream; partial records are kept for the next call
+    fun feed(data: ByteArray): String {
+        val buf = pending + data
+        val out = StringBuilder()
+        var pos = 0
+        while (pos < buf.size) {
+            if (buf[pos] != SYNC) {
+                var next = pos
+                while (next < buf.size && buf[next] != SYNC) next++
+                out.append("<skipped ${next - pos} bytes>\n")
+                atLineStart = true
+                pos = next
+                continue
+            }
+            if (pos + 2 > buf.size) break
+            val length = buf[pos + 1].toInt() and 0xFF
+            if (pos + length > buf.size) break
+            if (length < HEADER_SIZE) {
+                pos++
+                continue
+            }
+            out.append(record(buf.copyOfRange(pos, pos + length)))
+            pos += length
+        }
+        pending = buf.copyOfRange(pos, buf.size)
+        return out.toString()
+    }
+
+    private fun record(rec: ByteArray): String {
+        val header = ByteBuffer.wrap(rec).order(ByteOrder.LITTLE_ENDIAN)
+        val fileId = rec[2].toInt() and 0xFF
+        val line = header.getShort(3).toInt() and 0xFFFF
+        val rawTime = header.getInt(5).toLong() and 0xFFFFFFFFL
+        val args = Args(rec.copyOfRange(HEADER_SIZE, rec.size))
+
+        if (fileId == 0 && line == SITE_BOOT) {
+            timeBase = 0
+            lastRawTime = null
+            val seconds = timestamp(rawTime)
+            val firmwareHash = args.word()
+            val tableHash = table?.optLong("hash")
+            val status = if (firmwareHash != null && firmwareHash == tableHash) "string table OK"
+                else "STRING TABLE MISMATCH: firmware 0x%08X, table 0x%08X".format(firmwareHash ?: 0L, tableHash ?: 0L)
+            val prefix = if (atLineStart) "" else "\n"
+            atLineStart = true
+            return prefix + text(seconds, "=== boot ($status) ===\n")
+        }
+
+        val seconds = timestamp(rawTime)
+        if (fileId == 0 && line == SITE_DROPPED) {
+            return text(seconds, "[LOG] ${args.word()} bytes dropped\n")
+        }
+
+        val format = table?.optJSONObject("sites")?.optString("$fileId:$line", null)
+            ?: return text(seconds, "<unknown log site ${fileName(fileId)}:$line, ${rec.size - HEADER_SIZE} arg bytes>\n")
+        return text(seconds, formatRecord(format, args))
+    }
+
+    private fun fileName(fileId: Int): String =
+        table?.optJSONObject("files")?.optString(fileId.toString(), null) ?: "file $fileId"
+
+    // time_us_32() wraps every ~71.6 minutes; records are much closer together
+    private fun timestamp(raw: Long): Double {
+        lastRawTime?.let { if (raw < it) timeBase += 1L shl 32 }
+        lastRawTime = raw
+        return (timeBase + raw) / 1e6
+    }
+
+    private fun text(seconds: Double, text: String): String {
+        val out = StringBuilder()
+        var start = 0
+        while (start < text.length) {
+            val end = text.indexOf('\n', start).let { if (it < 0) text.length else it + 1 }
+            if (atLineStart) out.append(String.format(Locale.US, "[%10.3f] ", seconds))
+            out.append(text, start, end)
+            atLineStart = text[end - 1] == '\n'
+            start = end
+        }
+        return out.toString()
+    }
+
+    private class Args(private val payload: ByteArray) {
+        private var pos = 0
+
+        private fun take(n: Int): ByteBuffer? {
+            if (pos + n > payload.size) {
+                pos = payload.size
+                return null
+            }
+            val buffer = ByteBuffer.wrap(payload, pos, n).order(ByteOrder.LITTLE_ENDIAN)
+            pos += n
+            return buffer
+        }
+
+        fun word(): Long? = take(4)?.int?.toLong()?.and(0xFFFFFFFFL)
+        fun signedWord(): Long? = take(4)?.int?.toLong()
+        fun dword(): Long? = take(8)?.long
+        fun float(): Float? = take(4)?.float
+
+        fun string(): String? {
+            val n = take(1)?.get()?.toInt()?.and(0xFF) ?: return null
+            val start = pos
+            return take(n)?.let { String(payload, start, n, Charsets.UTF_8) }
+        }
+    }
+
+    // printf-style formatting with the arguments read from the record
+    private fun formatRecord(format: String, args: Args): String = CONVERSION.replace(format) { m ->
+        val (flags, widthSpec, precisionSpec, length, conv) = m.destructured
+        if (conv == "%") return@replace "%"
+        val width = if (widthSpec == "*") args.signedWord()?.toString() ?: "" else widthSpec
+        val precision = if (precisionSpec == "*") args.signedWord()?.toString() ?: "" else precisionSpec
+        val hasPrecision = m.value.contains('.')
+        val spec = "%" + flags + width + (if (hasPrecision) ".$precision" else "")
+
+        try {
+            when {
+                conv == "s" -> args.string()?.let { String.format(Locale.US, spec + "s", it) }
+                conv in "eEfFgGaA" -> args.float()?.let {
+                    String.format(Locale.US, spec + (if (conv in "aAF") "f" else conv), it.toDouble())
+                }
+                conv == "p" -> args.word()?.let { String.format(Locale.US, "0x%08x", it) }
+                conv == "c" -> args.word()?.let { String.format(Locale.US, "%" + flags + width + "c", it.toInt()) }
+                else -> {
+                    val signed = conv == "d" || conv == "i"
+                    val value: Any? = when {
+                        length == "ll" && signed -> args.dword()
+                        length == "ll" -> args.dword()?.let { java.lang.Long.toUnsignedString(it).toBigInteger() }
+                        signed -> args.signedWord()
+                        else -> args.word()
+                    }
+                    // Java has no %u/%i, and no precision or '#' for decimal integers
+                    val decimal = conv == "d" || conv == "i" || conv == "u"
+                    val intSpec = if (decimal) "%" + flags.replace("#", "") + width + "d" else "%" + flags + width + conv
+                    value?.let { String.format(Locale.US, intSpec, it) }
+                }
+            } ?: "?"
+        } catch (e: Exception) {
+            "?"
+        }
+    }
+}
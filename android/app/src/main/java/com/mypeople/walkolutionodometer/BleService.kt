@@ -32,6 +32,7 @@ import android.os.Handler
 import android.os.IBinder
 import android.os.Looper
 import android.os.PowerManager
+import android.os.SystemClock
 import android.util.Log
 import androidx.annotation.RequiresApi
 import androidx.core.app.ActivityCompat
@@ -44,6 +45,8 @@ import kotlinx.coroutines.flow.MutableStateFlow
 import kotlinx.coroutines.flow.StateFlow
 import kotlinx.coroutines.flow.asStateFlow
 import kotlinx.coroutines.launch
+import kotlinx.coroutines.withContext
+import java.io.IOException
 import java.nio.ByteBuffer
 import java.nio.ByteOrder
 import java.util.UUID
@@ -126,7 +129,18 @@ class BleService : Service() {
     private var scanStartTime = 0L
 
     // MTU negotiation
-    private val desiredMtu = 185
+    // Fills one 251-byte data length extension packet (firmware LINK_POLICY_ATT_MTU)
+    private val desiredMtu = 247
+    private var negotiatedMtu = 23
+
+    // Connection to first odometer notification; a bonded device skips discovery (cached GATT)
+    private var connectedAtMs = 0L
+    private var connectedBonded = false
+    private var firstNotificationLogged = false
+
+    // L2CAP bulk channel (BulkChannel.kt), opened on first use; GATT reads when the firmware has none
+    @Volatile private var bulkChannel: BulkChannel? = null
+    private var bulkChannelUnavailable = false
 
     // Watchdog timer to detect and recover from stuck states
     private var watchdogRunnable: Runnable? = null
@@ -167,6 +181,28 @@ class BleService : Service() {
         val USER_SETTINGS_CHARACTERISTIC_UUID: UUID = UUID.fromString("12345678-1234-5678-1234-56789abcdef5")
         val SET_LIFETIME_TOTALS_CHARACTERISTIC_UUID: UUID = UUID.fromString("12345678-1234-5678-1234-56789abcdef7")
         val LOGS_CHARACTERISTIC_UUID: UUID = UUID.fromString("12345678-1234-5678-1234-56789abcdef8")
+
+        // Log stream flow control: notifications granted at a time, and the
+        // number left outstanding when more are granted
+        private const val LOG_STREAM_CREDITS = 32
+        private const val LOG_STREAM_LOW_CREDITS = 16
+
+        // Odometer notification formats (firmware odo_packet.h): 1 = full packed
+        // struct every second, 2 = only the fields that changed, as varints
+        private const val ODOMETER_FORMAT_FULL = 1
+        private const val ODOMETER_FORMAT_COMPACT = 2
+        private const val ODOMETER_FIELD_COUNT = 9
+        private const val ODOMETER_KEYFRAME = 0x8000
+
+        // Session IDs per batched mark reported write (firmware ODOMETER_MARK_BATCH_MAX)
+        // and the result codes read back after it
+        private const val MARK_REPORTED_BATCH_MAX = 60
+        private const val MARK_RESULT_NOT_FOUND = 2
+        private const val MARK_RESULT_FAILED = 3
+
+        // Watch UI open: ask for faster (about 4 Hz) odometer notifications
+        const val ACTION_LIVE_UPDATES = "com.mypeople.walkolutionodometer.LIVE_UPDATES"
+        const val EXTRA_LIVE_UPDATES_ENABLED = "enabled"
         val CLIENT_CHARACTERISTIC_CONFIG_UUID: UUID = UUID.fromString("00002902-0000-1000-8000-00805f9b34fb")
 
         const val CM_PER_ROTATION = 34.56f
@@ -209,6 +245,13 @@ class BleService : Service() {
     }
 
     override fun onStartCommand(intent: Intent?, flags: Int, startId: Int): Int {
+        if (intent?.action == ACTION_LIVE_UPDATES) {
+            setLiveUpdates(intent.getBooleanExtra(EXTRA_LIVE_UPDATES_ENABLED, false))
+            // Already running: nothing else to start
+            if (serviceStarted) return START_STICKY
+        }
+        serviceStarted = true
+
         val isPeriodicWakeup = intent?.getBooleanExtra("periodic_wakeup", false) ?: false
         Log.i(TAG, "BleService started (periodic_wakeup=$isPeriodicWakeup)")
 
@@ -522,6 +565,16 @@ class BleService : Service() {
         }
         bluetoothGatt = null
         lastGattActivityTime = 0
+        closeBulkChannel()
+    }
+
+    private fun closeBulkChannel() {
+        try {
+            bulkChannel?.close()
+        } catch (e: IOException) {
+            Log.w(TAG, "Closing bulk channel: ${e.message}")
+        }
+        bulkChannel = null
     }
 
     private fun resetBluetoothScanner() {
@@ -860,7 +913,11 @@ class BleService : Service() {
 
             when (newState) {
                 BluetoothProfile.STATE_CONNECTED -> {
-                    Log.i(TAG, "BLE connected, requesting MTU...")
+                    connectedAtMs = System.currentTimeMillis()
+                    connectedBonded = hasBluetoothConnectPermission() && gatt.device.bondState == BluetoothDevice.BOND_BONDED
+                    firstNotificationLogged = false
+                    bulkChannelUnavailable = false
+                    Log.i(TAG, "BLE connected (${if (connectedBonded) "bonded" else "not bonded, firmware asks to pair"}), requesting MTU...")
                     _isConnected.value = true
                     isConnecting = false
                     connectionAttemptStartTime = 0
@@ -902,12 +959,15 @@ class BleService : Service() {
                     connectionAttemptStartTime = 0
                     _connectionStatus.value = "Disconnected"
                     notificationsEnabled = false
+                    odometerFormat = ODOMETER_FORMAT_FULL
+                    negotiatedMtu = 23
 
                     // Send disconnection status to watch
                     wearDataSender.sendOdometerData(_odometerData.value, false, dailyGoalMiles)
 
                     // Stop log polling on disconnect
                     stopLogPolling()
+                    stopLogStream()
 
                     cleanupGatt()
 
@@ -990,11 +1050,24 @@ class BleService : Service() {
         override fun onMtuChanged(gatt: BluetoothGatt, mtu: Int, status: Int) {
             Log.i(TAG, "onMtuChanged: mtu=$mtu, status=$status")
             lastGattActivityTime = System.currentTimeMillis()
+            if (status == BluetoothGatt.GATT_SUCCESS) {
+                negotiatedMtu = mtu
+            }
         }
 
         override fun onDescriptorWrite(gatt: BluetoothGatt, descriptor: BluetoothGattDescriptor, status: Int) {
             lastGattActivityTime = System.currentTimeMillis()
 
+            if (descriptor.characteristic.uuid == LOGS_CHARACTERISTIC_UUID) {
+                onLogStreamEnabled(status == BluetoothGatt.GATT_SUCCESS)
+                return
+            }
+            if (descriptor.characteristic.uuid == SESSIONS_LIST_CHARACTERISTIC_UUID) {
+                Log.i(TAG, "Sessions notifications ${if (status == BluetoothGatt.GATT_SUCCESS) "enabled" else "failed: $status"}")
+                completeBleRequest()
+                return
+            }
+
             if (descriptor.uuid == CLIENT_CHARACTERISTIC_CONFIG_UUID) {
                 if (status == BluetoothGatt.GATT_SUCCESS) {
                     notificationsEnabled = true
@@ -1029,10 +1102,17 @@ class BleService : Service() {
                         Log.i(TAG, "Time sync sent successfully")
                         // Complete the request and queue next operations
                         completeBleRequest()
+                        enqueueBleRequest(BleRequest.SetOdometerFormat(ODOMETER_FORMAT_COMPACT, liveUpdates))
                         enqueueBleRequest(BleRequest.ReadUserSettings)
                         enqueueBleRequest(BleRequest.ReadSessionsList)
+                        enqueueBleRequest(BleRequest.StartSessionsNotifications)
                         enqueueBleRequest(BleRequest.StartLogPolling)
                     }
+                    LOGS_CHARACTERISTIC_UUID -> {
+                        // Credits granted; notifications keep coming without more round trips
+                        logCreditGrantPending = false
+                        completeBleRequest(0)
+                    }
                     MARK_REPORTED_CHARACTERISTIC_UUID -> {
                         Log.i(TAG, "Session marked as reported successfully")
                         completeBleRequest()
@@ -1041,6 +1121,13 @@ class BleService : Service() {
                         Log.i(TAG, "User settings written successfully")
                         completeBleRequest()
                     }
+                    ODOMETER_CHARACTERISTIC_UUID -> {
+                        // Notifications after the write response use the new format
+                        Log.i(TAG, "Odometer notification format $pendingOdometerFormat accepted")
+                        odometerFormat = pendingOdometerFormat
+                        compactHaveKeyframe = false
+                        completeBleRequest()
+                    }
                 }
             } else {
                 val errorMsg = getGattErrorMessage(status)
@@ -1050,6 +1137,11 @@ class BleService : Service() {
                         Log.w(TAG, "Mark reported write failed: $errorMsg (status=$status)")
                         failBleRequest("Write failed: $errorMsg")
                     }
+                    LOGS_CHARACTERISTIC_UUID -> {
+                        Log.w(TAG, "Log credit write failed: $errorMsg (status=$status)")
+                        logCreditGrantPending = false
+                        completeBleRequest()
+                    }
                     else -> {
                         Log.w(TAG, "Characteristic write failed for ${characteristic.uuid}: $errorMsg (status=$status)")
                         completeBleRequest()
@@ -1072,6 +1164,10 @@ class BleService : Service() {
                         parseUserSettings(value)
                         completeBleRequest()
                     }
+                    MARK_REPORTED_CHARACTERISTIC_UUID -> {
+                        parseMarkResults(value)
+                        completeBleRequest()
+                    }
                     LOGS_CHARACTERISTIC_UUID -> {
                         parseLogs(value)
                         // This is polled, not queued, so don't complete
@@ -1082,7 +1178,7 @@ class BleService : Service() {
                 Log.w(TAG, "Characteristic read failed for ${characteristic.uuid}: $errorMsg (status=$status)")
                 // Complete request even on failure to avoid queue getting stuck
                 when (characteristic.uuid) {
-                    SESSIONS_LIST_CHARACTERISTIC_UUID, USER_SETTINGS_CHARACTERISTIC_UUID -> {
+                    SESSIONS_LIST_CHARACTERISTIC_UUID, USER_SETTINGS_CHARACTERISTIC_UUID, MARK_REPORTED_CHARACTERISTIC_UUID -> {
                         _bleLastError.value = "Read ${characteristic.uuid} failed: $errorMsg"
                         completeBleRequest()
                     }
@@ -1109,6 +1205,10 @@ class BleService : Service() {
                             parseUserSettings(value)
                             completeBleRequest()
                         }
+                        MARK_REPORTED_CHARACTERISTIC_UUID -> {
+                            parseMarkResults(value)
+                            completeBleRequest()
+                        }
                         LOGS_CHARACTERISTIC_UUID -> {
                             parseLogs(value)
                             // This is polled, not queued, so don't complete
@@ -1120,7 +1220,7 @@ class BleService : Service() {
                 Log.w(TAG, "Characteristic read failed for ${characteristic.uuid}: $errorMsg (status=$status)")
                 // Complete request even on failure to avoid queue getting stuck
                 when (characteristic.uuid) {
-                    SESSIONS_LIST_CHARACTERISTIC_UUID, USER_SETTINGS_CHARACTERISTIC_UUID -> {
+                    SESSIONS_LIST_CHARACTERISTIC_UUID, USER_SETTINGS_CHARACTERISTIC_UUID, MARK_REPORTED_CHARACTERISTIC_UUID -> {
                         _bleLastError.value = "Read ${characteristic.uuid} failed: $errorMsg"
                         completeBleRequest()
                     }
@@ -1133,6 +1233,10 @@ class BleService : Service() {
             lastGattActivityTime = System.currentTimeMillis()
             if (characteristic.uuid == ODOMETER_CHARACTERISTIC_UUID) {
                 parseOdometerData(value)
+            } else if (characteristic.uuid == LOGS_CHARACTERISTIC_UUID) {
+                handleLogNotification(value)
+            } else if (characteristic.uuid == SESSIONS_LIST_CHARACTERISTIC_UUID) {
+                handleSessionNotification(value)
             }
         }
 
@@ -1143,11 +1247,25 @@ class BleService : Service() {
             lastGattActivityTime = System.currentTimeMillis()
             if (characteristic.uuid == ODOMETER_CHARACTERISTIC_UUID) {
                 characteristic.value?.let { parseOdometerData(it) }
+            } else if (characteristic.uuid == LOGS_CHARACTERISTIC_UUID) {
+                characteristic.value?.let { handleLogNotification(it) }
+            } else if (characteristic.uuid == SESSIONS_LIST_CHARACTERISTIC_UUID) {
+                characteristic.value?.let { handleSessionNotification(it) }
             }
         }
     }
 
     private fun parseOdometerData(data: ByteArray) {
+        if (!firstNotificationLogged) {
+            firstNotificationLogged = true
+            Log.i(TAG, "First odometer notification ${System.currentTimeMillis() - connectedAtMs} ms after connecting " +
+                    "(${if (connectedBonded) "bonded" else "not bonded"})")
+        }
+        if (odometerFormat == ODOMETER_FORMAT_COMPACT) {
+            parseCompactOdometerData(data)
+            return
+        }
+
         if (data.size < 28) {
             Log.e(TAG, "Data too short: ${data.size} bytes, expected at least 28")
             return
@@ -1173,6 +1291,70 @@ class BleService : Service() {
             String(ssidBytes).trim('\u0000')
         } else ""
 
+        Log.d(TAG, "Parsed data: sessRot=$sessionRotations, runSpeed=$runningAvgSpeed ${if (metric) "km/h" else "mph"}, sessionId=$sessionId, metric=$metric, ssid=$ssid")
+
+        publishOdometerData(
+            sessionRotations.toInt(), totalRotations.toLong(), sessionTimeSeconds.toInt(), totalTimeSeconds.toInt(),
+            runningAvgSpeed, sessionAvgSpeed, voltageMv.toLong(), sessionId, metric
+        )
+    }
+
+    // Compact notification: [2][bitmap u16][one varint per bitmap bit]. A keyframe
+    // (bit 15) has plain values, otherwise each varint is a zigzag delta.
+    private fun parseCompactOdometerData(data: ByteArray) {
+        if (data.size < 3 || data[0].toInt() != ODOMETER_FORMAT_COMPACT) {
+            Log.w(TAG, "Unexpected odometer packet: ${data.size} bytes, version ${data.firstOrNull()}")
+            return
+        }
+        val bitmap = (data[1].toInt() and 0xFF) or ((data[2].toInt() and 0xFF) shl 8)
+        val keyframe = (bitmap and ODOMETER_KEYFRAME) != 0
+        if (!keyframe && !compactHaveKeyframe) {
+            Log.d(TAG, "Odometer delta before a keyframe - waiting for the next keyframe")
+            return
+        }
+
+        val values = compactValues.copyOf()
+        var pos = 3
+        for (field in 0 until ODOMETER_FIELD_COUNT) {
+            if ((bitmap and (1 shl field)) == 0) continue
+            var raw = 0L
+            var shift = 0
+            while (true) {
+                if (pos >= data.size || shift > 28) {
+                    Log.w(TAG, "Truncated odometer packet (${data.size} bytes)")
+                    return
+                }
+                val b = data[pos++].toInt() and 0xFF
+                raw = raw or ((b and 0x7F).toLong() shl shift)
+                shift += 7
+                if ((b and 0x80) == 0) break
+            }
+            raw = raw and 0xFFFFFFFFL
+            values[field] = if (keyframe) raw else (values[field] + ((raw ushr 1) xor -(raw and 1))) and 0xFFFFFFFFL
+        }
+        values.copyInto(compactValues)
+        compactHaveKeyframe = true
+
+        val metric = values[8] != 0L
+        Log.d(TAG, "Parsed compact data (${data.size} bytes${if (keyframe) ", keyframe" else ""}): sessRot=${values[0]}, runSpeed=${values[4] / 100f} ${if (metric) "km/h" else "mph"}, sessionId=${values[7]}")
+
+        publishOdometerData(
+            values[0].toInt(), values[1], values[2].toInt(), values[3].toInt(),
+            values[4] / 100f, values[5] / 100f, values[6], values[7].toInt(), metric
+        )
+    }
+
+    private fun publishOdometerData(
+        sessionRotations: Int,
+        totalRotations: Long,
+        sessionTimeSeconds: Int,
+        totalTimeSeconds: Int,
+        runningAvgSpeed: Float,
+        sessionAvgSpeed: Float,
+        voltageMv: Long,
+        sessionId: Int,
+        metric: Boolean
+    ) {
         // Calculate unreported totals from all unreported sessions
         val unreportedRotations = _unreportedSessions.value.sumOf { it.rotationCount }
         val unreportedSeconds = _unreportedSessions.value.sumOf { it.activeTimeSeconds }
@@ -1180,21 +1362,19 @@ class BleService : Service() {
         val newData = OdometerData(
             sessionMiles = sessionRotations.toFloat() * MILES_PER_ROTATION,
             totalMiles = totalRotations.toFloat() * MILES_PER_ROTATION,
-            sessionTime = formatTime(sessionTimeSeconds.toInt()),
-            totalTime = formatTime(totalTimeSeconds.toInt()),
+            sessionTime = formatTime(sessionTimeSeconds),
+            totalTime = formatTime(totalTimeSeconds),
             runningAvgSpeed = runningAvgSpeed,
             sessionAvgSpeed = sessionAvgSpeed,
             voltageV = voltageMv.toFloat() / 1000f,
             sessionId = sessionId,
-            sessionRotations = sessionRotations.toInt(),
-            sessionTimeSeconds = sessionTimeSeconds.toInt(),
+            sessionRotations = sessionRotations,
+            sessionTimeSeconds = sessionTimeSeconds,
             metric = metric,
             unreportedMiles = unreportedRotations.toFloat() * MILES_PER_ROTATION,
             unreportedTimeSeconds = unreportedSeconds
         )
 
-        Log.d(TAG, "Parsed data: sessRot=$sessionRotations, runSpeed=$runningAvgSpeed ${if (metric) "km/h" else "mph"}, sessionId=$sessionId, metric=$metric, ssid=$ssid")
-
         val previousSessionId = _odometerData.value.sessionId
         _odometerData.value = newData
 
@@ -1424,6 +1604,12 @@ class BleService : Service() {
             return
         }
 
+        val device = bluetoothGatt?.device
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.Q && !bulkChannelUnavailable && device != null) {
+            readSessionsListBulk(device)
+            return
+        }
+
         val service = bluetoothGatt?.getService(ODOMETER_SERVICE_UUID)
         if (service == null) {
             Log.w(TAG, "Cannot read sessions list - service not found")
@@ -1444,6 +1630,35 @@ class BleService : Service() {
         // Will be completed in onCharacteristicRead callback
     }
 
+    // Sessions list in one stream over the bulk channel instead of a GATT long read
+    @RequiresApi(Build.VERSION_CODES.Q)
+    private fun readSessionsListBulk(device: BluetoothDevice) {
+        serviceScope.launch {
+            val result = withContext(Dispatchers.IO) {
+                try {
+                    val channel = bulkChannel ?: BulkChannel.open(device).also { bulkChannel = it }
+                    channel.fetch(BulkChannel.TYPE_SESSIONS)
+                } catch (e: IOException) {
+                    Log.w(TAG, "Bulk channel unavailable (${e.message}), reading sessions list over GATT")
+                    closeBulkChannel()
+                    null
+                }
+            }
+            if (currentRequest != BleRequest.ReadSessionsList) {
+                return@launch // Timed out or disconnected meanwhile
+            }
+            if (result == null) {
+                bulkChannelUnavailable = true
+                executeReadSessionsList()
+                return@launch
+            }
+            Log.i(TAG, "Sessions list over bulk channel: ${result.data.size} bytes in ${result.frames} frames, " +
+                    "${result.millis} ms (${result.bytesPerSecond} B/s)")
+            parseSessionsList(result.data)
+            completeBleRequest()
+        }
+    }
+
     private fun parseSessionsList(data: ByteArray) {
         Log.d(TAG, "parseSessionsList: received ${data.size} bytes")
 
@@ -1484,23 +1699,23 @@ class BleService : Service() {
             val discardedSessions = sessionCacheManager.getDiscardedSessions()
             val discardedIds = discardedSessions.map { it.sessionId }.toSet()
 
-            // Send confirmations for uploaded sessions
+            // Send confirmations for uploaded and discarded sessions, together
+            val confirmIds = mutableListOf<Int>()
             for (session in sessions) {
                 if (session.sessionId in uploadedIds) {
                     Log.i(TAG, "Syncing confirmation for uploaded session ${session.sessionId}")
-                    markSessionReported(session.sessionId)
+                    confirmIds.add(session.sessionId)
                     sessionCacheManager.removeUploadedSession(session.sessionId)
                 }
             }
-
-            // Send confirmations for discarded sessions
             for (session in sessions) {
                 if (session.sessionId in discardedIds) {
                     Log.i(TAG, "Syncing confirmation for discarded session ${session.sessionId}")
-                    markSessionReported(session.sessionId)
+                    confirmIds.add(session.sessionId)
                     sessionCacheManager.removeDiscardedSession(session.sessionId)
                 }
             }
+            markMultipleSessionsReported(confirmIds)
 
             val filteredSessions = sessions.filter {
                 it.sessionId !in uploadedIds && it.sessionId !in discardedIds
@@ -1566,15 +1781,87 @@ class BleService : Service() {
 
         Log.i(TAG, "Marking ${sessionIds.size} sessions as reported in batch")
 
-        // Queue all mark reported requests without individual refreshes
-        sessionIds.forEach { sessionId ->
-            enqueueBleRequest(BleRequest.MarkSessionReported(sessionId))
+        // Firmware that reports batch results (readable characteristic) takes many
+        // IDs per write and commits each write to flash at once
+        val characteristic = bluetoothGatt?.getService(ODOMETER_SERVICE_UUID)?.getCharacteristic(MARK_REPORTED_CHARACTERISTIC_UUID)
+        val batched = characteristic != null && (characteristic.properties and BluetoothGattCharacteristic.PROPERTY_READ) != 0
+        val perWrite = minOf(MARK_REPORTED_BATCH_MAX, (negotiatedMtu - 3) / 4)
+        if (batched && sessionIds.size > 1 && perWrite > 1) {
+            sessionIds.chunked(perWrite).forEach { ids ->
+                if (ids.size == 1) {
+                    // A single ID is the legacy write, which has no results to read
+                    enqueueBleRequest(BleRequest.MarkSessionReported(ids[0]))
+                } else {
+                    enqueueBleRequest(BleRequest.MarkSessionsReported(ids))
+                    enqueueBleRequest(BleRequest.ReadMarkResults)
+                }
+            }
+        } else {
+            // Queue all mark reported requests without individual refreshes
+            sessionIds.forEach { sessionId ->
+                enqueueBleRequest(BleRequest.MarkSessionReported(sessionId))
+            }
         }
 
         // Queue a single refresh at the end
         enqueueBleRequest(BleRequest.ReadSessionsList)
     }
 
+    private fun executeMarkSessionsReported(sessionIds: List<Int>) {
+        val characteristic = bluetoothGatt?.getService(ODOMETER_SERVICE_UUID)?.getCharacteristic(MARK_REPORTED_CHARACTERISTIC_UUID)
+        if (characteristic == null || !hasBluetoothConnectPermission()) {
+            Log.w(TAG, "Cannot mark sessions reported - characteristic or permission missing")
+            completeBleRequest()
+            return
+        }
+
+        val buffer = ByteBuffer.allocate(sessionIds.size * 4).order(ByteOrder.LITTLE_ENDIAN)
+        sessionIds.forEach { buffer.putInt(it) }
+        val data = buffer.array()
+
+        Log.d(TAG, "Marking ${sessionIds.size} sessions as reported in one write...")
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.TIRAMISU) {
+            bluetoothGatt?.writeCharacteristic(characteristic, data, BluetoothGattCharacteristic.WRITE_TYPE_DEFAULT)
+        } else {
+            @Suppress("DEPRECATION")
+            characteristic.value = data
+            @Suppress("DEPRECATION")
+            characteristic.writeType = BluetoothGattCharacteristic.WRITE_TYPE_DEFAULT
+            @Suppress("DEPRECATION")
+            bluetoothGatt?.writeCharacteristic(characteristic)
+        }
+        // Will be completed in onCharacteristicWrite callback
+    }
+
+    private fun executeReadMarkResults() {
+        val characteristic = bluetoothGatt?.getService(ODOMETER_SERVICE_UUID)?.getCharacteristic(MARK_REPORTED_CHARACTERISTIC_UUID)
+        if (characteristic == null || !hasBluetoothConnectPermission()) {
+            completeBleRequest()
+            return
+        }
+        bluetoothGatt?.readCharacteristic(characteristic)
+        // Will be completed in onCharacteristicRead callback
+    }
+
+    // Results of the last batch: [session_id u32][result u8] per ID.
+    // Sessions whose flash write failed are retried one at a time
+    private fun parseMarkResults(data: ByteArray) {
+        val buffer = ByteBuffer.wrap(data).order(ByteOrder.LITTLE_ENDIAN)
+        var marked = 0
+        while (buffer.remaining() >= 5) {
+            val sessionId = buffer.int
+            when (buffer.get().toInt()) {
+                MARK_RESULT_FAILED -> {
+                    Log.w(TAG, "Session $sessionId not marked reported (flash write failed) - retrying alone")
+                    enqueueBleRequest(BleRequest.MarkSessionReported(sessionId))
+                }
+                MARK_RESULT_NOT_FOUND -> Log.w(TAG, "Session $sessionId not found on device")
+                else -> marked++
+            }
+        }
+        Log.i(TAG, "Batch mark reported: $marked of ${data.size / 5} sessions marked (or already reported)")
+    }
+
     // Execute mark session reported
     private fun executeMarkSessionReported(sessionId: Int) {
         Log.i(TAG, "Executing mark session $sessionId as reported")
@@ -1634,19 +1921,20 @@ class BleService : Service() {
 
         val characteristic = service.getCharacteristic(TIME_SYNC_CHARACTERISTIC_UUID)
         if (characteristic != null) {
-            val unixTimestamp = (System.currentTimeMillis() / 1000).toInt()
+            val unixTimeMs = System.currentTimeMillis()
 
             // Get timezone offset in seconds
             val timeZone = java.util.TimeZone.getDefault()
-            val timezoneOffsetSeconds = timeZone.getOffset(System.currentTimeMillis()) / 1000
+            val timezoneOffsetSeconds = timeZone.getOffset(unixTimeMs) / 1000
 
-            // Send 8 bytes: 4 bytes timestamp + 4 bytes timezone offset
-            val buffer = ByteBuffer.allocate(8).order(ByteOrder.LITTLE_ENDIAN)
-            buffer.putInt(unixTimestamp)
+            // Send 12 bytes: 8 bytes timestamp in ms + 4 bytes timezone offset.
+            // The device disciplines its clock with these, so keep the milliseconds
+            val buffer = ByteBuffer.allocate(12).order(ByteOrder.LITTLE_ENDIAN)
+            buffer.putLong(unixTimeMs)
             buffer.putInt(timezoneOffsetSeconds)
             val data = buffer.array()
 
-            Log.i(TAG, "Sending time sync: timestamp=$unixTimestamp, timezone_offset=${timezoneOffsetSeconds}s (${timezoneOffsetSeconds/3600.0f}h)")
+            Log.i(TAG, "Sending time sync: timestamp=${unixTimeMs}ms, timezone_offset=${timezoneOffsetSeconds}s (${timezoneOffsetSeconds/3600.0f}h)")
             val result = if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.TIRAMISU) {
                 bluetoothGatt?.writeCharacteristic(characteristic, data, BluetoothGattCharacteristic.WRITE_TYPE_DEFAULT)
             } else {
@@ -1801,6 +2089,65 @@ class BleService : Service() {
         }
     }
 
+    // Enable notifications on the sessions list characteristic: after the one full
+    // read on connect, each session saved on the device arrives on its own
+    private fun executeStartSessionsNotifications() {
+        val gatt = bluetoothGatt
+        val characteristic = gatt?.getService(ODOMETER_SERVICE_UUID)?.getCharacteristic(SESSIONS_LIST_CHARACTERISTIC_UUID)
+        val descriptor = characteristic?.getDescriptor(CLIENT_CHARACTERISTIC_CONFIG_UUID)
+        if (descriptor == null || !hasBluetoothConnectPermission()) {
+            Log.w(TAG, "Cannot enable sessions notifications")
+            completeBleRequest()
+            return
+        }
+
+        gatt.setCharacteristicNotification(characteristic, true)
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.TIRAMISU) {
+            gatt.writeDescriptor(descriptor, BluetoothGattDescriptor.ENABLE_NOTIFICATION_VALUE)
+        } else {
+            @Suppress("DEPRECATION")
+            descriptor.value = BluetoothGattDescriptor.ENABLE_NOTIFICATION_VALUE
+            @Suppress("DEPRECATION")
+            gatt.writeDescriptor(descriptor)
+        }
+        // Will be completed in onDescriptorWrite callback
+    }
+
+    // One session record (20 bytes, as in the sessions list) saved on the device.
+    // Replaces any entry for the same session, the current session included
+    private fun handleSessionNotification(data: ByteArray) {
+        if (data.size != 20) {
+            Log.e(TAG, "Invalid session notification size: ${data.size} bytes")
+            return
+        }
+
+        val buffer = ByteBuffer.wrap(data).order(ByteOrder.LITTLE_ENDIAN)
+        val session = SessionRecord(
+            sessionId = buffer.int,
+            rotationCount = buffer.int,
+            activeTimeSeconds = buffer.int,
+            startTimeUnix = buffer.int.toLong() and 0xFFFFFFFFL,
+            endTimeUnix = buffer.int.toLong() and 0xFFFFFFFFL
+        )
+        Log.i(TAG, "Session ${session.sessionId} saved on device: ${session.rotationCount} rotations, ${session.activeTimeSeconds}s")
+
+        serviceScope.launch {
+            val uploadedIds = sessionCacheManager.getUploadedSessions().map { it.sessionId }.toSet()
+            val discardedIds = sessionCacheManager.getDiscardedSessions().map { it.sessionId }.toSet()
+            if (session.sessionId in uploadedIds || session.sessionId in discardedIds) {
+                // Already dealt with here; the device only missed the confirmation
+                markSessionReported(session.sessionId)
+                sessionCacheManager.removeUploadedSession(session.sessionId)
+                sessionCacheManager.removeDiscardedSession(session.sessionId)
+                return@launch
+            }
+
+            val existingCached = sessionCacheManager.getCachedSessions()
+            sessionCacheManager.cacheSessions(existingCached.filter { it.sessionId != session.sessionId } + session)
+            _unreportedSessions.value = _unreportedSessions.value.filter { it.sessionId != session.sessionId } + session
+        }
+    }
+
     // Public API to read user settings (queues the request)
     fun readUserSettings() {
         enqueueBleRequest(BleRequest.ReadUserSettings)
@@ -1834,6 +2181,43 @@ class BleService : Service() {
     }
 
     // Execute write user settings
+    // Ask for an odometer notification format; firmware without the write
+    // property only has format 1
+    private fun executeSetOdometerFormat(version: Int, highRate: Boolean) {
+        val characteristic = bluetoothGatt?.getService(ODOMETER_SERVICE_UUID)?.getCharacteristic(ODOMETER_CHARACTERISTIC_UUID)
+        if (characteristic == null || !hasBluetoothConnectPermission() ||
+            (characteristic.properties and BluetoothGattCharacteristic.PROPERTY_WRITE) == 0) {
+            Log.i(TAG, "Odometer notification format not selectable - keeping format $odometerFormat")
+            completeBleRequest(0)
+            return
+        }
+
+        val data = byteArrayOf(version.toByte(), (if (highRate) 1 else 0).toByte())
+        pendingOdometerFormat = version
+        Log.d(TAG, "Requesting odometer notification format $version (high rate: $highRate)")
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.TIRAMISU) {
+            bluetoothGatt?.writeCharacteristic(characteristic, data, BluetoothGattCharacteristic.WRITE_TYPE_DEFAULT)
+        } else {
+            @Suppress("DEPRECATION")
+            characteristic.value = data
+            @Suppress("DEPRECATION")
+            characteristic.writeType = BluetoothGattCharacteristic.WRITE_TYPE_DEFAULT
+            @Suppress("DEPRECATION")
+            bluetoothGatt?.writeCharacteristic(characteristic)
+        }
+        // Will be completed in onCharacteristicWrite callback
+    }
+
+    // Faster odometer updates while the watch shows them
+    private fun setLiveUpdates(enabled: Boolean) {
+        if (enabled == liveUpdates) return
+        liveUpdates = enabled
+        Log.i(TAG, "Watch live updates ${if (enabled) "on" else "off"}")
+        if (_isConnected.value && notificationsEnabled && odometerFormat == ODOMETER_FORMAT_COMPACT) {
+            enqueueBleRequest(BleRequest.SetOdometerFormat(ODOMETER_FORMAT_COMPACT, enabled))
+        }
+    }
+
     private fun executeWriteUserSettings(metric: Boolean) {
         Log.i(TAG, "Executing write user settings")
 
@@ -1907,21 +2291,51 @@ class BleService : Service() {
     // Track if last log read returned data (for adaptive polling)
     private var lastLogReadHadData = false
 
+    // Firmware built with LOG_BINARY=1 sends binary records instead of text
+    private val binaryLogDecoder by lazy { BinaryLogDecoder.fromAssets(this) }
+    private var binaryLogs = false
+
     // Track if LogsActivity is visible (for adaptive polling)
     private var logsActivityVisible = false
 
+    // Log streaming over notifications (firmware log_stream.h): the device sends
+    // one notification per credit, each starting with its position in the log.
+    // The cursor survives reconnects so the device can resend what was missed.
+    private var logStreaming = false
+    private var logStreamCursor: Long? = null
+    private var logCreditsOutstanding = 0
+    private var logCreditGrantPending = false
+    private var logStreamBurstBytes = 0L
+    private var logStreamBurstStartMs = 0L
+
+    // Odometer notification format in use; compact packets are deltas against
+    // the values decoded so far, starting from a keyframe
+    private var odometerFormat = ODOMETER_FORMAT_FULL
+    private var pendingOdometerFormat = ODOMETER_FORMAT_FULL
+    private val compactValues = LongArray(ODOMETER_FIELD_COUNT)
+    private var compactHaveKeyframe = false
+    private var liveUpdates = false
+    private var serviceStarted = false
+
     // BLE request queue for serializing operations
     private sealed class BleRequest {
         object SendTimeSync : BleRequest()
         object ReadUserSettings : BleRequest()
         object ReadSessionsList : BleRequest()
         object StartLogPolling : BleRequest()
+        object StartLogStream : BleRequest()
+        object StartSessionsNotifications : BleRequest()
+        data class GrantLogCredits(val credits: Int, val resumeCursor: Long?) : BleRequest()
         data class MarkSessionReported(val sessionId: Int, val retryCount: Int = 0) : BleRequest()
+        data class MarkSessionsReported(val sessionIds: List<Int>) : BleRequest()
+        object ReadMarkResults : BleRequest()
         data class WriteUserSettings(val metric: Boolean) : BleRequest()
+        data class SetOdometerFormat(val version: Int, val highRate: Boolean) : BleRequest()
     }
     private val bleRequestQueue = mutableListOf<BleRequest>()
     private var processingBleRequest = false
     private var currentRequest: BleRequest? = null
+    private var requestStartedMs = 0L  // Request to response time, e.g. ATT read/write latency
 
     // Retry configuration
     private val MAX_RETRIES = 3
@@ -1986,6 +2400,7 @@ class BleService : Service() {
         val request = bleRequestQueue.removeAt(0)
         _bleQueueSize.value = bleRequestQueue.size
         currentRequest = request
+        requestStartedMs = SystemClock.elapsedRealtime()
         Log.i(TAG, "Processing BLE request: ${request::class.simpleName}, ${bleRequestQueue.size} remaining")
 
         // Start timeout watchdog
@@ -1996,8 +2411,14 @@ class BleService : Service() {
             is BleRequest.ReadUserSettings -> executeReadUserSettings()
             is BleRequest.ReadSessionsList -> executeReadSessionsList()
             is BleRequest.StartLogPolling -> executeStartLogPolling()
+            is BleRequest.StartLogStream -> executeStartLogStream()
+            is BleRequest.StartSessionsNotifications -> executeStartSessionsNotifications()
+            is BleRequest.GrantLogCredits -> executeGrantLogCredits(request.credits, request.resumeCursor)
             is BleRequest.MarkSessionReported -> executeMarkSessionReported(request.sessionId)
+            is BleRequest.MarkSessionsReported -> executeMarkSessionsReported(request.sessionIds)
+            is BleRequest.ReadMarkResults -> executeReadMarkResults()
             is BleRequest.WriteUserSettings -> executeWriteUserSettings(request.metric)
+            is BleRequest.SetOdometerFormat -> executeSetOdometerFormat(request.version, request.highRate)
         }
     }
 
@@ -2021,6 +2442,9 @@ class BleService : Service() {
 
     // Mark the current BLE request as complete and process the next one
     private fun completeBleRequest(delayMs: Long = 150) {
+        currentRequest?.let {
+            Log.i(TAG, "BLE request ${it::class.simpleName} answered in ${SystemClock.elapsedRealtime() - requestStartedMs} ms")
+        }
         Log.d(TAG, "BLE request complete, scheduling next after ${delayMs}ms")
         cancelRequestTimeout()
         currentRequest = null
@@ -2063,6 +2487,17 @@ class BleService : Service() {
                 processNextBleRequest()
             }, retryDelay)
         } else {
+            // A failed batch is retried one session at a time
+            if (request is BleRequest.MarkSessionsReported) {
+                Log.w(TAG, "Batch mark reported failed: $reason. Retrying ${request.sessionIds.size} sessions one at a time")
+                // Its results read would return the previous batch
+                if (bleRequestQueue.firstOrNull() is BleRequest.ReadMarkResults) {
+                    bleRequestQueue.removeAt(0)
+                }
+                request.sessionIds.reversed().forEach { bleRequestQueue.add(0, BleRequest.MarkSessionReported(it)) }
+                _bleQueueSize.value = bleRequestQueue.size
+            }
+
             // No more retries or non-retryable request
             if (request is BleRequest.MarkSessionReported && request.retryCount >= MAX_RETRIES) {
                 Log.e(TAG, "BLE request permanently failed after $MAX_RETRIES attempts: $reason")
@@ -2106,7 +2541,15 @@ class BleService : Service() {
     }
 
     // Execute start log polling
+    // Firmware whose logs characteristic can notify streams the logs instead
     private fun executeStartLogPolling() {
+        val logsCharacteristic = bluetoothGatt?.getService(ODOMETER_SERVICE_UUID)?.getCharacteristic(LOGS_CHARACTERISTIC_UUID)
+        if (logsCharacteristic != null && (logsCharacteristic.properties and BluetoothGattCharacteristic.PROPERTY_NOTIFY) != 0) {
+            completeBleRequest(0)
+            enqueueBleRequest(BleRequest.StartLogStream)
+            return
+        }
+
         Log.i(TAG, "========== STARTING LOG POLLING ==========")
         Log.i(TAG, "Connected: ${_isConnected.value}, Notifications: $notificationsEnabled")
         mainHandler.removeCallbacks(logPollingRunnable)
@@ -2121,6 +2564,122 @@ class BleService : Service() {
         mainHandler.removeCallbacks(logPollingRunnable)
     }
 
+    // Enable notifications on the logs characteristic
+    private fun executeStartLogStream() {
+        val gatt = bluetoothGatt
+        val characteristic = gatt?.getService(ODOMETER_SERVICE_UUID)?.getCharacteristic(LOGS_CHARACTERISTIC_UUID)
+        val descriptor = characteristic?.getDescriptor(CLIENT_CHARACTERISTIC_CONFIG_UUID)
+        if (descriptor == null || !hasBluetoothConnectPermission()) {
+            Log.w(TAG, "Cannot stream logs - falling back to polling")
+            completeBleRequest(0)
+            mainHandler.post(logPollingRunnable)
+            return
+        }
+
+        Log.i(TAG, "========== STARTING LOG STREAM ==========")
+        gatt.setCharacteristicNotification(characteristic, true)
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.TIRAMISU) {
+            gatt.writeDescriptor(descriptor, BluetoothGattDescriptor.ENABLE_NOTIFICATION_VALUE)
+        } else {
+            @Suppress("DEPRECATION")
+            descriptor.value = BluetoothGattDescriptor.ENABLE_NOTIFICATION_VALUE
+            @Suppress("DEPRECATION")
+            gatt.writeDescriptor(descriptor)
+        }
+        // Will be completed in onDescriptorWrite callback
+    }
+
+    private fun onLogStreamEnabled(success: Boolean) {
+        completeBleRequest(0)
+        if (!success) {
+            Log.w(TAG, "Enabling log notifications failed - falling back to polling")
+            mainHandler.post(logPollingRunnable)
+            return
+        }
+        logStreaming = true
+        logCreditsOutstanding = 0
+        logStreamBurstBytes = 0
+        grantLogCredits(logStreamCursor)
+    }
+
+    private fun grantLogCredits(resumeCursor: Long? = null) {
+        if (logCreditGrantPending) return
+        val credits = LOG_STREAM_CREDITS - logCreditsOutstanding
+        logCreditGrantPending = true
+        logCreditsOutstanding += credits
+        enqueueBleRequest(BleRequest.GrantLogCredits(credits, resumeCursor))
+    }
+
+    // Write credits, plus the position to resume from after a reconnect
+    private fun executeGrantLogCredits(credits: Int, resumeCursor: Long?) {
+        val characteristic = bluetoothGatt?.getService(ODOMETER_SERVICE_UUID)?.getCharacteristic(LOGS_CHARACTERISTIC_UUID)
+        if (characteristic == null || !hasBluetoothConnectPermission()) {
+            logCreditGrantPending = false
+            completeBleRequest(0)
+            return
+        }
+
+        val buffer = ByteBuffer.allocate(if (resumeCursor != null) 6 else 2).order(ByteOrder.LITTLE_ENDIAN)
+        buffer.putShort(credits.toShort())
+        resumeCursor?.let { buffer.putInt(it.toInt()) }
+        val data = buffer.array()
+
+        Log.d(TAG, "Granting $credits log credits${resumeCursor?.let { ", resume at $it" } ?: ""}")
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.TIRAMISU) {
+            bluetoothGatt?.writeCharacteristic(characteristic, data, BluetoothGattCharacteristic.WRITE_TYPE_DEFAULT)
+        } else {
+            @Suppress("DEPRECATION")
+            characteristic.value = data
+            @Suppress("DEPRECATION")
+            characteristic.writeType = BluetoothGattCharacteristic.WRITE_TYPE_DEFAULT
+            @Suppress("DEPRECATION")
+            bluetoothGatt?.writeCharacteristic(characteristic)
+        }
+        // Will be completed in onCharacteristicWrite callback
+    }
+
+    // One log notification: [cursor u32][log bytes]
+    private fun handleLogNotification(value: ByteArray) {
+        if (value.size < 4) return
+        val cursor = ByteBuffer.wrap(value, 0, 4).order(ByteOrder.LITTLE_ENDIAN).int.toLong() and 0xFFFFFFFFL
+        val payload = value.copyOfRange(4, value.size)
+
+        logStreamCursor?.let { expected ->
+            if (cursor != expected) {
+                val gap = (cursor - expected) and 0xFFFFFFFFL
+                val note = if (gap < 0x80000000L) "<$gap bytes of logs missed>" else "<log stream restarted>"
+                Log.w(TAG, "Log stream jumped from $expected to $cursor: $note")
+                _logMessages.value = _logMessages.value + "\n$note\n"
+            }
+        }
+        logStreamCursor = (cursor + payload.size) and 0xFFFFFFFFL
+
+        // Throughput while notifications keep arriving back to back
+        val now = System.currentTimeMillis()
+        if (logStreamBurstBytes == 0L || now - logStreamBurstStartMs > 5000) {
+            logStreamBurstStartMs = now
+            logStreamBurstBytes = 0
+        }
+        logStreamBurstBytes += payload.size
+
+        parseLogs(payload)
+
+        logCreditsOutstanding = maxOf(0, logCreditsOutstanding - 1)
+        if (logCreditsOutstanding <= LOG_STREAM_LOW_CREDITS) {
+            val elapsed = now - logStreamBurstStartMs
+            if (elapsed > 0) {
+                Log.d(TAG, "Log stream: $logStreamBurstBytes bytes in ${elapsed}ms (${logStreamBurstBytes * 1000 / elapsed} B/s)")
+            }
+            grantLogCredits()
+        }
+    }
+
+    private fun stopLogStream() {
+        logStreaming = false
+        logCreditsOutstanding = 0
+        logCreditGrantPending = false
+    }
+
     // Read logs from device
     private fun readLogs() {
         if (!hasBluetoothConnectPermission()) {
@@ -2156,8 +2715,12 @@ class BleService : Service() {
         }
 
         try {
-            // Convert bytes to string and append to existing logs
-            val newLogs = String(data, Charsets.UTF_8)
+            // Convert bytes to string (decoding binary records) and append to existing logs
+            if (!binaryLogs && BinaryLogDecoder.looksBinary(data)) {
+                Log.i(TAG, "Device sends binary logs - decoding with the bundled string table")
+                binaryLogs = true
+            }
+            val newLogs = if (binaryLogs) binaryLogDecoder.feed(data) else String(data, Charsets.UTF_8)
             val currentLogs = _logMessages.value + newLogs
 
             _logMessages.value = currentLogs
@@ -2182,6 +2745,10 @@ class BleService : Service() {
 
     // Manually trigger a log read and drain buffer (for manual refresh)
     fun triggerLogRead() {
+        if (logStreaming) {
+            Log.i(TAG, "Manual log read ignored - logs are streamed")
+            return
+        }
         Log.i(TAG, "Manual log read triggered - will drain buffer")
         if (_isConnected.value && notificationsEnabled) {
             // Remove scheduled poll and force rapid polling to drain buffer
@@ -2198,6 +2765,9 @@ class BleService : Service() {
         Log.i(TAG, "========== LOGS ACTIVITY VISIBLE ==========")
         Log.i(TAG, "Connected: ${_isConnected.value}, Notifications: $notificationsEnabled")
         logsActivityVisible = true
+        if (logStreaming) {
+            return
+        }
 
         // Trigger an immediate poll when activity becomes visible
         // Remove any pending polls and restart immediately
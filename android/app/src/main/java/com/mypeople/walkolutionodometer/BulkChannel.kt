@@ -0,0 +1,98 @@
+package com.mypeople.walkolutionodometer
+
+import android.annotation.SuppressLint
+import android.bluetooth.BluetoothDevice
+import android.bluetooth.BluetoothSocket
+import android.os.Build
+import android.os.SystemClock
+import androidx.annotation.RequiresApi
+import java.io.ByteArrayOutputStream
+import java.io.Closeable
+import java.io.DataInputStream
+import java.io.IOException
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * Client for the firmware's L2CAP bulk channel (bulk_proto.h, bulk_channel.h).
+ *
+ * One request, then frames [type][status][cursor u32][length u16][payload]
+ * until the one marked END. Each fetch is a single stream at the link's rate
+ * instead of one GATT read per MTU. Blocking: call from a background thread.
+ */
+@RequiresApi(Build.VERSION_CODES.Q)
+class BulkChannel private constructor(private val socket: BluetoothSocket) : Closeable {
+
+    companion object {
+        const val PSM = 0x0081
+
+        const val TYPE_LOGS = 1
+        const val TYPE_SESSIONS = 2
+        const val TYPE_DIAG = 3
+
+        const val LENGTH_ALL = 0xFFFFFFFFL
+
+        private const val HEADER_SIZE = 8
+        private const val STATUS_END = 1
+        private const val STATUS_ERROR = 2
+
+        // Needs BLUETOOTH_CONNECT, checked by the caller
+        @SuppressLint("MissingPermission")
+        fun open(device: BluetoothDevice): BulkChannel {
+            val socket = device.createInsecureL2capChannel(PSM)
+            try {
+                socket.connect()
+            } catch (e: IOException) {
+                socket.close()
+                throw e
+            }
+            return BulkChannel(socket)
+        }
+    }
+
+    data class Result(val data: ByteArray, val nextCursor: Long, val frames: Int, val millis: Long) {
+        val bytesPerSecond: Long get() = if (millis > 0) data.size * 1000L / millis else 0
+    }
+
+    private val input = DataInputStream(socket.inputStream)
+
+    fun fetch(type: Int, cursor: Long = 0, length: Long = LENGTH_ALL): Result {
+        val startedMs = SystemClock.elapsedRealtime()
+        val request = ByteBuffer.allocate(9).order(ByteOrder.LITTLE_ENDIAN)
+            .put(type.toByte())
+            .putInt(cursor.toInt())
+            .putInt(length.toInt())
+        socket.outputStream.write(request.array())
+        socket.outputStream.flush()
+
+        val data = ByteArrayOutputStream()
+        val header = ByteArray(HEADER_SIZE)
+        var frames = 0
+        while (true) {
+            input.readFully(header)
+            val buffer = ByteBuffer.wrap(header).order(ByteOrder.LITTLE_ENDIAN)
+            val frameType = buffer.get().toInt() and 0xFF
+            val status = buffer.get().toInt() and 0xFF
+            val frameCursor = buffer.int.toLong() and 0xFFFFFFFFL
+            val frameLength = buffer.short.toInt() and 0xFFFF
+            val payload = ByteArray(frameLength)
+            input.readFully(payload)
+            frames++
+
+            if (status == STATUS_ERROR) {
+                throw IOException("Bulk request type $type refused")
+            }
+            if (frameType != type) {
+                throw IOException("Bulk frame type $frameType, expected $type")
+            }
+            data.write(payload)
+            if (status == STATUS_END) {
+                return Result(data.toByteArray(), frameCursor + frameLength, frames, SystemClock.elapsedRealtime() - startedMs)
+            }
+        }
+    }
+
+    override fun close() {
+        socket.close()
+    }
+}
@@ -9,6 +9,7 @@ class WearMessageListener : WearableListenerService() {
     companion object {
         private const val TAG = "WearMessageListener"
         const val REPORT_ALL_PATH = "/report_all"
+        const val LIVE_UPDATES_PATH = "/live_updates"
     }
 
     override fun onMessageReceived(messageEvent: MessageEvent) {
@@ -24,6 +25,21 @@ class WearMessageListener : WearableListenerService() {
                 }
                 startActivity(intent)
             }
+            LIVE_UPDATES_PATH -> {
+                // Payload: 1 while the watch shows live values, 0 when it stops
+                val enabled = messageEvent.data.firstOrNull()?.toInt() == 1
+                Log.i(TAG, "Watch live updates ${if (enabled) "on" else "off"}")
+                val intent = Intent(this, BleService::class.java).apply {
+                    action = BleService.ACTION_LIVE_UPDATES
+                    putExtra(BleService.EXTRA_LIVE_UPDATES_ENABLED, enabled)
+                }
+                try {
+                    startService(intent)
+                } catch (e: IllegalStateException) {
+                    // BleService not running and the app is in the background
+                    Log.w(TAG, "Cannot reach BleService for live updates: ${e.message}")
+                }
+            }
         }
     }
 }
@@ -45,23 +45,36 @@ class WatchMainActivity : ComponentActivity() {
         }
     }
 
+    // Faster odometer updates from the phone while the screen is showing them
+    override fun onResume() {
+        super.onResume()
+        sendMessage("/live_updates", byteArrayOf(1))
+    }
+
+    override fun onPause() {
+        sendMessage("/live_updates", byteArrayOf(0))
+        super.onPause()
+    }
+
     private fun sendReportAllMessage() {
         Log.i(TAG, "Sending Report All message to phone")
+        sendMessage("/report_all", "/report_all".toByteArray())
+    }
 
-        // Send via Wearable Data Layer message
-        val message = "/report_all".toByteArray()
+    // Send via Wearable Data Layer message to every connected phone
+    private fun sendMessage(path: String, message: ByteArray) {
         val nodeClient = Wearable.getNodeClient(this)
         nodeClient.connectedNodes.addOnSuccessListener { nodes ->
             if (nodes.isEmpty()) {
                 Log.w(TAG, "No connected nodes found")
             }
             for (node in nodes) {
-                messageClient.sendMessage(node.id, "/report_all", message)
+                messageClient.sendMessage(node.id, path, message)
                     .addOnSuccessListener {
-                        Log.i(TAG, "Report All message sent to ${node.displayName}")
+                        Log.i(TAG, "$path message sent to ${node.displayName}")
                     }
                     .addOnFailureListener { e ->
-                        Log.e(TAG, "Failed to send Report All message to ${node.displayName}", e)
+                        Log.e(TAG, "Failed to send $path message to ${node.displayName}", e)
                     }
             }
         }.addOnFailureListener { e ->
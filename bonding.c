@@ -0,0 +1,250 @@
+/**
+ * BLE bonding implementation
+ */
+
+#include "bonding.h"
+#include "gatt_cache.h"
+#include "diag.h"
+#include "logging.h"
+#include "pico/stdlib.h"
+#include "btstack.h"
+
+// TLV tag of the GATT cache record ("WOGC"), next to BTstack's own bond tags
+#define BONDING_TAG_GATT_CACHE (((uint32_t)'W' << 24) | ((uint32_t)'O' << 16) | ((uint32_t)'G' << 8) | 'C')
+
+typedef struct
+{
+    bool connected;                    // Slot in use
+    hci_con_handle_t con_handle;
+    bool reconnect;                    // Address resolved to a stored bond
+    int index;                         // LE device DB index of that bond
+} bond_link_t;
+
+static bond_link_t links[MAX_NR_HCI_CONNECTIONS];
+static gatt_cache_t gatt_cache;
+static uint16_t service_changed_handle = 0;
+static const btstack_tlv_t *tlv_impl = NULL;
+static void *tlv_context = NULL;
+static btstack_packet_callback_registration_t hci_event_callback_registration;
+static btstack_packet_callback_registration_t sm_event_callback_registration;
+
+static bond_link_t *find_link(hci_con_handle_t con_handle)
+{
+    for (int i = 0; i < MAX_NR_HCI_CONNECTIONS; i++)
+    {
+        if (links[i].connected && links[i].con_handle == con_handle)
+        {
+            return &links[i];
+        }
+    }
+    return NULL;
+}
+
+static bond_link_t *free_link(void)
+{
+    for (int i = 0; i < MAX_NR_HCI_CONNECTIONS; i++)
+    {
+        if (!links[i].connected)
+        {
+            return &links[i];
+        }
+    }
+    return NULL;
+}
+
+static void store_gatt_cache(void)
+{
+    if (tlv_impl == NULL)
+    {
+        return;
+    }
+    int result = tlv_impl->store_tag(tlv_context, BONDING_TAG_GATT_CACHE, (const uint8_t *)&gatt_cache, sizeof(gatt_cache));
+    if (result != 0)
+    {
+        LOG_ERROR(LOG_TAG_BLE, "[BOND] ERROR: GATT cache record not stored (%d)\n", result);
+    }
+}
+
+// Bonds stored in the LE device DB, one bit per index
+static uint32_t bonded_mask(void)
+{
+    uint32_t bonded = 0;
+    int count = le_device_db_max_count();
+
+    for (int i = 0; i < count && i < GATT_CACHE_MAX_CLIENTS; i++)
+    {
+        int addr_type;
+        bd_addr_t addr;
+        sm_key_t irk;
+        le_device_db_info(i, &addr_type, addr, irk);
+        if (addr_type != BD_ADDR_TYPE_UNKNOWN)
+        {
+            bonded |= 1u << i;
+        }
+    }
+    return bonded;
+}
+
+// A bonded client is encrypted again: tell it once if the database changed
+static void check_service_changed(bond_link_t *link)
+{
+    if (!link->reconnect || !gatt_cache_changed_for(&gatt_cache, link->index))
+    {
+        return;
+    }
+
+    uint8_t range[4];
+    little_endian_store_16(range, 0, 0x0001);
+    little_endian_store_16(range, 2, 0xFFFF);
+    uint8_t result = att_server_indicate(link->con_handle, service_changed_handle, range, sizeof(range));
+    if (result != ERROR_CODE_SUCCESS)
+    {
+        LOG_WARN(LOG_TAG_BLE, "[BOND] Service Changed to bond %d not sent (0x%02x), next time\n", link->index, result);
+        return;
+    }
+    LOG_INFO(LOG_TAG_BLE, "[BOND] Service Changed sent to bond %d\n", link->index);
+    if (gatt_cache_client_current(&gatt_cache, link->index))
+    {
+        store_gatt_cache();
+    }
+}
+
+static void bonding_packet_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size)
+{
+    UNUSED(channel);
+    UNUSED(size);
+
+    if (packet_type != HCI_EVENT_PACKET)
+    {
+        return;
+    }
+
+    bond_link_t *link;
+    hci_con_handle_t con_handle;
+    switch (hci_event_packet_get_type(packet))
+    {
+    case HCI_EVENT_LE_META:
+        if (hci_event_le_meta_get_subevent_code(packet) != HCI_SUBEVENT_LE_CONNECTION_COMPLETE)
+        {
+            break;
+        }
+        link = free_link();
+        if (link != NULL)
+        {
+            link->connected = true;
+            link->con_handle = hci_subevent_le_connection_complete_get_connection_handle(packet);
+            link->reconnect = false;
+            link->index = -1;
+        }
+        break;
+
+    case HCI_EVENT_DISCONNECTION_COMPLETE:
+        link = find_link(hci_event_disconnection_complete_get_connection_handle(packet));
+        if (link != NULL)
+        {
+            link->connected = false;
+        }
+        break;
+
+    case SM_EVENT_IDENTITY_RESOLVING_SUCCEEDED:
+        link = find_link(sm_event_identity_resolving_succeeded_get_handle(packet));
+        if (link != NULL)
+        {
+            link->reconnect = true;
+            link->index = sm_event_identity_resolving_succeeded_get_index(packet);
+            LOG_INFO(LOG_TAG_BLE, "[BOND] 0x%04x is bond %d\n", link->con_handle, link->index);
+        }
+        break;
+
+    case SM_EVENT_JUST_WORKS_REQUEST:
+        con_handle = sm_event_just_works_request_get_handle(packet);
+        LOG_INFO(LOG_TAG_BLE, "[BOND] Pairing with 0x%04x (Just Works)\n", con_handle);
+        sm_just_works_confirm(con_handle);
+        break;
+
+    case SM_EVENT_PAIRING_COMPLETE:
+        con_handle = sm_event_pairing_complete_get_handle(packet);
+        if (sm_event_pairing_complete_get_status(packet) != ERROR_CODE_SUCCESS)
+        {
+            LOG_WARN(LOG_TAG_BLE, "[BOND] Pairing with 0x%04x failed: status 0x%02x, reason 0x%02x\n", con_handle,
+                                  sm_event_pairing_complete_get_status(packet), sm_event_pairing_complete_get_reason(packet));
+            break;
+        }
+        diag_count_pairing();
+        LOG_INFO(LOG_TAG_BLE, "[BOND] Paired with 0x%04x, bond %d\n", con_handle, sm_le_device_index(con_handle));
+        // The new bond discovers the current database
+        if (gatt_cache_client_current(&gatt_cache, sm_le_device_index(con_handle)))
+        {
+            store_gatt_cache();
+        }
+        break;
+
+    case SM_EVENT_REENCRYPTION_COMPLETE:
+        if (sm_event_reencryption_complete_get_status(packet) != ERROR_CODE_SUCCESS)
+        {
+            LOG_WARN(LOG_TAG_BLE, "[BOND] Re-encryption with 0x%04x failed: status 0x%02x (client dropped the bond?)\n",
+                                  sm_event_reencryption_complete_get_handle(packet), sm_event_reencryption_complete_get_status(packet));
+        }
+        break;
+
+    case HCI_EVENT_ENCRYPTION_CHANGE:
+        con_handle = hci_event_encryption_change_get_connection_handle(packet);
+        if (hci_event_encryption_change_get_status(packet) != ERROR_CODE_SUCCESS ||
+            !hci_event_encryption_change_get_encryption_enabled(packet))
+        {
+            break;
+        }
+        LOG_INFO(LOG_TAG_BLE, "[BOND] 0x%04x encrypted, key size %u\n", con_handle, gap_encryption_key_size(con_handle));
+        link = find_link(con_handle);
+        if (link != NULL)
+        {
+            check_service_changed(link);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+void bonding_init(const uint8_t *att_db, size_t att_db_size, uint16_t service_changed)
+{
+    service_changed_handle = service_changed;
+
+    // LE Secure Connections, bonding, no MITM protection: nothing to show or type a passkey on
+    sm_set_io_capabilities(IO_CAPABILITY_NO_INPUT_NO_OUTPUT);
+    sm_set_authentication_requirements(SM_AUTHREQ_SECURE_CONNECTION | SM_AUTHREQ_BONDING);
+    sm_set_request_security(1);
+
+    hci_event_callback_registration.callback = &bonding_packet_handler;
+    hci_add_event_handler(&hci_event_callback_registration);
+    sm_event_callback_registration.callback = &bonding_packet_handler;
+    sm_add_event_handler(&sm_event_callback_registration);
+
+    // GATT cache record: which bonds still have to hear that the database changed
+    gatt_cache_t stored;
+    bool have_stored = false;
+    btstack_tlv_get_instance(&tlv_impl, &tlv_context);
+    if (tlv_impl != NULL)
+    {
+        have_stored = tlv_impl->get_tag(tlv_context, BONDING_TAG_GATT_CACHE, (uint8_t *)&stored, sizeof(stored)) == sizeof(stored);
+    }
+    else
+    {
+        LOG_WARN(LOG_TAG_BLE, "[BOND] No key-value store: bonds are not kept\n");
+    }
+
+    uint32_t bonded = bonded_mask();
+    if (gatt_cache_boot(&gatt_cache, have_stored ? &stored : NULL, gatt_cache_fingerprint(att_db, att_db_size), bonded))
+    {
+        store_gatt_cache();
+    }
+    LOG_INFO(LOG_TAG_BLE, "[BOND] Bonds 0x%08lx, GATT database %08lx, Service Changed due 0x%08lx\n",
+                          bonded, gatt_cache.db_fingerprint, gatt_cache.pending);
+}
+
+bool bonding_is_reconnect(hci_con_handle_t con_handle)
+{
+    bond_link_t *link = find_link(con_handle);
+    return link != NULL && link->reconnect;
+}
@@ -0,0 +1,35 @@
+/**
+ * BLE bonding
+ *
+ * LE Secure Connections pairing with bonding (Just Works: the device has no
+ * input, and its display is off much of the time). The security request at
+ * connection time makes a new client pair and a bonded one encrypt with its
+ * stored keys. A bonded Android phone keeps its GATT cache and reconnects
+ * without service discovery.
+ *
+ * Bonds (LE device DB) and the GATT cache record (gatt_cache.h) are kept in
+ * BTstack's flash key-value store (TLV). The pico_flash_bank sectors hold it;
+ * CMakeLists.txt places them below the settings sector (see flash.h for the
+ * layout). After a firmware update that changes the GATT database, each
+ * bonded client gets one Service Changed indication when it next encrypts.
+ */
+
+#ifndef BONDING_H
+#define BONDING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "btstack.h"
+
+// Set up pairing and load the GATT cache record. The ATT database and the
+// Service Changed value handle come from the generated GATT header, which
+// only walkolution-odometer.c can include. Call after sm_init() and
+// att_server_init()
+void bonding_init(const uint8_t *att_db, size_t att_db_size, uint16_t service_changed_handle);
+
+// Whether this connection is a bonded client coming back (its address
+// resolved to a stored bond), as opposed to a new or unbonded one
+bool bonding_is_reconnect(hci_con_handle_t con_handle);
+
+#endif // BONDING_H
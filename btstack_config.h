@@ -4,6 +4,9 @@
 // BTstack features that can be enabled
 #define ENABLE_BLE
 #define ENABLE_LE_PERIPHERAL
+#define ENABLE_LE_DATA_LENGTH_EXTENSION
+#define ENABLE_LE_SECURE_CONNECTIONS
+#define ENABLE_L2CAP_LE_CREDIT_BASED_FLOW_CONTROL_MODE  // Bulk channel (bulk_channel.h)
 #define ENABLE_LOG_INFO
 #define ENABLE_LOG_ERROR
 #define ENABLE_PRINTF_HEXDUMP
@@ -14,12 +17,12 @@
 #define HCI_ACL_CHUNK_SIZE_ALIGNMENT 4
 
 #define MAX_NR_GATT_CLIENTS 1
-#define MAX_NR_HCI_CONNECTIONS 1
-#define MAX_NR_L2CAP_CHANNELS 2
+#define MAX_NR_HCI_CONNECTIONS 2  // Centrals at once, e.g. phone and watch
+#define MAX_NR_L2CAP_CHANNELS 2  // A bulk channel per connection
 #define MAX_NR_L2CAP_SERVICES 2
 #define MAX_NR_SM_LOOKUP_ENTRIES 3
 #define MAX_NR_WHITELIST_ENTRIES 1
-#define MAX_NR_LE_DEVICE_DB_ENTRIES 1
+#define MAX_NR_LE_DEVICE_DB_ENTRIES 4  // Bonds (bonding.h), as many as NVM_NUM_DEVICE_DB_ENTRIES
 
 // Limit number of ACL/SCO Buffer to use by stack to avoid cyw43 shared bus overrun
 #define MAX_NR_CONTROLLER_ACL_BUFFERS 3
@@ -0,0 +1,351 @@
+/**
+ * Bulk transfer channel implementation
+ */
+
+#include "bulk_channel.h"
+#include "bulk_proto.h"
+#include "link_policy.h"
+#include "log_stream.h"
+#include "logging.h"
+#include "odometer.h"
+#include "flash.h"
+#include "diag.h"
+#include "timebase.h"
+#include "pico/stdlib.h"
+#include "btstack.h"
+#include <string.h>
+
+// Our receive MTU: requests are BULK_REQUEST_SIZE bytes, L2CAP's minimum is 23
+#define BULK_CHANNEL_RECEIVE_SIZE 32
+
+typedef struct
+{
+    bool open;                         // Slot in use, from the incoming connection on
+    uint16_t local_cid;
+    hci_con_handle_t con_handle;
+    uint16_t remote_mtu;               // 0 until the channel is open
+    bulk_transfer_t transfer;
+    bool error_pending;                // Answer error_request with an error frame
+    bulk_request_t error_request;
+    uint32_t started_us;
+    uint8_t receive_buffer[BULK_CHANNEL_RECEIVE_SIZE];
+    uint8_t frame[BULK_CHANNEL_SDU_SIZE]; // L2CAP sends from here until it can send again
+
+    // Sessions list and diagnostics as served: all frames of a response, and a
+    // request resuming at a later cursor, come from the same copy
+    session_record_t sessions[FLASH_SECTOR_COUNT];
+    uint32_t sessions_size;
+    bool sessions_valid;
+    diag_snapshot_t diag;
+    bool diag_valid;
+} bulk_link_t;
+
+static bulk_link_t links[MAX_NR_HCI_CONNECTIONS];
+static hci_con_handle_t log_owner = HCI_CON_HANDLE_INVALID; // GATT log stream's connection
+
+static bulk_link_t *find_link(uint16_t local_cid)
+{
+    for (int i = 0; i < MAX_NR_HCI_CONNECTIONS; i++)
+    {
+        if (links[i].open && links[i].local_cid == local_cid)
+        {
+            return &links[i];
+        }
+    }
+    return NULL;
+}
+
+static bulk_link_t *find_link_by_handle(hci_con_handle_t con_handle)
+{
+    for (int i = 0; i < MAX_NR_HCI_CONNECTIONS; i++)
+    {
+        if (links[i].open && links[i].con_handle == con_handle)
+        {
+            return &links[i];
+        }
+    }
+    return NULL;
+}
+
+static bulk_link_t *free_link(void)
+{
+    for (int i = 0; i < MAX_NR_HCI_CONNECTIONS; i++)
+    {
+        if (!links[i].open)
+        {
+            return &links[i];
+        }
+    }
+    return NULL;
+}
+
+static const char *type_name(uint8_t type)
+{
+    switch (type)
+    {
+    case BULK_TYPE_LOGS:
+        return "logs";
+    case BULK_TYPE_SESSIONS:
+        return "sessions";
+    case BULK_TYPE_DIAG:
+        return "diagnostics";
+    default:
+        return "unknown";
+    }
+}
+
+static size_t read_snapshot(const uint8_t *data, uint32_t size, uint32_t cursor, uint8_t *dest, size_t max_len)
+{
+    if (cursor >= size)
+    {
+        return 0;
+    }
+    size_t len = (size - cursor < max_len) ? size - cursor : max_len;
+    memcpy(dest, &data[cursor], len);
+    return len;
+}
+
+// Consumes what it reads, like the logs characteristic
+static size_t read_logs(void *context, uint32_t *cursor, uint8_t *dest, size_t max_len)
+{
+    UNUSED(context);
+    if (*cursor != logging_get_read_cursor())
+    {
+        *cursor = logging_seek_logs(*cursor); // Later if that part was dropped
+    }
+    return logging_get_new_logs((char *)dest, max_len);
+}
+
+static size_t read_sessions(void *context, uint32_t *cursor, uint8_t *dest, size_t max_len)
+{
+    bulk_link_t *link = (bulk_link_t *)context;
+    return read_snapshot((const uint8_t *)link->sessions, link->sessions_size, *cursor, dest, max_len);
+}
+
+static size_t read_diag(void *context, uint32_t *cursor, uint8_t *dest, size_t max_len)
+{
+    bulk_link_t *link = (bulk_link_t *)context;
+    return read_snapshot((const uint8_t *)&link->diag, sizeof(link->diag), *cursor, dest, max_len);
+}
+
+static bulk_read_fn reader_for(uint8_t type)
+{
+    switch (type)
+    {
+    case BULK_TYPE_LOGS:
+        return read_logs;
+    case BULK_TYPE_SESSIONS:
+        return read_sessions;
+    case BULK_TYPE_DIAG:
+        return read_diag;
+    default:
+        return NULL;
+    }
+}
+
+// Logs are read by one connection at a time: the GATT stream's, or the
+// first to ask here
+static bool logs_taken(const bulk_link_t *link)
+{
+    return (log_owner != HCI_CON_HANDLE_INVALID && log_owner != link->con_handle) ||
+           bulk_channel_reading_logs(link->con_handle);
+}
+
+static void handle_request(bulk_link_t *link, const uint8_t *data, uint16_t size)
+{
+    bulk_request_t req;
+    bool parsed = bulk_parse_request(data, size, &req);
+    bool logs_busy = parsed && req.type == BULK_TYPE_LOGS && logs_taken(link);
+    if (!parsed || reader_for(req.type) == NULL || link->transfer.active || logs_busy)
+    {
+        LOG_WARN(LOG_TAG_BLE, "[BULK] 0x%04x request refused: %u bytes, type %u%s\n", link->con_handle, size,
+                              size > 0 ? data[0] : 0,
+                              link->transfer.active ? ", transfer running" : logs_busy ? ", logs read by another connection" : "");
+        memset(&link->error_request, 0, sizeof(link->error_request));
+        if (size > 0)
+        {
+            link->error_request.type = data[0];
+        }
+        link->error_pending = true;
+        l2cap_request_can_send_now_event(link->local_cid);
+        return;
+    }
+
+    // A request from the start takes a fresh copy of a snapshot source
+    switch (req.type)
+    {
+    case BULK_TYPE_LOGS:
+        if (req.cursor == LOG_STREAM_CURSOR_CURRENT)
+        {
+            req.cursor = logging_get_read_cursor();
+        }
+        break;
+    case BULK_TYPE_SESSIONS:
+        if (req.cursor == 0 || !link->sessions_valid)
+        {
+            link->sessions_size = odometer_get_unreported_sessions(link->sessions, FLASH_SECTOR_COUNT) * sizeof(session_record_t);
+            link->sessions_valid = true;
+        }
+        break;
+    case BULK_TYPE_DIAG:
+        if (req.cursor == 0 || !link->diag_valid)
+        {
+            diag_snapshot(&link->diag, timebase_ms());
+            link->diag_valid = true;
+        }
+        break;
+    }
+
+    LOG_DEBUG(LOG_TAG_BLE, "[BULK] 0x%04x %s from %lu, up to %lu bytes\n", link->con_handle, type_name(req.type), req.cursor, req.length);
+    bulk_transfer_start(&link->transfer, &req);
+    link->started_us = time_us_32();
+    link_policy_bulk(link->con_handle, timebase_ms());
+    l2cap_request_can_send_now_event(link->local_cid);
+}
+
+static void send_next_frame(bulk_link_t *link)
+{
+    size_t len;
+    if (link->error_pending)
+    {
+        link->error_pending = false;
+        len = bulk_error_frame(&link->error_request, link->frame);
+    }
+    else
+    {
+        size_t frame_size = (link->remote_mtu < sizeof(link->frame)) ? link->remote_mtu : sizeof(link->frame);
+        len = bulk_transfer_next(&link->transfer, reader_for(link->transfer.type), link, link->frame, frame_size);
+        if (len == 0)
+        {
+            return;
+        }
+    }
+
+    uint8_t status = l2cap_send(link->local_cid, link->frame, (uint16_t)len);
+    if (status != ERROR_CODE_SUCCESS)
+    {
+        LOG_WARN(LOG_TAG_BLE, "[BULK] 0x%04x frame not sent (0x%02x), %s transfer stopped\n", link->con_handle, status, type_name(link->transfer.type));
+        link->transfer.active = false;
+        return;
+    }
+    link_policy_bulk(link->con_handle, timebase_ms());
+
+    if (link->transfer.active || link->error_pending)
+    {
+        l2cap_request_can_send_now_event(link->local_cid);
+    }
+    else if (link->transfer.frames > 0)
+    {
+        uint32_t elapsed_us = time_us_32() - link->started_us;
+        uint32_t rate = elapsed_us > 0 ? (uint32_t)((uint64_t)link->transfer.bytes * 1000000u / elapsed_us) : 0;
+        LOG_INFO(LOG_TAG_BLE, "[BULK] 0x%04x %s: %lu bytes in %lu frames, %lu ms, %lu B/s\n", link->con_handle,
+                              type_name(link->transfer.type), link->transfer.bytes, link->transfer.frames, elapsed_us / 1000, rate);
+        link->transfer.frames = 0;
+    }
+}
+
+static void bulk_packet_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size)
+{
+    bulk_link_t *link;
+    uint16_t local_cid;
+
+    if (packet_type == L2CAP_DATA_PACKET)
+    {
+        link = find_link(channel);
+        if (link != NULL && link->remote_mtu > 0)
+        {
+            handle_request(link, packet, size);
+        }
+        return;
+    }
+    if (packet_type != HCI_EVENT_PACKET)
+    {
+        return;
+    }
+
+    switch (hci_event_packet_get_type(packet))
+    {
+    case L2CAP_EVENT_CBM_INCOMING_CONNECTION:
+    {
+        local_cid = l2cap_event_cbm_incoming_connection_get_local_cid(packet);
+        hci_con_handle_t con_handle = l2cap_event_cbm_incoming_connection_get_handle(packet);
+        link = (find_link_by_handle(con_handle) == NULL) ? free_link() : NULL;
+        if (link == NULL)
+        {
+            LOG_WARN(LOG_TAG_BLE, "[BULK] 0x%04x already has a channel, declined\n", con_handle);
+            l2cap_cbm_decline_connection(local_cid, L2CAP_CBM_CONNECTION_RESULT_NO_RESOURCES_AVAILABLE);
+            break;
+        }
+        memset(link, 0, sizeof(*link));
+        link->open = true;
+        link->local_cid = local_cid;
+        link->con_handle = con_handle;
+        l2cap_cbm_accept_connection(local_cid, link->receive_buffer, sizeof(link->receive_buffer), L2CAP_LE_AUTOMATIC_CREDITS);
+        break;
+    }
+
+    case L2CAP_EVENT_CBM_CHANNEL_OPENED:
+        local_cid = l2cap_event_cbm_channel_opened_get_local_cid(packet);
+        link = find_link(local_cid);
+        if (link == NULL)
+        {
+            break;
+        }
+        if (l2cap_event_cbm_channel_opened_get_status(packet) != ERROR_CODE_SUCCESS)
+        {
+            LOG_WARN(LOG_TAG_BLE, "[BULK] 0x%04x channel not opened: 0x%02x\n", link->con_handle, l2cap_event_cbm_channel_opened_get_status(packet));
+            link->open = false;
+            break;
+        }
+        link->remote_mtu = l2cap_event_cbm_channel_opened_get_remote_mtu(packet);
+        LOG_INFO(LOG_TAG_BLE, "[BULK] 0x%04x channel open, cid 0x%04x, remote MTU %u\n", link->con_handle, local_cid, link->remote_mtu);
+        break;
+
+    case L2CAP_EVENT_CHANNEL_CLOSED:
+        link = find_link(l2cap_event_channel_closed_get_local_cid(packet));
+        if (link != NULL)
+        {
+            LOG_INFO(LOG_TAG_BLE, "[BULK] 0x%04x channel closed%s\n", link->con_handle, link->transfer.active ? " during a transfer" : "");
+            link->open = false;
+        }
+        break;
+
+    case L2CAP_EVENT_CAN_SEND_NOW:
+        link = find_link(l2cap_event_can_send_now_get_local_cid(packet));
+        if (link != NULL)
+        {
+            send_next_frame(link);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+void bulk_channel_init(void)
+{
+    uint8_t status = l2cap_cbm_register_service(&bulk_packet_handler, BULK_CHANNEL_PSM, LEVEL_0);
+    if (status != ERROR_CODE_SUCCESS)
+    {
+        LOG_ERROR(LOG_TAG_BLE, "[BULK] ERROR: L2CAP service 0x%04x not registered (0x%02x)\n", BULK_CHANNEL_PSM, status);
+    }
+}
+
+void bulk_channel_set_log_owner(uint16_t con_handle)
+{
+    log_owner = con_handle;
+}
+
+bool bulk_channel_reading_logs(uint16_t con_handle)
+{
+    for (int i = 0; i < MAX_NR_HCI_CONNECTIONS; i++)
+    {
+        if (links[i].open && links[i].con_handle != con_handle &&
+            links[i].transfer.active && links[i].transfer.type == BULK_TYPE_LOGS)
+        {
+            return true;
+        }
+    }
+    return false;
+}
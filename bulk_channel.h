@@ -0,0 +1,40 @@
+/**
+ * Bulk transfer over an LE credit-based L2CAP channel
+ *
+ * The phone opens a channel on BULK_CHANNEL_PSM (one per connection) and
+ * writes requests; the framing and the sources are in bulk_proto.h. Frames of
+ * up to BULK_CHANNEL_SDU_SIZE bytes go out whenever L2CAP can take one, split
+ * into link packets by BTstack, so a transfer is paced by the link and the
+ * phone's credits instead of one GATT round trip per MTU.
+ *
+ * Each finished transfer is logged with its throughput; compare it with the
+ * "[PERF] ble logs" line for the logs characteristic (GATT reads and
+ * notifications).
+ */
+
+#ifndef BULK_CHANNEL_H
+#define BULK_CHANNEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Fixed dynamic LE PSM (0x0080-0x00FF), known to the app
+#define BULK_CHANNEL_PSM 0x0081
+
+// Largest frame sent (one SDU), capped by the phone's MTU
+#ifndef BULK_CHANNEL_SDU_SIZE
+#define BULK_CHANNEL_SDU_SIZE 1024
+#endif
+
+// Register the L2CAP service. Call after l2cap_init()
+void bulk_channel_init(void);
+
+// The log has one read position, shared with the GATT log stream. Tell the
+// channel which connection streams it (0xFFFF: none): logs requests from
+// other connections are refused meanwhile
+void bulk_channel_set_log_owner(uint16_t con_handle);
+
+// Whether a logs transfer is running for a connection other than con_handle
+bool bulk_channel_reading_logs(uint16_t con_handle);
+
+#endif // BULK_CHANNEL_H
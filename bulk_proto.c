@@ -0,0 +1,102 @@
+/**
+ * Bulk transfer protocol implementation
+ */
+
+#include "bulk_proto.h"
+
+static void put_u16(uint8_t *p, uint16_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void put_header(uint8_t *frame, uint8_t type, uint8_t status, uint32_t cursor, uint16_t length)
+{
+    frame[0] = type;
+    frame[1] = status;
+    put_u32(&frame[2], cursor);
+    put_u16(&frame[6], length);
+}
+
+bool bulk_parse_request(const uint8_t *data, size_t len, bulk_request_t *req)
+{
+    if (len != BULK_REQUEST_SIZE)
+    {
+        return false;
+    }
+    req->type = data[0];
+    req->cursor = get_u32(&data[1]);
+    req->length = get_u32(&data[5]);
+    return true;
+}
+
+size_t bulk_write_request(const bulk_request_t *req, uint8_t *out)
+{
+    out[0] = req->type;
+    put_u32(&out[1], req->cursor);
+    put_u32(&out[5], req->length);
+    return BULK_REQUEST_SIZE;
+}
+
+void bulk_transfer_start(bulk_transfer_t *t, const bulk_request_t *req)
+{
+    t->active = true;
+    t->type = req->type;
+    t->cursor = req->cursor;
+    t->remaining = req->length;
+    t->frames = 0;
+    t->bytes = 0;
+}
+
+size_t bulk_transfer_next(bulk_transfer_t *t, bulk_read_fn read, void *context, uint8_t *frame, size_t frame_size)
+{
+    if (!t->active || frame_size <= BULK_FRAME_HEADER_SIZE)
+    {
+        return 0;
+    }
+
+    size_t room = frame_size - BULK_FRAME_HEADER_SIZE;
+    if (room > 0xFFFF)
+    {
+        room = 0xFFFF;
+    }
+    if (room > t->remaining)
+    {
+        room = t->remaining;
+    }
+
+    uint32_t start = t->cursor;
+    size_t len = (room > 0) ? read(context, &start, &frame[BULK_FRAME_HEADER_SIZE], room) : 0;
+    t->cursor = start + (uint32_t)len;
+    t->remaining -= (uint32_t)len;
+    t->frames++;
+    t->bytes += (uint32_t)len;
+
+    // A short read means the source ran out; a full one may have more
+    bool end = len < room || t->remaining == 0;
+    if (end)
+    {
+        t->active = false;
+    }
+    put_header(frame, t->type, end ? BULK_STATUS_END : BULK_STATUS_MORE, start, (uint16_t)len);
+    return BULK_FRAME_HEADER_SIZE + len;
+}
+
+size_t bulk_error_frame(const bulk_request_t *req, uint8_t *frame)
+{
+    put_header(frame, req->type, BULK_STATUS_ERROR, req->cursor, 0);
+    return BULK_FRAME_HEADER_SIZE;
+}
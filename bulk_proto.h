@@ -0,0 +1,88 @@
+/**
+ * Bulk transfer protocol (L2CAP channel, see bulk_channel.h)
+ *
+ * GATT reads move at most one MTU per round trip. For bulk data the phone
+ * opens an LE credit-based L2CAP channel and writes a request; the device
+ * answers with frames of up to one SDU each, sent as fast as the link and the
+ * phone's credits allow. All values little-endian:
+ *
+ * - Request: [type u8][cursor u32][length u32]
+ *   cursor: source position to start at; length: most bytes wanted
+ *   (BULK_LENGTH_ALL: everything there is)
+ * - Frame:   [type u8][status u8][cursor u32][length u16][payload]
+ *   cursor is the source position of the first payload byte, so a gap shows
+ *   (log data dropped before it could be sent). The last frame of a response
+ *   has BULK_STATUS_END; its cursor + length is where a later request resumes.
+ *   A request that can't be served gets one BULK_STATUS_ERROR frame.
+ *
+ * Sources (positions are byte offsets):
+ * - BULK_TYPE_LOGS: the log, cursor as for the logs characteristic
+ *   (log_stream.h); reading consumes, as the characteristic does
+ * - BULK_TYPE_SESSIONS: the unreported session_record_t list
+ * - BULK_TYPE_DIAG: one diag_snapshot_t
+ *
+ * Nothing here touches BTstack, so the framing runs in the host tests.
+ */
+
+#ifndef BULK_PROTO_H
+#define BULK_PROTO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define BULK_REQUEST_SIZE 9
+#define BULK_FRAME_HEADER_SIZE 8
+
+#define BULK_LENGTH_ALL 0xFFFFFFFFu
+
+// Request and frame types: only append
+#define BULK_TYPE_LOGS 1
+#define BULK_TYPE_SESSIONS 2
+#define BULK_TYPE_DIAG 3
+
+#define BULK_STATUS_MORE 0
+#define BULK_STATUS_END 1
+#define BULK_STATUS_ERROR 2
+
+typedef struct
+{
+    uint8_t type;
+    uint32_t cursor;
+    uint32_t length;
+} bulk_request_t;
+
+// Copy up to max_len bytes of a source, starting at *cursor, into dest.
+// May move *cursor forward if the data there is gone (logs).
+// Returns the bytes copied; fewer than max_len means the source has no more.
+typedef size_t (*bulk_read_fn)(void *context, uint32_t *cursor, uint8_t *dest, size_t max_len);
+
+// One response in progress
+typedef struct
+{
+    bool active;
+    uint8_t type;
+    uint32_t cursor;       // Next source position to send
+    uint32_t remaining;    // Bytes still wanted
+    uint32_t frames;       // Sent for this request
+    uint32_t bytes;        // Payload sent for this request
+} bulk_transfer_t;
+
+// Parse a request SDU; false if it is not one
+bool bulk_parse_request(const uint8_t *data, size_t len, bulk_request_t *req);
+
+// Write a request (the client side, used by the tests and the benchmark)
+size_t bulk_write_request(const bulk_request_t *req, uint8_t *out);
+
+void bulk_transfer_start(bulk_transfer_t *t, const bulk_request_t *req);
+
+// Build the next frame of the response (up to frame_size bytes, header
+// included) into `frame`. The frame with BULK_STATUS_END ends the transfer.
+// Returns the frame length, 0 if no transfer is active or frame_size has no
+// room for payload.
+size_t bulk_transfer_next(bulk_transfer_t *t, bulk_read_fn read, void *context, uint8_t *frame, size_t frame_size);
+
+// The one frame answering a request that can't be served
+size_t bulk_error_frame(const bulk_request_t *req, uint8_t *frame);
+
+#endif // BULK_PROTO_H
@@ -0,0 +1,86 @@
+/**
+ * Drift-disciplined wall clock implementation
+ */
+
+#include "clock_sync.h"
+#include <string.h>
+
+void clock_sync_init(clock_sync_t *c)
+{
+    memset(c, 0, sizeof(*c));
+}
+
+static void restart_baseline(clock_sync_t *c, uint64_t local_us, uint64_t unix_us)
+{
+    c->anchor_local_us = local_us;
+    c->anchor_unix_us = unix_us;
+}
+
+uint64_t clock_sync_unix_us(const clock_sync_t *c, uint64_t local_us)
+{
+    if (!c->synced)
+    {
+        return 0;
+    }
+
+    uint64_t elapsed = (local_us > c->ref_local_us) ? local_us - c->ref_local_us : 0;
+    int64_t corrected = (int64_t)elapsed + (int64_t)elapsed * c->drift_ppb / 1000000000;
+
+    // Slew a clock that was ahead back at no more than CLOCK_SYNC_SLEW_PPM
+    int64_t slew_max = (int64_t)(elapsed * CLOCK_SYNC_SLEW_PPM / 1000000);
+    int64_t slew = (c->slew_us < -slew_max) ? -slew_max : c->slew_us;
+
+    return c->ref_unix_us + (uint64_t)(corrected + slew);
+}
+
+void clock_sync_update(clock_sync_t *c, uint64_t local_us, uint64_t unix_us)
+{
+    c->syncs++;
+    if (!c->synced)
+    {
+        c->synced = true;
+        c->ref_local_us = local_us;
+        c->ref_unix_us = unix_us;
+        c->slew_us = 0;
+        c->last_error_us = 0;
+        restart_baseline(c, local_us, unix_us);
+        return;
+    }
+
+    uint64_t shown = clock_sync_unix_us(c, local_us);
+    int64_t error = (int64_t)(unix_us - shown);
+    c->last_error_us = error;
+
+    // Rate error over the baseline; too large a difference is a time change
+    uint64_t base_local = local_us - c->anchor_local_us;
+    int64_t base_diff = (int64_t)(unix_us - c->anchor_unix_us) - (int64_t)base_local;
+    int64_t base_limit = (int64_t)(base_local / (1000000000 / CLOCK_SYNC_MAX_DRIFT_PPB)) + CLOCK_SYNC_TIME_CHANGE_US;
+    if (base_diff > base_limit || base_diff < -base_limit)
+    {
+        restart_baseline(c, local_us, unix_us);
+    }
+    else if (base_local >= CLOCK_SYNC_MIN_BASELINE_US)
+    {
+        int64_t ppb = base_diff * 1000000000 / (int64_t)base_local;
+        if (ppb > CLOCK_SYNC_MAX_DRIFT_PPB || ppb < -CLOCK_SYNC_MAX_DRIFT_PPB)
+        {
+            restart_baseline(c, local_us, unix_us); // A smaller time change: keep the last estimate
+        }
+        else
+        {
+            c->drift_ppb = (int32_t)ppb;
+        }
+    }
+
+    c->ref_local_us = local_us;
+    if (error >= 0 || error < -(int64_t)CLOCK_SYNC_TIME_CHANGE_US)
+    {
+        c->ref_unix_us = unix_us; // Behind: step forward. Far ahead: set back
+        c->slew_us = 0;
+    }
+    else
+    {
+        c->ref_unix_us = shown;   // Ahead: carry on from the time shown, slewing back
+        c->slew_us = error;
+    }
+}
@@ -0,0 +1,65 @@
+/**
+ * Drift-disciplined wall clock
+ *
+ * The phone's time sync (characteristic ...DEF4) gives Unix time in
+ * milliseconds at each connection. Between syncs the device extrapolates
+ * with its crystal, which is off by some tens of ppm: up to a few hundred
+ * milliseconds over a long session. This module:
+ * - estimates the local clock's rate error from the first sync to the
+ *   latest, once they are CLOCK_SYNC_MIN_BASELINE_US apart, and applies it
+ *   between syncs
+ * - moves forward at once when a sync finds the clock behind, and slews at
+ *   CLOCK_SYNC_SLEW_PPM when it is ahead, so wall time never goes backwards.
+ *   Only a clock more than CLOCK_SYNC_TIME_CHANGE_US ahead is set back at once
+ *
+ * A sync off the baseline by more than CLOCK_SYNC_MAX_DRIFT_PPB allows, plus
+ * CLOCK_SYNC_TIME_CHANGE_US for the delay jitter of the writes, means the
+ * phone's time was changed: the baseline starts again from it. Times are
+ * 64-bit microseconds: local_us is the monotonic uptime, so nothing wraps.
+ * No hardware access, so it runs in the host tests.
+ */
+
+#ifndef CLOCK_SYNC_H
+#define CLOCK_SYNC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef CLOCK_SYNC_MIN_BASELINE_US
+#define CLOCK_SYNC_MIN_BASELINE_US (60ull * 60 * 1000000) // An hour of syncs before estimating drift
+#endif
+
+#ifndef CLOCK_SYNC_MAX_DRIFT_PPB
+#define CLOCK_SYNC_MAX_DRIFT_PPB 200000                   // 200 ppm, well beyond a crystal's error
+#endif
+
+#ifndef CLOCK_SYNC_SLEW_PPM
+#define CLOCK_SYNC_SLEW_PPM 1000                          // Slew back 1 ms per second
+#endif
+
+#ifndef CLOCK_SYNC_TIME_CHANGE_US
+#define CLOCK_SYNC_TIME_CHANGE_US 2000000                 // More than drift and delay jitter explain
+#endif
+
+typedef struct
+{
+    bool synced;
+    uint64_t ref_local_us;      // Local time of the last sync
+    uint64_t ref_unix_us;       // Wall time at ref_local_us, before slewing
+    int64_t slew_us;            // Correction still to slew in (<= 0: clock ahead)
+    uint64_t anchor_local_us;   // Start of the drift baseline
+    uint64_t anchor_unix_us;
+    int32_t drift_ppb;          // Local clock rate error, positive when it runs slow
+    int64_t last_error_us;      // Phone minus device at the last sync
+    uint32_t syncs;
+} clock_sync_t;
+
+void clock_sync_init(clock_sync_t *c);
+
+// The phone says it is unix_us at local time local_us
+void clock_sync_update(clock_sync_t *c, uint64_t local_us, uint64_t unix_us);
+
+// Wall time at local_us (not before the last sync), 0 before the first sync
+uint64_t clock_sync_unix_us(const clock_sync_t *c, uint64_t local_us);
+
+#endif // CLOCK_SYNC_H
@@ -0,0 +1,179 @@
+/**
+ * Always-on diagnostics counters implementation
+ */
+
+#include "diag.h"
+#include <string.h>
+
+typedef struct
+{
+    uint32_t count;
+    uint64_t sum;
+    uint32_t min;
+    uint32_t max;
+} diag_stat_t;
+
+// Module state
+static uint32_t start_ms = 0;
+static diag_stat_t loop_us;
+static diag_stat_t render_us;
+static diag_stat_t transfer_us;
+static diag_stat_t flash_write_us;
+static diag_stat_t irq_latency_us;
+static uint32_t rotations = 0;
+static uint32_t max_batch = 0;
+static uint32_t att_reads[DIAG_ATT_COUNT];
+static uint32_t att_writes[DIAG_ATT_COUNT];
+static uint32_t notify_ok = 0;
+static uint32_t notify_failed = 0;
+static uint32_t i2c_errors = 0;
+static uint32_t i2c_recoveries = 0;
+static diag_stat_t reconnect_us;
+static diag_stat_t connect_us;
+static uint32_t pairings = 0;
+
+static void stat_add(diag_stat_t *stat, uint32_t value)
+{
+    if (stat->count == 0 || value < stat->min)
+    {
+        stat->min = value;
+    }
+    if (value > stat->max)
+    {
+        stat->max = value;
+    }
+    stat->sum += value;
+    stat->count++;
+}
+
+static void stat_copy(diag_timing_t *out, const diag_stat_t *stat)
+{
+    out->count = stat->count;
+    out->min_us = stat->min;
+    out->avg_us = stat->count ? (uint32_t)(stat->sum / stat->count) : 0;
+    out->max_us = stat->max;
+}
+
+void diag_reset(uint32_t now_ms)
+{
+    diag_stat_t empty = {0};
+
+    start_ms = now_ms;
+    loop_us = empty;
+    render_us = empty;
+    transfer_us = empty;
+    flash_write_us = empty;
+    irq_latency_us = empty;
+    rotations = 0;
+    max_batch = 0;
+    memset(att_reads, 0, sizeof(att_reads));
+    memset(att_writes, 0, sizeof(att_writes));
+    notify_ok = 0;
+    notify_failed = 0;
+    i2c_errors = 0;
+    i2c_recoveries = 0;
+    reconnect_us = empty;
+    connect_us = empty;
+    pairings = 0;
+}
+
+void diag_record_loop(uint32_t us)
+{
+    stat_add(&loop_us, us);
+}
+
+void diag_record_frame(uint32_t render, uint32_t transfer)
+{
+    stat_add(&render_us, render);
+    if (transfer > 0)
+    {
+        stat_add(&transfer_us, transfer);
+    }
+}
+
+void diag_record_flash_write(uint32_t us)
+{
+    stat_add(&flash_write_us, us);
+}
+
+void diag_record_rotations(uint32_t count, uint32_t latency_us)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    rotations += count;
+    if (count > max_batch)
+    {
+        max_batch = count;
+    }
+    stat_add(&irq_latency_us, latency_us);
+}
+
+void diag_count_att(diag_att_t att, bool write)
+{
+    if ((unsigned)att >= DIAG_ATT_COUNT)
+    {
+        return;
+    }
+    if (write)
+    {
+        att_writes[att]++;
+    }
+    else
+    {
+        att_reads[att]++;
+    }
+}
+
+void diag_count_notify(bool ok)
+{
+    if (ok)
+    {
+        notify_ok++;
+    }
+    else
+    {
+        notify_failed++;
+    }
+}
+
+void diag_count_i2c(uint32_t errors, uint32_t recoveries)
+{
+    i2c_errors += errors;
+    i2c_recoveries += recoveries;
+}
+
+void diag_record_first_notification(bool bonded, uint32_t us)
+{
+    stat_add(bonded ? &reconnect_us : &connect_us, us);
+}
+
+void diag_count_pairing(void)
+{
+    pairings++;
+}
+
+void diag_snapshot(diag_snapshot_t *out, uint32_t now_ms)
+{
+    memset(out, 0, sizeof(*out));
+    out->version = DIAG_VERSION;
+    out->att_count = DIAG_ATT_COUNT;
+    out->seconds = (now_ms - start_ms) / 1000;
+    stat_copy(&out->loop, &loop_us);
+    stat_copy(&out->render, &render_us);
+    stat_copy(&out->transfer, &transfer_us);
+    stat_copy(&out->flash_write, &flash_write_us);
+    stat_copy(&out->irq_latency, &irq_latency_us);
+    out->rotations = rotations;
+    out->max_batch = max_batch;
+    memcpy(out->att_reads, att_reads, sizeof(att_reads));
+    memcpy(out->att_writes, att_writes, sizeof(att_writes));
+    out->notify_ok = notify_ok;
+    out->notify_failed = notify_failed;
+    out->i2c_errors = i2c_errors;
+    out->i2c_recoveries = i2c_recoveries;
+    stat_copy(&out->reconnect, &reconnect_us);
+    stat_copy(&out->connect, &connect_us);
+    out->pairings = pairings;
+}
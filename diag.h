@@ -0,0 +1,104 @@
+/**
+ * Always-on diagnostics counters
+ *
+ * Cheap running counters for profiling units in the field, read over BLE
+ * (diagnostics characteristic ...DEFB) as one diag_snapshot_t:
+ * - Main loop pass time, frame render and transfer time (min/avg/max)
+ * - Flash writes and their worst latency
+ * - Rotations per IRQ batch and IRQ-to-processing latency
+ * - ATT reads and writes per characteristic, notification results
+ * - I2C errors and bus recoveries
+ * - Connection to first notification, bonded clients and others; pairings
+ *
+ * Unlike the perf.h stats, which restart with every [PERF] report, these run
+ * from boot until a client resets them. Each record call is a few adds and
+ * compares; nothing here touches hardware, so callers pass the measurements.
+ * All calls come from core 0: BTstack callbacks, and the main loop only while
+ * it holds ble_lock(). With BLE_BACKGROUND the callbacks run from an IRQ and
+ * take snapshots or reset the counters, so a main loop update outside the
+ * lock could be torn; the display's numbers are passed on under the lock.
+ */
+
+#ifndef DIAG_H
+#define DIAG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Layout version of diag_snapshot_t, bumped when fields change
+#define DIAG_VERSION 2
+
+// Characteristics with ATT counters. Values index the snapshot arrays: only append
+typedef enum
+{
+    DIAG_ATT_ODOMETER = 0,      // ...DEF1
+    DIAG_ATT_SESSIONS = 1,      // ...DEF2
+    DIAG_ATT_MARK_REPORTED = 2, // ...DEF3
+    DIAG_ATT_TIME_SYNC = 3,     // ...DEF4
+    DIAG_ATT_SETTINGS = 4,      // ...DEF5
+    DIAG_ATT_LIFETIME = 5,      // ...DEF7
+    DIAG_ATT_LOGS = 6,          // ...DEF8
+    DIAG_ATT_LOG_LEVELS = 7,    // ...DEF9
+    DIAG_ATT_TRACE = 8,         // ...DEFA
+    DIAG_ATT_DIAGNOSTICS = 9,   // ...DEFB
+    DIAG_ATT_COUNT
+} diag_att_t;
+
+// One timing statistic; all zero until there is a sample
+typedef struct __attribute__((packed))
+{
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t avg_us;
+    uint32_t max_us;
+} diag_timing_t;
+
+// Characteristic value, little-endian
+typedef struct __attribute__((packed))
+{
+    uint8_t version;                    // DIAG_VERSION
+    uint8_t att_count;                  // Entries in att_reads / att_writes
+    uint16_t reserved;
+    uint32_t seconds;                   // Since boot or the last reset
+    diag_timing_t loop;                 // Main loop pass, sleep excluded
+    diag_timing_t render;               // Frame render into the buffer
+    diag_timing_t transfer;             // Frame transfer (only frames with changes)
+    diag_timing_t flash_write;          // Erase + program + verify, retries included
+    diag_timing_t irq_latency;          // First edge of a batch until it is processed
+    uint32_t rotations;                 // Over irq_latency.count batches
+    uint32_t max_batch;                 // Most rotations in one batch
+    uint32_t att_reads[DIAG_ATT_COUNT];
+    uint32_t att_writes[DIAG_ATT_COUNT];
+    uint32_t notify_ok;                 // att_server_notify accepted
+    uint32_t notify_failed;             // att_server_notify refused
+    uint32_t i2c_errors;
+    uint32_t i2c_recoveries;
+    diag_timing_t reconnect;            // Connection to first odometer notification, bonded client back
+    diag_timing_t connect;              // The same for a new or unbonded client
+    uint32_t pairings;                  // Pairings completed (new bonds)
+} diag_snapshot_t;
+
+// Clear every counter; now_ms starts the seconds field
+void diag_reset(uint32_t now_ms);
+
+void diag_record_loop(uint32_t us);
+void diag_record_frame(uint32_t render_us, uint32_t transfer_us); // transfer_us 0: nothing sent
+void diag_record_flash_write(uint32_t us);
+
+// One odometer_process batch of `rotations`, latency_us after the first edge
+void diag_record_rotations(uint32_t rotations, uint32_t latency_us);
+
+// Out-of-range characteristics are ignored
+void diag_count_att(diag_att_t att, bool write);
+void diag_count_notify(bool ok);
+void diag_count_i2c(uint32_t errors, uint32_t recoveries); // Since the last call (oled.h)
+
+// Time from a connection to its first odometer notification; bonded: the
+// client reconnected with a stored bond (bonding.h)
+void diag_record_first_notification(bool bonded, uint32_t us);
+void diag_count_pairing(void);
+
+// Fill in the characteristic value
+void diag_snapshot(diag_snapshot_t *out, uint32_t now_ms);
+
+#endif // DIAG_H
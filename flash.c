@@ -4,6 +4,9 @@
 
 #include "flash.h"
 #include "logging.h"
+#include "trace.h"
+#include "diag.h"
+#include "pico/time.h"
 #include "hardware/flash.h"
 #include "hardware/sync.h"
 #include <string.h>
@@ -42,6 +45,16 @@ typedef struct
     uint32_t checksum;                    // XOR checksum of all fields above
 } flash_data_t;
 
+// Reported batch record (FLASH_REPORTED_MAGIC), one per sector like flash_data_t
+typedef struct
+{
+    uint32_t magic;                          // 0x4F44524D ("ODRM")
+    uint32_t write_index;                    // Globally incrementing write counter (determines sector)
+    uint32_t count;                          // Session IDs in use
+    uint32_t session_ids[FLASH_REPORTED_MAX];
+    uint32_t checksum;                       // XOR checksum of all fields above
+} flash_reported_t;
+
 // Calculate XOR checksum for flash data (internal function)
 static uint32_t flash_calculate_checksum(const flash_data_t *data)
 {
@@ -59,6 +72,31 @@ static uint32_t flash_calculate_checksum(const flash_data_t *data)
            data->reported;
 }
 
+static uint32_t flash_reported_checksum(const flash_reported_t *record)
+{
+    uint32_t checksum = record->magic ^ record->write_index ^ record->count;
+    for (uint32_t i = 0; i < FLASH_REPORTED_MAX; i++)
+    {
+        checksum ^= record->session_ids[i];
+    }
+    return checksum;
+}
+
+// Erase a sector and program its first page
+static void flash_program_sector(uint32_t sector, const uint8_t *page)
+{
+    uint32_t sector_offset = FLASH_START_OFFSET + (sector * FLASH_SECTOR_SIZE);
+
+    uint32_t ints = save_and_disable_interrupts();
+    TRACE_BEGIN(TRACE_FLASH_ERASE, sector);
+    flash_range_erase(sector_offset, FLASH_SECTOR_SIZE);
+    TRACE_END(TRACE_FLASH_ERASE, sector);
+    TRACE_BEGIN(TRACE_FLASH_PROGRAM, sector);
+    flash_range_program(sector_offset, page, FLASH_PAGE_SIZE);
+    TRACE_END(TRACE_FLASH_PROGRAM, sector);
+    restore_interrupts(ints);
+}
+
 bool flash_write(const session_data_t *data, const char *operation_title)
 {
     const flash_data_t *flash_data;
@@ -67,7 +105,7 @@ bool flash_write(const session_data_t *data, const char *operation_title)
     // Never write sessions with zero rotations - they're meaningless
     if (data->session_rotation_count == 0)
     {
-        log_printf("[FLASH WRITE] Skipping write: session has zero rotations\n");
+        LOG_INFO(LOG_TAG_FLASH, "[FLASH WRITE] Skipping write: session has zero rotations\n");
         return true; // Return success to avoid error handling in callers
     }
 
@@ -99,49 +137,48 @@ bool flash_write(const session_data_t *data, const char *operation_title)
     const flash_data_t *expected = (const flash_data_t *)write_buffer;
 
     // Log all data being written to flash BEFORE writing
-    log_printf("========================================\n");
-    log_printf("[FLASH WRITE] %s:\n", operation_title);
-    log_printf("  Sector: %lu (write_index %lu, offset 0x%08lX)\n", sector, data->write_index, sector_offset);
-    log_printf("  Magic: 0x%08lX\n", expected->magic);
-    log_printf("  Struct Version: %lu\n", expected->struct_version);
-    log_printf("  Session ID: %lu\n", expected->session_id);
-    log_printf("  Session Rotations: %lu\n", expected->session_rotation_count);
-    log_printf("  Session Active Time: %lu seconds\n", expected->session_active_time_seconds);
-    log_printf("  Session Start Time: %lu\n", expected->session_start_time_unix);
-    log_printf("  Session End Time: %lu\n", expected->session_end_time_unix);
-    log_printf("  Lifetime Rotations: %lu\n", expected->lifetime_rotation_count);
-    log_printf("  Lifetime Time: %lu seconds\n", expected->lifetime_time_seconds);
-    log_printf("  Reported: %u%s\n", expected->reported, expected->reported ? " (CHANGED TO 1)" : "");
-    log_printf("  Checksum: 0x%08lX\n", expected->checksum);
-    log_printf("========================================\n");
+    LOG_DEBUG(LOG_TAG_FLASH, "========================================\n");
+    LOG_DEBUG(LOG_TAG_FLASH, "[FLASH WRITE] %s:\n", operation_title);
+    LOG_DEBUG(LOG_TAG_FLASH, "  Sector: %lu (write_index %lu, offset 0x%08lX)\n", sector, data->write_index, sector_offset);
+    LOG_DEBUG(LOG_TAG_FLASH, "  Magic: 0x%08lX\n", expected->magic);
+    LOG_DEBUG(LOG_TAG_FLASH, "  Struct Version: %lu\n", expected->struct_version);
+    LOG_DEBUG(LOG_TAG_FLASH, "  Session ID: %lu\n", expected->session_id);
+    LOG_DEBUG(LOG_TAG_FLASH, "  Session Rotations: %lu\n", expected->session_rotation_count);
+    LOG_DEBUG(LOG_TAG_FLASH, "  Session Active Time: %lu seconds\n", expected->session_active_time_seconds);
+    LOG_DEBUG(LOG_TAG_FLASH, "  Session Start Time: %lu\n", expected->session_start_time_unix);
+    LOG_DEBUG(LOG_TAG_FLASH, "  Session End Time: %lu\n", expected->session_end_time_unix);
+    LOG_DEBUG(LOG_TAG_FLASH, "  Lifetime Rotations: %lu\n", expected->lifetime_rotation_count);
+    LOG_DEBUG(LOG_TAG_FLASH, "  Lifetime Time: %lu seconds\n", expected->lifetime_time_seconds);
+    LOG_DEBUG(LOG_TAG_FLASH, "  Reported: %u%s\n", expected->reported, expected->reported ? " (CHANGED TO 1)" : "");
+    LOG_DEBUG(LOG_TAG_FLASH, "  Checksum: 0x%08lX\n", expected->checksum);
+    LOG_DEBUG(LOG_TAG_FLASH, "========================================\n");
 
     // Try write + verify up to 2 times (initial + 1 retry)
+    uint32_t start_us = time_us_32();
     for (int attempt = 0; attempt < 2; attempt++) {
         if (attempt > 0) {
-            log_printf("[FLASH VERIFY] Retrying flash write (attempt %d/2)...\n", attempt + 1);
+            LOG_WARN(LOG_TAG_FLASH, "[FLASH VERIFY] Retrying flash write (attempt %d/2)...\n", attempt + 1);
         }
 
         // Erase and program the flash sector
-        uint32_t ints = save_and_disable_interrupts();
-        flash_range_erase(sector_offset, FLASH_SECTOR_SIZE);
-        flash_range_program(sector_offset, write_buffer, FLASH_PAGE_SIZE);
-        restore_interrupts(ints);
+        flash_program_sector(sector, write_buffer);
 
         // Now verify what we just wrote
+        TRACE_BEGIN(TRACE_FLASH_VERIFY, sector);
         flash_data = (const flash_data_t *)(XIP_BASE + sector_offset);
         verification_passed = true; // Assume success until we find a problem
 
         // Verify magic number
         if (flash_data->magic != expected->magic) {
-            log_printf("[FLASH VERIFY] ERROR: Magic mismatch! Expected 0x%08lX, got 0x%08lX\n",
-                       expected->magic, flash_data->magic);
+            LOG_ERROR(LOG_TAG_FLASH, "[FLASH VERIFY] ERROR: Magic mismatch! Expected 0x%08lX, got 0x%08lX\n",
+                                     expected->magic, flash_data->magic);
             verification_passed = false;
         }
 
         // Verify checksum
         else if (flash_data->checksum != expected->checksum) {
-            log_printf("[FLASH VERIFY] ERROR: Checksum mismatch! Expected 0x%08lX, got 0x%08lX\n",
-                       expected->checksum, flash_data->checksum);
+            LOG_ERROR(LOG_TAG_FLASH, "[FLASH VERIFY] ERROR: Checksum mismatch! Expected 0x%08lX, got 0x%08lX\n",
+                                     expected->checksum, flash_data->checksum);
             verification_passed = false;
         }
 
@@ -149,8 +186,8 @@ bool flash_write(const session_data_t *data, const char *operation_title)
         else {
             uint32_t calculated_checksum = flash_calculate_checksum(flash_data);
             if (flash_data->checksum != calculated_checksum) {
-                log_printf("[FLASH VERIFY] ERROR: Checksum invalid! Stored 0x%08lX, calculated 0x%08lX\n",
-                           flash_data->checksum, calculated_checksum);
+                LOG_ERROR(LOG_TAG_FLASH, "[FLASH VERIFY] ERROR: Checksum invalid! Stored 0x%08lX, calculated 0x%08lX\n",
+                                         flash_data->checksum, calculated_checksum);
                 verification_passed = false;
             }
         }
@@ -167,48 +204,133 @@ bool flash_write(const session_data_t *data, const char *operation_title)
              flash_data->lifetime_time_seconds != expected->lifetime_time_seconds ||
              flash_data->reported != expected->reported)) {
 
-            log_printf("[FLASH VERIFY] ERROR: Field mismatch detected:\n");
+            LOG_ERROR(LOG_TAG_FLASH, "[FLASH VERIFY] ERROR: Field mismatch detected:\n");
             if (flash_data->struct_version != expected->struct_version)
-                log_printf("  - struct_version: expected %lu, got %lu\n", expected->struct_version, flash_data->struct_version);
+                LOG_ERROR(LOG_TAG_FLASH, "  - struct_version: expected %lu, got %lu\n", expected->struct_version, flash_data->struct_version);
             if (flash_data->session_id != expected->session_id)
-                log_printf("  - session_id: expected %lu, got %lu\n", expected->session_id, flash_data->session_id);
+                LOG_ERROR(LOG_TAG_FLASH, "  - session_id: expected %lu, got %lu\n", expected->session_id, flash_data->session_id);
             if (flash_data->session_rotation_count != expected->session_rotation_count)
-                log_printf("  - session_rotation_count: expected %lu, got %lu\n", expected->session_rotation_count, flash_data->session_rotation_count);
+                LOG_ERROR(LOG_TAG_FLASH, "  - session_rotation_count: expected %lu, got %lu\n", expected->session_rotation_count, flash_data->session_rotation_count);
             if (flash_data->session_active_time_seconds != expected->session_active_time_seconds)
-                log_printf("  - session_active_time_seconds: expected %lu, got %lu\n", expected->session_active_time_seconds, flash_data->session_active_time_seconds);
+                LOG_ERROR(LOG_TAG_FLASH, "  - session_active_time_seconds: expected %lu, got %lu\n", expected->session_active_time_seconds, flash_data->session_active_time_seconds);
             if (flash_data->session_start_time_unix != expected->session_start_time_unix)
-                log_printf("  - session_start_time_unix: expected %lu, got %lu\n", expected->session_start_time_unix, flash_data->session_start_time_unix);
+                LOG_ERROR(LOG_TAG_FLASH, "  - session_start_time_unix: expected %lu, got %lu\n", expected->session_start_time_unix, flash_data->session_start_time_unix);
             if (flash_data->session_end_time_unix != expected->session_end_time_unix)
-                log_printf("  - session_end_time_unix: expected %lu, got %lu\n", expected->session_end_time_unix, flash_data->session_end_time_unix);
+                LOG_ERROR(LOG_TAG_FLASH, "  - session_end_time_unix: expected %lu, got %lu\n", expected->session_end_time_unix, flash_data->session_end_time_unix);
             if (flash_data->lifetime_rotation_count != expected->lifetime_rotation_count)
-                log_printf("  - lifetime_rotation_count: expected %lu, got %lu\n", expected->lifetime_rotation_count, flash_data->lifetime_rotation_count);
+                LOG_ERROR(LOG_TAG_FLASH, "  - lifetime_rotation_count: expected %lu, got %lu\n", expected->lifetime_rotation_count, flash_data->lifetime_rotation_count);
             if (flash_data->lifetime_time_seconds != expected->lifetime_time_seconds)
-                log_printf("  - lifetime_time_seconds: expected %lu, got %lu\n", expected->lifetime_time_seconds, flash_data->lifetime_time_seconds);
+                LOG_ERROR(LOG_TAG_FLASH, "  - lifetime_time_seconds: expected %lu, got %lu\n", expected->lifetime_time_seconds, flash_data->lifetime_time_seconds);
             if (flash_data->reported != expected->reported)
-                log_printf("  - reported: expected %u, got %u\n", expected->reported, flash_data->reported);
+                LOG_ERROR(LOG_TAG_FLASH, "  - reported: expected %u, got %u\n", expected->reported, flash_data->reported);
 
             verification_passed = false;
         }
+        TRACE_END(TRACE_FLASH_VERIFY, verification_passed);
 
         // If verification passed, we're done
         if (verification_passed) {
             if (attempt > 0) {
-                log_printf("[FLASH VERIFY] ✓ Flash write verified successfully after retry\n");
+                LOG_DEBUG(LOG_TAG_FLASH, "[FLASH VERIFY] ✓ Flash write verified successfully after retry\n");
             } else {
-                log_printf("[FLASH VERIFY] ✓ Flash write verified successfully\n");
+                LOG_DEBUG(LOG_TAG_FLASH, "[FLASH VERIFY] ✓ Flash write verified successfully\n");
             }
+            diag_record_flash_write(time_us_32() - start_us);
             return true;
         }
 
         // If this was our last attempt, log final failure
         if (attempt == 1) {
-            log_printf("[FLASH VERIFY] ERROR: Flash write verification failed after retry!\n");
+            LOG_ERROR(LOG_TAG_FLASH, "[FLASH VERIFY] ERROR: Flash write verification failed after retry!\n");
+        }
+    }
+
+    diag_record_flash_write(time_us_32() - start_us);
+    return false;
+}
+
+bool flash_write_reported(const uint32_t *session_ids, uint32_t count, uint32_t write_index, const char *operation_title)
+{
+    if (count == 0 || count > FLASH_REPORTED_MAX)
+    {
+        LOG_ERROR(LOG_TAG_FLASH, "[FLASH WRITE] ERROR: %lu reported sessions in one record (max %u)\n", count, FLASH_REPORTED_MAX);
+        return false;
+    }
+
+    uint32_t sector = write_index % FLASH_SECTOR_COUNT;
+    uint32_t sector_offset = FLASH_START_OFFSET + (sector * FLASH_SECTOR_SIZE);
+
+    static uint8_t __attribute__((aligned(FLASH_PAGE_SIZE))) write_buffer[FLASH_PAGE_SIZE];
+    _Static_assert(sizeof(flash_reported_t) <= FLASH_PAGE_SIZE, "reported record must fit one flash page");
+
+    flash_reported_t record;
+    memset(&record, 0, sizeof(record));
+    record.magic = FLASH_REPORTED_MAGIC;
+    record.write_index = write_index;
+    record.count = count;
+    memcpy(record.session_ids, session_ids, count * sizeof(uint32_t));
+    record.checksum = flash_reported_checksum(&record);
+
+    memset(write_buffer, 0, FLASH_PAGE_SIZE);
+    memcpy(write_buffer, &record, sizeof(record));
+
+    LOG_DEBUG(LOG_TAG_FLASH, "[FLASH WRITE] %s: %lu sessions, sector %lu (write_index %lu)\n", operation_title, count, sector, write_index);
+
+    // Try write + verify up to 2 times (initial + 1 retry), as flash_write
+    uint32_t start_us = time_us_32();
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (attempt > 0) {
+            LOG_WARN(LOG_TAG_FLASH, "[FLASH VERIFY] Retrying reported record write (attempt %d/2)...\n", attempt + 1);
+        }
+
+        flash_program_sector(sector, write_buffer);
+
+        TRACE_BEGIN(TRACE_FLASH_VERIFY, sector);
+        bool verification_passed = memcmp((const void *)(XIP_BASE + sector_offset), &record, sizeof(record)) == 0;
+        TRACE_END(TRACE_FLASH_VERIFY, verification_passed);
+
+        if (verification_passed) {
+            LOG_DEBUG(LOG_TAG_FLASH, "[FLASH VERIFY] ✓ Reported record verified successfully\n");
+            diag_record_flash_write(time_us_32() - start_us);
+            return true;
         }
+        LOG_ERROR(LOG_TAG_FLASH, "[FLASH VERIFY] ERROR: Reported record mismatch in sector %lu\n", sector);
     }
 
+    diag_record_flash_write(time_us_32() - start_us);
     return false;
 }
 
+// Private function - returns the reported batch record in a sector, NULL if there is none
+static const flash_reported_t *flash_read_reported(uint32_t sector)
+{
+    const flash_reported_t *record = (const flash_reported_t *)(XIP_BASE + FLASH_START_OFFSET + (sector * FLASH_SECTOR_SIZE));
+
+    if (record->magic != FLASH_REPORTED_MAGIC || record->count > FLASH_REPORTED_MAX ||
+        record->checksum != flash_reported_checksum(record))
+    {
+        return NULL;
+    }
+    return record;
+}
+
+// Private function - set reported on a session entry if a later reported batch lists it
+static void flash_apply_reported(session_data_t *data, const flash_reported_t *record)
+{
+    if (data->reported || data->write_index >= record->write_index)
+    {
+        return;
+    }
+    for (uint32_t i = 0; i < record->count; i++)
+    {
+        if (record->session_ids[i] == data->session_id)
+        {
+            data->reported = 1;
+            return;
+        }
+    }
+}
+
 // Private function - reads and verifies a single sector
 static bool flash_read(uint32_t sector, session_data_t *data)
 {
@@ -227,15 +349,15 @@ static bool flash_read(uint32_t sector, session_data_t *data)
     // Check if struct version is newer than what we can handle
     if (struct_version > FLASH_STRUCT_VERSION) {
         // Can't validate newer versions - just erase if it looks valid
-        log_printf("[FLASH] WARNING: Sector %lu has newer struct_version %lu (current is %u)\n",
-                   sector, struct_version, FLASH_STRUCT_VERSION);
-        log_printf("[FLASH] Erasing sector to prevent corruption...\n");
+        LOG_WARN(LOG_TAG_FLASH, "[FLASH] WARNING: Sector %lu has newer struct_version %lu (current is %u)\n",
+                                sector, struct_version, FLASH_STRUCT_VERSION);
+        LOG_WARN(LOG_TAG_FLASH, "[FLASH] Erasing sector to prevent corruption...\n");
 
         uint32_t ints = save_and_disable_interrupts();
         flash_range_erase(sector_offset, FLASH_SECTOR_SIZE);
         restore_interrupts(ints);
 
-        log_printf("[FLASH] Sector %lu erased successfully\n", sector);
+        LOG_INFO(LOG_TAG_FLASH, "[FLASH] Sector %lu erased successfully\n", sector);
         return false;
     }
 
@@ -350,6 +472,19 @@ uint32_t flash_scan_all_sessions(session_data_t *sessions, uint32_t max_sessions
         }
     }
 
+    // Second pass: apply reported batch records
+    for (uint32_t sector = 0; sector < FLASH_SECTOR_COUNT; sector++)
+    {
+        const flash_reported_t *record = flash_read_reported(sector);
+        if (record != NULL)
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                flash_apply_reported(&sessions[i], record);
+            }
+        }
+    }
+
     return count;
 }
 
@@ -375,5 +510,36 @@ bool flash_find_session(uint32_t session_id, session_data_t *data)
         }
     }
 
+    for (uint32_t sector = 0; found && sector < FLASH_SECTOR_COUNT; sector++)
+    {
+        const flash_reported_t *record = flash_read_reported(sector);
+        if (record != NULL)
+        {
+            flash_apply_reported(data, record);
+        }
+    }
+
     return found;
 }
+
+uint32_t flash_last_write_index(void)
+{
+    uint32_t last = 0;
+
+    for (uint32_t sector = 0; sector < FLASH_SECTOR_COUNT; sector++)
+    {
+        session_data_t session_data;
+        const flash_reported_t *record = flash_read_reported(sector);
+
+        if (record != NULL && record->write_index > last)
+        {
+            last = record->write_index;
+        }
+        else if (flash_read(sector, &session_data) && session_data.write_index > last)
+        {
+            last = session_data.write_index;
+        }
+    }
+
+    return last;
+}
@@ -10,11 +10,21 @@
 #include <stdbool.h>
 
 // Flash storage configuration - wear leveling with 64 sectors
+// Layout from the end of flash: these 64 sectors, the settings sector
+// (user_settings.c), then two sectors of BTstack key-value store (bonding.h,
+// PICO_FLASH_BANK_STORAGE_OFFSET in CMakeLists.txt)
 #define FLASH_SECTOR_COUNT 64
 #define FLASH_START_OFFSET (PICO_FLASH_SIZE_BYTES - (FLASH_SECTOR_SIZE * FLASH_SECTOR_COUNT))
 #define FLASH_MAGIC_NUMBER 0x4F444F53 // "ODOS" in hex (Odometer Session)
 #define FLASH_STRUCT_VERSION 2         // Current struct version (increment when changing flash_data_t)
 
+// Reported batch record: marks several sessions reported with one sector write.
+// It takes the next write_index slot like a session save and applies to session
+// entries with a lower write_index, which the ring always overwrites before it.
+// A different magic, so firmware without it ignores these sectors.
+#define FLASH_REPORTED_MAGIC 0x4F44524D // "ODRM" in hex (Odometer Reported Marks)
+#define FLASH_REPORTED_MAX 60           // Session IDs per record (fits one flash page)
+
 // Public session data structure - this is what callers work with
 // Internal flash fields (magic, version, checksum) are handled by flash module
 typedef struct
@@ -41,12 +51,31 @@ typedef struct
  */
 bool flash_write(const session_data_t *data, const char *operation_title);
 
+/**
+ * Mark sessions reported with a single erase + program, instead of rewriting each session's sector
+ * Written to the sector for write_index, with verification and retry like flash_write
+ *
+ * @param session_ids Session IDs to mark (at most FLASH_REPORTED_MAX)
+ * @param count Number of session IDs
+ * @param write_index Next write_index (the caller's write counter, as for flash_write)
+ * @param operation_title Human-readable operation description for logging
+ * @return true if write succeeded and verified, false otherwise
+ */
+bool flash_write_reported(const uint32_t *session_ids, uint32_t count, uint32_t write_index, const char *operation_title);
+
+/**
+ * Highest write_index of any valid record (sessions and reported batches)
+ *
+ * @return The write_index to continue from, 0 if flash holds no records
+ */
+uint32_t flash_last_write_index(void);
+
 /**
  * Scan all flash sectors and build a deduplicated list of sessions
  * For each unique session_id, keeps only the entry with highest write_index
  *
  * This function scans all 64 sectors ONCE and deduplicates in a single pass,
- * avoiding repeated sector scans.
+ * avoiding repeated sector scans. Reported batch records are applied to the result.
  *
  * @param sessions Array to fill with deduplicated session data (must hold at least FLASH_SECTOR_COUNT entries)
  * @param max_sessions Maximum size of sessions array (should be FLASH_SECTOR_COUNT)
@@ -56,7 +85,8 @@ uint32_t flash_scan_all_sessions(session_data_t *sessions, uint32_t max_sessions
 
 /**
  * Find a specific session by session_id
- * Returns the entry with the highest write_index for the given session_id
+ * Returns the entry with the highest write_index for the given session_id,
+ * with reported batch records applied
  *
  * @param session_id The session ID to search for
  * @param data Pointer to session_data_t to fill if found
@@ -0,0 +1,211 @@
+/**
+ * Float-free number formatting implementation
+ */
+
+#include "fmt.h"
+
+#define FMT_MAX_PRECISION 6
+
+static const uint32_t powers_of_ten[FMT_MAX_PRECISION + 1] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+
+// Output cursor with snprintf-style truncation
+typedef struct
+{
+    char *buf;
+    size_t size;
+    size_t len;
+} fmt_writer_t;
+
+static void writer_init(fmt_writer_t *w, char *buf, size_t size)
+{
+    w->buf = buf;
+    w->size = size;
+    w->len = 0;
+    if (size > 0)
+    {
+        buf[0] = '\0';
+    }
+}
+
+static void put_char(fmt_writer_t *w, char c)
+{
+    if (w->len + 1 < w->size)
+    {
+        w->buf[w->len++] = c;
+        w->buf[w->len] = '\0';
+    }
+}
+
+static void put_str(fmt_writer_t *w, const char *s)
+{
+    while (*s)
+    {
+        put_char(w, *s++);
+    }
+}
+
+// Decimal digits of value, zero-padded to at least min_digits
+static void put_uint(fmt_writer_t *w, uint64_t value, uint8_t min_digits)
+{
+    char digits[20];
+    int count = 0;
+
+    // 64-bit division is a library call on Cortex-M0+, so only use it while needed
+    while (value > UINT32_MAX)
+    {
+        digits[count++] = (char)('0' + (value % 10));
+        value /= 10;
+    }
+    uint32_t small = (uint32_t)value;
+    do
+    {
+        digits[count++] = (char)('0' + (small % 10));
+        small /= 10;
+    } while (small != 0 || count < min_digits);
+
+    while (count > 0)
+    {
+        put_char(w, digits[--count]);
+    }
+}
+
+// num/den rounded half to even at `precision` decimals
+static void put_ratio(fmt_writer_t *w, uint64_t num, uint64_t den, uint8_t precision)
+{
+    if (precision > FMT_MAX_PRECISION)
+    {
+        precision = FMT_MAX_PRECISION;
+    }
+    if (den == 0)
+    {
+        den = 1;
+    }
+
+    uint32_t scale = powers_of_ten[precision];
+    uint64_t scaled = num * scale;
+    uint64_t quotient = scaled / den;
+    uint64_t remainder = scaled - quotient * den;
+
+    // Round to nearest, ties to even (matches printf on exactly representable halves)
+    if (remainder * 2 > den || (remainder * 2 == den && (quotient & 1)))
+    {
+        quotient++;
+    }
+
+    put_uint(w, quotient / scale, 1);
+    if (precision > 0)
+    {
+        put_char(w, '.');
+        put_uint(w, quotient % scale, precision);
+    }
+}
+
+size_t fmt_uint(char *buf, size_t size, uint32_t value)
+{
+    fmt_writer_t w;
+    writer_init(&w, buf, size);
+    put_uint(&w, value, 1);
+    return w.len;
+}
+
+size_t fmt_ratio(char *buf, size_t size, uint64_t num, uint64_t den, uint8_t precision)
+{
+    fmt_writer_t w;
+    writer_init(&w, buf, size);
+    put_ratio(&w, num, den, precision);
+    return w.len;
+}
+
+size_t fmt_fixed(char *buf, size_t size, uint32_t value, uint8_t scale, uint8_t precision)
+{
+    if (scale > FMT_MAX_PRECISION)
+    {
+        scale = FMT_MAX_PRECISION;
+    }
+    return fmt_ratio(buf, size, value, powers_of_ten[scale], precision);
+}
+
+size_t fmt_voltage(char *buf, size_t size, uint16_t voltage_mv, uint8_t precision)
+{
+    fmt_writer_t w;
+    writer_init(&w, buf, size);
+    put_ratio(&w, voltage_mv, 1000, precision);
+    put_char(&w, 'V');
+    return w.len;
+}
+
+size_t fmt_distance(char *buf, size_t size, uint32_t rotations, bool metric, uint8_t min_precision, const char *label)
+{
+    uint64_t num = (uint64_t)rotations * (metric ? FMT_KM_PER_ROTATION_NUM : FMT_MILES_PER_ROTATION_NUM);
+    uint64_t den = metric ? FMT_KM_PER_ROTATION_DEN : FMT_MILES_PER_ROTATION_DEN;
+
+    // Fewer decimals as the value grows so the string stays about the same width
+    uint8_t precision;
+    if (num < 10 * den)
+    {
+        precision = 2;
+    }
+    else if (num < 100 * den)
+    {
+        precision = 1;
+    }
+    else
+    {
+        precision = 0;
+    }
+    if (precision < min_precision)
+    {
+        precision = min_precision;
+    }
+
+    fmt_writer_t w;
+    writer_init(&w, buf, size);
+    put_ratio(&w, num, den, precision);
+    if (label)
+    {
+        put_str(&w, label);
+    }
+    put_str(&w, metric ? " km" : " mi");
+    return w.len;
+}
+
+size_t fmt_duration(char *buf, size_t size, uint32_t seconds)
+{
+    fmt_writer_t w;
+    writer_init(&w, buf, size);
+
+    if (seconds >= 3600)
+    {
+        put_uint(&w, seconds / 3600, 1);
+        put_char(&w, ':');
+        put_uint(&w, (seconds % 3600) / 60, 2);
+    }
+    else
+    {
+        put_uint(&w, seconds / 60, 1);
+    }
+    put_char(&w, ':');
+    put_uint(&w, seconds % 60, 2);
+    return w.len;
+}
+
+size_t fmt_clock_12h(char *buf, size_t size, uint32_t seconds_since_midnight)
+{
+    uint32_t hours = (seconds_since_midnight / 3600) % 24;
+    uint32_t minutes = (seconds_since_midnight % 3600) / 60;
+
+    // Convert to 12-hour format
+    const char *am_pm = (hours >= 12) ? " PM" : " AM";
+    if (hours == 0)
+        hours = 12;
+    else if (hours > 12)
+        hours -= 12;
+
+    fmt_writer_t w;
+    writer_init(&w, buf, size);
+    put_uint(&w, hours, 1);
+    put_char(&w, ':');
+    put_uint(&w, minutes, 2);
+    put_str(&w, am_pm);
+    return w.len;
+}
@@ -0,0 +1,58 @@
+/**
+ * Float-free number formatting for display and BLE strings
+ *
+ * The RP2040 has no FPU, so snprintf("%.2f") pulls in soft-float printf and
+ * costs thousands of cycles per call. These formatters work on integer
+ * fixed-point values (millivolts, rotations, seconds) and produce the same
+ * text as the printf formats they replace.
+ *
+ * Rounding is done on the exact value, ties to even. That matches printf
+ * except where the old float value was off by its representation error:
+ * decimal half-way values (e.g. 0.015f is stored just below 0.015) and very
+ * large distances, where the float product drifted across a rounding boundary.
+ *
+ * All functions behave like snprintf with truncation: the output is always
+ * NUL-terminated (if size > 0) and the return value is the number of
+ * characters written, excluding the terminator.
+ */
+
+#ifndef FMT_H
+#define FMT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Exact distance per rotation (34.56 cm) as integer ratios
+// miles = rotations * 9 / 41910 (0.3456 m / 1609.344 m), km = rotations * 3456 / 10^7
+#define FMT_MILES_PER_ROTATION_NUM 9u
+#define FMT_MILES_PER_ROTATION_DEN 41910u
+#define FMT_KM_PER_ROTATION_NUM 3456u
+#define FMT_KM_PER_ROTATION_DEN 10000000u
+
+// Unsigned integer, like "%lu"
+size_t fmt_uint(char *buf, size_t size, uint32_t value);
+
+// Exact ratio num/den rounded to `precision` decimals (0-6), like "%.*f"
+size_t fmt_ratio(char *buf, size_t size, uint64_t num, uint64_t den, uint8_t precision);
+
+// Fixed-point value / 10^scale rounded to `precision` decimals
+// e.g. fmt_fixed(buf, size, 4125, 3, 2) -> "4.12" (millivolts to volts)
+size_t fmt_fixed(char *buf, size_t size, uint32_t value, uint8_t scale, uint8_t precision);
+
+// Voltage in volts with a "V" suffix, e.g. fmt_voltage(buf, size, 4950, 1) -> "5.0V" ("%.1fV")
+size_t fmt_voltage(char *buf, size_t size, uint16_t voltage_mv, uint8_t precision);
+
+// Distance for a rotation count with unit suffix: "<distance><label> mi" or "... km"
+// Precision is chosen by magnitude: 2 decimals below 10, 1 below 100, 0 from 100,
+// but never fewer than min_precision decimals
+// e.g. fmt_distance(buf, size, 50000, false, 0, " total") -> "10.7 total mi"
+size_t fmt_distance(char *buf, size_t size, uint32_t rotations, bool metric, uint8_t min_precision, const char *label);
+
+// Elapsed time as H:MM:SS, or M:SS under an hour ("%lu:%02lu:%02lu" / "%lu:%02lu")
+size_t fmt_duration(char *buf, size_t size, uint32_t seconds);
+
+// Time of day (seconds since midnight) in 12-hour format, e.g. "9:05 PM" ("%lu:%02lu %s")
+size_t fmt_clock_12h(char *buf, size_t size, uint32_t seconds_since_midnight);
+
+#endif // FMT_H
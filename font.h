@@ -3,9 +3,13 @@
 
 #include <stdint.h>
 
-// Adafruit GFX font format - variable-width, professional quality fonts
+// Adafruit GFX font metrics - variable-width, professional quality fonts
+// Fonts are generated at build time by tools/font_subset.py from adafruit_fonts.c.
+// Only the glyphs the UI draws are kept, and bitmaps are pre-rasterized in the
+// SH1106 page-major layout: byte[band * width + column], bit n = row (band * 8 + n).
+// Characters that are not in the subset have zero width and advance.
 typedef struct {
-    uint16_t bitmap_offset; // Pointer into GFXfont->bitmap
+    uint16_t bitmap_offset; // Offset of the glyph's first column byte in GFXfont->bitmap
     uint8_t width;          // Bitmap dimensions in pixels
     uint8_t height;
     uint8_t x_advance;      // Distance to advance cursor (x axis)
@@ -14,16 +18,16 @@ typedef struct {
 } GFXglyph;
 
 typedef struct {
-    const uint8_t *bitmap;  // Glyph bitmaps, concatenated
+    const uint8_t *bitmap;  // Page-major glyph bitmaps, concatenated
     const GFXglyph *glyph;  // Glyph array
     uint8_t first;          // ASCII value of first character
     uint8_t last;           // ASCII value of last character
     uint8_t y_advance;      // Newline distance (y axis)
 } GFXfont;
 
-// Available fonts (from Adafruit GFX library)
-// Tiny font (perfect for indicators, status text)
-extern const GFXfont Picopixel;
+// Available fonts (subsets of the Adafruit GFX library fonts)
+// To use another font from adafruit_fonts.c (Picopixel, FreeSans24pt7b, FreeSansBold*),
+// add it to FONT_GLYPHS in tools/font_subset.py and declare it here.
 
 // Fixed-width 5x7 font (author: Rob Jennings)
 extern const GFXfont Font5x7Fixed;
@@ -32,12 +36,5 @@ extern const GFXfont Font5x7Fixed;
 extern const GFXfont FreeSans9pt7b;
 extern const GFXfont FreeSans12pt7b;
 extern const GFXfont FreeSans18pt7b;
-extern const GFXfont FreeSans24pt7b;
-
-// Bold weight (more prominent, better for emphasis)
-extern const GFXfont FreeSansBold9pt7b;
-extern const GFXfont FreeSansBold12pt7b;
-extern const GFXfont FreeSansBold18pt7b;
-extern const GFXfont FreeSansBold24pt7b;
 
 #endif // FONT_H
@@ -0,0 +1,60 @@
+/**
+ * GATT cache state implementation
+ */
+
+#include "gatt_cache.h"
+
+static uint32_t index_bit(int index)
+{
+    return (index >= 0 && index < GATT_CACHE_MAX_CLIENTS) ? (1u << index) : 0;
+}
+
+uint32_t gatt_cache_fingerprint(const uint8_t *db, size_t len)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        crc ^= db[i];
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1u));
+        }
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+bool gatt_cache_boot(gatt_cache_t *cache, const gatt_cache_t *stored, uint32_t db_fingerprint, uint32_t bonded)
+{
+    cache->db_fingerprint = db_fingerprint;
+    if (stored == NULL)
+    {
+        cache->pending = bonded; // Unknown what the bonds discovered: tell them all
+        return true;
+    }
+
+    if (stored->db_fingerprint != db_fingerprint)
+    {
+        cache->pending = bonded;
+    }
+    else
+    {
+        cache->pending = stored->pending & bonded;
+    }
+    return cache->db_fingerprint != stored->db_fingerprint || cache->pending != stored->pending;
+}
+
+bool gatt_cache_changed_for(const gatt_cache_t *cache, int index)
+{
+    return (cache->pending & index_bit(index)) != 0;
+}
+
+bool gatt_cache_client_current(gatt_cache_t *cache, int index)
+{
+    if (!gatt_cache_changed_for(cache, index))
+    {
+        return false;
+    }
+    cache->pending &= ~index_bit(index);
+    return true;
+}
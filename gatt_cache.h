@@ -0,0 +1,50 @@
+/**
+ * GATT cache state for bonded clients
+ *
+ * A bonded client keeps the GATT database it discovered and skips discovery
+ * when it reconnects. Once a firmware update changes the database, each
+ * bonded client has to be told once with a Service Changed indication, or it
+ * goes on using stale handles. What is kept in flash for that:
+ * - a fingerprint of the database the bonded clients discovered (CRC-32 of
+ *   the ATT database generated from walkolution-odometer.gatt)
+ * - which bonded clients still have to be told, one bit per LE device DB
+ *   entry (the index BTstack stores the bond at)
+ *
+ * Pure logic: the caller loads and stores the record (bonding.c) and sends
+ * the indication.
+ */
+
+#ifndef GATT_CACHE_H
+#define GATT_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Bonds that can be tracked (bits of the pending mask)
+#define GATT_CACHE_MAX_CLIENTS 32
+
+typedef struct
+{
+    uint32_t db_fingerprint;               // Database the bonded clients know
+    uint32_t pending;                      // Bit per bond index: not told of a change yet
+} gatt_cache_t;
+
+// Fingerprint of an ATT database
+uint32_t gatt_cache_fingerprint(const uint8_t *db, size_t len);
+
+// Set up at boot from the stored record (NULL if there is none), the current
+// database and the bonds there are (bit per index). Bonds made with another
+// database have to be told; bonds that no longer exist are dropped.
+// Returns true if the record changed and should be stored
+bool gatt_cache_boot(gatt_cache_t *cache, const gatt_cache_t *stored, uint32_t db_fingerprint, uint32_t bonded);
+
+// Whether the bonded client at index still has to be told the database changed
+bool gatt_cache_changed_for(const gatt_cache_t *cache, int index);
+
+// The client at index knows the current database: it was just told, or it
+// just bonded (and discovered it). Returns true if the record changed and
+// should be stored
+bool gatt_cache_client_current(gatt_cache_t *cache, int index);
+
+#endif // GATT_CACHE_H
@@ -0,0 +1,38 @@
+/**
+ * Hot path code placement
+ *
+ * Code normally runs from QSPI flash through the 16 KB XIP cache, which the
+ * per-frame rendering code shares with BTstack and the CYW43 driver. When
+ * HOT_PATH_IN_RAM is 1 (CMake option of the same name), the functions and
+ * tables marked here are linked into SRAM (.time_critical, copied at boot) so
+ * they never stall on a cache miss.
+ *
+ * Marked: oled_draw_text / oled_fill_rect / oled_draw_bitmap and dirty
+ * tracking, the font tables, gpio_irq_handler, the log ring and trace writers
+ * and the speed window math. The font tables alone are ~3.7 KB (font_size_report.txt);
+ * the .map file shows the total under .time_critical.
+ *
+ * Use perf.h stats to compare builds with and without the option.
+ * On the host (tests) both macros expand to nothing.
+ */
+
+#ifndef HOT_PATH_H
+#define HOT_PATH_H
+
+#ifndef HOT_PATH_IN_RAM
+#define HOT_PATH_IN_RAM 0
+#endif
+
+#if HOT_PATH_IN_RAM
+#include "pico.h"
+
+// Function definition: void HOT_FUNC(name)(args) { ... }
+#define HOT_FUNC(func) __not_in_flash_func(func)
+// Table definition: static const uint8_t table[] HOT_DATA("group") = { ... };
+#define HOT_DATA(group) __not_in_flash(group)
+#else
+#define HOT_FUNC(func) func
+#define HOT_DATA(group)
+#endif
+
+#endif // HOT_PATH_H
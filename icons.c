@@ -18,5 +18,5 @@ const uint8_t bluetooth_bitmap[] = {
 
 const Icon icon_bluetooth = {
     .bitmap = bluetooth_bitmap,
-    .width = 6,
-    .height = 11};
+    .width = ICON_BLUETOOTH_WIDTH,
+    .height = ICON_BLUETOOTH_HEIGHT};
@@ -10,6 +10,10 @@ typedef struct {
     uint8_t height;         // Height in pixels
 } Icon;
 
+// Icon dimensions (compile-time constants for static layouts)
+#define ICON_BLUETOOTH_WIDTH 6
+#define ICON_BLUETOOTH_HEIGHT 11
+
 // Available icons
 extern const Icon icon_bluetooth;
 
@@ -3,7 +3,10 @@
  */
 
 #include "irq.h"
+#include "hot_path.h"
+#include "trace.h"
 #include "hardware/gpio.h"
+#include "hardware/timer.h"
 
 // Module state
 static uint8_t sensor_pin = 0;
@@ -14,10 +17,13 @@ static uint8_t sensor_pin = 0;
 // interrupt disabling is needed and no rotation counts are ever lost.
 static volatile uint32_t pending_rotation_count = 0;
 
+// time_us_32() of the first edge counted into pending_rotation_count
+static volatile uint32_t first_edge_us = 0;
+
 // GPIO IRQ handler for sensor pin
 // This must be fast and minimal - just count edges
 // Uses atomic operations so no rotation counts are lost
-static void gpio_irq_handler(uint gpio, uint32_t events)
+static void HOT_FUNC(gpio_irq_handler)(uint gpio, uint32_t events)
 {
     // Check if this is our sensor pin
     if (gpio != sensor_pin)
@@ -25,11 +31,18 @@ static void gpio_irq_handler(uint gpio, uint32_t events)
         return;
     }
 
+    TRACE_BEGIN(TRACE_SENSOR_IRQ, events);
+
     // Handle falling edge (sensor goes LOW) - count rotation
     if (events & GPIO_IRQ_EDGE_FALL)
     {
-        __atomic_fetch_add(&pending_rotation_count, 1u, __ATOMIC_RELAXED);
+        if (__atomic_fetch_add(&pending_rotation_count, 1u, __ATOMIC_RELAXED) == 0)
+        {
+            first_edge_us = time_us_32();
+        }
     }
+
+    TRACE_END(TRACE_SENSOR_IRQ, events);
 }
 
 void irq_init(uint8_t pin)
@@ -52,3 +65,8 @@ uint32_t irq_read_and_clear_rotations(void)
     // No need to disable interrupts - __atomic_exchange_n is a single atomic operation
     return __atomic_exchange_n(&pending_rotation_count, 0u, __ATOMIC_ACQ_REL);
 }
+
+uint32_t irq_get_first_edge_us(void)
+{
+    return first_edge_us;
+}
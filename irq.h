@@ -32,4 +32,15 @@ void irq_init(uint8_t sensor_pin);
  */
 uint32_t irq_read_and_clear_rotations(void);
 
+/**
+ * Time of the first edge in the rotations last read
+ *
+ * Valid right after irq_read_and_clear_rotations() returned a non-zero count.
+ * An edge landing between the two calls starts the next batch and is
+ * reported here instead, so that batch's latency reads slightly short.
+ *
+ * @return time_us_32() when the edge was seen
+ */
+uint32_t irq_get_first_edge_us(void);
+
 #endif // IRQ_H
@@ -0,0 +1,191 @@
+/**
+ * BLE link policy implementation
+ */
+
+#include "link_policy.h"
+#include "logging.h"
+#include "timebase.h"
+#include "pico/stdlib.h"
+#include "btstack.h"
+
+// LE Set Data Length: largest link packet and the time it takes at 1M PHY
+#define DLE_TX_OCTETS 251
+#define DLE_TX_TIME_US 2120
+
+typedef enum
+{
+    LINK_MODE_NONE = 0,                // Nothing requested on this connection yet
+    LINK_MODE_IDLE,
+    LINK_MODE_BULK
+} link_mode_t;
+
+typedef struct
+{
+    uint16_t interval_min;
+    uint16_t interval_max;
+    uint16_t latency;
+    uint16_t supervision_timeout;
+} link_params_t;
+
+static const link_params_t idle_params = {
+    LINK_POLICY_IDLE_INTERVAL_MIN, LINK_POLICY_IDLE_INTERVAL_MAX, LINK_POLICY_IDLE_LATENCY, LINK_POLICY_IDLE_TIMEOUT};
+static const link_params_t bulk_params = {
+    LINK_POLICY_BULK_INTERVAL_MIN, LINK_POLICY_BULK_INTERVAL_MAX, 0, LINK_POLICY_BULK_TIMEOUT};
+
+typedef struct
+{
+    bool connected;                    // Slot in use
+    hci_con_handle_t con_handle;
+    link_mode_t requested_mode;
+    uint32_t last_request_ms;
+    uint32_t last_bulk_ms;
+    bool data_length_pending;
+} link_t;
+
+static link_t links[MAX_NR_HCI_CONNECTIONS];
+
+static link_t *find_link(hci_con_handle_t con_handle)
+{
+    for (int i = 0; i < MAX_NR_HCI_CONNECTIONS; i++)
+    {
+        if (links[i].connected && links[i].con_handle == con_handle)
+        {
+            return &links[i];
+        }
+    }
+    return NULL;
+}
+
+static link_t *free_link(void)
+{
+    for (int i = 0; i < MAX_NR_HCI_CONNECTIONS; i++)
+    {
+        if (!links[i].connected)
+        {
+            return &links[i];
+        }
+    }
+    return NULL;
+}
+
+// Interval in 1.25 ms units as hundredths of a millisecond, for %lu logging
+static uint32_t interval_centi_ms(uint16_t interval)
+{
+    return (uint32_t)interval * 125;
+}
+
+static void log_params(const char *what, hci_con_handle_t con_handle, uint16_t interval, uint16_t latency, uint16_t timeout)
+{
+    uint32_t centi = interval_centi_ms(interval);
+    LOG_INFO(LOG_TAG_BLE, "[LINK] %s (0x%04x): interval %lu.%02lu ms, latency %u, timeout %lu ms\n",
+                          what, con_handle, centi / 100, centi % 100, latency, (uint32_t)timeout * 10);
+}
+
+void link_policy_packet_handler(uint8_t *packet)
+{
+    link_t *link;
+
+    switch (hci_event_packet_get_type(packet))
+    {
+    case HCI_EVENT_LE_META:
+        switch (hci_event_le_meta_get_subevent_code(packet))
+        {
+        case HCI_SUBEVENT_LE_CONNECTION_COMPLETE:
+            link = free_link();
+            if (link == NULL)
+            {
+                break; // More connections than BTstack takes: cannot happen
+            }
+            link->connected = true;
+            link->con_handle = hci_subevent_le_connection_complete_get_connection_handle(packet);
+            link->requested_mode = LINK_MODE_NONE;
+            link->last_bulk_ms = timebase_ms(); // Client setup is bulk traffic
+            link->data_length_pending = true;
+            log_params("Connected", link->con_handle, hci_subevent_le_connection_complete_get_conn_interval(packet),
+                       hci_subevent_le_connection_complete_get_conn_latency(packet),
+                       hci_subevent_le_connection_complete_get_supervision_timeout(packet));
+            break;
+        case HCI_SUBEVENT_LE_CONNECTION_UPDATE_COMPLETE:
+            log_params("Parameters updated", hci_subevent_le_connection_update_complete_get_connection_handle(packet),
+                       hci_subevent_le_connection_update_complete_get_conn_interval(packet),
+                       hci_subevent_le_connection_update_complete_get_conn_latency(packet),
+                       hci_subevent_le_connection_update_complete_get_supervision_timeout(packet));
+            break;
+        case HCI_SUBEVENT_LE_DATA_LENGTH_CHANGE:
+            LOG_INFO(LOG_TAG_BLE, "[LINK] Data length (0x%04x): tx %u bytes, rx %u bytes\n",
+                                  hci_subevent_le_data_length_change_get_connection_handle(packet),
+                                  hci_subevent_le_data_length_change_get_max_tx_octets(packet),
+                                  hci_subevent_le_data_length_change_get_max_rx_octets(packet));
+            break;
+        default:
+            break;
+        }
+        break;
+
+    case HCI_EVENT_DISCONNECTION_COMPLETE:
+        link = find_link(hci_event_disconnection_complete_get_connection_handle(packet));
+        if (link != NULL)
+        {
+            link->connected = false;
+            link->data_length_pending = false;
+        }
+        break;
+
+    case ATT_EVENT_MTU_EXCHANGE_COMPLETE:
+        LOG_INFO(LOG_TAG_BLE, "[LINK] ATT MTU (0x%04x): %u%s\n", att_event_mtu_exchange_complete_get_handle(packet),
+                              att_event_mtu_exchange_complete_get_MTU(packet),
+                              att_event_mtu_exchange_complete_get_MTU(packet) < LINK_POLICY_ATT_MTU ? " (client asked for less than one full link packet)" : "");
+        break;
+
+    default:
+        break;
+    }
+}
+
+void link_policy_bulk(hci_con_handle_t con_handle, uint32_t now_ms)
+{
+    link_t *link = find_link(con_handle);
+    if (link != NULL)
+    {
+        link->last_bulk_ms = now_ms;
+    }
+}
+
+static void poll_link(link_t *link, uint32_t now_ms)
+{
+    if (link->data_length_pending && hci_can_send_command_packet_now())
+    {
+        link->data_length_pending = false;
+        hci_send_cmd(&hci_le_set_data_length, link->con_handle, DLE_TX_OCTETS, DLE_TX_TIME_US);
+    }
+
+    link_mode_t wanted = (now_ms - link->last_bulk_ms) < LINK_POLICY_BULK_HOLD_MS ? LINK_MODE_BULK : LINK_MODE_IDLE;
+    if (wanted == link->requested_mode)
+    {
+        return;
+    }
+    if (link->requested_mode != LINK_MODE_NONE && (now_ms - link->last_request_ms) < LINK_POLICY_REQUEST_GAP_MS)
+    {
+        return; // Give the central time to answer the last one
+    }
+
+    const link_params_t *params = (wanted == LINK_MODE_BULK) ? &bulk_params : &idle_params;
+    gap_request_connection_parameter_update(link->con_handle, params->interval_min, params->interval_max,
+                                            params->latency, params->supervision_timeout);
+    link->requested_mode = wanted;
+    link->last_request_ms = now_ms;
+    LOG_INFO(LOG_TAG_BLE, "[LINK] Requesting %s parameters (0x%04x, interval %u-%u, latency %u)\n",
+                          wanted == LINK_MODE_BULK ? "bulk" : "idle", link->con_handle,
+                          params->interval_min, params->interval_max, params->latency);
+}
+
+void link_policy_poll(uint32_t now_ms)
+{
+    for (int i = 0; i < MAX_NR_HCI_CONNECTIONS; i++)
+    {
+        if (links[i].connected)
+        {
+            poll_link(&links[i], now_ms);
+        }
+    }
+}
@@ -0,0 +1,80 @@
+/**
+ * BLE link policy
+ *
+ * The central picks the connection interval, latency and MTU, and its choice
+ * suits neither of our two kinds of traffic: a notification about once a
+ * second, and now and then a bulk read (sessions list, log backlog). After a
+ * connection this module:
+ * - asks the controller for LE Data Length Extension (251-byte link packets),
+ *   so an ATT packet of up to LINK_POLICY_ATT_MTU bytes goes in one radio packet
+ * - requests the bulk parameters (short interval, no latency) while there is
+ *   bulk traffic or the client is setting up, and the idle parameters (long
+ *   interval, peripheral latency) once it has been quiet for
+ *   LINK_POLICY_BULK_HOLD_MS
+ * - logs what was negotiated: interval, latency, timeout, data length and MTU
+ *
+ * Each connected central (up to MAX_NR_HCI_CONNECTIONS) has its own mode:
+ * a bulk read on one link does not speed up the others.
+ *
+ * The MTU itself can only be requested by the client (ATT MTU exchange);
+ * the server accepts up to the L2CAP maximum, well above LINK_POLICY_ATT_MTU.
+ * Requests are only requests: the central may refuse or pick other values,
+ * which the log shows.
+ */
+
+#ifndef LINK_POLICY_H
+#define LINK_POLICY_H
+
+#include <stdint.h>
+#include "btstack.h"
+
+// ATT MTU that fills one Data Length Extension packet (251 - 4 L2CAP header)
+#define LINK_POLICY_ATT_MTU 247
+
+// Connection intervals in 1.25 ms units, supervision timeouts in 10 ms units
+#ifndef LINK_POLICY_IDLE_INTERVAL_MIN
+#define LINK_POLICY_IDLE_INTERVAL_MIN 96   // 120 ms
+#endif
+
+#ifndef LINK_POLICY_IDLE_INTERVAL_MAX
+#define LINK_POLICY_IDLE_INTERVAL_MAX 120  // 150 ms
+#endif
+
+#ifndef LINK_POLICY_IDLE_LATENCY
+#define LINK_POLICY_IDLE_LATENCY 4         // May skip 4 events: up to 750 ms asleep
+#endif
+
+#ifndef LINK_POLICY_IDLE_TIMEOUT
+#define LINK_POLICY_IDLE_TIMEOUT 600       // 6 s
+#endif
+
+#ifndef LINK_POLICY_BULK_INTERVAL_MIN
+#define LINK_POLICY_BULK_INTERVAL_MIN 6    // 7.5 ms
+#endif
+
+#ifndef LINK_POLICY_BULK_INTERVAL_MAX
+#define LINK_POLICY_BULK_INTERVAL_MAX 12   // 15 ms
+#endif
+
+#ifndef LINK_POLICY_BULK_TIMEOUT
+#define LINK_POLICY_BULK_TIMEOUT 400       // 4 s
+#endif
+
+#ifndef LINK_POLICY_BULK_HOLD_MS
+#define LINK_POLICY_BULK_HOLD_MS 5000      // Quiet time before going back to idle
+#endif
+
+#ifndef LINK_POLICY_REQUEST_GAP_MS
+#define LINK_POLICY_REQUEST_GAP_MS 2000    // Between parameter update requests
+#endif
+
+// Feed every HCI/ATT event packet (connection, updates, data length, MTU)
+void link_policy_packet_handler(uint8_t *packet);
+
+// Bulk traffic on a connection now: use the fast link until it has been quiet for a while
+void link_policy_bulk(hci_con_handle_t con_handle, uint32_t now_ms);
+
+// Send whatever request is due (main loop)
+void link_policy_poll(uint32_t now_ms);
+
+#endif // LINK_POLICY_H
@@ -0,0 +1,186 @@
+/**
+ * Deferred binary logging (LOG_BINARY=1, CMake option of the same name)
+ *
+ * log_printf() becomes a macro that stores a compact record in the log ring
+ * instead of formatting text on the device. The record holds the call site
+ * ID, a timestamp and the raw argument values; tools/log_strings.py builds the
+ * table of format strings at build time and tools/log_decode.py (or the
+ * Android log viewer) does the formatting on the host.
+ *
+ * Record layout (little-endian):
+ *   [0xFE][len][file id][line u16][time_us_32 u32][arguments...]
+ *
+ * - len is the size of the whole record. 0xFE never occurs in UTF-8 text, so
+ *   a reader can tell binary logs from text and resynchronize after a gap.
+ * - The call site ID is (file id, line). File ids follow the order of
+ *   LOG_SOURCES in CMakeLists.txt (passed to each source as LOG_FILE_ID) and
+ *   the line is that of the log_printf token. File id 0 is reserved for the
+ *   records logging.c writes itself (LOG_BINARY_SITE_*).
+ * - Arguments are encoded by C type: integers up to 32 bits as 4 bytes,
+ *   long long as 8, float and double as a 4-byte float, strings as a length
+ *   byte plus up to LOG_BINARY_MAX_STRING bytes. The decoder walks the format
+ *   string and reads the same sizes (%ll* = 8, %f/%e/%g = float, %s = string,
+ *   anything else 4), so printf format checking is kept to catch mismatches.
+ * - A record that would not fit in LOG_BINARY_MAX_RECORD bytes ends at the
+ *   last argument that fits; the decoder prints the missing ones as "?".
+ *
+ * A call costs a few byte stores per argument plus one ring write - no
+ * vsnprintf, no soft-float formatting and no USB printf.
+ */
+
+#ifndef LOG_BINARY_H
+#define LOG_BINARY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define LOG_BINARY_SYNC 0xFE
+#define LOG_BINARY_HEADER_SIZE 9
+
+#ifndef LOG_BINARY_MAX_RECORD
+#define LOG_BINARY_MAX_RECORD 96
+#endif
+
+#ifndef LOG_BINARY_MAX_STRING
+#define LOG_BINARY_MAX_STRING 32
+#endif
+
+// Call sites in file id 0
+#define LOG_BINARY_SITE_BOOT 1      // Args: string table hash (LOG_STRINGS_HASH)
+#define LOG_BINARY_SITE_DROPPED 2   // Args: bytes dropped since the last marker
+
+typedef struct {
+    uint8_t *pos;   // Next argument byte
+    uint8_t *end;   // Set to pos once an argument did not fit
+    uint8_t data[LOG_BINARY_MAX_RECORD];
+} log_binary_record_t;
+
+static inline void log_binary_begin(log_binary_record_t *rec, uint8_t file_id, uint16_t line) {
+    rec->data[0] = LOG_BINARY_SYNC;
+    rec->data[2] = file_id;
+    rec->data[3] = (uint8_t)line;
+    rec->data[4] = (uint8_t)(line >> 8);
+    rec->pos = &rec->data[LOG_BINARY_HEADER_SIZE];
+    rec->end = &rec->data[LOG_BINARY_MAX_RECORD];
+}
+
+// Fill in the length and timestamp; returns the record size
+static inline size_t log_binary_finish(log_binary_record_t *rec, uint32_t timestamp_us) {
+    size_t len = (size_t)(rec->pos - rec->data);
+    rec->data[1] = (uint8_t)len;
+    rec->data[5] = (uint8_t)timestamp_us;
+    rec->data[6] = (uint8_t)(timestamp_us >> 8);
+    rec->data[7] = (uint8_t)(timestamp_us >> 16);
+    rec->data[8] = (uint8_t)(timestamp_us >> 24);
+    return len;
+}
+
+// Stamp the record and write it to the log ring (logging.c)
+void log_binary_commit(log_binary_record_t *rec);
+
+static inline int log_binary_reserve(log_binary_record_t *rec, size_t len) {
+    if ((size_t)(rec->end - rec->pos) < len) {
+        rec->end = rec->pos; // Drop this and every later argument
+        return 0;
+    }
+    return 1;
+}
+
+static inline void log_binary_put_u32(log_binary_record_t *rec, uint32_t value) {
+    if (log_binary_reserve(rec, 4)) {
+        rec->pos[0] = (uint8_t)value;
+        rec->pos[1] = (uint8_t)(value >> 8);
+        rec->pos[2] = (uint8_t)(value >> 16);
+        rec->pos[3] = (uint8_t)(value >> 24);
+        rec->pos += 4;
+    }
+}
+
+static inline void log_binary_put_u64(log_binary_record_t *rec, uint64_t value) {
+    if (log_binary_reserve(rec, 8)) {
+        log_binary_put_u32(rec, (uint32_t)value);
+        log_binary_put_u32(rec, (uint32_t)(value >> 32));
+    }
+}
+
+static inline void log_binary_put_float(log_binary_record_t *rec, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    log_binary_put_u32(rec, bits);
+}
+
+static inline void log_binary_put_double(log_binary_record_t *rec, double value) {
+    log_binary_put_float(rec, (float)value);
+}
+
+static inline void log_binary_put_ptr(log_binary_record_t *rec, const void *value) {
+    log_binary_put_u32(rec, (uint32_t)(uintptr_t)value);
+}
+
+static inline void log_binary_put_str(log_binary_record_t *rec, const char *value) {
+    if (value == NULL) {
+        value = "(null)";
+    }
+    size_t len = 0;
+    while (len < LOG_BINARY_MAX_STRING && value[len] != '\0') {
+        len++;
+    }
+    if (log_binary_reserve(rec, 1 + len)) {
+        rec->pos[0] = (uint8_t)len;
+        memcpy(&rec->pos[1], value, len);
+        rec->pos += 1 + len;
+    }
+}
+
+// Encode one argument according to its C type
+#define LOG_BINARY_ARG(rec, x) _Generic((x), \
+        float: log_binary_put_float, \
+        double: log_binary_put_double, \
+        long long: log_binary_put_u64, \
+        unsigned long long: log_binary_put_u64, \
+        char *: log_binary_put_str, \
+        const char *: log_binary_put_str, \
+        void *: log_binary_put_ptr, \
+        const void *: log_binary_put_ptr, \
+        default: log_binary_put_u32)(rec, x)
+
+// Number of arguments after the format (up to 16)
+#define LOG_BINARY_NARGS(...) \
+    LOG_BINARY_NARGS_(__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, ~)
+#define LOG_BINARY_NARGS_(f, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14, a15, a16, n, ...) n
+
+#define LOG_BINARY_EACH_0(rec, ...)
+#define LOG_BINARY_EACH_1(rec, a) LOG_BINARY_ARG(rec, a);
+#define LOG_BINARY_EACH_2(rec, a, ...) LOG_BINARY_ARG(rec, a); LOG_BINARY_EACH_1(rec, __VA_ARGS__)
+#define LOG_BINARY_EACH_3(rec, a, ...) LOG_BINARY_ARG(rec, a); LOG_BINARY_EACH_2(rec, __VA_ARGS__)
+#define LOG_BINARY_EACH_4(rec, a, ...) LOG_BINARY_ARG(rec, a); LOG_BINARY_EACH_3(rec, __VA_ARGS__)
+#define LOG_BINARY_EACH_5(rec, a, ...) LOG_BINARY_ARG(rec, a); LOG_BINARY_EACH_4(rec, __VA_ARGS__)
+#define LOG_BINARY_EACH_6(rec, a, ...) LOG_BINARY_ARG(rec, a); LOG_BINARY_EACH_5(rec, __VA_ARGS__)
+#define LOG_BINARY_EACH_7(rec, a, ...) LOG_BINARY_ARG(rec, a); LOG_BINARY_EACH_6(rec, __VA_ARGS__)
+#define LOG_BINARY_EACH_8(rec, a, ...) LOG_BINARY_ARG(rec, a); LOG_BINARY_EACH_7(rec, __VA_ARGS__)
+#define LOG_BINARY_EACH_9(rec, a, ...) LOG_BINARY_ARG(rec, a); LOG_BINARY_EACH_8(rec, __VA_ARGS__)
+#define LOG_BINARY_EACH_10(rec, a, ...) LOG_BINARY_ARG(rec, a); LOG_BINARY_EACH_9(rec, __VA_ARGS__)
+#define LOG_BINARY_EACH_11(rec, a, ...) LOG_BINARY_ARG(rec, a); LOG_BINARY_EACH_10(rec, __VA_ARGS__)
+#define LOG_BINARY_EACH_12(rec, a, ...) LOG_BINARY_ARG(rec, a); LOG_BINARY_EACH_11(rec, __VA_ARGS__)
+#define LOG_BINARY_EACH_13(rec, a, ...) LOG_BINARY_ARG(rec, a); LOG_BINARY_EACH_12(rec, __VA_ARGS__)
+#define LOG_BINARY_EACH_14(rec, a, ...) LOG_BINARY_ARG(rec, a); LOG_BINARY_EACH_13(rec, __VA_ARGS__)
+#define LOG_BINARY_EACH_15(rec, a, ...) LOG_BINARY_ARG(rec, a); LOG_BINARY_EACH_14(rec, __VA_ARGS__)
+#define LOG_BINARY_EACH_16(rec, a, ...) LOG_BINARY_ARG(rec, a); LOG_BINARY_EACH_15(rec, __VA_ARGS__)
+
+#define LOG_BINARY_CALL(n, ...) LOG_BINARY_CALL_(n, __VA_ARGS__)
+#define LOG_BINARY_CALL_(n, format, ...) do { \
+        log_binary_record_t log_rec_; \
+        if (0) { \
+            log_check_format(format, ##__VA_ARGS__); \
+        } \
+        log_binary_begin(&log_rec_, LOG_FILE_ID, __LINE__); \
+        LOG_BINARY_EACH_##n(&log_rec_, __VA_ARGS__) \
+        log_binary_commit(&log_rec_); \
+    } while (0)
+
+// Replaces the printf-style function. Sources calling it must be listed in
+// LOG_SOURCES (CMakeLists.txt) so they get a LOG_FILE_ID.
+#define log_printf(...) LOG_BINARY_CALL(LOG_BINARY_NARGS(__VA_ARGS__), __VA_ARGS__)
+
+#endif // LOG_BINARY_H
@@ -0,0 +1,120 @@
+/**
+ * Log retention implementation
+ *
+ * Nothing here touches hardware, so the checks run in the host tests. Restore
+ * and rewind run at boot before anything logs, so the ring indices are read
+ * and rewound without the acquire/release ordering log_ring.c uses; seek runs
+ * later in the reader's context and publishes tail like log_ring_consume.
+ */
+
+#include "log_persist.h"
+#include <string.h>
+
+#define LOG_BINARY_SYNC_BYTE 0xFE   // log_binary.h LOG_BINARY_SYNC
+#define LOG_BINARY_MIN_LEN 9        // log_binary.h LOG_BINARY_HEADER_SIZE
+#define LOG_BINARY_MAX_LEN 96       // log_binary.h LOG_BINARY_MAX_RECORD
+
+static bool is_intact(const log_persist_t *persist, const char *buffer, size_t size) {
+    const log_ring_t *ring = &persist->ring;
+
+    if (persist->magic != LOG_PERSIST_MAGIC || persist->check != ~LOG_PERSIST_MAGIC) {
+        return false;
+    }
+    if (ring->buffer != buffer || ring->mask != (uint32_t)size - 1) {
+        return false;
+    }
+    // origin <= tail <= head (offsets from the origin survive counter wrap)
+    // The writer overwrites unread data, so tail may lag head by more than size
+    uint32_t written = ring->head - persist->origin;
+    return ring->tail - persist->origin <= written;
+}
+
+bool log_persist_restore(log_persist_t *persist, char *buffer, size_t size, log_crash_t *crash) {
+    bool retained = is_intact(persist, buffer, size);
+
+    if (retained && persist->crash.magic == LOG_CRASH_MAGIC) {
+        *crash = persist->crash;
+    } else {
+        memset(crash, 0, sizeof(*crash));
+    }
+
+    if (!retained) {
+        if (!log_ring_init(&persist->ring, buffer, size)) {
+            return false;
+        }
+        persist->boot_count = 0;
+        persist->origin = persist->ring.head;
+        persist->magic = LOG_PERSIST_MAGIC;
+        persist->check = ~LOG_PERSIST_MAGIC;
+    }
+
+    persist->boot_count++;
+    persist->ring.dropped = 0; // The new boot reports its own drops
+    memset(&persist->crash, 0, sizeof(persist->crash));
+    return retained;
+}
+
+// 0xFE also turns up in timestamps and arguments, so a record only starts at
+// `pos` if following the length bytes from there lands exactly on head
+static bool starts_record_chain(const log_ring_t *ring, uint32_t pos) {
+    while (pos != ring->head) {
+        uint8_t sync = (uint8_t)ring->buffer[pos & ring->mask];
+        uint8_t len = (uint8_t)ring->buffer[(pos + 1) & ring->mask];
+        if (sync != LOG_BINARY_SYNC_BYTE || len < LOG_BINARY_MIN_LEN || len > LOG_BINARY_MAX_LEN ||
+            len > ring->head - pos) {
+            return false;
+        }
+        pos += len;
+    }
+    return true;
+}
+
+// Bytes still in the buffer: everything written, up to one ring's worth
+static uint32_t kept_bytes(const log_persist_t *persist) {
+    const log_ring_t *ring = &persist->ring;
+    uint32_t kept = ring->head - persist->origin;
+    return (kept > ring->mask + 1) ? ring->mask + 1 : kept;
+}
+
+size_t log_persist_rewind(log_persist_t *persist, size_t max_len, bool binary) {
+    log_ring_t *ring = &persist->ring;
+    uint32_t origin = persist->origin;
+
+    uint32_t kept = kept_bytes(persist);
+    if (kept > max_len) {
+        kept = (uint32_t)max_len;
+    }
+
+    // Older data is skipped even if it was never read: the previous boot's
+    // reader may have stopped long before the reset, and the lines leading up
+    // to it are the ones worth keeping
+    uint32_t start = ring->head - kept;
+
+    // The first byte ever written starts a message; otherwise find the next one
+    if (start != origin) {
+        while (start != ring->head) {
+            uint8_t c = (uint8_t)ring->buffer[start & ring->mask];
+            if (binary && c == LOG_BINARY_SYNC_BYTE && starts_record_chain(ring, start)) {
+                break;
+            }
+            start++;
+            if (!binary && c == '\n') {
+                break;
+            }
+        }
+    }
+
+    ring->tail = start;
+    return ring->head - ring->tail;
+}
+
+uint32_t log_persist_seek(log_persist_t *persist, uint32_t cursor) {
+    log_ring_t *ring = &persist->ring;
+    uint32_t oldest = ring->head - kept_bytes(persist);
+
+    if (cursor - oldest <= ring->head - oldest) {
+        __atomic_store_n(&ring->tail, cursor, __ATOMIC_RELEASE);
+        return cursor;
+    }
+    return log_ring_catch_up(ring);
+}
@@ -0,0 +1,81 @@
+/**
+ * Log retention across resets
+ *
+ * The log ring and this header live in RAM the C runtime does not clear
+ * (.uninitialized_data), so after a watchdog reset, a hard fault or any other
+ * reset that keeps SRAM powered the next boot still has the previous boot's
+ * log. A power-on or brown-out reset leaves SRAM undefined; the header checks
+ * then fail and the ring starts empty.
+ *
+ * - restore checks the magic words and that the ring indices are consistent
+ *   with this build's buffer before trusting them.
+ * - rewind makes the last part of the retained log unread again, so the BLE
+ *   logs characteristic serves it before the new boot's messages.
+ * - seek moves the read position to a client's resume point (log_stream.h).
+ * - The crash record is filled in by the hard fault handler (logging.c) and
+ *   reported by the next boot.
+ */
+
+#ifndef LOG_PERSIST_H
+#define LOG_PERSIST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "log_ring.h"
+
+#define LOG_PERSIST_MAGIC 0x4C4F4752u   // "LOGR"
+#define LOG_CRASH_MAGIC 0x43525348u     // "CRSH"
+
+#ifndef LOG_CRASH_BACKTRACE_DEPTH
+#define LOG_CRASH_BACKTRACE_DEPTH 8
+#endif
+
+// Registers at the time of a hard fault
+// Cortex-M0+ has no fault status registers: the stacked frame, EXC_RETURN and
+// ICSR are what there is. The backtrace is a stack scan for return addresses
+// (see logging.c), so it can contain stale entries; map it with addr2line.
+typedef struct {
+    uint32_t magic;         // LOG_CRASH_MAGIC once filled in
+    uint32_t r[4];          // r0-r3
+    uint32_t r12;
+    uint32_t lr;
+    uint32_t pc;            // Faulting instruction
+    uint32_t xpsr;
+    uint32_t sp;            // Stack pointer before the exception frame
+    uint32_t exc_return;
+    uint32_t icsr;
+    uint32_t depth;         // Valid backtrace entries
+    uint32_t backtrace[LOG_CRASH_BACKTRACE_DEPTH];
+} log_crash_t;
+
+typedef struct {
+    uint32_t magic;         // LOG_PERSIST_MAGIC
+    uint32_t boot_count;    // Boots since the ring was last started empty
+    uint32_t origin;        // ring.head when the ring was started empty
+    log_ring_t ring;
+    log_crash_t crash;
+    uint32_t check;         // ~LOG_PERSIST_MAGIC
+} log_persist_t;
+
+// Take over the ring retained in `persist` if it is intact and uses `buffer`
+// (size must be a power of two); otherwise start an empty ring there.
+// Counts the boot, clears the dropped counter and moves any crash record to
+// `crash` (cleared if there is none). Returns true if the log was retained.
+bool log_persist_restore(log_persist_t *persist, char *buffer, size_t size, log_crash_t *crash);
+
+// Make the last max_len bytes of the retained log the unread data, whether or
+// not older bytes were ever read, so the new boot's log follows the lines
+// leading up to the reset. The new start is moved forward to the first
+// message boundary: after a '\n' for text; for binary records at a 0xFE sync
+// byte whose chain of record lengths ends exactly at head. Returns the
+// number of retained bytes now unread.
+size_t log_persist_rewind(log_persist_t *persist, size_t max_len, bool binary);
+
+// Move the read position to `cursor` (a position in the log, as counted by
+// ring head/tail) if the bytes from there on are still in the buffer; a
+// cursor outside that window leaves it unchanged, apart from catching up with
+// anything already overwritten. Returns the read position.
+uint32_t log_persist_seek(log_persist_t *persist, uint32_t cursor);
+
+#endif // LOG_PERSIST_H
@@ -0,0 +1,141 @@
+/**
+ * Lock-free byte ring implementation
+ *
+ * Each index has exactly one writer. The writer publishes head with a release
+ * store after copying the data in; the reader publishes tail with a release
+ * store after it is done with the data. The acquire loads on the other side
+ * guarantee the bytes are visible (or no longer needed) before the index is.
+ */
+
+#include "log_ring.h"
+#include "hot_path.h"
+#include <string.h>
+
+static inline uint32_t load_acquire(const uint32_t *p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void store_release(uint32_t *p, uint32_t v) {
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+bool log_ring_init(log_ring_t *ring, char *buffer, size_t size) {
+    if (size == 0 || (size & (size - 1)) != 0 || size > 0x80000000u) {
+        return false;
+    }
+    ring->buffer = buffer;
+    ring->mask = (uint32_t)size - 1;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->dropped = 0;
+    return true;
+}
+
+static inline uint32_t ring_size(const log_ring_t *ring) {
+    return ring->mask + 1;
+}
+
+size_t log_ring_free(const log_ring_t *ring) {
+    return ring_size(ring) - log_ring_available(ring);
+}
+
+size_t log_ring_available(const log_ring_t *ring) {
+    uint32_t unread = load_acquire(&ring->head) - ring->tail;
+    return (size_t)(unread > ring_size(ring) ? ring_size(ring) : unread);
+}
+
+void HOT_FUNC(log_ring_write)(log_ring_t *ring, const char *data, size_t len) {
+    uint32_t head = ring->head;
+
+    // Only the end of an oversized message can be kept
+    if (len > ring_size(ring)) {
+        head += (uint32_t)(len - ring_size(ring));
+        data += len - ring_size(ring);
+        len = ring_size(ring);
+    }
+
+    // At most two copies: up to the end of the buffer, then from the start
+    uint32_t start = head & ring->mask;
+    size_t first = ring_size(ring) - start;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(&ring->buffer[start], data, first);
+    memcpy(ring->buffer, data + first, len - first);
+
+    store_release(&ring->head, head + (uint32_t)len);
+}
+
+uint32_t log_ring_catch_up(log_ring_t *ring) {
+    uint32_t tail = ring->tail;
+    uint32_t head = load_acquire(&ring->head);
+    if (head - tail > ring_size(ring)) {
+        ring->dropped += head - ring_size(ring) - tail;
+        tail = head - ring_size(ring);
+        store_release(&ring->tail, tail);
+    }
+    return tail;
+}
+
+// Bytes from the read position on that the writer has overwritten, at most len
+static uint32_t overwritten(const log_ring_t *ring, uint32_t tail, size_t len) {
+    uint32_t lapped = load_acquire(&ring->head) - tail;
+    if (lapped <= ring_size(ring)) {
+        return 0;
+    }
+    lapped -= ring_size(ring);
+    return (lapped < len) ? lapped : (uint32_t)len;
+}
+
+size_t log_ring_peek(log_ring_t *ring, log_ring_spans_t *spans) {
+    uint32_t tail = log_ring_catch_up(ring);
+    size_t available = (size_t)(load_acquire(&ring->head) - tail);
+
+    uint32_t start = tail & ring->mask;
+    size_t first = ring_size(ring) - start;
+    if (first > available) {
+        first = available;
+    }
+
+    spans->data[0] = &ring->buffer[start];
+    spans->len[0] = first;
+    spans->data[1] = ring->buffer;
+    spans->len[1] = available - first;
+    return available;
+}
+
+// On a single core a writer that interrupts the reader has finished by the
+// time the reader resumes, so head read after using the data shows whether
+// any of it was overwritten meanwhile
+void log_ring_consume(log_ring_t *ring, size_t len) {
+    uint32_t tail = ring->tail;
+    uint32_t unread = load_acquire(&ring->head) - tail;
+    if (len > unread) {
+        len = unread;
+    }
+    ring->dropped += overwritten(ring, tail, len);
+    store_release(&ring->tail, tail + (uint32_t)len);
+}
+
+size_t log_ring_read(log_ring_t *ring, char *dest, size_t max_len) {
+    log_ring_spans_t spans;
+    log_ring_peek(ring, &spans);
+    uint32_t tail = ring->tail;
+
+    size_t first = (spans.len[0] < max_len) ? spans.len[0] : max_len;
+    size_t second = (spans.len[1] < max_len - first) ? spans.len[1] : max_len - first;
+    memcpy(dest, spans.data[0], first);
+    memcpy(dest + first, spans.data[1], second);
+
+    // Leave out the start of the copy if it was overwritten while copying
+    size_t copied = first + second;
+    uint32_t lost = overwritten(ring, tail, copied);
+    memmove(dest, dest + lost, copied - lost);
+    ring->dropped += lost;
+    store_release(&ring->tail, tail + (uint32_t)copied);
+    return copied - lost;
+}
+
+uint32_t log_ring_dropped(const log_ring_t *ring) {
+    return __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,75 @@
+/**
+ * Lock-free byte ring for log storage
+ *
+ * Single producer, single consumer: one context writes (log_printf on core 0)
+ * and one context reads (BLE / USB drain). Neither side takes a lock.
+ *
+ * - The size is a power of two; head and tail are free-running 32-bit byte
+ *   counters, so indexing is a mask and full/empty never need a spare slot.
+ * - Writes always succeed and cost at most two memcpy calls. The ring keeps
+ *   the newest bytes: a writer that laps the reader overwrites the oldest
+ *   unread data without touching tail.
+ * - The reader notices it was lapped (head - tail > size), skips to the
+ *   oldest byte still in the buffer and adds what it missed to the dropped
+ *   counter; a reader with a cursor sees the jump in the read position.
+ * - Reads are zero-copy: peek returns up to two spans pointing into the ring.
+ *   They stay valid until consumed unless the writer laps the reader in the
+ *   meantime; consume counts any bytes that were overwritten under the
+ *   reader as dropped, and log_ring_read leaves them out of the copy.
+ */
+
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct {
+    char *buffer;
+    uint32_t mask;      // size - 1
+    uint32_t head;      // Bytes ever written (owned by the writer)
+    uint32_t tail;      // Bytes ever consumed or skipped (owned by the reader)
+    uint32_t dropped;   // Bytes overwritten before they were read (owned by the reader)
+} log_ring_t;
+
+// Unread data as at most two contiguous pieces (second is empty unless wrapped)
+typedef struct {
+    const char *data[2];
+    size_t len[2];
+} log_ring_spans_t;
+
+// Use `buffer` (size must be a power of two) as an empty ring
+// Returns false if size is not a power of two
+bool log_ring_init(log_ring_t *ring, char *buffer, size_t size);
+
+// Writer: append len bytes, overwriting the oldest data if the ring is full
+// (of a message longer than the ring only the end is kept)
+void log_ring_write(log_ring_t *ring, const char *data, size_t len);
+
+// Bytes that can be written before unread data is overwritten
+size_t log_ring_free(const log_ring_t *ring);
+
+// Reader: unread bytes still in the buffer
+size_t log_ring_available(const log_ring_t *ring);
+
+// Reader: if the writer has lapped the reader, move the read position to the
+// oldest byte still in the buffer and count the bytes skipped as dropped.
+// Returns the read position (as counted by head/tail)
+uint32_t log_ring_catch_up(log_ring_t *ring);
+
+// Reader: describe the unread data without copying it (catches up first)
+// Returns the total number of unread bytes (len[0] + len[1])
+size_t log_ring_peek(log_ring_t *ring, log_ring_spans_t *spans);
+
+// Reader: release len bytes from the front of the unread data
+void log_ring_consume(log_ring_t *ring, size_t len);
+
+// Reader: copy up to max_len unread bytes into dest and consume them
+// Returns the number of bytes copied
+size_t log_ring_read(log_ring_t *ring, char *dest, size_t max_len);
+
+// Total bytes lost to overwriting since init (wraps at 2^32)
+uint32_t log_ring_dropped(const log_ring_t *ring);
+
+#endif // LOG_RING_H
@@ -0,0 +1,85 @@
+/**
+ * Log streaming implementation
+ *
+ * No BTstack calls here: the caller peeks the log, sends what this builds
+ * and consumes the bytes once att_server_notify() accepted the packet.
+ */
+
+#include "log_stream.h"
+#include <string.h>
+
+void log_stream_init(log_stream_t *stream) {
+    memset(stream, 0, sizeof(*stream));
+}
+
+void log_stream_enable(log_stream_t *stream, bool enabled) {
+    stream->enabled = enabled;
+    if (!enabled) {
+        stream->credits = 0;
+    }
+}
+
+void log_stream_grant(log_stream_t *stream, uint16_t credits) {
+    uint32_t total = (uint32_t)stream->credits + credits;
+    stream->credits = (total > 0xFFFF) ? 0xFFFF : (uint16_t)total;
+}
+
+bool log_stream_ready(const log_stream_t *stream, size_t available) {
+    return stream->enabled && stream->credits > 0 && available > 0;
+}
+
+size_t log_stream_build(const log_stream_t *stream, const log_ring_spans_t *spans, uint32_t cursor,
+                        uint8_t *out, size_t max_len) {
+    size_t available = spans->len[0] + spans->len[1];
+    if (!log_stream_ready(stream, available) || max_len <= LOG_STREAM_HEADER_SIZE) {
+        return 0;
+    }
+
+    out[0] = (uint8_t)cursor;
+    out[1] = (uint8_t)(cursor >> 8);
+    out[2] = (uint8_t)(cursor >> 16);
+    out[3] = (uint8_t)(cursor >> 24);
+
+    size_t room = max_len - LOG_STREAM_HEADER_SIZE;
+    size_t first = (spans->len[0] < room) ? spans->len[0] : room;
+    size_t second = (spans->len[1] < room - first) ? spans->len[1] : room - first;
+    memcpy(&out[LOG_STREAM_HEADER_SIZE], spans->data[0], first);
+    memcpy(&out[LOG_STREAM_HEADER_SIZE + first], spans->data[1], second);
+    return LOG_STREAM_HEADER_SIZE + first + second;
+}
+
+void log_stream_sent(log_stream_t *stream, size_t len) {
+    (void)len;
+    if (stream->credits > 0) {
+        stream->credits--;
+    }
+}
+
+void log_throughput_record(log_throughput_t *t, size_t bytes, bool drained, uint32_t now_us) {
+    if (!t->in_burst) {
+        if (bytes == 0) {
+            return;
+        }
+        t->in_burst = true;
+        t->burst_start_us = now_us;
+        t->burst_bytes = 0;
+    }
+    t->burst_bytes += (uint32_t)bytes;
+
+    if (drained) {
+        uint32_t duration = now_us - t->burst_start_us;
+        // A single packet has no duration and says nothing about the rate
+        if (duration > 0) {
+            t->bytes += t->burst_bytes;
+            t->busy_us += duration;
+        }
+        t->in_burst = false;
+    }
+}
+
+uint32_t log_throughput_bytes_per_sec(const log_throughput_t *t) {
+    if (t->busy_us == 0) {
+        return 0;
+    }
+    return (uint32_t)((uint64_t)t->bytes * 1000000u / t->busy_us);
+}
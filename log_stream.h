@@ -0,0 +1,78 @@
+/**
+ * Log streaming over BLE notifications
+ *
+ * The logs characteristic can be polled with reads (one ATT round trip per
+ * MTU) or, once the client enables notifications, pushes the log itself:
+ *
+ * - Notification: [cursor u32][log bytes]. The cursor is the position of the
+ *   first byte in the log (a free-running byte count), so the client sees any
+ *   gap and knows where to resume after a reconnect.
+ * - Write: [credits u16] or [credits u16][cursor u32]. Each notification costs
+ *   one credit, so the client bounds what is in flight to what it can take.
+ *   A cursor moves the read position back to data the client missed, if it
+ *   is still in the buffer (LOG_STREAM_CURSOR_CURRENT: keep the position).
+ *
+ * This module does the framing, credits and throughput accounting; the caller
+ * sends the notifications whenever BTstack can take one (can send now callback).
+ */
+
+#ifndef LOG_STREAM_H
+#define LOG_STREAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "log_ring.h"
+
+#define LOG_STREAM_HEADER_SIZE 4
+#define LOG_STREAM_CURSOR_CURRENT 0xFFFFFFFFu
+
+// Largest notification built (an LE data length extension packet: 251 - 4 - 3)
+#ifndef LOG_STREAM_MAX_PACKET
+#define LOG_STREAM_MAX_PACKET 244
+#endif
+
+// Bytes per second while a backlog is being drained
+// A burst runs from the first packet that carries data to the one that leaves
+// nothing unread; time spent waiting for credits or buffers counts.
+typedef struct {
+    uint32_t bytes;         // Delivered in completed bursts
+    uint32_t busy_us;       // Duration of completed bursts
+    uint32_t burst_bytes;
+    uint32_t burst_start_us;
+    bool in_burst;
+} log_throughput_t;
+
+typedef struct {
+    bool enabled;           // Client enabled notifications
+    uint16_t credits;       // Notifications the client can still take
+    log_throughput_t throughput;
+} log_stream_t;
+
+void log_stream_init(log_stream_t *stream);
+
+// Notifications turned on or off (CCCD write, disconnect); off drops the credits
+void log_stream_enable(log_stream_t *stream, bool enabled);
+
+// Add credits from a client write (saturates at 65535)
+void log_stream_grant(log_stream_t *stream, uint16_t credits);
+
+// Whether a notification could be sent with `available` unread log bytes
+bool log_stream_ready(const log_stream_t *stream, size_t available);
+
+// Build one notification in `out` from the unread log (up to max_len bytes,
+// header included); `cursor` is the log position of spans->data[0].
+// Returns the packet length, or 0 if there is nothing to send.
+size_t log_stream_build(const log_stream_t *stream, const log_ring_spans_t *spans, uint32_t cursor,
+                        uint8_t *out, size_t max_len);
+
+// A packet of `len` bytes was queued: takes one credit
+void log_stream_sent(log_stream_t *stream, size_t len);
+
+// Account `bytes` delivered at now_us; `drained` when nothing is left unread
+void log_throughput_record(log_throughput_t *t, size_t bytes, bool drained, uint32_t now_us);
+
+// Average over completed bursts, 0 until there has been one
+uint32_t log_throughput_bytes_per_sec(const log_throughput_t *t);
+
+#endif // LOG_STREAM_H
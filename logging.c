@@ -1,46 +1,145 @@
 #include "logging.h"
-#include "pico/sync.h"
+#include "log_ring.h"
+#include "log_persist.h"
+#include "hot_path.h"
 #include <stdio.h>
 #include <stdarg.h>
 #include <string.h>
+#include "pico.h"
+#include "pico/stdio_usb.h"
+#include "hardware/sync.h"
+#include "hardware/watchdog.h"
+#include "hardware/structs/scb.h"
+#include "hardware/structs/vreg_and_chip_reset.h"
+#include "tusb.h"
 
-// Circular buffer configuration
+// Set for the firmware target by CMakeLists.txt (see walkolution-odometer.c)
+#ifndef BLE_BACKGROUND
+#define BLE_BACKGROUND 0
+#endif
+
+#if LOG_BINARY
+#include "hardware/timer.h"
+#include "log_strings.h" // Generated by tools/log_strings.py
+#endif
+
+// Circular buffer configuration (must be a power of two)
 #define LOG_BUFFER_SIZE (64 * 1024)  // 64KB buffer
 
-// Circular buffer state
-static char log_buffer[LOG_BUFFER_SIZE];
-static volatile uint32_t write_index = 0;  // Current write position
-static volatile uint32_t read_index = 0;   // Last read position (for get_new_logs)
-static mutex_t log_mutex;
+// USB copy of the log, drained by logging_drain_usb (must be a power of two)
+// Only needs to cover bursts between main loop passes, e.g. at boot
+#ifndef LOG_USB_BUFFER_SIZE
+#define LOG_USB_BUFFER_SIZE (8 * 1024)
+#endif
+
+// Previous boot's log made unread again at boot, for the BLE logs characteristic
+#ifndef LOG_RETAINED_REPLAY_BYTES
+#define LOG_RETAINED_REPLAY_BYTES (8 * 1024)
+#endif
+
+// Stack words the hard fault handler scans for return addresses
+#define CRASH_STACK_SCAN_WORDS 256
+
+// Lock-free rings: log_printf is the only writer of both, the BLE logs
+// characteristic the only reader of log_ring and logging_drain_usb of usb_ring
+// A full ring overwrites its oldest bytes, so each keeps the newest log
+// All log_printf calls must come from core 0. With BLE_BACKGROUND the BLE code
+// logs from an IRQ, so messages go into the rings with interrupts disabled
+// The BLE ring and its indices are not cleared at boot (see log_persist.h)
+static char __uninitialized_ram(log_buffer)[LOG_BUFFER_SIZE];
+static log_persist_t __uninitialized_ram(log_persist);
+static log_ring_t* const log_ring = &log_persist.ring;
+static char usb_buffer[LOG_USB_BUFFER_SIZE];
+static log_ring_t usb_ring;
+
+// Bytes USB serial missed that it has already announced
+static uint32_t usb_dropped_reported = 0;
+
+// Run-time level per tag (see LOG_AT in logging.h)
+uint8_t log_tag_levels[LOG_TAG_COUNT] = { [0 ... LOG_TAG_COUNT - 1] = LOG_LEVEL_DEFAULT };
+
+// What ended the previous boot (logging_get_boot_info)
+static log_crash_t previous_crash;
+static logging_boot_info_t boot_info;
+
+static logging_reset_t read_reset_reason(void) {
+    if (previous_crash.magic == LOG_CRASH_MAGIC) {
+        return LOGGING_RESET_HARD_FAULT;
+    }
+    if (watchdog_caused_reboot()) {
+        // watchdog_enable() marks its scratch register; watchdog_reboot() does not
+        return watchdog_enable_caused_reboot() ? LOGGING_RESET_WATCHDOG : LOGGING_RESET_SOFTWARE;
+    }
+    uint32_t chip_reset = vreg_and_chip_reset_hw->chip_reset;
+    if (chip_reset & VREG_AND_CHIP_RESET_CHIP_RESET_HAD_PSM_RESTART_BITS) {
+        return LOGGING_RESET_DEBUGGER;
+    }
+    if (chip_reset & VREG_AND_CHIP_RESET_CHIP_RESET_HAD_RUN_BITS) {
+        return LOGGING_RESET_RUN_PIN;
+    }
+    return LOGGING_RESET_POWER_ON;
+}
 
 // Initialize the logging system
+// Keeps the log of the previous boot if SRAM survived the reset
 void logging_init(void) {
-    mutex_init(&log_mutex);
-    write_index = 0;
-    read_index = 0;
-    memset(log_buffer, 0, LOG_BUFFER_SIZE);
-}
+    bool retained = log_persist_restore(&log_persist, log_buffer, LOG_BUFFER_SIZE, &previous_crash);
+    boot_info.boot_count = log_persist.boot_count;
+    boot_info.reset = read_reset_reason();
+    boot_info.retained_bytes = retained ? log_persist_rewind(&log_persist, LOG_RETAINED_REPLAY_BYTES, LOG_BINARY) : 0;
+    boot_info.crash = (previous_crash.magic == LOG_CRASH_MAGIC) ? &previous_crash : NULL;
+
+    log_ring_init(&usb_ring, usb_buffer, LOG_USB_BUFFER_SIZE);
+    usb_dropped_reported = 0;
 
-// Internal function to write data to the circular buffer
-static void write_to_buffer(const char* data, size_t len) {
-    mutex_enter_blocking(&log_mutex);
+#if LOG_BINARY
+    // Lets the decoder check that its string table matches this firmware
+    log_binary_record_t rec;
+    log_binary_begin(&rec, 0, LOG_BINARY_SITE_BOOT);
+    log_binary_put_u32(&rec, LOG_STRINGS_HASH);
+    log_binary_commit(&rec);
+#endif
+}
 
-    for (size_t i = 0; i < len; i++) {
-        log_buffer[write_index] = data[i];
-        write_index = (write_index + 1) % LOG_BUFFER_SIZE;
+// Build the "N bytes dropped" marker for USB serial in the current log format
+static size_t make_dropped_marker(char* marker, size_t size, uint32_t dropped) {
+#if LOG_BINARY
+    (void)size; // Records are always shorter than the marker buffer
+    log_binary_record_t rec;
+    log_binary_begin(&rec, 0, LOG_BINARY_SITE_DROPPED);
+    log_binary_put_u32(&rec, dropped);
+    size_t len = log_binary_finish(&rec, time_us_32());
+    memcpy(marker, rec.data, len);
+    return len;
+#else
+    return (size_t)snprintf(marker, size, "[LOG] %lu bytes dropped\n", (unsigned long)dropped);
+#endif
+}
 
-        // If we've wrapped around and caught up to the read index,
-        // move the read index forward to avoid reading stale/overwritten data
-        if (write_index == read_index) {
-            read_index = (read_index + 1) % LOG_BUFFER_SIZE;
-        }
-    }
+// The same bytes go to the BLE and USB rings, so each reader loses data only
+// when it falls behind itself. Only with BLE_BACKGROUND is there a second
+// writer (the BLE IRQ) to keep out; otherwise the rings need no masking
+static void HOT_FUNC(write_to_buffer)(const char* data, size_t len) {
+#if BLE_BACKGROUND
+    uint32_t ints = save_and_disable_interrupts();
+#endif
+    log_ring_write(log_ring, data, len);
+    log_ring_write(&usb_ring, data, len);
+#if BLE_BACKGROUND
+    restore_interrupts(ints);
+#endif
+}
 
-    mutex_exit(&log_mutex);
+#if LOG_BINARY
+// Binary mode: log_printf() call sites end here (see log_binary.h)
+void HOT_FUNC(log_binary_commit)(log_binary_record_t* rec) {
+    size_t len = log_binary_finish(rec, time_us_32());
+    write_to_buffer((const char*)rec->data, len);
 }
+#else
 
 // Printf-style logging function
-// Logs to both stdout (USB serial) and the circular buffer
+// Formats once into the circular buffers; USB output happens in logging_drain_usb
 int log_printf(const char* format, ...) {
     char temp_buffer[256];  // Temporary buffer for formatting
     va_list args;
@@ -50,15 +149,62 @@ int log_printf(const char* format, ...) {
     int result = vsnprintf(temp_buffer, sizeof(temp_buffer), format, args);
     va_end(args);
 
-    // Output to stdout (USB serial)
-    printf("%s", temp_buffer);
-
-    // Also store in circular buffer (truncate if too long)
+    // Store in the circular buffers (truncate if too long)
     size_t len = (result < sizeof(temp_buffer)) ? result : (sizeof(temp_buffer) - 1);
     write_to_buffer(temp_buffer, len);
 
     return result;
 }
+#endif
+
+// Send as much of the USB copy as the CDC endpoint takes without waiting
+// stdio_usb's out_chars only blocks when the TX FIFO is full, so never hand it
+// more than tud_cdc_write_available() reports. Without a host the data is
+// discarded, as printf did, so a terminal opened later starts with fresh logs.
+// When the host fell behind and the ring overwrote output it had not sent, a
+// marker says how much is missing before the output continues
+void logging_drain_usb(void) {
+    if (!stdio_usb_connected()) {
+        log_ring_consume(&usb_ring, log_ring_available(&usb_ring));
+        usb_dropped_reported = log_ring_dropped(&usb_ring);
+        return;
+    }
+
+    log_ring_spans_t spans;
+    size_t available = log_ring_peek(&usb_ring, &spans);
+    size_t space = tud_cdc_write_available();
+
+    uint32_t dropped = log_ring_dropped(&usb_ring);
+    if (dropped != usb_dropped_reported) {
+        char marker[48];
+        size_t marker_len = make_dropped_marker(marker, sizeof(marker), dropped - usb_dropped_reported);
+        if (space < marker_len) {
+            return;
+        }
+        stdio_usb.out_chars(marker, (int)marker_len);
+        space -= marker_len;
+        usb_dropped_reported = dropped;
+    }
+
+    if (available == 0) {
+        return;
+    }
+
+    size_t sent = 0;
+    for (int i = 0; i < 2 && space > 0; i++) {
+        size_t n = (spans.len[i] < space) ? spans.len[i] : space;
+        if (n > 0) {
+            stdio_usb.out_chars(spans.data[i], (int)n);
+            sent += n;
+            space -= n;
+        }
+    }
+    log_ring_consume(&usb_ring, sent);
+}
+
+uint32_t logging_get_usb_dropped_bytes(void) {
+    return log_ring_dropped(&usb_ring);
+}
 
 // Get logs accumulated since the last call to this function
 // Returns number of bytes copied, or 0 if no new logs
@@ -67,59 +213,128 @@ size_t logging_get_new_logs(char* dest_buffer, size_t max_len) {
     if (dest_buffer == NULL || max_len == 0) {
         return 0;
     }
+    return log_ring_read(log_ring, dest_buffer, max_len);
+}
 
-    mutex_enter_blocking(&log_mutex);
+size_t logging_peek_logs(logging_spans_t* spans) {
+    return log_ring_peek(log_ring, spans);
+}
 
-    size_t available = 0;
-    uint32_t current_read = read_index;
-    uint32_t current_write = write_index;
+void logging_consume_logs(size_t len) {
+    log_ring_consume(log_ring, len);
+}
 
-    // Calculate how many bytes are available
-    if (current_write >= current_read) {
-        available = current_write - current_read;
-    } else {
-        available = (LOG_BUFFER_SIZE - current_read) + current_write;
-    }
+uint32_t logging_get_read_cursor(void) {
+    return log_ring_catch_up(log_ring);
+}
 
-    // Limit to the destination buffer size
-    size_t to_copy = (available < max_len) ? available : max_len;
+uint32_t logging_seek_logs(uint32_t cursor) {
+    return log_persist_seek(&log_persist, cursor);
+}
 
-    if (to_copy == 0) {
-        mutex_exit(&log_mutex);
-        return 0;
-    }
+// Get the total number of unread bytes in the log buffer
+size_t logging_get_available_bytes(void) {
+    return log_ring_available(log_ring);
+}
+
+uint32_t logging_get_dropped_bytes(void) {
+    return log_ring_dropped(log_ring);
+}
 
-    // Copy data from circular buffer
-    size_t copied = 0;
-    while (copied < to_copy) {
-        dest_buffer[copied] = log_buffer[current_read];
-        current_read = (current_read + 1) % LOG_BUFFER_SIZE;
-        copied++;
+bool logging_set_tag_level(uint8_t tag, uint8_t level) {
+    if (tag >= LOG_TAG_COUNT || level > LOG_LEVEL_VERBOSE) {
+        return false;
     }
+    // Messages above LOG_LEVEL_MAX are not in the build
+    log_tag_levels[tag] = (level > LOG_LEVEL_MAX) ? LOG_LEVEL_MAX : level;
+    return true;
+}
+
+size_t logging_get_tag_levels(uint8_t* dest, size_t max_len) {
+    size_t len = (max_len < LOG_TAG_COUNT) ? max_len : LOG_TAG_COUNT;
+    memcpy(dest, log_tag_levels, len);
+    return len;
+}
 
-    // Update read index to mark these logs as read
-    read_index = current_read;
+const logging_boot_info_t* logging_get_boot_info(void) {
+    return &boot_info;
+}
 
-    mutex_exit(&log_mutex);
+// Hard fault capture
+// The handler stores the exception frame and a backtrace in the retained area,
+// then reboots through the watchdog; the next boot reports them. It must not
+// touch the faulting context's stack beyond reading it, nor log.
 
-    return copied;
+static bool is_sram(uint32_t addr) {
+    return addr >= SRAM_BASE && addr < SRAM_END;
 }
 
-// Get the total number of unread bytes in the log buffer
-size_t logging_get_available_bytes(void) {
-    mutex_enter_blocking(&log_mutex);
+// Thumb return address: odd, in code, right after a BL or BLX
+static bool is_return_address(uint32_t value) {
+    uint32_t addr = value & ~1u;
+    bool in_flash = addr >= XIP_BASE + 4 && addr < XIP_BASE + PICO_FLASH_SIZE_BYTES;
+    if (!(value & 1u) || !(in_flash || (is_sram(addr - 4) && is_sram(addr)))) {
+        return false;
+    }
+    const uint16_t* code = (const uint16_t*)(uintptr_t)addr;
+    if ((code[-1] & 0xFF87) == 0x4780) {
+        return true; // BLX Rm
+    }
+    return (code[-2] & 0xF800) == 0xF000 && (code[-1] & 0xD000) == 0xD000; // BL
+}
+
+static void __attribute__((used, noreturn)) hard_fault_record(uint32_t* frame, uint32_t exc_return) {
+    extern uint32_t __StackTop;
+    log_crash_t* crash = &log_persist.crash;
+    uint32_t sp = (uint32_t)(uintptr_t)frame;
+
+    memset(crash, 0, sizeof(*crash));
+    crash->exc_return = exc_return;
+    crash->icsr = scb_hw->icsr;
 
-    size_t available = 0;
-    uint32_t current_write = write_index;
-    uint32_t current_read = read_index;
+    // A stack overflow can leave the frame pointer outside RAM
+    if (is_sram(sp) && is_sram(sp + 31)) {
+        for (int i = 0; i < 4; i++) {
+            crash->r[i] = frame[i];
+        }
+        crash->r12 = frame[4];
+        crash->lr = frame[5];
+        crash->pc = frame[6];
+        crash->xpsr = frame[7];
+        crash->sp = sp + 32 + ((frame[7] & (1u << 9)) ? 4 : 0); // Bit 9: aligned with padding
 
-    if (current_write >= current_read) {
-        available = current_write - current_read;
-    } else {
-        available = (LOG_BUFFER_SIZE - current_read) + current_write;
+        // No frame pointers on this build, so look for anything that could be a
+        // return address between the frame and the top of the stack
+        const uint32_t* word = (const uint32_t*)(uintptr_t)crash->sp;
+        const uint32_t* top = &__StackTop;
+        for (int n = 0; n < CRASH_STACK_SCAN_WORDS && word < top && crash->depth < LOG_CRASH_BACKTRACE_DEPTH; n++, word++) {
+            if (is_return_address(*word)) {
+                crash->backtrace[crash->depth++] = *word & ~1u;
+            }
+        }
     }
 
-    mutex_exit(&log_mutex);
+    crash->magic = LOG_CRASH_MAGIC;
+    watchdog_reboot(0, 0, 0);
+    while (true) {
+        tight_loop_contents();
+    }
+}
 
-    return available;
+// Overrides the SDK's weak handler. Passes the stack the exception frame was
+// pushed to (EXC_RETURN bit 2 selects PSP) and EXC_RETURN itself.
+void __attribute__((naked)) isr_hardfault(void) {
+    __asm volatile(
+        "movs r0, #4\n"
+        "mov r1, lr\n"
+        "tst r0, r1\n"
+        "beq 1f\n"
+        "mrs r0, psp\n"
+        "b 2f\n"
+        "1:\n"
+        "mrs r0, msp\n"
+        "2:\n"
+        "ldr r2, =hard_fault_record\n"
+        "bx r2\n"
+        ".ltorg\n");
 }
@@ -2,28 +2,196 @@
 #define LOGGING_H
 
 #include <stdarg.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include "log_ring.h"
+#include "log_persist.h"
+
+// LOG_BINARY=1 turns log_printf into a macro that writes binary records
+// decoded on the host (see log_binary.h)
+#ifndef LOG_BINARY
+#define LOG_BINARY 0
+#endif
 
 // Initialize the logging system
 // Must be called before using any other logging functions
+// If SRAM survived the reset, the end of the previous boot's log (up to
+// LOG_RETAINED_REPLAY_BYTES) is unread again, ahead of this boot's messages
 void logging_init(void);
 
+// What ended the previous boot
+typedef enum {
+    LOGGING_RESET_POWER_ON = 0,     // Power-on or brown-out: no log retained
+    LOGGING_RESET_RUN_PIN,
+    LOGGING_RESET_DEBUGGER,
+    LOGGING_RESET_WATCHDOG,         // Watchdog timer expired
+    LOGGING_RESET_SOFTWARE,         // watchdog_reboot(), e.g. from picotool
+    LOGGING_RESET_HARD_FAULT,       // Fault handler rebooted (see crash)
+} logging_reset_t;
+
+typedef struct {
+    uint32_t boot_count;            // Boots since the log was last started empty
+    logging_reset_t reset;
+    size_t retained_bytes;          // Previous log unread again (0 if not retained)
+    const log_crash_t* crash;       // Hard fault that ended the previous boot, or NULL
+} logging_boot_info_t;
+
+// Filled in by logging_init
+const logging_boot_info_t* logging_get_boot_info(void);
+
+// Never called: gives printf format checking to log calls that are compiled out
+static inline __attribute__((format(printf, 1, 2))) void log_check_format(const char* format, ...) {
+    (void)format;
+}
+
 // Printf-style logging function
-// Logs to both USB serial (printf) and the circular buffer in RAM
+// Logs to the circular buffer in RAM and the USB copy (see logging_drain_usb)
+// Call from core 0 only: the main loop or BTstack callbacks. With BLE_BACKGROUND
+// the callbacks run from an IRQ, so messages are written with interrupts off
+// If the buffer is full the oldest unread bytes are overwritten, so it always
+// holds the newest log (see logging_get_dropped_bytes)
 // Returns the number of characters that would have been written (like printf)
+// With LOG_BINARY=1 it is a statement that only writes a record to the buffer
+#if LOG_BINARY
+#include "log_binary.h"
+#else
 int log_printf(const char* format, ...);
+#endif
+
+// Log levels and subsystem tags
+//
+// LOG_ERROR / LOG_WARN / LOG_INFO / LOG_DEBUG / LOG_VERBOSE(tag, format, ...)
+// log like log_printf when the message is enabled:
+// - Levels above LOG_LEVEL_MAX (build time, CMake option of the same name)
+//   compile out completely; arguments are still type-checked but not evaluated.
+// - The rest are filtered at run time by a per-tag level, LOG_LEVEL_DEFAULT
+//   at boot and adjustable over BLE (logging_set_tag_level), at the cost of
+//   one byte load and compare per call.
+// The tag does not add a prefix; messages keep their own "[BLE]" etc.
+// Levels are plain numbers so LOG_LEVEL_MAX can be tested by the preprocessor
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4       // Flash record dumps, per-request BLE details
+#define LOG_LEVEL_VERBOSE 5     // Per-second status line, every ATT write
+
+// Values are part of the BLE log levels characteristic: only append
+typedef enum {
+    LOG_TAG_SYSTEM = 0,      // Startup, main loop, power
+    LOG_TAG_BLE = 1,
+    LOG_TAG_FLASH = 2,
+    LOG_TAG_SESSION = 3,
+    LOG_TAG_SPEED = 4,
+    LOG_TAG_SETTINGS = 5,
+    LOG_TAG_TIME = 6,
+    LOG_TAG_DISPLAY = 7,
+    LOG_TAG_PERF = 8,
+    LOG_TAG_COUNT
+} log_tag_t;
+
+#ifndef LOG_LEVEL_MAX
+#define LOG_LEVEL_MAX LOG_LEVEL_DEBUG
+#endif
+
+#ifndef LOG_LEVEL_DEFAULT
+#define LOG_LEVEL_DEFAULT LOG_LEVEL_INFO
+#endif
+
+// Current level per tag (read inline by the LOG_* macros)
+extern uint8_t log_tag_levels[LOG_TAG_COUNT];
+
+#define LOG_AT(level, tag, ...) do { \
+        if (log_tag_levels[tag] >= (level)) { \
+            log_printf(__VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOG_DISABLED(tag, ...) do { \
+        if (0) { \
+            (void)(tag); \
+            log_check_format(__VA_ARGS__); \
+        } \
+    } while (0)
+
+#if LOG_LEVEL_MAX >= LOG_LEVEL_ERROR
+#define LOG_ERROR(tag, ...) LOG_AT(LOG_LEVEL_ERROR, tag, __VA_ARGS__)
+#else
+#define LOG_ERROR(tag, ...) LOG_DISABLED(tag, __VA_ARGS__)
+#endif
+
+#if LOG_LEVEL_MAX >= LOG_LEVEL_WARN
+#define LOG_WARN(tag, ...) LOG_AT(LOG_LEVEL_WARN, tag, __VA_ARGS__)
+#else
+#define LOG_WARN(tag, ...) LOG_DISABLED(tag, __VA_ARGS__)
+#endif
+
+#if LOG_LEVEL_MAX >= LOG_LEVEL_INFO
+#define LOG_INFO(tag, ...) LOG_AT(LOG_LEVEL_INFO, tag, __VA_ARGS__)
+#else
+#define LOG_INFO(tag, ...) LOG_DISABLED(tag, __VA_ARGS__)
+#endif
+
+#if LOG_LEVEL_MAX >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(tag, ...) LOG_AT(LOG_LEVEL_DEBUG, tag, __VA_ARGS__)
+#else
+#define LOG_DEBUG(tag, ...) LOG_DISABLED(tag, __VA_ARGS__)
+#endif
+
+#if LOG_LEVEL_MAX >= LOG_LEVEL_VERBOSE
+#define LOG_VERBOSE(tag, ...) LOG_AT(LOG_LEVEL_VERBOSE, tag, __VA_ARGS__)
+#else
+#define LOG_VERBOSE(tag, ...) LOG_DISABLED(tag, __VA_ARGS__)
+#endif
+
+// Set the run-time level of one tag (levels above LOG_LEVEL_MAX are clamped)
+// Returns false if the tag or level is out of range
+bool logging_set_tag_level(uint8_t tag, uint8_t level);
+
+// Copy the current level of every tag (indexed by log_tag_t) into dest
+// Returns the number of bytes written (at most LOG_TAG_COUNT)
+size_t logging_get_tag_levels(uint8_t* dest, size_t max_len);
 
 // Get new log data accumulated since the last call to this function
 // Copies unread logs into dest_buffer (up to max_len bytes)
 // Returns the number of bytes copied (0 if no new logs available)
-// Thread-safe: can be called from any core
+// At most two memcpy calls; must be called from a single reader context
 // Note: Each call advances the read pointer, so logs are only returned once
 size_t logging_get_new_logs(char* dest_buffer, size_t max_len);
 
+// Zero-copy read: describe the unread logs as up to two spans in the buffer
+// The spans stay valid until logging_consume_logs() releases them
+// Returns the total number of unread bytes
+typedef log_ring_spans_t logging_spans_t;
+size_t logging_peek_logs(logging_spans_t* spans);
+
+// Release len bytes from the front of the unread logs (after logging_peek_logs)
+void logging_consume_logs(size_t len);
+
+// Position of the next unread byte in the log (free-running byte count)
+// Moves past anything already overwritten, so a jump means lost bytes
+uint32_t logging_get_read_cursor(void);
+
+// Continue reading at `cursor` if that part of the log is still buffered
+// (e.g. where a BLE client's stream broke off); returns the read position
+uint32_t logging_seek_logs(uint32_t cursor);
+
 // Get the number of unread bytes currently available in the log buffer
 // Useful for checking if there are new logs before calling logging_get_new_logs
 // Returns the number of bytes available to read
 size_t logging_get_available_bytes(void);
 
+// Total bytes of log the reader lost because newer messages overwrote them
+uint32_t logging_get_dropped_bytes(void);
+
+// Copy pending log output to USB serial, as much as the CDC endpoint can take
+// right now - never blocks. Call from the main loop (core 0).
+// Output is raw: "\n" line endings, binary records with LOG_BINARY=1.
+void logging_drain_usb(void);
+
+// Total bytes of log messages that USB serial missed because the host fell
+// behind by more than LOG_USB_BUFFER_SIZE (without a host it is discarded)
+uint32_t logging_get_usb_dropped_bytes(void);
+
 #endif // LOGGING_H
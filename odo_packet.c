@@ -0,0 +1,159 @@
+/**
+ * Compact odometer notifications implementation
+ */
+
+#include "odo_packet.h"
+#include <string.h>
+
+// Smallest change worth a packet
+static uint32_t field_threshold(int field)
+{
+    switch (field)
+    {
+    case ODO_FIELD_RUNNING_SPEED:
+    case ODO_FIELD_SESSION_SPEED:
+        return ODO_PACKET_SPEED_THRESHOLD;
+    case ODO_FIELD_VOLTAGE:
+        return ODO_PACKET_VOLTAGE_THRESHOLD_MV;
+    default:
+        return 1;
+    }
+}
+
+static bool field_changed(int field, uint32_t sent, uint32_t value)
+{
+    if (value == sent)
+    {
+        return false;
+    }
+    if (value == 0 && field != ODO_FIELD_VOLTAGE)
+    {
+        return true; // Stopped: report it even below the threshold
+    }
+    uint32_t diff = (value > sent) ? value - sent : sent - value;
+    return diff >= field_threshold(field);
+}
+
+static uint8_t *put_varint(uint8_t *out, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        *out++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (uint8_t)value;
+    return out;
+}
+
+static const uint8_t *get_varint(const uint8_t *in, const uint8_t *end, uint32_t *value)
+{
+    uint32_t result = 0;
+
+    for (int shift = 0; shift < 35 && in < end; shift += 7)
+    {
+        uint8_t b = *in++;
+        result |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80))
+        {
+            *value = result;
+            return in;
+        }
+    }
+    return NULL;
+}
+
+// Signed difference, small either way: 0, -1, 1, -2, ... -> 0, 1, 2, 3, ...
+static uint32_t zigzag(uint32_t value, uint32_t base)
+{
+    int32_t diff = (int32_t)(value - base);
+    return ((uint32_t)diff << 1) ^ (uint32_t)(diff >> 31);
+}
+
+static uint32_t unzigzag(uint32_t encoded, uint32_t base)
+{
+    return base + ((encoded >> 1) ^ (0u - (encoded & 1)));
+}
+
+void odo_encoder_reset(odo_encoder_t *enc)
+{
+    memset(enc, 0, sizeof(*enc));
+}
+
+size_t odo_packet_encode(odo_encoder_t *enc, const odo_values_t *values, uint32_t now_ms, uint8_t *out)
+{
+    bool keyframe = !enc->have_sent || (now_ms - enc->last_sent_ms) >= ODO_PACKET_KEEPALIVE_MS;
+    uint16_t bitmap = 0;
+
+    for (int field = 0; field < ODO_FIELD_COUNT; field++)
+    {
+        if (keyframe || field_changed(field, enc->sent.field[field], values->field[field]))
+        {
+            bitmap |= (uint16_t)(1u << field);
+        }
+    }
+    if (bitmap == 0)
+    {
+        return 0;
+    }
+    if (keyframe)
+    {
+        bitmap |= ODO_PACKET_KEYFRAME;
+    }
+
+    uint8_t *p = out;
+    *p++ = ODO_PACKET_VERSION;
+    *p++ = (uint8_t)bitmap;
+    *p++ = (uint8_t)(bitmap >> 8);
+    for (int field = 0; field < ODO_FIELD_COUNT; field++)
+    {
+        if (!(bitmap & (1u << field)))
+        {
+            continue;
+        }
+        uint32_t value = values->field[field];
+        p = put_varint(p, keyframe ? value : zigzag(value, enc->sent.field[field]));
+        enc->sent.field[field] = value;
+    }
+
+    enc->have_sent = true;
+    enc->last_sent_ms = now_ms;
+    return (size_t)(p - out);
+}
+
+bool odo_packet_decode(const uint8_t *data, size_t len, odo_values_t *values, bool *have_keyframe)
+{
+    if (len < 3 || data[0] != ODO_PACKET_VERSION)
+    {
+        return false;
+    }
+
+    uint16_t bitmap = (uint16_t)(data[1] | (data[2] << 8));
+    bool keyframe = (bitmap & ODO_PACKET_KEYFRAME) != 0;
+    if (!keyframe && !*have_keyframe)
+    {
+        return false;
+    }
+
+    // Decode into a copy so a bad packet leaves the values alone
+    odo_values_t decoded = *values;
+    const uint8_t *p = data + 3;
+    const uint8_t *end = data + len;
+    for (int field = 0; field < ODO_FIELD_COUNT; field++)
+    {
+        if (!(bitmap & (1u << field)))
+        {
+            continue;
+        }
+        uint32_t raw;
+        p = get_varint(p, end, &raw);
+        if (p == NULL)
+        {
+            return false;
+        }
+        decoded.field[field] = keyframe ? raw : unzigzag(raw, values->field[field]);
+    }
+
+    *values = decoded;
+    *have_keyframe = true;
+    return true;
+}
@@ -0,0 +1,91 @@
+/**
+ * Compact odometer notifications (format v2)
+ *
+ * The v1 notification is the full 33-byte odometer_data_t every second, sent
+ * even when nothing changed. A v2 notification carries only the fields that
+ * changed since the last one sent:
+ *
+ *   [version = 2][bitmap u16 LE][one varint per bitmap bit, in bit order]
+ *
+ * Bitmap bits 0-8 are the odo_field_t fields. In a keyframe (bit 15) every
+ * field is present as its plain value (unsigned LEB128); otherwise each present
+ * field is the zigzag LEB128 difference from the value in the last packet.
+ * The first packet after a reset is a keyframe, and so is a keepalive sent
+ * after ODO_PACKET_KEEPALIVE_MS without one.
+ *
+ * Speeds and voltage are only sent when they move by their threshold, against
+ * the value last sent so slow drift still gets reported; a speed dropping to
+ * zero is always sent. Nothing here touches hardware, so it runs in the host
+ * tests, together with the decoder the tests use to check the round trip.
+ */
+
+#ifndef ODO_PACKET_H
+#define ODO_PACKET_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define ODO_PACKET_VERSION 2
+
+#define ODO_PACKET_KEYFRAME 0x8000
+
+// Largest packet: header plus every field as a 5-byte varint
+#define ODO_PACKET_MAX_SIZE (3 + 5 * ODO_FIELD_COUNT)
+
+#ifndef ODO_PACKET_KEEPALIVE_MS
+#define ODO_PACKET_KEEPALIVE_MS 30000      // Keyframe at least this often
+#endif
+
+#ifndef ODO_PACKET_SPEED_THRESHOLD
+#define ODO_PACKET_SPEED_THRESHOLD 5       // Hundredths of mph or km/h
+#endif
+
+#ifndef ODO_PACKET_VOLTAGE_THRESHOLD_MV
+#define ODO_PACKET_VOLTAGE_THRESHOLD_MV 50
+#endif
+
+// Bitmap bit of each field: only append
+typedef enum
+{
+    ODO_FIELD_SESSION_ROTATIONS = 0,
+    ODO_FIELD_TOTAL_ROTATIONS = 1,
+    ODO_FIELD_SESSION_TIME = 2,
+    ODO_FIELD_TOTAL_TIME = 3,
+    ODO_FIELD_RUNNING_SPEED = 4,
+    ODO_FIELD_SESSION_SPEED = 5,
+    ODO_FIELD_VOLTAGE = 6,
+    ODO_FIELD_SESSION_ID = 7,
+    ODO_FIELD_METRIC = 8,
+    ODO_FIELD_COUNT
+} odo_field_t;
+
+// Values of one notification, indexed by odo_field_t. Speeds are hundredths
+// of mph or km/h (per the metric field: 0=miles, 1=km)
+typedef struct
+{
+    uint32_t field[ODO_FIELD_COUNT];
+} odo_values_t;
+
+// What the client last received
+typedef struct
+{
+    odo_values_t sent;
+    bool have_sent;                // False: next packet is a keyframe
+    uint32_t last_sent_ms;
+} odo_encoder_t;
+
+// Forget what was sent; the next packet is a keyframe
+void odo_encoder_reset(odo_encoder_t *enc);
+
+// Build the packet for `values` into out (ODO_PACKET_MAX_SIZE bytes).
+// Returns its length, or 0 when nothing changed enough to send.
+// A returned packet counts as sent: reset the encoder if it can't be delivered.
+size_t odo_packet_encode(odo_encoder_t *enc, const odo_values_t *values, uint32_t now_ms, uint8_t *out);
+
+// Apply a packet to the client's copy of the values.
+// Returns false (values untouched) for another version, a truncated packet,
+// or a delta before any keyframe (have_keyframe tracks that).
+bool odo_packet_decode(const uint8_t *data, size_t len, odo_values_t *values, bool *have_keyframe);
+
+#endif // ODO_PACKET_H
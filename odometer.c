@@ -6,7 +6,9 @@
 #include "flash.h"
 #include "logging.h"
 #include "irq.h"
+#include "diag.h"
 #include "speed.h"
+#include "timebase.h"
 #include "pico/stdlib.h"
 #include "hardware/flash.h"
 #include "hardware/adc.h"
@@ -36,10 +38,7 @@ typedef struct
 typedef struct
 {
     uint32_t current_session_id;      // Current session ID
-    uint32_t session_start_time_unix; // Unix timestamp when Pico booted (calculated)
-    uint32_t time_reference_unix;     // Reference Unix timestamp from external source
-    uint32_t time_reference_boot_ms;  // Boot time when we got the timestamp
-    bool time_acquired;               // Whether we've gotten time from any source
+    uint32_t session_start_time_unix; // Unix timestamp when the session started (0 = unknown)
 } session_state_t;
 
 typedef struct
@@ -57,6 +56,19 @@ static save_state_t save_state = {0};
 static uint32_t last_session_id = 0;
 static uint32_t last_write_index = 0;
 
+_Static_assert(ODOMETER_MARK_BATCH_MAX <= FLASH_REPORTED_MAX, "a batch must fit one reported record");
+
+// Bumped on every change to the sessions in flash or the current session ID
+static uint32_t sessions_generation = 0;
+
+// Bumped when a session ends: saved once the walk stopped, or reported and
+// followed by a new one (not on checkpoints while walking)
+static uint32_t sessions_closed = 0;
+
+// Record of the last session saved to flash, until taken for a notification
+static session_record_t saved_session;
+static bool saved_session_pending = false;
+
 // Read VSYS voltage in millivolts
 uint16_t odometer_read_voltage(void)
 {
@@ -64,7 +76,7 @@ uint16_t odometer_read_voltage(void)
     static uint32_t last_read_time_ms = 0;   // Time of last actual ADC read
 
     // Return cached value if less than 1 second has passed
-    uint32_t current_time_ms = to_ms_since_boot(get_absolute_time());
+    uint32_t current_time_ms = timebase_ms();
     if (last_valid_voltage > 0 && (current_time_ms - last_read_time_ms) < 1000)
     {
         return last_valid_voltage;
@@ -115,8 +127,8 @@ uint16_t odometer_read_voltage(void)
         // Return last valid reading if we have one, otherwise return the bad reading
         if (last_valid_voltage > 0)
         {
-            log_printf("WARNING: Invalid voltage reading %lu mV, using cached %u mV\n",
-                       vsys_mv, last_valid_voltage);
+            LOG_WARN(LOG_TAG_SYSTEM, "WARNING: Invalid voltage reading %lu mV, using cached %u mV\n",
+                                     vsys_mv, last_valid_voltage);
             return last_valid_voltage;
         }
     }
@@ -140,8 +152,8 @@ static bool load_count_from_flash(void)
     {
         // No valid data found - start fresh
         last_session_id = 0;
-        last_write_index = 0;
-        log_printf("[FLASH] No valid previous session found - starting fresh\n");
+        last_write_index = flash_last_write_index();
+        LOG_INFO(LOG_TAG_FLASH, "[FLASH] No valid previous session found - starting fresh\n");
         return false;
     }
 
@@ -169,8 +181,8 @@ static bool load_count_from_flash(void)
     session_data_t latest_data = sessions[latest_index];
 
     // Log the 10 most recent valid sessions (sorted by session_id, descending)
-    log_printf("[FLASH] Found %lu valid session(s) in flash\n", session_count);
-    log_printf("[FLASH] Logging up to 10 most recent sessions:\n");
+    LOG_INFO(LOG_TAG_FLASH, "[FLASH] Found %lu valid session(s) in flash\n", session_count);
+    LOG_DEBUG(LOG_TAG_FLASH, "[FLASH] Logging up to 10 most recent sessions:\n");
 
     // Simple bubble sort to sort by session_id (descending)
     for (uint32_t i = 0; i < session_count - 1; i++)
@@ -192,18 +204,18 @@ static bool load_count_from_flash(void)
     {
         const session_data_t *d = &sessions[i];
         uint32_t sector = d->write_index % FLASH_SECTOR_COUNT;
-        log_printf("[FLASH]   [%lu] Sector %lu: ID=%lu, WrIdx=%lu, Rotations=%lu/%lu, Time=%lu/%lu sec, Start=%lu, End=%lu, Reported=%s\n",
-                   i + 1,
-                   sector,
-                   d->session_id,
-                   d->write_index,
-                   d->session_rotation_count,
-                   d->lifetime_rotation_count,
-                   d->session_active_time_seconds,
-                   d->lifetime_time_seconds,
-                   d->session_start_time_unix,
-                   d->session_end_time_unix,
-                   (d->reported != 0) ? "YES" : "NO");
+        LOG_DEBUG(LOG_TAG_FLASH, "[FLASH]   [%lu] Sector %lu: ID=%lu, WrIdx=%lu, Rotations=%lu/%lu, Time=%lu/%lu sec, Start=%lu, End=%lu, Reported=%s\n",
+                                 i + 1,
+                                 sector,
+                                 d->session_id,
+                                 d->write_index,
+                                 d->session_rotation_count,
+                                 d->lifetime_rotation_count,
+                                 d->session_active_time_seconds,
+                                 d->lifetime_time_seconds,
+                                 d->session_start_time_unix,
+                                 d->session_end_time_unix,
+                                 (d->reported != 0) ? "YES" : "NO");
     }
 
     // Load lifetime totals from the most recent session
@@ -211,32 +223,30 @@ static bool load_count_from_flash(void)
     counts.lifetime_active_seconds = latest_data.lifetime_time_seconds;
 
     // Store the highest session ID and write_index we've seen
+    // (reported batch records take write_index slots too)
     last_session_id = latest_data.session_id;
-    last_write_index = max_write_index;
+    last_write_index = flash_last_write_index();
+    if (max_write_index > last_write_index)
+    {
+        last_write_index = max_write_index;
+    }
 
     // Start fresh for this session
     counts.session_rotations = 0;
     counts.session_active_seconds = 0;
 
-    log_printf("[FLASH] Loaded lifetime totals from flash:\n");
-    log_printf("  - Last session ID: %lu\n", last_session_id);
-    log_printf("  - Last write index: %lu\n", last_write_index);
-    log_printf("  - Lifetime totals: %lu rotations, %lu sec\n", counts.lifetime_rotations, counts.lifetime_active_seconds);
+    LOG_INFO(LOG_TAG_FLASH, "[FLASH] Loaded lifetime totals from flash:\n");
+    LOG_INFO(LOG_TAG_FLASH, "  - Last session ID: %lu\n", last_session_id);
+    LOG_INFO(LOG_TAG_FLASH, "  - Last write index: %lu\n", last_write_index);
+    LOG_INFO(LOG_TAG_FLASH, "  - Lifetime totals: %lu rotations, %lu sec\n", counts.lifetime_rotations, counts.lifetime_active_seconds);
 
     return true;
 }
 
-// Get current Unix timestamp based on time reference
+// Get current Unix timestamp from the disciplined wall clock
 uint32_t odometer_get_current_unix_time(void)
 {
-    if (!session.time_acquired || session.time_reference_unix == 0)
-    {
-        return 0; // No time available
-    }
-
-    uint32_t current_boot_ms = to_ms_since_boot(get_absolute_time());
-    uint32_t elapsed_seconds = (current_boot_ms - session.time_reference_boot_ms) / 1000;
-    return session.time_reference_unix + elapsed_seconds;
+    return timebase_unix_seconds();
 }
 
 void odometer_save_count(void)
@@ -251,8 +261,8 @@ void odometer_save_count(void)
     {
         uint32_t active_seconds = odometer_get_session_active_time_seconds();
         session.session_start_time_unix = session_end_time - active_seconds;
-        log_printf("[SESSION] Estimated start time from end time - active seconds: %lu - %lu = %lu\n",
-                   session_end_time, active_seconds, session.session_start_time_unix);
+        LOG_DEBUG(LOG_TAG_SESSION, "[SESSION] Estimated start time from end time - active seconds: %lu - %lu = %lu\n",
+                                   session_end_time, active_seconds, session.session_start_time_unix);
     }
 
     // Increment write_index for this save (globally incrementing, never resets)
@@ -275,17 +285,28 @@ void odometer_save_count(void)
     // Write to flash (sector determined by write_index)
     if (!flash_write(&data, "Writing session to flash"))
     {
-        log_printf("[FLASH WRITE] ERROR: Flash write verification failed!\n");
-        log_printf("[FLASH WRITE] Data integrity cannot be guaranteed. System may need attention.\n");
+        LOG_ERROR(LOG_TAG_FLASH, "[FLASH WRITE] ERROR: Flash write verification failed!\n");
+        LOG_ERROR(LOG_TAG_FLASH, "[FLASH WRITE] Data integrity cannot be guaranteed. System may need attention.\n");
         // Continue anyway - we've already written the data, and there's not much we can do at this point
         // except log the error for debugging. The checksum will prevent this data from being loaded.
     }
+    else
+    {
+        saved_session.session_id = data.session_id;
+        saved_session.rotation_count = data.session_rotation_count;
+        saved_session.active_time_seconds = data.session_active_time_seconds;
+        saved_session.start_time_unix = data.session_start_time_unix;
+        saved_session.end_time_unix = data.session_end_time_unix;
+        saved_session_pending = true;
+    }
+
+    sessions_generation++;
 
     // Update save state
     save_state.last_saved_count = counts.lifetime_rotations;
-    save_state.last_save_time_ms = to_ms_since_boot(get_absolute_time());
+    save_state.last_save_time_ms = timebase_ms();
 
-    log_printf("[FLASH WRITE] ✓ Flash write completed successfully\n");
+    LOG_DEBUG(LOG_TAG_FLASH, "[FLASH WRITE] ✓ Flash write completed successfully\n");
 }
 
 void odometer_init(void)
@@ -311,16 +332,20 @@ void odometer_init(void)
     counts.session_active_seconds = 0;
     session.current_session_id = last_session_id + 1;
 
-    log_printf("[SESSION] Starting new session ID: %lu\n", session.current_session_id);
+    LOG_INFO(LOG_TAG_SESSION, "[SESSION] Starting new session ID: %lu\n", session.current_session_id);
 }
 
 bool odometer_process(void)
 {
     bool rotation_detected = false;
-    uint32_t current_time_ms = to_ms_since_boot(get_absolute_time());
+    uint32_t current_time_ms = timebase_ms();
 
     // Read and clear pending rotations from IRQ module
     uint32_t rotations_to_process = irq_read_and_clear_rotations();
+    if (rotations_to_process > 0)
+    {
+        diag_record_rotations(rotations_to_process, time_us_32() - irq_get_first_edge_us());
+    }
 
     // Process each pending rotation
     for (uint32_t i = 0; i < rotations_to_process; i++)
@@ -350,9 +375,10 @@ bool odometer_process(void)
         (current_time_ms - counts.last_rotation_time_ms) >= IDLE_SAVE_TIMEOUT_MS &&
         (current_time_ms - save_state.last_save_time_ms) >= FLASH_SAVE_INTERVAL_MS)
     {
-        log_printf("Idle save: persisting %lu unsaved rotations\n",
-                   counts.lifetime_rotations - save_state.last_saved_count);
+        LOG_INFO(LOG_TAG_SESSION, "Idle save: persisting %lu unsaved rotations\n",
+                                  counts.lifetime_rotations - save_state.last_saved_count);
         odometer_save_count();
+        sessions_closed++;
     }
 
     // Check voltage - save immediately if voltage drops below threshold (power loss imminent)
@@ -389,7 +415,7 @@ uint32_t odometer_get_active_time_seconds(void)
     // If currently active, add the time elapsed in the current active period
     if (counts.is_active)
     {
-        uint32_t current_time_ms = to_ms_since_boot(get_absolute_time());
+        uint32_t current_time_ms = timebase_ms();
         uint32_t current_period_seconds = (current_time_ms - counts.active_start_time_ms) / 1000;
         total += current_period_seconds;
     }
@@ -404,7 +430,7 @@ uint32_t odometer_get_session_active_time_seconds(void)
     // If currently active, add the time elapsed in the current active period
     if (counts.is_active)
     {
-        uint32_t current_time_ms = to_ms_since_boot(get_absolute_time());
+        uint32_t current_time_ms = timebase_ms();
         uint32_t current_period_seconds = (current_time_ms - counts.active_start_time_ms) / 1000;
         total += current_period_seconds;
     }
@@ -414,7 +440,7 @@ uint32_t odometer_get_session_active_time_seconds(void)
 
 void odometer_add_rotation(void)
 {
-    uint32_t current_time_ms = to_ms_since_boot(get_absolute_time());
+    uint32_t current_time_ms = timebase_ms();
 
     // Increment rotation counters
     counts.lifetime_rotations++;
@@ -441,7 +467,7 @@ uint32_t odometer_get_unreported_sessions(session_record_t *sessions, uint32_t m
 {
     // Exclude the current active session
     uint32_t exclude_session_id = session.current_session_id;
-    log_printf("[SESSION] Excluding session %lu from unreported list (current session)\n", exclude_session_id);
+    LOG_DEBUG(LOG_TAG_SESSION, "[SESSION] Excluding session %lu from unreported list (current session)\n", exclude_session_id);
 
     // Use flash module's scan function to get deduplicated sessions in one pass
     session_data_t all_sessions[FLASH_SECTOR_COUNT];
@@ -468,13 +494,41 @@ uint32_t odometer_get_unreported_sessions(session_record_t *sessions, uint32_t m
     return count;
 }
 
+// A session marked reported is no news to the client that marked it
+static void drop_saved_session(uint32_t session_id)
+{
+    if (saved_session_pending && saved_session.session_id == session_id)
+    {
+        saved_session_pending = false;
+    }
+}
+
+// The current session has been reported: continue counting in a new one
+static void start_next_session(void)
+{
+    session.current_session_id++;
+    sessions_closed++;
+    counts.session_rotations = 0;
+    counts.session_active_seconds = 0;
+    speed_reset();
+
+    if (timebase_has_time())
+    {
+        session.session_start_time_unix = odometer_get_current_unix_time();
+    }
+
+    LOG_INFO(LOG_TAG_SESSION, "  - Starting fresh session with zero counts\n");
+    LOG_INFO(LOG_TAG_SESSION, "  - New session ID: %lu (rotations: %lu)\n",
+                              session.current_session_id, counts.session_rotations);
+}
+
 // Mark a specific session as reported
 bool odometer_mark_session_reported(uint32_t session_id)
 {
     // If marking the current session, save it first, then start a new one
     if (session_id == session.current_session_id)
     {
-        log_printf("[SESSION] Marking current session %lu as reported\n", session_id);
+        LOG_INFO(LOG_TAG_SESSION, "[SESSION] Marking current session %lu as reported\n", session_id);
         odometer_save_count(); // Persist current state before marking
     }
 
@@ -482,76 +536,192 @@ bool odometer_mark_session_reported(uint32_t session_id)
     session_data_t data;
     if (!flash_find_session(session_id, &data))
     {
-        log_printf("[FLASH] ERROR: Session %lu not found in flash when trying to mark as reported\n", session_id);
+        LOG_ERROR(LOG_TAG_FLASH, "[FLASH] ERROR: Session %lu not found in flash when trying to mark as reported\n", session_id);
         return false; // Session not found
     }
 
     data.reported = 1;
     if (!flash_write(&data, session_id == session.current_session_id ? "Marking session as REPORTED" : "Marking OLD session as REPORTED"))
     {
-        log_printf("[FLASH WRITE] ERROR: Flash write verification failed!\n");
-        log_printf("[FLASH WRITE] Session %lu may not be properly marked as reported.\n", session_id);
+        LOG_ERROR(LOG_TAG_FLASH, "[FLASH WRITE] ERROR: Flash write verification failed!\n");
+        LOG_ERROR(LOG_TAG_FLASH, "[FLASH WRITE] Session %lu may not be properly marked as reported.\n", session_id);
     }
+    sessions_generation++;
+    drop_saved_session(session_id);
 
-    log_printf("[FLASH WRITE] ✓ %s session %lu marked as reported in flash\n",
-               session_id == session.current_session_id ? "Current" : "Old", session_id);
+    LOG_INFO(LOG_TAG_FLASH, "[FLASH WRITE] ✓ %s session %lu marked as reported in flash\n",
+                            session_id == session.current_session_id ? "Current" : "Old", session_id);
 
     // If this was the current session, start a new one
     if (session_id == session.current_session_id)
     {
-        session.current_session_id = session_id + 1;
-        counts.session_rotations = 0;
-        counts.session_active_seconds = 0;
-        speed_reset();
+        start_next_session();
+    }
+
+    return true;
+}
+
+// Mark several sessions as reported in one flash transaction
+uint32_t odometer_mark_sessions_reported(const uint32_t *session_ids, uint32_t count, uint8_t *results)
+{
+    uint32_t current_id = session.current_session_id;
+    bool includes_current = false;
+
+    if (count > ODOMETER_MARK_BATCH_MAX)
+    {
+        count = ODOMETER_MARK_BATCH_MAX;
+    }
+    for (uint32_t i = 0; i < count; i++)
+    {
+        includes_current |= (session_ids[i] == current_id);
+    }
+    if (includes_current)
+    {
+        LOG_INFO(LOG_TAG_SESSION, "[SESSION] Marking current session %lu as reported\n", current_id);
+        odometer_save_count(); // Persist current state before marking
+    }
+
+    // One scan for the whole batch
+    session_data_t all_sessions[FLASH_SECTOR_COUNT];
+    uint32_t all_count = flash_scan_all_sessions(all_sessions, FLASH_SECTOR_COUNT);
+
+    uint32_t pending_ids[ODOMETER_MARK_BATCH_MAX];
+    session_data_t *pending_single = NULL;
+    uint32_t pending = 0;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        session_data_t *found = NULL;
+        for (uint32_t j = 0; j < all_count && found == NULL; j++)
+        {
+            if (all_sessions[j].session_id == session_ids[i])
+            {
+                found = &all_sessions[j];
+            }
+        }
+
+        if (found == NULL)
+        {
+            LOG_WARN(LOG_TAG_FLASH, "[FLASH] Session %lu not found in flash when trying to mark as reported\n", session_ids[i]);
+            results[i] = ODOMETER_MARK_NOT_FOUND;
+        }
+        else if (found->reported)
+        {
+            results[i] = ODOMETER_MARK_ALREADY; // Also covers an ID repeated in the batch
+        }
+        else
+        {
+            found->reported = 1;
+            pending_single = found;
+            pending_ids[pending++] = session_ids[i];
+            results[i] = ODOMETER_MARK_OK;
+        }
+    }
+
+    // A single session is rewritten in place; more take one reported batch record
+    bool written = true;
+    if (pending == 1)
+    {
+        written = flash_write(pending_single, "Marking session as REPORTED");
+    }
+    else if (pending > 1)
+    {
+        last_write_index++;
+        written = flash_write_reported(pending_ids, pending, last_write_index, "Marking sessions as REPORTED");
+    }
+
+    if (!written)
+    {
+        LOG_ERROR(LOG_TAG_FLASH, "[FLASH WRITE] ERROR: %lu session(s) may not be properly marked as reported.\n", pending);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (results[i] == ODOMETER_MARK_OK)
+            {
+                results[i] = ODOMETER_MARK_FAILED;
+            }
+        }
+        pending = 0;
+    }
+    else if (pending > 0)
+    {
+        LOG_INFO(LOG_TAG_FLASH, "[FLASH WRITE] ✓ %lu of %lu session(s) marked as reported in flash\n", pending, count);
+    }
+    sessions_generation++;
 
-        if (session.time_acquired)
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (results[i] == ODOMETER_MARK_OK || results[i] == ODOMETER_MARK_ALREADY)
         {
-            session.session_start_time_unix = odometer_get_current_unix_time();
+            drop_saved_session(session_ids[i]);
         }
+    }
 
-        log_printf("  - Starting fresh session with zero counts\n");
-        log_printf("  - New session ID: %lu (rotations: %lu)\n",
-                   session.current_session_id, counts.session_rotations);
+    // If the current session was marked, start a new one
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (session_ids[i] == current_id && results[i] == ODOMETER_MARK_OK)
+        {
+            start_next_session();
+            break;
+        }
     }
 
+    return pending;
+}
+
+uint32_t odometer_get_sessions_generation(void)
+{
+    return sessions_generation;
+}
+
+uint32_t odometer_get_sessions_closed(void)
+{
+    return sessions_closed;
+}
+
+bool odometer_take_saved_session(session_record_t *record)
+{
+    if (!saved_session_pending)
+    {
+        return false;
+    }
+    *record = saved_session;
+    saved_session_pending = false;
     return true;
 }
 
 // Set time reference from external source (BLE or NTP)
-void odometer_set_time_reference(uint32_t unix_timestamp)
+void odometer_set_time_reference(uint64_t unix_ms)
 {
-    if (unix_timestamp > 0)
+    if (unix_ms > 0)
     {
-        uint32_t current_boot_ms = to_ms_since_boot(get_absolute_time());
-
-        session.time_reference_unix = unix_timestamp;
-        session.time_reference_boot_ms = current_boot_ms;
-        session.time_acquired = true;
+        timebase_sync(unix_ms);
 
-        // Calculate when the Pico started by subtracting uptime from current time
-        uint32_t uptime_seconds = current_boot_ms / 1000;
-        session.session_start_time_unix = unix_timestamp - uptime_seconds;
-
-        log_printf("[TIME] Time reference set!\n");
-        log_printf("  - Current Unix time: %lu\n", unix_timestamp);
-        log_printf("  - Uptime: %lu ms (%.1f sec)\n", current_boot_ms, current_boot_ms / 1000.0f);
-        log_printf("  - Calculated session start: %lu\n", session.session_start_time_unix);
+        // The first session runs from boot: date it once, later syncs only
+        // correct the clock (a resync must not move a session's start)
+        if (session.session_start_time_unix == 0)
+        {
+            uint64_t uptime_us = timebase_us();
+            session.session_start_time_unix = (uint32_t)((unix_ms * 1000 - uptime_us) / 1000000);
+            LOG_INFO(LOG_TAG_TIME, "  - Uptime: %lu s, calculated session start: %lu\n",
+                                   (uint32_t)(uptime_us / 1000000), session.session_start_time_unix);
+        }
 
         // Print human-readable date (approximate - just for debugging)
-        uint32_t days_since_epoch = unix_timestamp / 86400;
+        uint32_t days_since_epoch = (uint32_t)(unix_ms / 1000 / 86400);
         uint32_t years = days_since_epoch / 365 + 1970;
-        log_printf("  - Approximate date: year ~%lu\n", years);
+        LOG_DEBUG(LOG_TAG_TIME, "  - Approximate date: year ~%lu\n", years);
     }
     else
     {
-        log_printf("[TIME] Warning: Received invalid timestamp (0)\n");
+        LOG_WARN(LOG_TAG_TIME, "[TIME] Warning: Received invalid timestamp (0)\n");
     }
 }
 
 // Check if time has been acquired from external source
 bool odometer_has_time(void)
 {
-    return session.time_acquired;
+    return timebase_has_time();
 }
 
 // Get current session ID (0 if not yet decided)
@@ -571,21 +741,21 @@ void odometer_set_lifetime_totals(float hours, float distance_miles)
     // Convert hours to seconds
     uint32_t seconds = (uint32_t)(hours * 3600.0f);
 
-    log_printf("[ODOMETER] Setting lifetime totals:\n");
-    log_printf("  - Hours: %.2f -> %lu seconds\n", hours, seconds);
-    log_printf("  - Distance: %.2f miles -> %lu rotations\n", distance_miles, rotations);
-    log_printf("  - Previous lifetime: %lu rotations, %lu seconds\n",
-               counts.lifetime_rotations, counts.lifetime_active_seconds);
+    LOG_INFO(LOG_TAG_SESSION, "[ODOMETER] Setting lifetime totals:\n");
+    LOG_INFO(LOG_TAG_SESSION, "  - Hours: %.2f -> %lu seconds\n", hours, seconds);
+    LOG_INFO(LOG_TAG_SESSION, "  - Distance: %.2f miles -> %lu rotations\n", distance_miles, rotations);
+    LOG_INFO(LOG_TAG_SESSION, "  - Previous lifetime: %lu rotations, %lu seconds\n",
+                              counts.lifetime_rotations, counts.lifetime_active_seconds);
 
     // Update the lifetime totals
     counts.lifetime_rotations = rotations;
     counts.lifetime_active_seconds = seconds;
 
-    log_printf("  - New lifetime: %lu rotations, %lu seconds\n",
-               counts.lifetime_rotations, counts.lifetime_active_seconds);
+    LOG_INFO(LOG_TAG_SESSION, "  - New lifetime: %lu rotations, %lu seconds\n",
+                              counts.lifetime_rotations, counts.lifetime_active_seconds);
 
     // Save to flash immediately
-    log_printf("  - Saving to flash...\n");
+    LOG_INFO(LOG_TAG_SESSION, "  - Saving to flash...\n");
     odometer_save_count();
-    log_printf("  - Lifetime totals saved successfully\n");
+    LOG_INFO(LOG_TAG_SESSION, "  - Lifetime totals saved successfully\n");
 }
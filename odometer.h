@@ -59,8 +59,40 @@ uint32_t odometer_get_unreported_sessions(session_record_t *sessions, uint32_t m
 // Returns true if session was found and marked, false otherwise
 bool odometer_mark_session_reported(uint32_t session_id);
 
-// Set time reference from external source (BLE or NTP)
-void odometer_set_time_reference(uint32_t unix_timestamp);
+// Result of marking one session in a batch
+typedef enum
+{
+    ODOMETER_MARK_OK = 0,              // Marked reported
+    ODOMETER_MARK_ALREADY = 1,         // Was already reported, nothing written
+    ODOMETER_MARK_NOT_FOUND = 2,       // No such session in flash
+    ODOMETER_MARK_FAILED = 3           // Flash write failed
+} odometer_mark_result_t;
+
+// Maximum session IDs in one batch
+#define ODOMETER_MARK_BATCH_MAX 60     // FLASH_REPORTED_MAX
+
+// Mark several sessions as reported with a single flash scan and, for two or
+// more sessions, a single flash write. Fills results[i] for session_ids[i]
+// Returns the number of sessions marked (ODOMETER_MARK_OK)
+uint32_t odometer_mark_sessions_reported(const uint32_t *session_ids, uint32_t count, uint8_t *results);
+
+// Changes whenever the unreported sessions list may have changed (a session
+// written to flash, marked reported, or a new current session), so callers
+// can keep a copy of the list until it does
+uint32_t odometer_get_sessions_generation(void);
+
+// Changes when a session ends: saved after the walk stopped (idle save), or
+// marked reported and followed by a new session. Checkpoints while walking
+// and low-voltage saves leave it unchanged
+uint32_t odometer_get_sessions_closed(void);
+
+// Take the record of the last session saved to flash, once, for clients kept
+// up to date by notifications. Returns false if none was saved since the last
+// call, or the session has been marked reported since
+bool odometer_take_saved_session(session_record_t *record);
+
+// Set time reference from external source (BLE or NTP), Unix time in milliseconds
+void odometer_set_time_reference(uint64_t unix_ms);
 
 // Check if time has been acquired from external source
 bool odometer_has_time(void);
@@ -1,13 +1,25 @@
 #include "oled.h"
 #include "logging.h"
+#include "hot_path.h"
+#include "trace.h"
 #include <stdio.h>
 #include <string.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
 
+// Number of 8-pixel pages (SH1106 memory is organized in horizontal pages)
+#define OLED_PAGES (OLED_HEIGHT / 8)
+
+// SH1106 has 132 columns of RAM; the 128-pixel panel starts at column 2
+#define OLED_COLUMN_OFFSET 2
+
 // Display buffer
 static uint8_t oled_buffer[OLED_WIDTH * OLED_HEIGHT / 8];
 
+// Dirty column range per page [start, end) - only these bytes are sent by oled_update()
+static uint8_t dirty_start[OLED_PAGES];
+static uint8_t dirty_end[OLED_PAGES];
+
 // Hardware configuration
 static i2c_inst_t* i2c_port;
 static uint8_t oled_addr;
@@ -15,12 +27,21 @@ static uint8_t oled_sda_pin;
 static uint8_t oled_scl_pin;
 static uint32_t i2c_error_count = 0;
 
-// Forward declaration
+// Totals not yet taken by oled_take_i2c_counts()
+static uint32_t i2c_errors_untaken = 0;
+static uint32_t i2c_recoveries_untaken = 0;
+
+// Characters drawn that the font subset does not have (see oled_missing_glyphs())
+static uint32_t missing_glyph_count = 0;
+
+// Forward declarations
 static void oled_hw_init(void);
+static void oled_mark_dirty(int x, int y, int width, int height);
 
 // Reinitialize I2C bus after errors
 static void oled_i2c_recover(void) {
-    log_printf("I2C recovery: reinitializing bus after %lu errors\n", i2c_error_count);
+    i2c_recoveries_untaken++;
+    LOG_WARN(LOG_TAG_DISPLAY, "I2C recovery: reinitializing bus after %lu errors\n", i2c_error_count);
     i2c_deinit(i2c_port);
     i2c_init(i2c_port, 400 * 1000);
     gpio_set_function(oled_sda_pin, GPIO_FUNC_I2C);
@@ -30,6 +51,9 @@ static void oled_i2c_recover(void) {
     sleep_ms(10);
     oled_hw_init();
     i2c_error_count = 0;
+
+    // Display RAM contents are unknown after a reset - resend everything
+    oled_mark_dirty(0, 0, OLED_WIDTH, OLED_HEIGHT);
 }
 
 // Check I2C result and recover if needed. Returns true if ok.
@@ -39,6 +63,7 @@ static bool oled_i2c_check(int result) {
         return true;
     }
     i2c_error_count++;
+    i2c_errors_untaken++;
     if (i2c_error_count >= 10) {
         oled_i2c_recover();
     }
@@ -52,11 +77,39 @@ static void oled_send_cmd(uint8_t cmd) {
     oled_i2c_check(ret);
 }
 
-// Send data byte to OLED
-static void oled_send_data(uint8_t data) {
-    uint8_t buf[2] = {0x40, data};
-    int ret = i2c_write_timeout_us(i2c_port, oled_addr, buf, 2, false, 50000);
-    oled_i2c_check(ret);
+// Send a run of data bytes to OLED in a single I2C transaction
+// Returns true if the transfer succeeded
+static bool oled_send_data(const uint8_t *data, int len) {
+    static uint8_t buf[1 + OLED_WIDTH];
+    buf[0] = 0x40; // Co = 0, D/C = 1: all following bytes are display data
+    memcpy(&buf[1], data, len);
+    int ret = i2c_write_timeout_us(i2c_port, oled_addr, buf, len + 1, false, 50000);
+    return oled_i2c_check(ret);
+}
+
+// Mark a pixel rectangle as changed so oled_update() sends it
+static void HOT_FUNC(oled_mark_dirty)(int x, int y, int width, int height) {
+    // Clip to screen bounds
+    if (x < 0) { width += x; x = 0; }
+    if (y < 0) { height += y; y = 0; }
+    if (x + width > OLED_WIDTH) width = OLED_WIDTH - x;
+    if (y + height > OLED_HEIGHT) height = OLED_HEIGHT - y;
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    int x_end = x + width;
+    int end_page = (y + height - 1) / 8;
+    for (int page = y / 8; page <= end_page; page++) {
+        if (dirty_start[page] >= dirty_end[page]) {
+            // Page was clean
+            dirty_start[page] = x;
+            dirty_end[page] = x_end;
+        } else {
+            if (x < dirty_start[page]) dirty_start[page] = x;
+            if (x_end > dirty_end[page]) dirty_end[page] = x_end;
+        }
+    }
 }
 
 // Hardware initialization for SH1106
@@ -87,17 +140,36 @@ static void oled_hw_init(void) {
     oled_send_cmd(0xAF); // Display on
 }
 
-// Send buffer to display
+// Send the dirty part of the buffer to display
+// Each dirty page is sent as one burst covering its changed column range
 static void oled_render(void) {
-    for (int page = 0; page < 8; page++) {
-        oled_send_cmd(0xB0 + page); // Set page address
-        oled_send_cmd(0x02); // Set lower column address
-        oled_send_cmd(0x10); // Set higher column address
+    uint16_t sent = 0;
+    TRACE_BEGIN(TRACE_OLED_RENDER, 0);
+
+    for (int page = 0; page < OLED_PAGES; page++) {
+        int start = dirty_start[page];
+        int end = dirty_end[page];
+        if (start >= end) {
+            continue; // Page unchanged since last update
+        }
+        dirty_start[page] = 0;
+        dirty_end[page] = 0;
 
-        for (int x = 0; x < OLED_WIDTH; x++) {
-            oled_send_data(oled_buffer[x + page * OLED_WIDTH]);
+        int column = OLED_COLUMN_OFFSET + start;
+        oled_send_cmd(0xB0 + page);                 // Set page address
+        oled_send_cmd(0x00 | (column & 0x0F));      // Set lower column address
+        oled_send_cmd(0x10 | ((column >> 4) & 0x0F)); // Set higher column address
+
+        if (!oled_send_data(&oled_buffer[page * OLED_WIDTH + start], end - start)) {
+            // Transfer failed - keep the range dirty so the next update retries it
+            oled_mark_dirty(start, page * 8, end - start, 8);
+        } else {
+            sent += end - start;
         }
     }
+
+    TRACE_END(TRACE_OLED_RENDER, sent);
+    (void)sent;
 }
 
 // Public API implementation
@@ -115,8 +187,9 @@ void oled_init(void* i2c_inst, uint8_t sda_pin, uint8_t scl_pin, uint8_t addr) {
     gpio_set_pulls(sda_pin, true, false);
     gpio_set_pulls(scl_pin, true, false);
 
-    // Clear buffer
+    // Clear buffer (first update sends the whole frame)
     memset(oled_buffer, 0, sizeof(oled_buffer));
+    oled_mark_dirty(0, 0, OLED_WIDTH, OLED_HEIGHT);
 
     // Initialize hardware
     sleep_ms(100);
@@ -125,6 +198,7 @@ void oled_init(void* i2c_inst, uint8_t sda_pin, uint8_t scl_pin, uint8_t addr) {
 
 void oled_clear(void) {
     memset(oled_buffer, 0, sizeof(oled_buffer));
+    oled_mark_dirty(0, 0, OLED_WIDTH, OLED_HEIGHT);
 }
 
 void oled_set_pixel(int x, int y, bool on) {
@@ -137,11 +211,13 @@ void oled_set_pixel(int x, int y, bool on) {
     } else {
         oled_buffer[x + (y / 8) * OLED_WIDTH] &= ~(1 << (y & 7));
     }
+    oled_mark_dirty(x, y, 1, 1);
 }
 
 void oled_fill_circle(int x0, int y0, int radius) {
     // Bresenham-based scanline algorithm - only iterate actual pixels
     int radius_sq = radius * radius;
+    oled_mark_dirty(x0 - radius, y0 - radius, 2 * radius + 1, 2 * radius + 1);
 
     for (int y = -radius; y <= radius; y++) {
         int py = y0 + y;
@@ -177,7 +253,7 @@ void oled_fill_circle(int x0, int y0, int radius) {
     }
 }
 
-void oled_fill_rect(int x, int y, int width, int height, bool on) {
+void HOT_FUNC(oled_fill_rect)(int x, int y, int width, int height, bool on) {
     // Clip to screen bounds
     if (x < 0) { width += x; x = 0; }
     if (y < 0) { height += y; y = 0; }
@@ -186,6 +262,7 @@ void oled_fill_rect(int x, int y, int width, int height, bool on) {
     if (width <= 0 || height <= 0) {
         return;
     }
+    oled_mark_dirty(x, y, width, height);
 
     int y_end = y + height;
     int x_end = x + width;
@@ -225,7 +302,7 @@ void oled_fill_rect(int x, int y, int width, int height, bool on) {
     }
 }
 
-void oled_draw_text(int x, int y, const char *text, const GFXfont *font) {
+void HOT_FUNC(oled_draw_text)(int x, int y, const char *text, const GFXfont *font) {
     if (!text || !font) return;
 
     int cursor_x = x;
@@ -234,10 +311,14 @@ void oled_draw_text(int x, int y, const char *text, const GFXfont *font) {
         char c = *text++;
 
         if (c < font->first || c > font->last) {
+            missing_glyph_count++;
             continue;
         }
 
         const GFXglyph *glyph = &font->glyph[c - font->first];
+        if (glyph->x_advance == 0) {
+            missing_glyph_count++; // Dropped by tools/font_subset.py
+        }
 
         int glyph_width = glyph->width;
         int glyph_height = glyph->height;
@@ -262,28 +343,38 @@ void oled_draw_text(int x, int y, const char *text, const GFXfont *font) {
         }
 
         // Character is at least partially visible - render it
+        // Glyph bitmaps are page-major (see font.h): each byte is an 8-pixel column
+        // that is shifted into place and ORed into one or two display pages
         const uint8_t *bitmap = &font->bitmap[glyph->bitmap_offset];
-        uint8_t bit = 0;
-        uint8_t byte_val = 0;
-
-        for (int yy = 0; yy < glyph_height; yy++) {
-            int py = y + yo + yy;
-
-            for (int xx = 0; xx < glyph_width; xx++) {
-                if (!(bit++ & 7)) {
-                    byte_val = *bitmap++;
+        int bands = (glyph_height + 7) / 8;
+
+        // Page and bit shift of the glyph's top row (floor division for negative y)
+        int page = (char_top >= 0) ? (char_top / 8) : -((7 - char_top) / 8);
+        int shift = char_top - page * 8;
+
+        // Clip columns once per glyph
+        int col_start = (char_left < 0) ? -char_left : 0;
+        int col_end = (char_right > OLED_WIDTH) ? (OLED_WIDTH - char_left) : glyph_width;
+        oled_mark_dirty(char_left, char_top, glyph_width, glyph_height);
+
+        for (int band = 0; band < bands; band++, page++) {
+            const uint8_t *column = &bitmap[band * glyph_width];
+            bool upper_visible = (page >= 0 && page < OLED_PAGES);
+            bool lower_visible = (shift != 0 && page + 1 >= 0 && page + 1 < OLED_PAGES);
+            int upper = page * OLED_WIDTH + char_left;
+            int lower = upper + OLED_WIDTH;
+
+            for (int xx = col_start; xx < col_end; xx++) {
+                uint8_t bits = column[xx];
+                if (!bits) {
+                    continue;
                 }
-
-                if (byte_val & 0x80) {
-                    int px = cursor_x + xo + xx;
-
-                    // Bounds check for individual pixel
-                    if (px >= 0 && px < OLED_WIDTH && py >= 0 && py < OLED_HEIGHT) {
-                        oled_buffer[px + (py / 8) * OLED_WIDTH] |= (1 << (py & 7));
-                    }
+                if (upper_visible) {
+                    oled_buffer[upper + xx] |= (uint8_t)(bits << shift);
+                }
+                if (lower_visible) {
+                    oled_buffer[lower + xx] |= (uint8_t)(bits >> (8 - shift));
                 }
-
-                byte_val <<= 1;
             }
         }
 
@@ -305,6 +396,17 @@ void oled_draw_text_centered(int center_x, int y, const char *text, const GFXfon
     oled_draw_text(x, y, text, font);
 }
 
+void oled_take_i2c_counts(uint32_t* errors, uint32_t* recoveries) {
+    *errors = i2c_errors_untaken;
+    *recoveries = i2c_recoveries_untaken;
+    i2c_errors_untaken = 0;
+    i2c_recoveries_untaken = 0;
+}
+
+uint32_t oled_missing_glyphs(void) {
+    return missing_glyph_count;
+}
+
 void oled_update(void) {
     // Send buffer to display immediately
     oled_render();
@@ -314,7 +416,7 @@ void oled_wait_for_update(void) {
     // No-op - updates are now synchronous
 }
 
-void oled_measure_text(const char *text, const GFXfont *font, int *width, int *ascent, int *descent) {
+void HOT_FUNC(oled_measure_text)(const char *text, const GFXfont *font, int *width, int *ascent, int *descent) {
     if (!text || !font) {
         if (width) *width = 0;
         if (ascent) *ascent = 0;
@@ -361,11 +463,12 @@ void oled_measure_text(const char *text, const GFXfont *font, int *width, int *a
     if (descent) *descent = max_descent;
 }
 
-void oled_draw_bitmap(int x, int y, const uint8_t *bitmap, int width, int height) {
+void HOT_FUNC(oled_draw_bitmap)(int x, int y, const uint8_t *bitmap, int width, int height) {
     if (!bitmap || width <= 0 || height <= 0) return;
 
     // Calculate bytes per row (round up to nearest byte)
     int bytes_per_row = (width + 7) / 8;
+    oled_mark_dirty(x, y, width, height);
 
     for (int row = 0; row < height; row++) {
         int py = y + row;
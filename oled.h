@@ -34,7 +34,7 @@ void oled_fill_rect(int x, int y, int width, int height, bool on);
 // Draw text using Adafruit GFX font (variable-width, professional quality)
 // x, y: baseline position (note: y is the baseline, not top-left!)
 // text: null-terminated string to draw
-// font: pointer to GFXfont structure (e.g., &FreeSansBold12pt7b)
+// font: pointer to GFXfont structure (e.g., &FreeSans12pt7b)
 void oled_draw_text(int x, int y, const char *text, const GFXfont *font);
 
 // Draw centered text using Adafruit GFX font
@@ -52,6 +52,15 @@ void oled_draw_text_centered(int center_x, int y, const char *text, const GFXfon
 // descent: pointer to store descent below baseline (can be NULL)
 void oled_measure_text(const char *text, const GFXfont *font, int *width, int *ascent, int *descent);
 
+// I2C errors and bus recoveries since the last call, for diag_count_i2c()
+// (the display is drawn outside ble_lock(), the diag counters only under it)
+void oled_take_i2c_counts(uint32_t* errors, uint32_t* recoveries);
+
+// Number of characters drawn so far that are not in their font subset
+// (drawn as nothing). Nonzero means FONT_GLYPHS in tools/font_subset.py
+// is missing characters the screens use
+uint32_t oled_missing_glyphs(void);
+
 // Draw a bitmap/icon
 // x, y: top-left corner position
 // bitmap: pointer to bitmap data (1 bit per pixel, packed in bytes, row-major)
@@ -59,7 +68,7 @@ void oled_measure_text(const char *text, const GFXfont *font, int *width, int *a
 // Bitmap format: MSB first, rows packed into bytes (e.g., 12x12 icon = 12 bytes per row, rounded up)
 void oled_draw_bitmap(int x, int y, const uint8_t *bitmap, int width, int height);
 
-// Update the display (sends buffer to display)
+// Update the display (sends the parts of the buffer changed since the last update)
 void oled_update(void);
 
 // Wait for any pending update to complete (no-op, for backward compatibility)
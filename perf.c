@@ -0,0 +1,147 @@
+/**
+ * On-device performance measurement implementation
+ */
+
+#include "perf.h"
+#include "hot_path.h"
+#include "logging.h"
+#include "pico/stdlib.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/structs/systick.h"
+#include "hardware/structs/xip_ctrl.h"
+
+#define SYSTICK_MAX 0x00FFFFFFu
+
+typedef struct
+{
+    uint32_t count;
+    uint64_t sum;
+    uint32_t min;
+    uint32_t max;
+} perf_stat_t;
+
+static perf_stat_t render_cycles;
+static perf_stat_t transfer_us;
+static perf_stat_t irq_latency_cycles;
+
+static int probe_irq = -1;
+static volatile uint32_t probe_start;
+static volatile uint32_t probe_latency;
+
+static void stat_add(perf_stat_t *stat, uint32_t value)
+{
+    if (stat->count == 0 || value < stat->min)
+    {
+        stat->min = value;
+    }
+    if (value > stat->max)
+    {
+        stat->max = value;
+    }
+    stat->sum += value;
+    stat->count++;
+}
+
+static uint32_t stat_avg(const perf_stat_t *stat)
+{
+    return stat->count ? (uint32_t)(stat->sum / stat->count) : 0;
+}
+
+// Latency probe handler - placed like gpio_irq_handler so it sees the same
+// instruction fetch path (XIP cache or SRAM)
+static void HOT_FUNC(perf_irq_probe_handler)(void)
+{
+    probe_latency = (probe_start - systick_hw->cvr) & SYSTICK_MAX;
+}
+
+static void reset_period(void)
+{
+    perf_stat_t empty = {0};
+    render_cycles = empty;
+    transfer_us = empty;
+    irq_latency_cycles = empty;
+
+    // Writing the XIP counters clears them
+    xip_ctrl_hw->ctr_hit = 0;
+    xip_ctrl_hw->ctr_acc = 0;
+}
+
+void perf_init(void)
+{
+    // SysTick free-running from the processor clock, no interrupt
+    systick_hw->csr = 0;
+    systick_hw->rvr = SYSTICK_MAX;
+    systick_hw->cvr = 0;
+    systick_hw->csr = M0PLUS_SYST_CSR_CLKSOURCE_BITS | M0PLUS_SYST_CSR_ENABLE_BITS;
+
+    probe_irq = user_irq_claim_unused(false);
+    if (probe_irq >= 0)
+    {
+        irq_set_exclusive_handler(probe_irq, perf_irq_probe_handler);
+        irq_set_enabled(probe_irq, true);
+    }
+    else
+    {
+        LOG_WARN(LOG_TAG_PERF, "[PERF] No spare IRQ - latency probe disabled\n");
+    }
+
+    reset_period();
+}
+
+uint32_t perf_cycles_now(void)
+{
+    return systick_hw->cvr;
+}
+
+uint32_t perf_cycles_since(uint32_t start)
+{
+    // SysTick counts down
+    return (start - systick_hw->cvr) & SYSTICK_MAX;
+}
+
+void perf_record_frame(uint32_t render, uint32_t transfer)
+{
+    stat_add(&render_cycles, render);
+    if (transfer > 0)
+    {
+        stat_add(&transfer_us, transfer);
+    }
+}
+
+void perf_probe_irq_latency(void)
+{
+    if (probe_irq < 0)
+    {
+        return;
+    }
+
+    probe_latency = 0;
+    probe_start = perf_cycles_now();
+    irq_set_pending(probe_irq); // Taken as soon as the write completes
+    __dsb();
+    __isb();
+
+    if (probe_latency > 0)
+    {
+        stat_add(&irq_latency_cycles, probe_latency);
+    }
+}
+
+void perf_report(void)
+{
+    uint32_t accesses = xip_ctrl_hw->ctr_acc;
+    uint32_t hits = xip_ctrl_hw->ctr_hit;
+    uint32_t hit_permille = accesses ? (uint32_t)((uint64_t)hits * 1000 / accesses) : 0;
+
+    LOG_INFO(LOG_TAG_PERF, "[PERF] hot path in %s: frames=%lu render avg=%lu max=%lu cyc, transfers=%lu avg=%lu max=%lu us\n",
+                           HOT_PATH_IN_RAM ? "RAM" : "flash", render_cycles.count, stat_avg(&render_cycles), render_cycles.max,
+                           transfer_us.count, stat_avg(&transfer_us), transfer_us.max);
+    LOG_INFO(LOG_TAG_PERF, "[PERF] irq latency samples=%lu min=%lu avg=%lu max=%lu cyc, XIP cache hit %lu.%lu%% of %lu\n",
+                           irq_latency_cycles.count, irq_latency_cycles.min, stat_avg(&irq_latency_cycles),
+                           irq_latency_cycles.max, hit_permille / 10, hit_permille % 10, accesses);
+    LOG_INFO(LOG_TAG_PERF, "[PERF] log bytes dropped since boot: ble=%lu usb=%lu\n",
+                           logging_get_dropped_bytes(), logging_get_usb_dropped_bytes());
+
+    reset_period();
+}
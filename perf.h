@@ -0,0 +1,39 @@
+/**
+ * On-device performance measurement
+ *
+ * Cheap counters for comparing builds (e.g. with and without HOT_PATH_IN_RAM,
+ * see hot_path.h):
+ * - CPU cycles to render a frame into the OLED buffer, and time to send it
+ * - Interrupt entry latency in cycles, measured by pending a spare IRQ whose
+ *   handler is placed like gpio_irq_handler (flash or SRAM)
+ * - XIP cache hit rate over the same period
+ *
+ * Cycles come from SysTick (24-bit, CPU clock), so single measurements must
+ * stay under 2^24 cycles (~134 ms at 125 MHz).
+ */
+
+#ifndef PERF_H
+#define PERF_H
+
+#include <stdint.h>
+
+// Start SysTick and claim the IRQ used for latency probes
+void perf_init(void);
+
+// Current cycle counter value, for use with perf_cycles_since()
+uint32_t perf_cycles_now(void);
+
+// CPU cycles elapsed since a perf_cycles_now() value
+uint32_t perf_cycles_since(uint32_t start);
+
+// Record one display refresh: render cycles (buffer only) and transfer time
+// (oled_update, 0 if nothing was sent)
+void perf_record_frame(uint32_t render_cycles, uint32_t transfer_us);
+
+// Take one interrupt latency sample
+void perf_probe_irq_latency(void);
+
+// Log the stats gathered since the last report, then start a new period
+void perf_report(void);
+
+#endif // PERF_H
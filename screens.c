@@ -0,0 +1,127 @@
+/**
+ * OLED screen layouts implementation
+ */
+
+#include "screens.h"
+#include "ui.h"
+#include "oled.h"
+#include "font.h"
+#include "icons.h"
+#include "fmt.h"
+#include <string.h>
+
+// Layout: main content area (0-50), separator (51), status bar (52-63)
+#define STATUS_SEPARATOR_Y 51
+#define STATUS_BASELINE_Y 63
+
+#define ADVERTISING_BLINK_MS 250
+
+// ============================================================================
+// DATA SOURCES
+// ============================================================================
+
+// Session distance: 2 decimals under 10, otherwise 1
+static void format_session_distance(const void *m, char *buf, size_t size)
+{
+    const screen_model_t *model = m;
+    fmt_distance(buf, size, model->session_rotations, model->metric, 1, "");
+}
+
+// Session time as H:MM:SS, or M:SS under an hour
+static void format_session_time(const void *m, char *buf, size_t size)
+{
+    const screen_model_t *model = m;
+    fmt_duration(buf, size, model->session_time_seconds);
+}
+
+// Lifetime distance: 2 decimals under 10, 1 under 100, otherwise whole units
+static void format_total_distance(const void *m, char *buf, size_t size)
+{
+    const screen_model_t *model = m;
+    fmt_distance(buf, size, model->total_rotations, model->metric, 0, " total");
+}
+
+static void format_total_hours(const void *m, char *buf, size_t size)
+{
+    const screen_model_t *model = m;
+    size_t len = fmt_uint(buf, size, model->total_time_seconds / 3600);
+    strncat(buf, " total hr", size - len - 1);
+}
+
+// Clock in 12-hour format with AM/PM (empty until time is synced)
+static void format_clock(const void *m, char *buf, size_t size)
+{
+    const screen_model_t *model = m;
+    if (!model->clock_valid)
+    {
+        buf[0] = '\0';
+        return;
+    }
+    fmt_clock_12h(buf, size, model->clock_seconds);
+}
+
+static void format_voltage(const void *m, char *buf, size_t size)
+{
+    const screen_model_t *model = m;
+    fmt_voltage(buf, size, model->voltage_mv, 1);
+}
+
+// Bluetooth icon: solid when connected, flashing every 250ms while advertising
+static bool bluetooth_icon_visible(const void *m)
+{
+    const screen_model_t *model = m;
+    if (model->ble_connected)
+    {
+        return true;
+    }
+    return model->ble_advertising && ((model->now_ms / ADVERTISING_BLINK_MS) % 2) == 0;
+}
+
+// ============================================================================
+// LAYOUTS
+// ============================================================================
+
+// Common status bar at bottom of display
+// Shows: Clock (left) | Voltage (center) | Connection icon (right)
+#define STATUS_BAR_WIDGETS                                                                   \
+    {.type = UI_WIDGET_FILL, .x = 0, .y = STATUS_SEPARATOR_Y, .width = OLED_WIDTH, .height = 1}, \
+    {.type = UI_WIDGET_TEXT, .x = 1, .y = STATUS_BASELINE_Y,                                 \
+     .font = &Font5x7Fixed, .align = UI_ALIGN_LEFT, .text = format_clock},                    \
+    {.type = UI_WIDGET_TEXT, .x = OLED_WIDTH / 2, .y = STATUS_BASELINE_Y,                    \
+     .font = &Font5x7Fixed, .align = UI_ALIGN_CENTER, .text = format_voltage},                \
+    {.type = UI_WIDGET_ICON, .x = OLED_WIDTH - ICON_BLUETOOTH_WIDTH,                          \
+     .y = OLED_HEIGHT - ICON_BLUETOOTH_HEIGHT, .icon = &icon_bluetooth,                       \
+     .visible = bluetooth_icon_visible}
+
+// Session screen: large centered distance and session time below
+static ui_widget_t session_widgets[] = {
+    {.type = UI_WIDGET_TEXT, .x = OLED_WIDTH / 2, .y = 24,
+     .font = &FreeSans18pt7b, .align = UI_ALIGN_CENTER, .text = format_session_distance},
+    {.type = UI_WIDGET_TEXT, .x = OLED_WIDTH / 2, .y = 42,
+     .font = &FreeSans9pt7b, .align = UI_ALIGN_CENTER, .text = format_session_time},
+    STATUS_BAR_WIDGETS,
+};
+
+// Totals screen: lifetime distance and hours, both medium and centered
+static ui_widget_t totals_widgets[] = {
+    {.type = UI_WIDGET_TEXT, .x = OLED_WIDTH / 2, .y = 18,
+     .font = &FreeSans12pt7b, .align = UI_ALIGN_CENTER, .text = format_total_distance},
+    {.type = UI_WIDGET_TEXT, .x = OLED_WIDTH / 2, .y = 42,
+     .font = &FreeSans12pt7b, .align = UI_ALIGN_CENTER, .text = format_total_hours},
+    STATUS_BAR_WIDGETS,
+};
+
+static ui_screen_t screens[] = {
+    [SCREEN_SESSION] = {session_widgets, sizeof(session_widgets) / sizeof(session_widgets[0])},
+    [SCREEN_TOTALS] = {totals_widgets, sizeof(totals_widgets) / sizeof(totals_widgets[0])},
+};
+
+bool screens_render(screen_id_t screen, const screen_model_t *model)
+{
+    return ui_render(&screens[screen], model);
+}
+
+void screens_invalidate(void)
+{
+    ui_invalidate();
+}
@@ -0,0 +1,47 @@
+/**
+ * OLED screen layouts
+ *
+ * The session and totals screens (each with the shared status bar) are declared
+ * as retained widgets (see ui.h) bound to a screen_model_t snapshot. Rendering a
+ * screen only redraws the widgets whose formatted value changed.
+ */
+
+#ifndef SCREENS_H
+#define SCREENS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Snapshot of everything the screens display
+// Filled by the main loop before each refresh so widgets never call into other modules
+typedef struct
+{
+    uint32_t session_rotations;    // Current session rotation count
+    uint32_t session_time_seconds; // Current session active time
+    uint32_t total_rotations;      // Lifetime rotation count
+    uint32_t total_time_seconds;   // Lifetime active time
+    bool metric;                   // true = km, false = miles
+    uint16_t voltage_mv;           // VSYS voltage
+    bool clock_valid;              // false until time has been synced
+    uint32_t clock_seconds;        // Local time of day in seconds since midnight
+    bool ble_connected;
+    bool ble_advertising;
+    uint32_t now_ms;               // Current time since boot (drives the advertising icon blink)
+} screen_model_t;
+
+typedef enum
+{
+    SCREEN_SESSION, // Session distance and active time
+    SCREEN_TOTALS,  // Lifetime distance and hours
+} screen_id_t;
+
+// Render a screen into the OLED buffer
+// Switching screens redraws everything; otherwise only changed widgets are redrawn
+// Returns true if the buffer changed and oled_update() should be called
+bool screens_render(screen_id_t screen, const screen_model_t *model);
+
+// Force the next screens_render() to redraw the whole screen
+// (e.g. after the display was powered back on)
+void screens_invalidate(void);
+
+#endif // SCREENS_H
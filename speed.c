@@ -3,6 +3,7 @@
  */
 
 #include "speed.h"
+#include "hot_path.h"
 #include "logging.h"
 #include <string.h>
 
@@ -59,10 +60,10 @@ void speed_reset(void)
     slow_walking_range_start_ms = 0;
     speed_was_in_slow_walking_range = false;
     // Note: Do NOT reset BLE activation state - once BLE is activated, it stays active forever
-    log_printf("[SPEED] Speed window reset (starting new session)\n");
+    LOG_DEBUG(LOG_TAG_SPEED, "[SPEED] Speed window reset (starting new session)\n");
 }
 
-void speed_update(uint32_t session_rotations, uint32_t current_time_ms)
+void HOT_FUNC(speed_update)(uint32_t session_rotations, uint32_t current_time_ms)
 {
     // Update speed window
     speed_window.rotations[speed_window.index] = session_rotations;
@@ -89,8 +90,8 @@ void speed_update(uint32_t session_rotations, uint32_t current_time_ms)
             // Just entered slow walking range - start timer
             slow_walking_range_start_ms = current_time_ms;
             speed_was_in_slow_walking_range = true;
-            log_printf("[SPEED] Entered slow walking range (speed %.2f mph), starting 5-second timer\n",
-                       current_speed_mph);
+            LOG_INFO(LOG_TAG_SPEED, "[SPEED] Entered slow walking range (speed %.2f mph), starting 5-second timer\n",
+                                    current_speed_mph);
         }
         // else: already in slow walking range, timer already running
     }
@@ -100,7 +101,7 @@ void speed_update(uint32_t session_rotations, uint32_t current_time_ms)
         if (speed_was_in_slow_walking_range)
         {
             // Just exited slow walking range - reset timer
-            log_printf("[SPEED] Exited slow walking range (speed %.2f mph)\n", current_speed_mph);
+            LOG_INFO(LOG_TAG_SPEED, "[SPEED] Exited slow walking range (speed %.2f mph)\n", current_speed_mph);
             speed_was_in_slow_walking_range = false;
             slow_walking_range_start_ms = 0;
         }
@@ -120,8 +121,8 @@ void speed_update(uint32_t session_rotations, uint32_t current_time_ms)
                 // Just exceeded threshold - start timer
                 fast_walking_range_start_ms = current_time_ms;
                 speed_above_slow_walking_threshold = true;
-                log_printf("[SPEED] Speed exceeded slow walking threshold (%.2f mph), starting 5-second BLE activation timer\n",
-                           current_speed_mph);
+                LOG_INFO(LOG_TAG_SPEED, "[SPEED] Speed exceeded slow walking threshold (%.2f mph), starting 5-second BLE activation timer\n",
+                                        current_speed_mph);
             }
             else
             {
@@ -131,8 +132,8 @@ void speed_update(uint32_t session_rotations, uint32_t current_time_ms)
                 {
                     // Been above threshold for 5 seconds - activate BLE permanently
                     ble_has_been_activated = true;
-                    log_printf("[SPEED] *** BLE ACTIVATED *** (speed above %.2f mph for %lu ms)\n",
-                               SLOW_WALK_THRESHOLD_MPH, time_above_threshold_ms);
+                    LOG_INFO(LOG_TAG_SPEED, "[SPEED] *** BLE ACTIVATED *** (speed above %.2f mph for %lu ms)\n",
+                                            SLOW_WALK_THRESHOLD_MPH, time_above_threshold_ms);
                 }
             }
         }
@@ -141,8 +142,8 @@ void speed_update(uint32_t session_rotations, uint32_t current_time_ms)
             // Speed dropped below threshold - reset timer
             if (speed_above_slow_walking_threshold)
             {
-                log_printf("[SPEED] Speed dropped below threshold (%.2f mph), resetting BLE activation timer\n",
-                           current_speed_mph);
+                LOG_INFO(LOG_TAG_SPEED, "[SPEED] Speed dropped below threshold (%.2f mph), resetting BLE activation timer\n",
+                                        current_speed_mph);
                 speed_above_slow_walking_threshold = false;
                 fast_walking_range_start_ms = 0;
             }
@@ -150,7 +151,7 @@ void speed_update(uint32_t session_rotations, uint32_t current_time_ms)
     }
 }
 
-float speed_get_running_avg(bool metric)
+float HOT_FUNC(speed_get_running_avg)(bool metric)
 {
     if (!speed_window.filled && speed_window.index < 2)
     {
@@ -176,7 +177,7 @@ float speed_get_running_avg(bool metric)
     return rotations_per_hour * (metric ? KM_PER_ROTATION : MILES_PER_ROTATION);
 }
 
-float speed_get_session_avg(uint32_t session_rotations, uint32_t session_time_seconds, bool metric)
+float HOT_FUNC(speed_get_session_avg)(uint32_t session_rotations, uint32_t session_time_seconds, bool metric)
 {
     if (session_time_seconds == 0)
     {
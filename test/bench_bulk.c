@@ -0,0 +1,169 @@
+/**
+ * Bulk transfer benchmark: L2CAP channel against GATT reads
+ *
+ * A loopback stand-in for a BLE link (no radio, no BTstack): a source of
+ * SOURCE_SIZE bytes is moved once as GATT long reads and once as bulk_proto
+ * frames on an LE credit-based L2CAP channel. The L2CAP side runs the real
+ * framing code; its SDUs are split into link-layer packets as BTstack and the
+ * controller do. Link time comes from a model of the radio:
+ *
+ * - GATT read: a request and an MTU - 1 byte response; the next request
+ *   only goes out after the response, so one read per two connection events
+ * - L2CAP: packets of up to 251 bytes (4-byte header, 2-byte SDU length in
+ *   the first packet of an SDU) back to back in each connection event, as
+ *   many as fit in the interval, or as the controller's ACL buffers hold
+ *
+ * Link numbers are a model: use them to compare the two paths and link
+ * settings, and check against the [BULK] and [PERF] log lines on a device.
+ * Also times the frame building on the host CPU.
+ *
+ * Usage: ./build/bench_bulk [source_bytes]   (or: cmake --build build --target benchmark)
+ */
+
+#include "bulk_proto.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_SOURCE_SIZE (64 * 1024)
+#define ATT_MTU 247              // LINK_POLICY_ATT_MTU
+#define SDU_SIZE 1024            // BULK_CHANNEL_SDU_SIZE
+#define LL_MAX_PAYLOAD 251       // Data Length Extension
+#define L2CAP_HEADER 4
+#define SDU_LENGTH_FIELD 2
+#define ACL_BUFFERS 3            // MAX_NR_CONTROLLER_ACL_BUFFERS
+#define T_IFS_US 150
+
+static uint8_t *source;
+static uint32_t source_size;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static size_t read_source(void *context, uint32_t *cursor, uint8_t *dest, size_t max_len) {
+    (void)context;
+    if (*cursor >= source_size) {
+        return 0;
+    }
+    size_t len = (source_size - *cursor < max_len) ? source_size - *cursor : max_len;
+    memcpy(dest, &source[*cursor], len);
+    return len;
+}
+
+// Link-layer packets for one SDU of sdu_len bytes
+static uint32_t ll_packets_for_sdu(size_t sdu_len) {
+    size_t left = sdu_len + SDU_LENGTH_FIELD;
+    uint32_t packets = 0;
+    while (left > 0) {
+        size_t chunk = LL_MAX_PAYLOAD - L2CAP_HEADER;
+        left -= (left < chunk) ? left : chunk;
+        packets++;
+    }
+    return packets;
+}
+
+typedef struct {
+    uint32_t frames;
+    uint32_t packets;
+    uint32_t bytes;
+} l2cap_result_t;
+
+// Move the whole source through the framing, once
+static l2cap_result_t run_l2cap(void) {
+    static uint8_t frame[SDU_SIZE];
+    l2cap_result_t result = {0, 0, 0};
+    uint8_t request[BULK_REQUEST_SIZE];
+    bulk_request_t req = { BULK_TYPE_LOGS, 0, BULK_LENGTH_ALL };
+
+    // The request goes through the wire format like the phone's would
+    bulk_write_request(&req, request);
+    bulk_parse_request(request, sizeof(request), &req);
+
+    bulk_transfer_t transfer;
+    bulk_transfer_start(&transfer, &req);
+    size_t len;
+    while ((len = bulk_transfer_next(&transfer, read_source, NULL, frame, sizeof(frame))) > 0) {
+        result.frames++;
+        result.packets += ll_packets_for_sdu(len);
+        result.bytes += (uint32_t)(len - BULK_FRAME_HEADER_SIZE);
+    }
+    return result;
+}
+
+// Air time of one link-layer packet: preamble, access address, header, CRC
+static double packet_us(size_t payload, int phy_mbps) {
+    size_t preamble = (phy_mbps == 2) ? 2 : 1;
+    return (preamble + 4 + 2 + payload + 3) * 8.0 / phy_mbps;
+}
+
+// Full packets sent and acknowledged (empty packet back) in one event
+static uint32_t packets_per_event(double interval_ms, int phy_mbps) {
+    double pair_us = packet_us(LL_MAX_PAYLOAD, phy_mbps) + T_IFS_US + packet_us(0, phy_mbps) + T_IFS_US;
+    uint32_t n = (uint32_t)(interval_ms * 1000.0 / pair_us);
+    return n > 0 ? n : 1;
+}
+
+static void report_link(double interval_ms, int phy_mbps, const l2cap_result_t *l2cap) {
+    uint32_t reads = (source_size + (ATT_MTU - 1) - 1) / (ATT_MTU - 1);
+    double gatt_s = 2.0 * reads * interval_ms / 1000.0;
+
+    uint32_t air = packets_per_event(interval_ms, phy_mbps);
+    uint32_t buffered = air < ACL_BUFFERS ? air : ACL_BUFFERS;
+    // One event carries the request, then the frames follow
+    double l2cap_air_s = (1 + (l2cap->packets + air - 1) / air) * interval_ms / 1000.0;
+    double l2cap_buf_s = (1 + (l2cap->packets + buffered - 1) / buffered) * interval_ms / 1000.0;
+
+    printf("%6.1f ms  %d M  %10.0f  %13.0f  %13.0f  %5.1fx\n", interval_ms, phy_mbps,
+           source_size / gatt_s, source_size / l2cap_buf_s, source_size / l2cap_air_s, gatt_s / l2cap_buf_s);
+}
+
+int main(int argc, char **argv) {
+    source_size = DEFAULT_SOURCE_SIZE;
+    if (argc > 1) {
+        source_size = (uint32_t)strtoul(argv[1], NULL, 10);
+        if (source_size == 0) {
+            source_size = DEFAULT_SOURCE_SIZE;
+        }
+    }
+    source = malloc(source_size);
+    if (source == NULL) {
+        return 1;
+    }
+    for (uint32_t i = 0; i < source_size; i++) {
+        source[i] = (uint8_t)('a' + i % 26);
+    }
+
+    l2cap_result_t l2cap = run_l2cap();
+    if (l2cap.bytes != source_size) {
+        printf("Framing lost data: %lu of %lu bytes\n", (unsigned long)l2cap.bytes, (unsigned long)source_size);
+        return 1;
+    }
+
+    const int iterations = 200;
+    double start = now_seconds();
+    for (int i = 0; i < iterations; i++) {
+        run_l2cap();
+    }
+    double build_s = (now_seconds() - start) / iterations;
+
+    printf("Bulk transfer benchmark (%lu bytes, loopback link model)\n\n", (unsigned long)source_size);
+    printf("GATT reads:    %lu of %d bytes\n", (unsigned long)((source_size + ATT_MTU - 2) / (ATT_MTU - 1)), ATT_MTU - 1);
+    printf("L2CAP frames:  %lu of up to %d bytes, %lu link packets\n", (unsigned long)l2cap.frames, SDU_SIZE,
+           (unsigned long)l2cap.packets);
+    printf("Frame building (host CPU): %.0f us per transfer, %.0f MB/s\n\n", build_s * 1e6, source_size / build_s / 1e6);
+
+    printf("%9s  %3s  %10s  %13s  %13s  %6s\n", "Interval", "PHY", "GATT B/s", "L2CAP B/s", "L2CAP air B/s", "Gain");
+    static const double intervals_ms[] = {7.5, 15.0, 30.0};
+    for (size_t i = 0; i < sizeof(intervals_ms) / sizeof(intervals_ms[0]); i++) {
+        report_link(intervals_ms[i], 1, &l2cap);
+        report_link(intervals_ms[i], 2, &l2cap);
+    }
+    printf("\nL2CAP B/s: at most %d packets in the controller per event; air: as many as fit\n", ACL_BUFFERS);
+
+    free(source);
+    return 0;
+}
@@ -0,0 +1,197 @@
+/**
+ * Host rendering benchmark
+ *
+ * Times the oled.c drawing primitives and whole-screen renders against the
+ * in-memory SH1106 model and reports frames per second of pure rendering
+ * (no I2C wait, no sleeps). Numbers are for the host CPU - use them to compare
+ * changes, not as RP2040 timings.
+ *
+ * Usage: ./build/bench_render [iterations]   (or: cmake --build build --target benchmark)
+ */
+
+#include "sh1106_model.h"
+#include "oled.h"
+#include "screens.h"
+#include "icons.h"
+#include "hardware/i2c.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define DEFAULT_ITERATIONS 20000
+
+static volatile uint32_t sink; // Keeps results alive so nothing is optimized away
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+typedef void (*bench_fn_t)(uint32_t i);
+
+static double run(const char *name, bench_fn_t fn, uint32_t iterations) {
+    fn(0); // Warm up caches
+    double start = now_seconds();
+    for (uint32_t i = 0; i < iterations; i++) {
+        fn(i);
+    }
+    double elapsed = now_seconds() - start;
+    double per_call_ns = elapsed * 1e9 / iterations;
+    printf("%-36s %10.0f ns %12.0f /s\n", name, per_call_ns, iterations / elapsed);
+    return per_call_ns;
+}
+
+// ============================================================================
+// PRIMITIVES
+// ============================================================================
+
+static void bench_clear(uint32_t i) {
+    (void)i;
+    oled_clear();
+}
+
+static void bench_fill_rect(uint32_t i) {
+    oled_fill_rect((int)(i & 31), 3 + (int)(i & 7), 64, 20, (i & 1) != 0);
+}
+
+static void bench_text_18pt(uint32_t i) {
+    (void)i;
+    oled_draw_text(10, 24 + (int)(i & 3), "10.73 mi", &FreeSans18pt7b);
+}
+
+static void bench_text_12pt(uint32_t i) {
+    (void)i;
+    oled_draw_text(4, 18 + (int)(i & 3), "1074 total mi", &FreeSans12pt7b);
+}
+
+static void bench_text_9pt(uint32_t i) {
+    (void)i;
+    oled_draw_text(40, 42 + (int)(i & 3), "1:02:05", &FreeSans9pt7b);
+}
+
+static void bench_text_5x7(uint32_t i) {
+    (void)i;
+    oled_draw_text(1, 63, "12:59 PM", &Font5x7Fixed);
+}
+
+static void bench_measure_text(uint32_t i) {
+    int width;
+    oled_measure_text((i & 1) ? "10.73 mi" : "9.99 mi", &FreeSans18pt7b, &width, NULL, NULL);
+    sink += (uint32_t)width;
+}
+
+static void bench_bitmap(uint32_t i) {
+    oled_draw_bitmap(OLED_WIDTH - icon_bluetooth.width - (int)(i & 7), OLED_HEIGHT - icon_bluetooth.height,
+                     icon_bluetooth.bitmap, icon_bluetooth.width, icon_bluetooth.height);
+}
+
+static void bench_update_full(uint32_t i) {
+    (void)i;
+    oled_clear();
+    oled_update();
+}
+
+// ============================================================================
+// WHOLE SCREENS
+// ============================================================================
+
+static screen_model_t model = {
+    .session_rotations = 50000,
+    .session_time_seconds = 3725,
+    .total_rotations = 500000,
+    .total_time_seconds = 123 * 3600,
+    .voltage_mv = 4200,
+    .clock_valid = true,
+    .clock_seconds = 21 * 3600 + 5 * 60,
+    .ble_connected = true,
+};
+
+// Full redraw of the session screen into the buffer (what a screen switch costs)
+static void bench_session_full(uint32_t i) {
+    model.session_time_seconds = 3725 + i;
+    screens_invalidate();
+    sink += screens_render(SCREEN_SESSION, &model);
+}
+
+// Typical 1 Hz refresh: time ticks, distance creeps up
+static void bench_session_incremental(uint32_t i) {
+    model.session_time_seconds = 3725 + i;
+    model.session_rotations = 50000 + i * 3;
+    sink += screens_render(SCREEN_SESSION, &model);
+}
+
+static void bench_session_unchanged(uint32_t i) {
+    (void)i;
+    sink += screens_render(SCREEN_SESSION, &model);
+}
+
+static void bench_totals_full(uint32_t i) {
+    model.total_time_seconds = 123 * 3600 + i;
+    screens_invalidate();
+    sink += screens_render(SCREEN_TOTALS, &model);
+}
+
+// Full frame including the transfer to the controller model
+static void bench_frame_full(uint32_t i) {
+    bench_session_full(i);
+    oled_update();
+}
+
+static void bench_frame_incremental(uint32_t i) {
+    bench_session_incremental(i);
+    oled_update();
+}
+
+static void report_frame_traffic(const char *name, bench_fn_t fn) {
+    fn(0);
+    oled_update();
+    sh1106_model_reset_stats();
+    fn(1);
+    oled_update();
+    sh1106_stats_t stats = sh1106_model_stats();
+    printf("%-36s %6lu transactions %6lu bytes\n", name, (unsigned long)stats.transactions,
+           (unsigned long)stats.bytes);
+}
+
+int main(int argc, char **argv) {
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    if (argc > 1) {
+        iterations = (uint32_t)strtoul(argv[1], NULL, 10);
+        if (iterations == 0) {
+            iterations = DEFAULT_ITERATIONS;
+        }
+    }
+
+    sh1106_model_reset();
+    oled_init(i2c0, 4, 5, 0x3C);
+    oled_update();
+
+    printf("Rendering benchmark (%lu iterations, host CPU)\n\n", (unsigned long)iterations);
+    printf("%-36s %13s %14s\n", "Primitive", "time/call", "calls");
+    run("oled_clear", bench_clear, iterations);
+    run("oled_fill_rect 64x20", bench_fill_rect, iterations);
+    run("oled_draw_text 18pt \"10.73 mi\"", bench_text_18pt, iterations);
+    run("oled_draw_text 12pt \"1074 total mi\"", bench_text_12pt, iterations);
+    run("oled_draw_text 9pt \"1:02:05\"", bench_text_9pt, iterations);
+    run("oled_draw_text 5x7 \"12:59 PM\"", bench_text_5x7, iterations);
+    run("oled_measure_text 18pt", bench_measure_text, iterations);
+    run("oled_draw_bitmap bluetooth", bench_bitmap, iterations);
+    run("oled_update full frame", bench_update_full, iterations);
+
+    printf("\n%-36s %13s %14s\n", "Screen render (buffer only)", "time/frame", "frames");
+    run("session full redraw", bench_session_full, iterations);
+    run("session incremental", bench_session_incremental, iterations);
+    run("session unchanged", bench_session_unchanged, iterations);
+    run("totals full redraw", bench_totals_full, iterations);
+
+    printf("\n%-36s %13s %14s\n", "Frame (render + oled_update)", "time/frame", "frames");
+    run("session full frame", bench_frame_full, iterations);
+    run("session incremental frame", bench_frame_incremental, iterations);
+
+    printf("\n%-36s\n", "Bus traffic per frame");
+    report_frame_traffic("session full frame", bench_session_full);
+    report_frame_traffic("session incremental frame", bench_session_incremental);
+
+    return 0;
+}
@@ -0,0 +1,26 @@
+/**
+ * Host stand-in for the Pico SDK's hardware/i2c.h
+ *
+ * Writes go to the in-memory SH1106 model (see sh1106_model.h) instead of a bus.
+ */
+
+#ifndef HOST_HARDWARE_I2C_H
+#define HOST_HARDWARE_I2C_H
+
+#include "pico/stdlib.h"
+
+typedef struct i2c_inst i2c_inst_t;
+
+extern i2c_inst_t *const host_i2c0;
+#define i2c0 host_i2c0
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+void i2c_deinit(i2c_inst_t *i2c);
+
+// Returns the number of bytes written, or a negative value if the model was
+// told to fail the transfer
+int i2c_write_timeout_us(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop,
+                         uint timeout_us);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+
+#endif // HOST_HARDWARE_I2C_H
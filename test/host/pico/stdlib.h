@@ -0,0 +1,34 @@
+/**
+ * Host stand-in for the Pico SDK's pico/stdlib.h
+ *
+ * Only the pieces used by the display modules are provided. Delays are no-ops
+ * so tests and benchmarks measure rendering, not simulated waits.
+ */
+
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+
+#define GPIO_FUNC_I2C 3
+
+static inline void sleep_ms(uint32_t ms) {
+    (void)ms;
+}
+
+static inline void gpio_set_function(uint gpio, uint fn) {
+    (void)gpio;
+    (void)fn;
+}
+
+static inline void gpio_set_pulls(uint gpio, bool up, bool down) {
+    (void)gpio;
+    (void)up;
+    (void)down;
+}
+
+#endif // HOST_PICO_STDLIB_H
@@ -1,6 +1,10 @@
 #include "mock_logging.h"
+#include "logging.h"
 #include <stdio.h>
 
+// Everything reaches log_printf, so the arguments are evaluated as on the device
+uint8_t log_tag_levels[LOG_TAG_COUNT] = { [0 ... LOG_TAG_COUNT - 1] = LOG_LEVEL_VERBOSE };
+
 // Mock implementation - logs are ignored in tests
 void logging_init(void) {
     // No-op in tests
@@ -34,18 +34,134 @@ echo "🧪 Running speed module tests..."
 echo "=================================="
 "$SCRIPT_DIR/build/test_speed"
 SPEED_RESULT=$?
+echo ""
+
+# Run test_fmt
+echo "🧪 Running fmt module tests..."
+echo "=================================="
+"$SCRIPT_DIR/build/test_fmt"
+FMT_RESULT=$?
+echo ""
+
+# Run test_screens
+echo "🧪 Running screen golden-image tests..."
+echo "=================================="
+"$SCRIPT_DIR/build/test_screens"
+SCREENS_RESULT=$?
+echo ""
+
+# Run test_log_ring
+echo "🧪 Running log ring tests..."
+echo "=================================="
+"$SCRIPT_DIR/build/test_log_ring"
+LOG_RING_RESULT=$?
+echo ""
+
+# Run test_log_persist
+echo "🧪 Running log retention tests..."
+echo "=================================="
+"$SCRIPT_DIR/build/test_log_persist"
+LOG_PERSIST_RESULT=$?
+echo ""
+
+# Run test_log_stream
+echo "🧪 Running log stream tests..."
+echo "=================================="
+"$SCRIPT_DIR/build/test_log_stream"
+LOG_STREAM_RESULT=$?
+echo ""
+
+# Run test_log_binary, then decode its records with the host tool
+echo "🧪 Running binary log tests..."
+echo "=================================="
+"$SCRIPT_DIR/build/test_log_binary" "$SCRIPT_DIR/build/log_binary_dump.bin" "$SCRIPT_DIR/build/log_binary_expected.txt"
+python3 "$PROJECT_ROOT/tools/log_decode.py" --no-time "$SCRIPT_DIR/build/log_strings/log_strings.json" \
+    "$SCRIPT_DIR/build/log_binary_dump.bin" | diff -u "$SCRIPT_DIR/build/log_binary_expected.txt" -
+LOG_BINARY_RESULT=$?
+echo ""
+
+# Run test_diag
+echo "🧪 Running diagnostics counter tests..."
+echo "=================================="
+"$SCRIPT_DIR/build/test_diag"
+DIAG_RESULT=$?
+echo ""
+
+# Run test_trace_buffer, then export its dump with the host tool
+echo "🧪 Running trace buffer tests..."
+echo "=================================="
+"$SCRIPT_DIR/build/test_trace_buffer" "$SCRIPT_DIR/build/trace_dump.txt"
+python3 "$PROJECT_ROOT/tools/trace_export.py" "$SCRIPT_DIR/build/trace_dump.txt" 2>/dev/null \
+    | diff -u "$SCRIPT_DIR/golden/trace_export.json" -
+TRACE_BUFFER_RESULT=$?
+echo ""
+
+# Run test_odo_packet
+echo "🧪 Running odometer packet tests..."
+echo "=================================="
+"$SCRIPT_DIR/build/test_odo_packet"
+ODO_PACKET_RESULT=$?
+echo ""
+
+# Run test_adv_broadcast
+echo "🧪 Running advertising broadcast tests..."
+echo "=================================="
+"$SCRIPT_DIR/build/test_adv_broadcast"
+ADV_BROADCAST_RESULT=$?
+echo ""
+
+# Run test_adv_schedule
+echo "🧪 Running advertising schedule tests..."
+echo "=================================="
+"$SCRIPT_DIR/build/test_adv_schedule"
+ADV_SCHEDULE_RESULT=$?
+echo ""
+
+# Run test_gatt_cache
+echo "🧪 Running GATT cache state tests..."
+echo "=================================="
+"$SCRIPT_DIR/build/test_gatt_cache"
+GATT_CACHE_RESULT=$?
+echo ""
+
+# Run test_bulk_proto
+echo "🧪 Running bulk transfer framing tests..."
+echo "=================================="
+"$SCRIPT_DIR/build/test_bulk_proto"
+BULK_PROTO_RESULT=$?
+echo ""
+
+# Run test_clock_sync
+echo "🧪 Running wall clock discipline tests..."
+echo "=================================="
+"$SCRIPT_DIR/build/test_clock_sync"
+CLOCK_SYNC_RESULT=$?
 
 echo ""
 echo "=================================="
 echo "Test Summary"
 echo "=================================="
 
-if [ $SPEED_RESULT -eq 0 ]; then
+if [ $SPEED_RESULT -eq 0 ] && [ $FMT_RESULT -eq 0 ] && [ $SCREENS_RESULT -eq 0 ] && [ $LOG_RING_RESULT -eq 0 ] && [ $LOG_PERSIST_RESULT -eq 0 ] && [ $LOG_STREAM_RESULT -eq 0 ] && [ $LOG_BINARY_RESULT -eq 0 ] && [ $DIAG_RESULT -eq 0 ] && [ $TRACE_BUFFER_RESULT -eq 0 ] && [ $ODO_PACKET_RESULT -eq 0 ] && [ $ADV_BROADCAST_RESULT -eq 0 ] && [ $ADV_SCHEDULE_RESULT -eq 0 ] && [ $GATT_CACHE_RESULT -eq 0 ] && [ $BULK_PROTO_RESULT -eq 0 ] && [ $CLOCK_SYNC_RESULT -eq 0 ]; then
     echo ""
     echo "🎉 All tests passed!"
     exit 0
 else
-    echo "❌ test_speed: FAILED"
+    [ $SPEED_RESULT -ne 0 ] && echo "❌ test_speed: FAILED"
+    [ $FMT_RESULT -ne 0 ] && echo "❌ test_fmt: FAILED"
+    [ $SCREENS_RESULT -ne 0 ] && echo "❌ test_screens: FAILED"
+    [ $LOG_RING_RESULT -ne 0 ] && echo "❌ test_log_ring: FAILED"
+    [ $LOG_PERSIST_RESULT -ne 0 ] && echo "❌ test_log_persist: FAILED"
+    [ $LOG_STREAM_RESULT -ne 0 ] && echo "❌ test_log_stream: FAILED"
+    [ $LOG_BINARY_RESULT -ne 0 ] && echo "❌ test_log_binary: FAILED"
+    [ $DIAG_RESULT -ne 0 ] && echo "❌ test_diag: FAILED"
+    [ $TRACE_BUFFER_RESULT -ne 0 ] && echo "❌ test_trace_buffer: FAILED"
+    [ $ODO_PACKET_RESULT -ne 0 ] && echo "❌ test_odo_packet: FAILED"
+    [ $ADV_BROADCAST_RESULT -ne 0 ] && echo "❌ test_adv_broadcast: FAILED"
+    [ $ADV_SCHEDULE_RESULT -ne 0 ] && echo "❌ test_adv_schedule: FAILED"
+    [ $GATT_CACHE_RESULT -ne 0 ] && echo "❌ test_gatt_cache: FAILED"
+    [ $BULK_PROTO_RESULT -ne 0 ] && echo "❌ test_bulk_proto: FAILED"
+    [ $CLOCK_SYNC_RESULT -ne 0 ] && echo "❌ test_clock_sync: FAILED"
     echo ""
     echo "⚠️  Tests failed. Please fix the issues before committing."
     exit 1
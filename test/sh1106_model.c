@@ -0,0 +1,367 @@
+/**
+ * In-memory SH1106 display controller implementation
+ */
+
+#include "sh1106_model.h"
+#include "hardware/i2c.h"
+#include <stdio.h>
+#include <string.h>
+
+#define CONTROL_CO 0x80 // Continuation: one byte follows, then another control byte
+#define CONTROL_DC 0x40 // Following byte(s) are display data, not commands
+
+// Single I2C bus instance handed to oled_init() as i2c0
+static struct i2c_inst {
+    int unused;
+} host_i2c0_inst;
+i2c_inst_t *const host_i2c0 = &host_i2c0_inst;
+
+static struct {
+    uint8_t ram[SH1106_PAGES][SH1106_RAM_COLUMNS];
+    uint8_t page;
+    uint8_t column;
+    uint8_t start_line;
+    uint8_t display_offset;
+    uint8_t contrast;
+    bool display_on;
+    bool segment_remap;   // 0xA1: column 2 is the left edge
+    bool com_reverse;     // 0xC8: page 0 is the top edge
+    bool inverse;
+    bool entire_on;
+    uint8_t pending_cmd;  // Two-byte command waiting for its argument (0 = none)
+} sh;
+
+static sh1106_stats_t stats;
+static uint32_t fail_count = 0;
+
+void sh1106_model_reset(void) {
+    memset(&sh, 0, sizeof(sh));
+    for (int page = 0; page < SH1106_PAGES; page++) {
+        for (int col = 0; col < SH1106_RAM_COLUMNS; col++) {
+            sh.ram[page][col] = (uint8_t)((page * 37 + col * 11) ^ 0xA5);
+        }
+    }
+    sh.contrast = 0x80;
+    fail_count = 0;
+    sh1106_model_reset_stats();
+}
+
+void sh1106_model_reset_stats(void) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+sh1106_stats_t sh1106_model_stats(void) {
+    return stats;
+}
+
+void sh1106_model_fail_writes(uint32_t count) {
+    fail_count = count;
+}
+
+bool sh1106_model_display_on(void) {
+    return sh.display_on;
+}
+
+uint8_t sh1106_model_contrast(void) {
+    return sh.contrast;
+}
+
+static void execute_command(uint8_t cmd) {
+    stats.commands++;
+
+    if (sh.pending_cmd) {
+        uint8_t op = sh.pending_cmd;
+        sh.pending_cmd = 0;
+        switch (op) {
+        case 0x81: sh.contrast = cmd; break;
+        case 0xD3: sh.display_offset = cmd & 0x3F; break;
+        default: break; // Multiplex, clock, pre-charge, COM pins, VCOMH, DC-DC: no visible effect
+        }
+        return;
+    }
+
+    if (cmd <= 0x0F) {
+        sh.column = (sh.column & 0xF0) | cmd;
+    } else if (cmd <= 0x1F) {
+        sh.column = (uint8_t)((sh.column & 0x0F) | ((cmd & 0x0F) << 4));
+    } else if (cmd >= 0x40 && cmd <= 0x7F) {
+        sh.start_line = cmd & 0x3F;
+    } else if (cmd >= 0xB0 && cmd <= 0xB7) {
+        sh.page = cmd & 0x07;
+    } else if (cmd >= 0xC0 && cmd <= 0xCF) {
+        sh.com_reverse = (cmd & 0x08) != 0;
+    } else {
+        switch (cmd) {
+        case 0x81: case 0xA8: case 0xAD: case 0xD3:
+        case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+            sh.pending_cmd = cmd;
+            break;
+        case 0xA0: case 0xA1: sh.segment_remap = cmd & 1; break;
+        case 0xA4: case 0xA5: sh.entire_on = cmd & 1; break;
+        case 0xA6: case 0xA7: sh.inverse = cmd & 1; break;
+        case 0xAE: case 0xAF: sh.display_on = cmd & 1; break;
+        default:
+            // Not an SH1106 command (e.g. the SSD1306 charge pump 0x8D) - ignored,
+            // so its argument byte is decoded as a command of its own
+            break;
+        }
+    }
+}
+
+static void write_data(uint8_t value) {
+    stats.data_bytes++;
+    if (sh.column < SH1106_RAM_COLUMNS) {
+        sh.ram[sh.page][sh.column] = value;
+        sh.column++; // Stops at the end of the page, no wrap to the next page
+    }
+}
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    (void)i2c;
+    return baudrate;
+}
+
+void i2c_deinit(i2c_inst_t *i2c) {
+    (void)i2c;
+}
+
+int i2c_write_timeout_us(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop,
+                         uint timeout_us) {
+    (void)i2c;
+    (void)addr;
+    (void)nostop;
+    (void)timeout_us;
+
+    if (fail_count > 0) {
+        fail_count--;
+        stats.failed++;
+        return -1; // PICO_ERROR_GENERIC
+    }
+
+    stats.transactions++;
+    stats.bytes += (uint32_t)len;
+
+    size_t i = 0;
+    while (i < len) {
+        uint8_t control = src[i++];
+        bool data = (control & CONTROL_DC) != 0;
+
+        if (control & CONTROL_CO) {
+            // One byte, then another control byte
+            if (i < len) {
+                if (data) write_data(src[i]); else execute_command(src[i]);
+                i++;
+            }
+        } else {
+            // Everything after this control byte is the same kind
+            for (; i < len; i++) {
+                if (data) write_data(src[i]); else execute_command(src[i]);
+            }
+        }
+    }
+    return (int)len;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    return i2c_write_timeout_us(i2c, addr, src, len, nostop, 0);
+}
+
+bool sh1106_model_pixel(int x, int y) {
+    if (x < 0 || x >= SH1106_PANEL_WIDTH || y < 0 || y >= SH1106_PANEL_HEIGHT || !sh.display_on) {
+        return false;
+    }
+    if (sh.entire_on) {
+        return true;
+    }
+
+    // Orientation oled.c configures (0xA1/0xC8) is upright; the others mirror
+    int col = sh.segment_remap ? x + SH1106_COLUMN_OFFSET : SH1106_RAM_COLUMNS - 1 - SH1106_COLUMN_OFFSET - x;
+    int row = sh.com_reverse ? y : SH1106_PANEL_HEIGHT - 1 - y;
+    row = (row + sh.start_line + sh.display_offset) % SH1106_PANEL_HEIGHT;
+
+    bool lit = (sh.ram[row / 8][col] >> (row & 7)) & 1;
+    return lit != sh.inverse;
+}
+
+bool sh1106_model_save_pbm(const char *path) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        return false;
+    }
+    fprintf(f, "P1\n%d %d\n", SH1106_PANEL_WIDTH, SH1106_PANEL_HEIGHT);
+    for (int y = 0; y < SH1106_PANEL_HEIGHT; y++) {
+        for (int x = 0; x < SH1106_PANEL_WIDTH; x++) {
+            fputc(sh1106_model_pixel(x, y) ? '1' : '0', f);
+        }
+        fputc('\n', f);
+    }
+    return fclose(f) == 0;
+}
+
+// ============================================================================
+// PNG OUTPUT (uncompressed deflate, no zlib dependency)
+// ============================================================================
+
+static uint32_t crc_table[256];
+
+static uint32_t png_crc(uint32_t crc, const uint8_t *data, size_t len) {
+    if (crc_table[1] == 0) {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            crc_table[n] = c;
+        }
+    }
+    for (size_t i = 0; i < len; i++) {
+        crc = crc_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+static void put_be32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static void png_chunk(FILE *f, const char *type, const uint8_t *data, uint32_t len) {
+    uint8_t header[8];
+    put_be32(header, len);
+    memcpy(&header[4], type, 4);
+    fwrite(header, 1, 8, f);
+    if (len) {
+        fwrite(data, 1, len, f);
+    }
+
+    uint32_t crc = png_crc(0xFFFFFFFFu, (const uint8_t *)type, 4);
+    crc = png_crc(crc, data, len) ^ 0xFFFFFFFFu;
+    uint8_t trailer[4];
+    put_be32(trailer, crc);
+    fwrite(trailer, 1, 4, f);
+}
+
+bool sh1106_model_save_png(const char *path, int scale) {
+    if (scale < 1 || scale > 8) {
+        return false;
+    }
+
+    int width = SH1106_PANEL_WIDTH * scale;
+    int height = SH1106_PANEL_HEIGHT * scale;
+    size_t stride = 1 + (size_t)(width + 7) / 8; // Filter byte + packed row
+    size_t raw_len = stride * (size_t)height;
+
+    // Raw scanlines (filter type 0)
+    static uint8_t raw[(1 + SH1106_PANEL_WIDTH) * SH1106_PANEL_HEIGHT * 8];
+    memset(raw, 0, raw_len);
+    for (int y = 0; y < height; y++) {
+        uint8_t *row = &raw[y * stride + 1];
+        for (int x = 0; x < width; x++) {
+            if (sh1106_model_pixel(x / scale, y / scale)) {
+                row[x / 8] |= (uint8_t)(0x80 >> (x & 7));
+            }
+        }
+    }
+
+    // zlib stream of stored deflate blocks
+    static uint8_t idat[sizeof(raw) + 2 + 5 * (sizeof(raw) / 65535 + 1) + 4];
+    size_t n = 0;
+    idat[n++] = 0x78;
+    idat[n++] = 0x01;
+    uint32_t adler_a = 1, adler_b = 0;
+    for (size_t pos = 0; pos < raw_len;) {
+        size_t block = raw_len - pos;
+        if (block > 65535) block = 65535;
+        idat[n++] = (pos + block == raw_len) ? 1 : 0; // BFINAL, BTYPE = stored
+        idat[n++] = (uint8_t)block;
+        idat[n++] = (uint8_t)(block >> 8);
+        idat[n++] = (uint8_t)~block;
+        idat[n++] = (uint8_t)(~block >> 8);
+        memcpy(&idat[n], &raw[pos], block);
+        for (size_t i = 0; i < block; i++) {
+            adler_a = (adler_a + raw[pos + i]) % 65521;
+            adler_b = (adler_b + adler_a) % 65521;
+        }
+        n += block;
+        pos += block;
+    }
+    put_be32(&idat[n], (adler_b << 16) | adler_a);
+    n += 4;
+
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        return false;
+    }
+
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    fwrite(signature, 1, sizeof(signature), f);
+
+    uint8_t ihdr[13];
+    put_be32(&ihdr[0], (uint32_t)width);
+    put_be32(&ihdr[4], (uint32_t)height);
+    ihdr[8] = 1;  // Bit depth
+    ihdr[9] = 0;  // Grayscale
+    ihdr[10] = 0; // Deflate
+    ihdr[11] = 0; // Adaptive filtering
+    ihdr[12] = 0; // No interlace
+    png_chunk(f, "IHDR", ihdr, sizeof(ihdr));
+    png_chunk(f, "IDAT", idat, (uint32_t)n);
+    png_chunk(f, "IEND", NULL, 0);
+
+    return fclose(f) == 0;
+}
+
+// ============================================================================
+// GOLDEN IMAGE COMPARISON
+// ============================================================================
+
+// Next non-whitespace, non-comment character of a plain PBM (EOF at the end)
+static int pbm_next(FILE *f) {
+    int c;
+    while ((c = fgetc(f)) != EOF) {
+        if (c == '#') {
+            while ((c = fgetc(f)) != EOF && c != '\n') {
+            }
+        } else if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+            return c;
+        }
+    }
+    return EOF;
+}
+
+int sh1106_model_compare_pbm(const char *path, int *first_x, int *first_y) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return -1;
+    }
+
+    int width = 0, height = 0;
+    if (fgetc(f) != 'P' || fgetc(f) != '1' || fscanf(f, "%d %d", &width, &height) != 2 ||
+        width != SH1106_PANEL_WIDTH || height != SH1106_PANEL_HEIGHT) {
+        fclose(f);
+        return -1;
+    }
+
+    int diffs = 0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int c = pbm_next(f);
+            if (c != '0' && c != '1') {
+                fclose(f);
+                return -1;
+            }
+            if ((c == '1') != sh1106_model_pixel(x, y)) {
+                if (diffs == 0) {
+                    if (first_x) *first_x = x;
+                    if (first_y) *first_y = y;
+                }
+                diffs++;
+            }
+        }
+    }
+
+    fclose(f);
+    return diffs;
+}
@@ -0,0 +1,64 @@
+/**
+ * In-memory SH1106 display controller for host builds
+ *
+ * Receives the I2C writes oled.c makes (through test/host/hardware/i2c.h),
+ * decodes control bytes, commands and display data the way the controller
+ * does, and keeps its 132x8-page display RAM. The visible 128x64 panel is
+ * columns 2-129 of that RAM, in the orientation oled.c configures.
+ *
+ * Also counts bus traffic so tests can check what a frame update costs, and
+ * writes panel snapshots as PBM (plain text, used for golden images) or PNG.
+ */
+
+#ifndef SH1106_MODEL_H
+#define SH1106_MODEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define SH1106_RAM_COLUMNS 132
+#define SH1106_PAGES 8
+#define SH1106_COLUMN_OFFSET 2
+#define SH1106_PANEL_WIDTH 128
+#define SH1106_PANEL_HEIGHT 64
+
+// Bus traffic since the last sh1106_model_reset_stats()
+typedef struct {
+    uint32_t transactions;  // I2C write transactions (one START..STOP each)
+    uint32_t bytes;         // Bytes on the bus, including control bytes (address byte excluded)
+    uint32_t commands;      // Command bytes (including command arguments)
+    uint32_t data_bytes;    // Display RAM bytes written
+    uint32_t failed;        // Transactions rejected by sh1106_model_fail_writes()
+} sh1106_stats_t;
+
+// Power-on state: RAM filled with a noise pattern (the real RAM is undefined),
+// display off, stats cleared
+void sh1106_model_reset(void);
+
+void sh1106_model_reset_stats(void);
+sh1106_stats_t sh1106_model_stats(void);
+
+// Make the next `count` write transactions fail without reaching the controller
+void sh1106_model_fail_writes(uint32_t count);
+
+bool sh1106_model_display_on(void);
+uint8_t sh1106_model_contrast(void);
+
+// Panel pixel as currently shown (false while the display is off)
+bool sh1106_model_pixel(int x, int y);
+
+// Save the panel as plain PBM (P1, one text row per pixel row, 1 = lit)
+// Returns false if the file could not be written
+bool sh1106_model_save_pbm(const char *path);
+
+// Save the panel as a 1-bit grayscale PNG (lit pixels white), each pixel
+// enlarged to scale x scale so snapshots are easy to look at
+bool sh1106_model_save_png(const char *path, int scale);
+
+// Compare the panel with a plain PBM image
+// Returns the number of differing pixels, or -1 if the file is missing or not
+// a 128x64 P1 image. The first difference is stored in first_x/first_y (may be NULL)
+int sh1106_model_compare_pbm(const char *path, int *first_x, int *first_y);
+
+#endif // SH1106_MODEL_H
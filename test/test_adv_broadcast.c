@@ -0,0 +1,156 @@
+/**
+ * Unit tests for adv_broadcast.c module
+ *
+ * Tests the live data broadcast in advertising manufacturer data:
+ * - Wire format: AD structure header, company id, little-endian fields
+ * - Fits the legacy advertising data next to the flags
+ * - Decoder: round trip, finds the structure among others, rejects other
+ *   companies and versions, truncated and malformed data
+ */
+
+#include "unity.h"
+#include "adv_broadcast.h"
+#include <string.h>
+
+static adv_broadcast_t data;
+static adv_broadcast_t decoded;
+static uint8_t adv[31];
+
+void setUp(void) {
+    data.sequence = 7;
+    data.session_rotations = 4660;      // About 1 mile
+    data.session_time_seconds = 1200;
+    data.running_speed_centi = 305;
+    data.metric = false;
+    memset(&decoded, 0, sizeof(decoded));
+    memset(adv, 0, sizeof(adv));
+}
+
+void tearDown(void) {
+}
+
+static void assert_decoded_equals_data(void) {
+    TEST_ASSERT_EQUAL_UINT8(data.sequence, decoded.sequence);
+    TEST_ASSERT_EQUAL_UINT32(data.session_rotations, decoded.session_rotations);
+    TEST_ASSERT_EQUAL_UINT32(data.session_time_seconds, decoded.session_time_seconds);
+    TEST_ASSERT_EQUAL_UINT16(data.running_speed_centi, decoded.running_speed_centi);
+    TEST_ASSERT_EQUAL(data.metric, decoded.metric);
+}
+
+// ============================================================================
+// ENCODER TESTS
+// ============================================================================
+
+void test_encode_layout(void) {
+    size_t len = adv_broadcast_encode(&data, adv);
+
+    TEST_ASSERT_EQUAL(ADV_BROADCAST_AD_SIZE, len);
+    TEST_ASSERT_EQUAL_UINT8(len - 1, adv[0]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, adv[1]);
+    TEST_ASSERT_EQUAL_HEX8(ADV_BROADCAST_COMPANY_ID & 0xFF, adv[2]);
+    TEST_ASSERT_EQUAL_HEX8(ADV_BROADCAST_COMPANY_ID >> 8, adv[3]);
+    TEST_ASSERT_EQUAL_UINT8(ADV_BROADCAST_VERSION, adv[4]);
+    TEST_ASSERT_EQUAL_UINT8(7, adv[5]);
+    TEST_ASSERT_EQUAL_HEX8(0x34, adv[6]);   // 4660 = 0x1234, little-endian
+    TEST_ASSERT_EQUAL_HEX8(0x12, adv[7]);
+    TEST_ASSERT_EQUAL_HEX8(0x31, adv[14]);  // 305 = 0x0131
+    TEST_ASSERT_EQUAL_HEX8(0x00, adv[16]);
+}
+
+void test_fits_advertising_data_with_flags(void) {
+    TEST_ASSERT_TRUE(3 + ADV_BROADCAST_AD_SIZE <= 31);
+}
+
+void test_metric_flag(void) {
+    data.metric = true;
+    adv_broadcast_encode(&data, adv);
+    TEST_ASSERT_EQUAL_HEX8(ADV_BROADCAST_FLAG_METRIC, adv[16]);
+}
+
+// ============================================================================
+// DECODER TESTS
+// ============================================================================
+
+void test_round_trip_after_flags(void) {
+    adv[0] = 0x02;
+    adv[1] = 0x01;
+    adv[2] = 0x06;
+    size_t len = 3 + adv_broadcast_encode(&data, &adv[3]);
+
+    TEST_ASSERT_TRUE(adv_broadcast_decode(adv, len, &decoded));
+    assert_decoded_equals_data();
+}
+
+void test_round_trip_large_values(void) {
+    data.sequence = 255;
+    data.session_rotations = 0xFFFFFFFFu;
+    data.session_time_seconds = 0x80000001u;
+    data.running_speed_centi = 0xFFFF;
+    data.metric = true;
+    size_t len = adv_broadcast_encode(&data, adv);
+
+    TEST_ASSERT_TRUE(adv_broadcast_decode(adv, len, &decoded));
+    assert_decoded_equals_data();
+}
+
+void test_decode_ignores_trailing_padding(void) {
+    adv_broadcast_encode(&data, adv);
+    TEST_ASSERT_TRUE(adv_broadcast_decode(adv, sizeof(adv), &decoded));
+}
+
+void test_decode_rejects_other_company_and_version(void) {
+    size_t len = adv_broadcast_encode(&data, adv);
+
+    adv[2] ^= 0x01;
+    TEST_ASSERT_FALSE(adv_broadcast_decode(adv, len, &decoded));
+    adv[2] ^= 0x01;
+
+    adv[4] = ADV_BROADCAST_VERSION + 1;
+    TEST_ASSERT_FALSE(adv_broadcast_decode(adv, len, &decoded));
+}
+
+void test_decode_rejects_truncated(void) {
+    size_t len = adv_broadcast_encode(&data, adv);
+    TEST_ASSERT_FALSE(adv_broadcast_decode(adv, len - 1, &decoded));
+
+    // Structure claims fewer bytes than the fields need
+    adv[0] = 1 + ADV_BROADCAST_PAYLOAD_SIZE - 1;
+    TEST_ASSERT_FALSE(adv_broadcast_decode(adv, len, &decoded));
+}
+
+void test_decode_accepts_appended_fields(void) {
+    adv_broadcast_encode(&data, adv);
+    adv[0] += 2; // A later version's extra bytes
+    TEST_ASSERT_TRUE(adv_broadcast_decode(adv, ADV_BROADCAST_AD_SIZE + 2, &decoded));
+    assert_decoded_equals_data();
+}
+
+void test_decode_without_broadcast(void) {
+    static const uint8_t flags_and_name[] = {0x02, 0x01, 0x06, 0x04, 0x09, 'W', 'O', 'D'};
+    TEST_ASSERT_FALSE(adv_broadcast_decode(flags_and_name, sizeof(flags_and_name), &decoded));
+    TEST_ASSERT_FALSE(adv_broadcast_decode(flags_and_name, 0, &decoded));
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Encoder
+    RUN_TEST(test_encode_layout);
+    RUN_TEST(test_fits_advertising_data_with_flags);
+    RUN_TEST(test_metric_flag);
+
+    // Decoder
+    RUN_TEST(test_round_trip_after_flags);
+    RUN_TEST(test_round_trip_large_values);
+    RUN_TEST(test_decode_ignores_trailing_padding);
+    RUN_TEST(test_decode_rejects_other_company_and_version);
+    RUN_TEST(test_decode_rejects_truncated);
+    RUN_TEST(test_decode_accepts_appended_fields);
+    RUN_TEST(test_decode_without_broadcast);
+
+    return UNITY_END();
+}
@@ -0,0 +1,216 @@
+/**
+ * Unit tests for adv_schedule.c module
+ *
+ * Tests the advertising interval schedule:
+ * - Starts fast and backs off in steps, catching up over missed steps
+ * - Events (kick, a session ending, sustained walking, restart) go back to the
+ *   fastest step
+ * - Time spent at each interval, not counted while connected
+ */
+
+#include "unity.h"
+#include "adv_schedule.h"
+
+static adv_schedule_t sched;
+static uint32_t times[ADV_SCHEDULE_STEP_COUNT];
+
+void setUp(void) {
+    adv_schedule_init(&sched);
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// BACK-OFF TESTS
+// ============================================================================
+
+void test_start_is_fastest(void) {
+    adv_schedule_start(&sched, 1000);
+    TEST_ASSERT_TRUE(adv_schedule_update(&sched, 1000));
+    TEST_ASSERT_EQUAL_HEX16(0x0030, adv_schedule_interval(&sched));
+    TEST_ASSERT_FALSE(adv_schedule_update(&sched, 2000)); // Nothing new to apply
+}
+
+void test_backs_off_in_steps(void) {
+    adv_schedule_start(&sched, 0);
+    adv_schedule_update(&sched, 0);
+
+    TEST_ASSERT_FALSE(adv_schedule_update(&sched, 29999));
+    TEST_ASSERT_TRUE(adv_schedule_update(&sched, 30000));
+    TEST_ASSERT_EQUAL_HEX16(0x00A0, adv_schedule_interval(&sched));
+
+    TEST_ASSERT_TRUE(adv_schedule_update(&sched, 90000));
+    TEST_ASSERT_EQUAL_HEX16(0x0320, adv_schedule_interval(&sched));
+
+    TEST_ASSERT_TRUE(adv_schedule_update(&sched, 390000));
+    TEST_ASSERT_EQUAL_HEX16(0x0800, adv_schedule_interval(&sched));
+
+    // Slowest step stays
+    TEST_ASSERT_FALSE(adv_schedule_update(&sched, 100000000));
+    TEST_ASSERT_EQUAL_HEX16(0x0800, adv_schedule_interval(&sched));
+}
+
+void test_catches_up_over_missed_steps(void) {
+    adv_schedule_start(&sched, 0);
+    TEST_ASSERT_TRUE(adv_schedule_update(&sched, 100000));
+    TEST_ASSERT_EQUAL_HEX16(0x0320, adv_schedule_interval(&sched));
+
+    // Each step is charged its own duration
+    adv_schedule_time_in_step(&sched, 100000, times);
+    TEST_ASSERT_EQUAL_UINT32(30000, times[0]);
+    TEST_ASSERT_EQUAL_UINT32(60000, times[1]);
+    TEST_ASSERT_EQUAL_UINT32(10000, times[2]);
+}
+
+void test_works_across_timer_wrap(void) {
+    uint32_t start = 0xFFFFF000u;
+    adv_schedule_start(&sched, start);
+    adv_schedule_update(&sched, start);
+    TEST_ASSERT_TRUE(adv_schedule_update(&sched, start + 30000));
+    TEST_ASSERT_EQUAL_HEX16(0x00A0, adv_schedule_interval(&sched));
+}
+
+// ============================================================================
+// EVENT TESTS
+// ============================================================================
+
+void test_kick_goes_back_to_fastest(void) {
+    adv_schedule_start(&sched, 0);
+    adv_schedule_update(&sched, 0);
+    adv_schedule_update(&sched, 400000);
+
+    adv_schedule_kick(&sched, 500000);
+    TEST_ASSERT_TRUE(adv_schedule_update(&sched, 500000));
+    TEST_ASSERT_EQUAL_HEX16(0x0030, adv_schedule_interval(&sched));
+    TEST_ASSERT_EQUAL_UINT32(1, sched.kicks);
+
+    // The fast window starts again from the kick
+    TEST_ASSERT_FALSE(adv_schedule_update(&sched, 529999));
+    TEST_ASSERT_TRUE(adv_schedule_update(&sched, 530000));
+}
+
+void test_kick_ignored_while_connected(void) {
+    adv_schedule_start(&sched, 0);
+    adv_schedule_stop(&sched, 1000);
+    adv_schedule_kick(&sched, 2000);
+    TEST_ASSERT_EQUAL_UINT32(0, sched.kicks);
+}
+
+void test_session_closing_kicks(void) {
+    adv_schedule_start(&sched, 0);
+    adv_schedule_update(&sched, 0);
+    adv_schedule_update(&sched, 40000); // 100 ms step
+
+    // No session ended yet: the count is unchanged
+    adv_schedule_sessions(&sched, 0, 41000);
+    TEST_ASSERT_FALSE(adv_schedule_update(&sched, 41000));
+    TEST_ASSERT_EQUAL_UINT32(0, sched.kicks);
+
+    adv_schedule_sessions(&sched, 1, 42000);
+    TEST_ASSERT_TRUE(adv_schedule_update(&sched, 42000));
+    TEST_ASSERT_EQUAL_HEX16(0x0030, adv_schedule_interval(&sched));
+
+    // Once per session
+    adv_schedule_sessions(&sched, 1, 43000);
+    TEST_ASSERT_EQUAL_UINT32(1, sched.kicks);
+}
+
+void test_session_closed_while_connected_does_not_kick_later(void) {
+    adv_schedule_start(&sched, 0);
+    adv_schedule_stop(&sched, 1000);
+    adv_schedule_sessions(&sched, 1, 2000);
+
+    adv_schedule_start(&sched, 3000);
+    adv_schedule_sessions(&sched, 1, 4000);
+    TEST_ASSERT_EQUAL_UINT32(0, sched.kicks);
+}
+
+void test_sustained_walking_kicks_once(void) {
+    adv_schedule_start(&sched, 0);
+    adv_schedule_update(&sched, 100000); // Backed off
+
+    adv_schedule_walking(&sched, true, 100000);
+    adv_schedule_walking(&sched, true, 100000 + ADV_SCHEDULE_WALKING_MS - 1);
+    TEST_ASSERT_EQUAL_UINT32(0, sched.kicks);
+
+    adv_schedule_walking(&sched, true, 100000 + ADV_SCHEDULE_WALKING_MS);
+    TEST_ASSERT_EQUAL_UINT32(1, sched.kicks);
+    TEST_ASSERT_EQUAL_HEX16(0x0030, adv_schedule_interval(&sched));
+
+    adv_schedule_walking(&sched, true, 200000);
+    TEST_ASSERT_EQUAL_UINT32(1, sched.kicks);
+}
+
+void test_short_walks_do_not_kick(void) {
+    adv_schedule_start(&sched, 0);
+    for (uint32_t t = 0; t < 60000; t += 1000) {
+        // Walking 5 s, stopped 1 s
+        adv_schedule_walking(&sched, (t / 1000) % 6 != 5, t);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, sched.kicks);
+}
+
+void test_restart_after_disconnect_is_fastest(void) {
+    adv_schedule_start(&sched, 0);
+    adv_schedule_update(&sched, 0);
+    adv_schedule_update(&sched, 400000);
+    adv_schedule_stop(&sched, 400000);
+
+    adv_schedule_start(&sched, 900000);
+    TEST_ASSERT_TRUE(adv_schedule_update(&sched, 900000));
+    TEST_ASSERT_EQUAL_HEX16(0x0030, adv_schedule_interval(&sched));
+}
+
+// ============================================================================
+// STATS TESTS
+// ============================================================================
+
+void test_connected_time_not_counted(void) {
+    adv_schedule_start(&sched, 0);
+    adv_schedule_stop(&sched, 10000);       // Connected for a minute
+    adv_schedule_start(&sched, 70000);
+    adv_schedule_time_in_step(&sched, 75000, times);
+
+    TEST_ASSERT_EQUAL_UINT32(15000, times[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, times[1]);
+}
+
+void test_stats_between_updates_not_double_counted(void) {
+    adv_schedule_start(&sched, 0);
+    adv_schedule_time_in_step(&sched, 50000, times); // Step 0 ended at 30 s
+    adv_schedule_update(&sched, 50001);
+    adv_schedule_time_in_step(&sched, 60000, times);
+
+    TEST_ASSERT_EQUAL_UINT32(30000, times[0]);
+    TEST_ASSERT_EQUAL_UINT32(30000, times[1]);
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Back-off
+    RUN_TEST(test_start_is_fastest);
+    RUN_TEST(test_backs_off_in_steps);
+    RUN_TEST(test_catches_up_over_missed_steps);
+    RUN_TEST(test_works_across_timer_wrap);
+
+    // Events
+    RUN_TEST(test_kick_goes_back_to_fastest);
+    RUN_TEST(test_kick_ignored_while_connected);
+    RUN_TEST(test_session_closing_kicks);
+    RUN_TEST(test_session_closed_while_connected_does_not_kick_later);
+    RUN_TEST(test_sustained_walking_kicks_once);
+    RUN_TEST(test_short_walks_do_not_kick);
+    RUN_TEST(test_restart_after_disconnect_is_fastest);
+
+    // Stats
+    RUN_TEST(test_connected_time_not_counted);
+    RUN_TEST(test_stats_between_updates_not_double_counted);
+
+    return UNITY_END();
+}
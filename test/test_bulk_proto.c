@@ -0,0 +1,212 @@
+/**
+ * Unit tests for bulk_proto.c module
+ *
+ * Tests the framing of the L2CAP bulk channel:
+ * - Requests: parse and write, wrong sizes refused
+ * - Frames: header, payload limited by frame size and requested length
+ * - End of a response: source exhausted, length reached, cursor moved by the source
+ * - Error frames
+ */
+
+#include "unity.h"
+#include "bulk_proto.h"
+#include <string.h>
+
+// Source for the tests: SOURCE_SIZE bytes with value (position & 0xFF)
+#define SOURCE_SIZE 100
+
+static bulk_transfer_t transfer;
+static uint8_t frame[64];
+static uint32_t skip_to; // read_source moves a cursor below this up to it (dropped data)
+
+static size_t read_source(void *context, uint32_t *cursor, uint8_t *dest, size_t max_len) {
+    (void)context;
+    if (*cursor < skip_to) {
+        *cursor = skip_to;
+    }
+    if (*cursor >= SOURCE_SIZE) {
+        return 0;
+    }
+    size_t len = (SOURCE_SIZE - *cursor < max_len) ? SOURCE_SIZE - *cursor : max_len;
+    for (size_t i = 0; i < len; i++) {
+        dest[i] = (uint8_t)(*cursor + i);
+    }
+    return len;
+}
+
+static uint32_t frame_cursor(void) {
+    return (uint32_t)frame[2] | ((uint32_t)frame[3] << 8) | ((uint32_t)frame[4] << 16) | ((uint32_t)frame[5] << 24);
+}
+
+static uint16_t frame_length(void) {
+    return (uint16_t)(frame[6] | (frame[7] << 8));
+}
+
+static void start(uint8_t type, uint32_t cursor, uint32_t length) {
+    bulk_request_t req = { type, cursor, length };
+    bulk_transfer_start(&transfer, &req);
+}
+
+void setUp(void) {
+    memset(&transfer, 0, sizeof(transfer));
+    memset(frame, 0, sizeof(frame));
+    skip_to = 0;
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// REQUEST TESTS
+// ============================================================================
+
+void test_request_round_trip(void) {
+    bulk_request_t req = { BULK_TYPE_SESSIONS, 0x12345678u, BULK_LENGTH_ALL };
+    uint8_t data[BULK_REQUEST_SIZE];
+    TEST_ASSERT_EQUAL(BULK_REQUEST_SIZE, bulk_write_request(&req, data));
+
+    static const uint8_t expected[] = {0x02, 0x78, 0x56, 0x34, 0x12, 0xFF, 0xFF, 0xFF, 0xFF};
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, data, sizeof(expected));
+
+    bulk_request_t parsed;
+    TEST_ASSERT_TRUE(bulk_parse_request(data, sizeof(data), &parsed));
+    TEST_ASSERT_EQUAL_UINT8(BULK_TYPE_SESSIONS, parsed.type);
+    TEST_ASSERT_EQUAL_HEX32(0x12345678u, parsed.cursor);
+    TEST_ASSERT_EQUAL_HEX32(BULK_LENGTH_ALL, parsed.length);
+}
+
+void test_request_wrong_size_refused(void) {
+    uint8_t data[BULK_REQUEST_SIZE + 1] = {0};
+    bulk_request_t parsed;
+    TEST_ASSERT_FALSE(bulk_parse_request(data, BULK_REQUEST_SIZE - 1, &parsed));
+    TEST_ASSERT_FALSE(bulk_parse_request(data, BULK_REQUEST_SIZE + 1, &parsed));
+    TEST_ASSERT_FALSE(bulk_parse_request(data, 0, &parsed));
+}
+
+// ============================================================================
+// FRAME TESTS
+// ============================================================================
+
+void test_frames_fill_to_frame_size(void) {
+    start(BULK_TYPE_LOGS, 0, BULK_LENGTH_ALL);
+
+    size_t len = bulk_transfer_next(&transfer, read_source, NULL, frame, 40);
+    TEST_ASSERT_EQUAL(40, len);
+    TEST_ASSERT_EQUAL_UINT8(BULK_TYPE_LOGS, frame[0]);
+    TEST_ASSERT_EQUAL_UINT8(BULK_STATUS_MORE, frame[1]);
+    TEST_ASSERT_EQUAL_UINT32(0, frame_cursor());
+    TEST_ASSERT_EQUAL_UINT16(40 - BULK_FRAME_HEADER_SIZE, frame_length());
+    TEST_ASSERT_EQUAL_UINT8(0, frame[BULK_FRAME_HEADER_SIZE]);
+    TEST_ASSERT_EQUAL_UINT8(31, frame[39]);
+
+    bulk_transfer_next(&transfer, read_source, NULL, frame, 40);
+    TEST_ASSERT_EQUAL_UINT32(32, frame_cursor());
+    TEST_ASSERT_EQUAL_UINT8(32, frame[BULK_FRAME_HEADER_SIZE]);
+}
+
+void test_source_exhausted_ends_transfer(void) {
+    start(BULK_TYPE_DIAG, 0, BULK_LENGTH_ALL);
+
+    uint32_t total = 0;
+    int frames = 0;
+    size_t len;
+    while ((len = bulk_transfer_next(&transfer, read_source, NULL, frame, sizeof(frame))) > 0) {
+        total += frame_length();
+        frames++;
+        TEST_ASSERT_EQUAL(BULK_FRAME_HEADER_SIZE + frame_length(), len);
+    }
+    TEST_ASSERT_EQUAL_UINT32(SOURCE_SIZE, total);
+    TEST_ASSERT_EQUAL(2, frames); // 56 + 44
+    TEST_ASSERT_EQUAL_UINT8(BULK_STATUS_END, frame[1]);
+    TEST_ASSERT_FALSE(transfer.active);
+    TEST_ASSERT_EQUAL_UINT32(SOURCE_SIZE, transfer.bytes);
+}
+
+void test_exact_fit_ends_with_empty_frame(void) {
+    start(BULK_TYPE_DIAG, SOURCE_SIZE - 56, BULK_LENGTH_ALL);
+
+    bulk_transfer_next(&transfer, read_source, NULL, frame, sizeof(frame));
+    TEST_ASSERT_EQUAL_UINT8(BULK_STATUS_MORE, frame[1]);
+
+    TEST_ASSERT_EQUAL(BULK_FRAME_HEADER_SIZE, bulk_transfer_next(&transfer, read_source, NULL, frame, sizeof(frame)));
+    TEST_ASSERT_EQUAL_UINT8(BULK_STATUS_END, frame[1]);
+    TEST_ASSERT_EQUAL_UINT32(SOURCE_SIZE, frame_cursor());
+}
+
+void test_requested_length_limits_response(void) {
+    start(BULK_TYPE_SESSIONS, 10, 20);
+
+    size_t len = bulk_transfer_next(&transfer, read_source, NULL, frame, sizeof(frame));
+    TEST_ASSERT_EQUAL(BULK_FRAME_HEADER_SIZE + 20, len);
+    TEST_ASSERT_EQUAL_UINT8(BULK_STATUS_END, frame[1]);
+    TEST_ASSERT_EQUAL_UINT32(10, frame_cursor());
+    TEST_ASSERT_EQUAL_UINT32(30, transfer.cursor);
+    TEST_ASSERT_EQUAL(0, bulk_transfer_next(&transfer, read_source, NULL, frame, sizeof(frame)));
+}
+
+void test_zero_length_request_gets_end_frame(void) {
+    start(BULK_TYPE_SESSIONS, 0, 0);
+
+    TEST_ASSERT_EQUAL(BULK_FRAME_HEADER_SIZE, bulk_transfer_next(&transfer, read_source, NULL, frame, sizeof(frame)));
+    TEST_ASSERT_EQUAL_UINT8(BULK_STATUS_END, frame[1]);
+    TEST_ASSERT_EQUAL_UINT16(0, frame_length());
+}
+
+void test_cursor_moved_by_source_shows_gap(void) {
+    skip_to = 50;
+    start(BULK_TYPE_LOGS, 5, BULK_LENGTH_ALL);
+
+    bulk_transfer_next(&transfer, read_source, NULL, frame, 20);
+    TEST_ASSERT_EQUAL_UINT32(50, frame_cursor());
+    TEST_ASSERT_EQUAL_UINT8(50, frame[BULK_FRAME_HEADER_SIZE]);
+    TEST_ASSERT_EQUAL_UINT32(62, transfer.cursor);
+}
+
+void test_frame_without_payload_room_not_built(void) {
+    start(BULK_TYPE_LOGS, 0, BULK_LENGTH_ALL);
+
+    TEST_ASSERT_EQUAL(0, bulk_transfer_next(&transfer, read_source, NULL, frame, BULK_FRAME_HEADER_SIZE));
+    TEST_ASSERT_TRUE(transfer.active);
+
+    transfer.active = false;
+    TEST_ASSERT_EQUAL(0, bulk_transfer_next(&transfer, read_source, NULL, frame, sizeof(frame)));
+}
+
+// ============================================================================
+// ERROR TESTS
+// ============================================================================
+
+void test_error_frame(void) {
+    bulk_request_t req = { 0x7F, 0x01020304u, 10 };
+    TEST_ASSERT_EQUAL(BULK_FRAME_HEADER_SIZE, bulk_error_frame(&req, frame));
+    TEST_ASSERT_EQUAL_UINT8(0x7F, frame[0]);
+    TEST_ASSERT_EQUAL_UINT8(BULK_STATUS_ERROR, frame[1]);
+    TEST_ASSERT_EQUAL_HEX32(0x01020304u, frame_cursor());
+    TEST_ASSERT_EQUAL_UINT16(0, frame_length());
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Requests
+    RUN_TEST(test_request_round_trip);
+    RUN_TEST(test_request_wrong_size_refused);
+
+    // Frames
+    RUN_TEST(test_frames_fill_to_frame_size);
+    RUN_TEST(test_source_exhausted_ends_transfer);
+    RUN_TEST(test_exact_fit_ends_with_empty_frame);
+    RUN_TEST(test_requested_length_limits_response);
+    RUN_TEST(test_zero_length_request_gets_end_frame);
+    RUN_TEST(test_cursor_moved_by_source_shows_gap);
+    RUN_TEST(test_frame_without_payload_room_not_built);
+
+    // Errors
+    RUN_TEST(test_error_frame);
+
+    return UNITY_END();
+}
@@ -0,0 +1,149 @@
+/**
+ * Unit tests for clock_sync.c module
+ *
+ * Tests the drift-disciplined wall clock:
+ * - No time before the first sync; the first sync sets it
+ * - Drift estimated once the baseline is long enough, and applied between syncs
+ * - A clock behind steps forward; one ahead slews back without going backwards
+ * - A clock far ahead is set back; a time change restarts the drift baseline
+ */
+
+#include "unity.h"
+#include "clock_sync.h"
+
+#define SECOND_US 1000000ull
+#define HOUR_US (3600 * SECOND_US)
+#define T0_UNIX_US (1750000000ull * SECOND_US)
+
+static clock_sync_t wall;
+
+// A local clock running 50 ppm slow: local time lags the phone's
+static uint64_t slow_local(uint64_t unix_elapsed_us) {
+    return unix_elapsed_us - unix_elapsed_us / 20000;
+}
+
+void setUp(void) {
+    clock_sync_init(&wall);
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// FIRST SYNC TESTS
+// ============================================================================
+
+void test_no_time_before_first_sync(void) {
+    TEST_ASSERT_FALSE(wall.synced);
+    TEST_ASSERT_EQUAL_UINT64(0, clock_sync_unix_us(&wall, 5 * SECOND_US));
+}
+
+void test_first_sync_sets_time(void) {
+    clock_sync_update(&wall, 10 * SECOND_US, T0_UNIX_US);
+
+    TEST_ASSERT_TRUE(wall.synced);
+    TEST_ASSERT_EQUAL_UINT32(1, wall.syncs);
+    TEST_ASSERT_EQUAL_UINT64(T0_UNIX_US, clock_sync_unix_us(&wall, 10 * SECOND_US));
+    TEST_ASSERT_EQUAL_UINT64(T0_UNIX_US + 2500, clock_sync_unix_us(&wall, 10 * SECOND_US + 2500));
+}
+
+// ============================================================================
+// DRIFT TESTS
+// ============================================================================
+
+void test_drift_waits_for_baseline(void) {
+    clock_sync_update(&wall, 0, T0_UNIX_US);
+    clock_sync_update(&wall, slow_local(HOUR_US / 2), T0_UNIX_US + HOUR_US / 2);
+
+    TEST_ASSERT_EQUAL_INT32(0, wall.drift_ppb);
+}
+
+void test_drift_estimated_and_applied(void) {
+    clock_sync_update(&wall, 0, T0_UNIX_US);
+    clock_sync_update(&wall, slow_local(2 * HOUR_US), T0_UNIX_US + 2 * HOUR_US);
+
+    TEST_ASSERT_INT32_WITHIN(100, 50000, wall.drift_ppb);
+
+    // Another hour on the slow clock: the estimate keeps the error to microseconds
+    uint64_t shown = clock_sync_unix_us(&wall, slow_local(3 * HOUR_US));
+    TEST_ASSERT_UINT64_WITHIN(1000, T0_UNIX_US + 3 * HOUR_US, shown);
+}
+
+// ============================================================================
+// CORRECTION TESTS
+// ============================================================================
+
+void test_clock_behind_steps_forward(void) {
+    clock_sync_update(&wall, 0, T0_UNIX_US);
+    clock_sync_update(&wall, 60 * SECOND_US, T0_UNIX_US + 60 * SECOND_US + 300000);
+
+    TEST_ASSERT_EQUAL_INT64(300000, wall.last_error_us);
+    TEST_ASSERT_EQUAL_UINT64(T0_UNIX_US + 60 * SECOND_US + 300000, clock_sync_unix_us(&wall, 60 * SECOND_US));
+}
+
+void test_clock_ahead_slews_without_going_back(void) {
+    clock_sync_update(&wall, 0, T0_UNIX_US);
+    uint64_t local = 60 * SECOND_US;
+    uint64_t before = clock_sync_unix_us(&wall, local);
+    clock_sync_update(&wall, local, T0_UNIX_US + 60 * SECOND_US - 200000);
+
+    TEST_ASSERT_EQUAL_INT64(-200000, wall.last_error_us);
+    TEST_ASSERT_EQUAL_UINT64(before, clock_sync_unix_us(&wall, local));
+
+    // Never backwards while slewing: at most 1 ms taken back per second
+    uint64_t last = before;
+    for (int s = 1; s <= 300; s++) {
+        uint64_t now = clock_sync_unix_us(&wall, local + s * SECOND_US);
+        TEST_ASSERT_TRUE(now > last);
+        last = now;
+    }
+
+    // Slewed in after 200 s, then on the phone's time
+    TEST_ASSERT_EQUAL_UINT64(T0_UNIX_US + 360 * SECOND_US - 200000, last);
+}
+
+void test_clock_far_ahead_set_back(void) {
+    clock_sync_update(&wall, 0, T0_UNIX_US);
+    clock_sync_update(&wall, 60 * SECOND_US, T0_UNIX_US + 50 * SECOND_US);
+
+    TEST_ASSERT_EQUAL_UINT64(T0_UNIX_US + 50 * SECOND_US, clock_sync_unix_us(&wall, 60 * SECOND_US));
+    TEST_ASSERT_EQUAL_INT64(0, wall.slew_us);
+}
+
+void test_time_change_restarts_baseline(void) {
+    clock_sync_update(&wall, 0, T0_UNIX_US);
+    clock_sync_update(&wall, slow_local(2 * HOUR_US), T0_UNIX_US + 2 * HOUR_US);
+    int32_t drift = wall.drift_ppb;
+
+    // The phone's clock moved an hour forward
+    uint64_t local = slow_local(3 * HOUR_US);
+    clock_sync_update(&wall, local, T0_UNIX_US + 4 * HOUR_US);
+
+    TEST_ASSERT_EQUAL_INT32(drift, wall.drift_ppb);
+    TEST_ASSERT_EQUAL_UINT64(local, wall.anchor_local_us);
+    TEST_ASSERT_EQUAL_UINT64(T0_UNIX_US + 4 * HOUR_US, clock_sync_unix_us(&wall, local));
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // First sync
+    RUN_TEST(test_no_time_before_first_sync);
+    RUN_TEST(test_first_sync_sets_time);
+
+    // Drift
+    RUN_TEST(test_drift_waits_for_baseline);
+    RUN_TEST(test_drift_estimated_and_applied);
+
+    // Corrections
+    RUN_TEST(test_clock_behind_steps_forward);
+    RUN_TEST(test_clock_ahead_slews_without_going_back);
+    RUN_TEST(test_clock_far_ahead_set_back);
+    RUN_TEST(test_time_change_restarts_baseline);
+
+    return UNITY_END();
+}
@@ -0,0 +1,177 @@
+/**
+ * Unit tests for diag.c module
+ *
+ * Tests the always-on diagnostics counters:
+ * - Timing statistics (count, min, avg, max) and skipped empty transfers
+ * - Rotation batches, ATT and notification counters
+ * - Snapshot layout (size and field offsets read by BLE clients) and reset
+ */
+
+#include "unity.h"
+#include "diag.h"
+#include <stddef.h>
+#include <string.h>
+
+static diag_snapshot_t snap;
+
+void setUp(void) {
+    diag_reset(0);
+    memset(&snap, 0xAA, sizeof(snap));
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// TIMING TESTS
+// ============================================================================
+
+void test_empty_timing_is_zero(void) {
+    diag_snapshot(&snap, 0);
+    TEST_ASSERT_EQUAL_UINT32(0, snap.loop.count);
+    TEST_ASSERT_EQUAL_UINT32(0, snap.loop.min_us);
+    TEST_ASSERT_EQUAL_UINT32(0, snap.loop.avg_us);
+    TEST_ASSERT_EQUAL_UINT32(0, snap.loop.max_us);
+}
+
+void test_loop_min_avg_max(void) {
+    diag_record_loop(300);
+    diag_record_loop(100);
+    diag_record_loop(200);
+    diag_snapshot(&snap, 0);
+
+    TEST_ASSERT_EQUAL_UINT32(3, snap.loop.count);
+    TEST_ASSERT_EQUAL_UINT32(100, snap.loop.min_us);
+    TEST_ASSERT_EQUAL_UINT32(200, snap.loop.avg_us);
+    TEST_ASSERT_EQUAL_UINT32(300, snap.loop.max_us);
+}
+
+void test_frame_without_transfer(void) {
+    diag_record_frame(500, 0);
+    diag_record_frame(700, 9000);
+    diag_snapshot(&snap, 0);
+
+    TEST_ASSERT_EQUAL_UINT32(2, snap.render.count);
+    TEST_ASSERT_EQUAL_UINT32(600, snap.render.avg_us);
+    TEST_ASSERT_EQUAL_UINT32(1, snap.transfer.count);
+    TEST_ASSERT_EQUAL_UINT32(9000, snap.transfer.max_us);
+}
+
+void test_flash_write_worst_latency(void) {
+    diag_record_flash_write(45000);
+    diag_record_flash_write(90000);
+    diag_snapshot(&snap, 0);
+
+    TEST_ASSERT_EQUAL_UINT32(2, snap.flash_write.count);
+    TEST_ASSERT_EQUAL_UINT32(90000, snap.flash_write.max_us);
+}
+
+// ============================================================================
+// COUNTER TESTS
+// ============================================================================
+
+void test_rotation_batches(void) {
+    diag_record_rotations(1, 40000);
+    diag_record_rotations(3, 90000);
+    diag_record_rotations(0, 123); // No batch
+    diag_snapshot(&snap, 0);
+
+    TEST_ASSERT_EQUAL_UINT32(4, snap.rotations);
+    TEST_ASSERT_EQUAL_UINT32(3, snap.max_batch);
+    TEST_ASSERT_EQUAL_UINT32(2, snap.irq_latency.count);
+    TEST_ASSERT_EQUAL_UINT32(65000, snap.irq_latency.avg_us);
+}
+
+void test_att_and_notify_counters(void) {
+    diag_count_att(DIAG_ATT_LOGS, false);
+    diag_count_att(DIAG_ATT_LOGS, false);
+    diag_count_att(DIAG_ATT_TIME_SYNC, true);
+    diag_count_att(DIAG_ATT_COUNT, true); // Unknown handle: ignored
+    diag_count_notify(true);
+    diag_count_notify(false);
+    diag_count_notify(true);
+    diag_count_i2c(1, 0);
+    diag_count_i2c(2, 1);
+    diag_snapshot(&snap, 0);
+
+    TEST_ASSERT_EQUAL_UINT32(2, snap.att_reads[DIAG_ATT_LOGS]);
+    TEST_ASSERT_EQUAL_UINT32(0, snap.att_writes[DIAG_ATT_LOGS]);
+    TEST_ASSERT_EQUAL_UINT32(1, snap.att_writes[DIAG_ATT_TIME_SYNC]);
+    TEST_ASSERT_EQUAL_UINT32(2, snap.notify_ok);
+    TEST_ASSERT_EQUAL_UINT32(1, snap.notify_failed);
+    TEST_ASSERT_EQUAL_UINT32(3, snap.i2c_errors);
+    TEST_ASSERT_EQUAL_UINT32(1, snap.i2c_recoveries);
+}
+
+void test_first_notification_by_bond_state(void) {
+    diag_record_first_notification(true, 300000);
+    diag_record_first_notification(true, 500000);
+    diag_record_first_notification(false, 2500000);
+    diag_count_pairing();
+    diag_snapshot(&snap, 0);
+
+    TEST_ASSERT_EQUAL_UINT32(2, snap.reconnect.count);
+    TEST_ASSERT_EQUAL_UINT32(400000, snap.reconnect.avg_us);
+    TEST_ASSERT_EQUAL_UINT32(1, snap.connect.count);
+    TEST_ASSERT_EQUAL_UINT32(2500000, snap.connect.max_us);
+    TEST_ASSERT_EQUAL_UINT32(1, snap.pairings);
+}
+
+// ============================================================================
+// SNAPSHOT TESTS
+// ============================================================================
+
+void test_snapshot_layout(void) {
+    diag_snapshot(&snap, 0);
+
+    TEST_ASSERT_EQUAL(228, sizeof(diag_snapshot_t));
+    TEST_ASSERT_EQUAL(4, offsetof(diag_snapshot_t, seconds));
+    TEST_ASSERT_EQUAL(8, offsetof(diag_snapshot_t, loop));
+    TEST_ASSERT_EQUAL(88, offsetof(diag_snapshot_t, rotations));
+    TEST_ASSERT_EQUAL(96, offsetof(diag_snapshot_t, att_reads));
+    TEST_ASSERT_EQUAL(176, offsetof(diag_snapshot_t, notify_ok));
+    TEST_ASSERT_EQUAL(192, offsetof(diag_snapshot_t, reconnect));
+    TEST_ASSERT_EQUAL(224, offsetof(diag_snapshot_t, pairings));
+    TEST_ASSERT_EQUAL_UINT8(DIAG_VERSION, snap.version);
+    TEST_ASSERT_EQUAL_UINT8(DIAG_ATT_COUNT, snap.att_count);
+    TEST_ASSERT_EQUAL_UINT16(0, snap.reserved);
+}
+
+void test_reset_clears_and_restarts_seconds(void) {
+    diag_record_loop(100);
+    diag_count_notify(true);
+    diag_count_att(DIAG_ATT_ODOMETER, false);
+
+    diag_reset(50000);
+    diag_snapshot(&snap, 62500);
+
+    TEST_ASSERT_EQUAL_UINT32(12, snap.seconds);
+    TEST_ASSERT_EQUAL_UINT32(0, snap.loop.count);
+    TEST_ASSERT_EQUAL_UINT32(0, snap.notify_ok);
+    TEST_ASSERT_EQUAL_UINT32(0, snap.att_reads[DIAG_ATT_ODOMETER]);
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Timing
+    RUN_TEST(test_empty_timing_is_zero);
+    RUN_TEST(test_loop_min_avg_max);
+    RUN_TEST(test_frame_without_transfer);
+    RUN_TEST(test_flash_write_worst_latency);
+
+    // Counters
+    RUN_TEST(test_rotation_batches);
+    RUN_TEST(test_att_and_notify_counters);
+    RUN_TEST(test_first_notification_by_bond_state);
+
+    // Snapshot
+    RUN_TEST(test_snapshot_layout);
+    RUN_TEST(test_reset_clears_and_restarts_seconds);
+
+    return UNITY_END();
+}
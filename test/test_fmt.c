@@ -0,0 +1,328 @@
+/**
+ * Unit tests for fmt.c module
+ *
+ * Checks the float-free formatters against the snprintf formats they replace:
+ * - Voltage ("%.1fV" / "%.2fV") for every millivolt value
+ * - Session time ("%lu:%02lu:%02lu" / "%lu:%02lu") and 12-hour clock
+ * - Session and lifetime distance strings (miles and km)
+ * - Exact half-to-even rounding and snprintf-style truncation
+ */
+
+#include "unity.h"
+#include "fmt.h"
+#include <stdio.h>
+#include <string.h>
+
+// Float conversion used by the screens before fmt.c (kept here as the reference)
+#define CM_PER_ROTATION 34.56f
+#define METERS_PER_MILE 1609.344f
+#define METERS_PER_KM 1000.0f
+#define MILES_PER_ROTATION (CM_PER_ROTATION / 100.0f / METERS_PER_MILE)
+#define KM_PER_ROTATION (CM_PER_ROTATION / 100.0f / METERS_PER_KM)
+
+// The float path loses precision as the count grows and starts rounding the wrong
+// way at 2397019 rotations (514.7499 mi shown as "514.8") and 192853 rotations
+// (66.6499 km shown as "66.7"); below these counts it is correctly rounded
+#define FLOAT_SAFE_MILES_ROTATIONS 2397019u
+#define FLOAT_SAFE_KM_ROTATIONS 192853u
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+static void reference_total_distance(char *buf, size_t size, float distance, const char *unit) {
+    if (distance >= 100.0f) {
+        snprintf(buf, size, "%.0f total %s", distance, unit);
+    } else if (distance >= 10.0f) {
+        snprintf(buf, size, "%.1f total %s", distance, unit);
+    } else {
+        snprintf(buf, size, "%.2f total %s", distance, unit);
+    }
+}
+
+static void reference_session_distance(char *buf, size_t size, float distance, const char *unit) {
+    if (distance >= 10.0f) {
+        snprintf(buf, size, "%.1f %s", distance, unit);
+    } else {
+        snprintf(buf, size, "%.2f %s", distance, unit);
+    }
+}
+
+// ============================================================================
+// INTEGER AND FIXED-POINT TESTS
+// ============================================================================
+
+void test_uint_matches_printf(void) {
+    const uint32_t values[] = {0, 1, 9, 10, 99, 100, 12345, 4294967295u};
+    char expected[16], actual[16];
+
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        snprintf(expected, sizeof(expected), "%lu", (unsigned long)values[i]);
+        size_t len = fmt_uint(actual, sizeof(actual), values[i]);
+        TEST_ASSERT_EQUAL_STRING(expected, actual);
+        TEST_ASSERT_EQUAL(strlen(expected), len);
+    }
+}
+
+void test_fixed_examples(void) {
+    char buf[16];
+
+    fmt_fixed(buf, sizeof(buf), 4125, 3, 2);
+    TEST_ASSERT_EQUAL_STRING("4.12", buf); // Tie rounds to even
+
+    fmt_fixed(buf, sizeof(buf), 4135, 3, 2);
+    TEST_ASSERT_EQUAL_STRING("4.14", buf); // Tie rounds to even
+
+    fmt_fixed(buf, sizeof(buf), 4126, 3, 2);
+    TEST_ASSERT_EQUAL_STRING("4.13", buf);
+
+    fmt_fixed(buf, sizeof(buf), 5, 3, 3);
+    TEST_ASSERT_EQUAL_STRING("0.005", buf); // Leading zeros in the fraction
+
+    fmt_fixed(buf, sizeof(buf), 9999, 3, 1);
+    TEST_ASSERT_EQUAL_STRING("10.0", buf); // Carry into the integer part
+
+    fmt_fixed(buf, sizeof(buf), 2500, 3, 0);
+    TEST_ASSERT_EQUAL_STRING("2", buf);
+}
+
+void test_ratio_precision_clamped(void) {
+    char buf[32];
+    fmt_ratio(buf, sizeof(buf), 1, 3, 9);
+    TEST_ASSERT_EQUAL_STRING("0.333333", buf);
+}
+
+// ============================================================================
+// VOLTAGE TESTS
+// ============================================================================
+
+// Every millivolt value that is not exactly half-way between two outputs
+void test_voltage_matches_printf_all_millivolts(void) {
+    char expected[16], actual[16];
+
+    for (uint32_t mv = 0; mv < 10000; mv++) {
+        if (mv % 100 != 50) {
+            snprintf(expected, sizeof(expected), "%.1fV", mv / 1000.0f);
+            fmt_voltage(actual, sizeof(actual), (uint16_t)mv, 1);
+            TEST_ASSERT_EQUAL_STRING(expected, actual);
+        }
+
+        if (mv % 10 != 5) {
+            snprintf(expected, sizeof(expected), "%.2fV", mv / 1000.0f);
+            fmt_voltage(actual, sizeof(actual), (uint16_t)mv, 2);
+            TEST_ASSERT_EQUAL_STRING(expected, actual);
+        }
+    }
+}
+
+// Half-way values: printf on a float rounds whichever way the binary
+// representation error falls (0.015f is just below, so "0.01"); fmt rounds
+// the exact value half to even, which agrees with printf when the half is
+// exactly representable
+void test_voltage_ties_round_half_to_even(void) {
+    char buf[16];
+
+    fmt_voltage(buf, sizeof(buf), 4125, 2);
+    TEST_ASSERT_EQUAL_STRING("4.12V", buf);
+
+    fmt_voltage(buf, sizeof(buf), 4375, 2);
+    TEST_ASSERT_EQUAL_STRING("4.38V", buf);
+
+    fmt_voltage(buf, sizeof(buf), 4250, 1);
+    TEST_ASSERT_EQUAL_STRING("4.2V", buf);
+
+    fmt_voltage(buf, sizeof(buf), 4750, 1);
+    TEST_ASSERT_EQUAL_STRING("4.8V", buf);
+
+    fmt_voltage(buf, sizeof(buf), 15, 2);
+    TEST_ASSERT_EQUAL_STRING("0.02V", buf);
+}
+
+// ============================================================================
+// TIME TESTS
+// ============================================================================
+
+void test_duration_matches_printf(void) {
+    char expected[24], actual[24];
+
+    for (uint32_t seconds = 0; seconds < 400000; seconds++) {
+        if (seconds >= 3600) {
+            snprintf(expected, sizeof(expected), "%lu:%02lu:%02lu", (unsigned long)(seconds / 3600),
+                     (unsigned long)((seconds % 3600) / 60), (unsigned long)(seconds % 60));
+        } else {
+            snprintf(expected, sizeof(expected), "%lu:%02lu", (unsigned long)(seconds / 60),
+                     (unsigned long)(seconds % 60));
+        }
+        fmt_duration(actual, sizeof(actual), seconds);
+        TEST_ASSERT_EQUAL_STRING(expected, actual);
+    }
+}
+
+void test_clock_matches_printf_every_second(void) {
+    char expected[16], actual[16];
+
+    for (uint32_t seconds = 0; seconds < 24 * 3600; seconds++) {
+        uint32_t hours = seconds / 3600;
+        uint32_t minutes = (seconds % 3600) / 60;
+        const char *am_pm = (hours >= 12) ? "PM" : "AM";
+        if (hours == 0)
+            hours = 12;
+        else if (hours > 12)
+            hours -= 12;
+
+        snprintf(expected, sizeof(expected), "%lu:%02lu %s", (unsigned long)hours, (unsigned long)minutes, am_pm);
+        fmt_clock_12h(actual, sizeof(actual), seconds);
+        TEST_ASSERT_EQUAL_STRING(expected, actual);
+    }
+}
+
+// ============================================================================
+// DISTANCE TESTS
+// ============================================================================
+
+void test_distance_examples(void) {
+    char buf[32];
+
+    fmt_distance(buf, sizeof(buf), 0, false, 1, "");
+    TEST_ASSERT_EQUAL_STRING("0.00 mi", buf);
+
+    fmt_distance(buf, sizeof(buf), 50000, false, 0, " total");
+    TEST_ASSERT_EQUAL_STRING("10.7 total mi", buf);
+
+    fmt_distance(buf, sizeof(buf), 50000, true, 0, " total");
+    TEST_ASSERT_EQUAL_STRING("17.3 total km", buf);
+
+    // Session distance never drops below one decimal
+    fmt_distance(buf, sizeof(buf), 1000000, false, 1, "");
+    TEST_ASSERT_EQUAL_STRING("214.7 mi", buf);
+
+    // 467995 rotations is exactly 100.5 miles: ties round to even like printf
+    fmt_distance(buf, sizeof(buf), 467995, false, 0, " total");
+    TEST_ASSERT_EQUAL_STRING("100 total mi", buf);
+}
+
+void test_distance_precision_thresholds(void) {
+    char buf[32];
+
+    // 46566 rotations = 9.9999 mi (rounds up, but precision follows the unrounded value)
+    fmt_distance(buf, sizeof(buf), 46566, false, 0, "");
+    TEST_ASSERT_EQUAL_STRING("10.00 mi", buf);
+
+    fmt_distance(buf, sizeof(buf), 46567, false, 0, "");
+    TEST_ASSERT_EQUAL_STRING("10.0 mi", buf);
+
+    fmt_distance(buf, sizeof(buf), 465666, false, 0, "");
+    TEST_ASSERT_EQUAL_STRING("100.0 mi", buf);
+
+    fmt_distance(buf, sizeof(buf), 465667, false, 0, "");
+    TEST_ASSERT_EQUAL_STRING("100 mi", buf);
+}
+
+void test_distance_matches_float_printf_miles(void) {
+    char expected[32], actual[32];
+
+    for (uint32_t rotations = 0; rotations < FLOAT_SAFE_MILES_ROTATIONS; rotations += 7) {
+        float distance = (float)rotations * MILES_PER_ROTATION;
+
+        reference_total_distance(expected, sizeof(expected), distance, "mi");
+        fmt_distance(actual, sizeof(actual), rotations, false, 0, " total");
+        TEST_ASSERT_EQUAL_STRING(expected, actual);
+
+        reference_session_distance(expected, sizeof(expected), distance, "mi");
+        fmt_distance(actual, sizeof(actual), rotations, false, 1, "");
+        TEST_ASSERT_EQUAL_STRING(expected, actual);
+    }
+}
+
+void test_distance_matches_float_printf_km(void) {
+    char expected[32], actual[32];
+
+    for (uint32_t rotations = 0; rotations < FLOAT_SAFE_KM_ROTATIONS; rotations++) {
+        float distance = (float)rotations * KM_PER_ROTATION;
+
+        reference_total_distance(expected, sizeof(expected), distance, "km");
+        fmt_distance(actual, sizeof(actual), rotations, true, 0, " total");
+        TEST_ASSERT_EQUAL_STRING(expected, actual);
+
+        reference_session_distance(expected, sizeof(expected), distance, "km");
+        fmt_distance(actual, sizeof(actual), rotations, true, 1, "");
+        TEST_ASSERT_EQUAL_STRING(expected, actual);
+    }
+}
+
+// Beyond the float-safe range, compare against double precision, which is
+// exact enough at these magnitudes to round correctly
+void test_distance_matches_exact_reference_large_counts(void) {
+    char expected[32], actual[32];
+
+    for (uint32_t rotations = 0; rotations < 200000000u; rotations += 997) {
+        double miles = (double)rotations * FMT_MILES_PER_ROTATION_NUM / FMT_MILES_PER_ROTATION_DEN;
+        double km = (double)rotations * FMT_KM_PER_ROTATION_NUM / FMT_KM_PER_ROTATION_DEN;
+
+        snprintf(expected, sizeof(expected), "%.*f mi", miles >= 100.0 ? 0 : miles >= 10.0 ? 1 : 2, miles);
+        fmt_distance(actual, sizeof(actual), rotations, false, 0, "");
+        TEST_ASSERT_EQUAL_STRING(expected, actual);
+
+        snprintf(expected, sizeof(expected), "%.*f km", km >= 100.0 ? 0 : km >= 10.0 ? 1 : 2, km);
+        fmt_distance(actual, sizeof(actual), rotations, true, 0, "");
+        TEST_ASSERT_EQUAL_STRING(expected, actual);
+    }
+}
+
+// ============================================================================
+// TRUNCATION TESTS
+// ============================================================================
+
+void test_truncation_matches_snprintf(void) {
+    char expected[16], actual[16];
+
+    for (size_t size = 1; size <= sizeof(actual); size++) {
+        memset(actual, 'x', sizeof(actual));
+        snprintf(expected, size, "%.1f total %s", 17.3f, "km");
+        size_t len = fmt_distance(actual, size, 50000, true, 0, " total");
+        TEST_ASSERT_EQUAL_STRING(expected, actual);
+        TEST_ASSERT_EQUAL(strlen(expected), len);
+    }
+}
+
+void test_zero_size_buffer_untouched(void) {
+    char buf[4] = {'a', 'b', 'c', '\0'};
+    TEST_ASSERT_EQUAL(0, fmt_voltage(buf, 0, 4200, 1));
+    TEST_ASSERT_EQUAL_STRING("abc", buf);
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Integer and fixed-point
+    RUN_TEST(test_uint_matches_printf);
+    RUN_TEST(test_fixed_examples);
+    RUN_TEST(test_ratio_precision_clamped);
+
+    // Voltage
+    RUN_TEST(test_voltage_matches_printf_all_millivolts);
+    RUN_TEST(test_voltage_ties_round_half_to_even);
+
+    // Time
+    RUN_TEST(test_duration_matches_printf);
+    RUN_TEST(test_clock_matches_printf_every_second);
+
+    // Distance
+    RUN_TEST(test_distance_examples);
+    RUN_TEST(test_distance_precision_thresholds);
+    RUN_TEST(test_distance_matches_float_printf_miles);
+    RUN_TEST(test_distance_matches_float_printf_km);
+    RUN_TEST(test_distance_matches_exact_reference_large_counts);
+
+    // Truncation
+    RUN_TEST(test_truncation_matches_snprintf);
+    RUN_TEST(test_zero_size_buffer_untouched);
+
+    return UNITY_END();
+}
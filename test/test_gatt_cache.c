@@ -0,0 +1,123 @@
+/**
+ * Unit tests for gatt_cache.c module
+ *
+ * Tests the GATT cache state kept for bonded clients:
+ * - Database fingerprint (CRC-32)
+ * - Boot: bonds made with another database are due a Service Changed,
+ *   bonds that are gone are dropped, a missing record tells every bond
+ * - Clients told, or newly bonded, are no longer due one
+ */
+
+#include "unity.h"
+#include "gatt_cache.h"
+#include <string.h>
+
+static gatt_cache_t cache;
+static gatt_cache_t stored;
+
+void setUp(void) {
+    memset(&cache, 0xAA, sizeof(cache));
+    stored.db_fingerprint = 0x11111111u;
+    stored.pending = 0;
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// FINGERPRINT TESTS
+// ============================================================================
+
+void test_fingerprint_is_crc32(void) {
+    static const uint8_t check[] = "123456789";
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926u, gatt_cache_fingerprint(check, 9));
+    TEST_ASSERT_EQUAL_HEX32(0x00000000u, gatt_cache_fingerprint(check, 0));
+}
+
+void test_fingerprint_changes_with_a_handle(void) {
+    uint8_t db[] = {0x01, 0x00, 0x02, 0x00, 0x03, 0x28};
+    uint32_t before = gatt_cache_fingerprint(db, sizeof(db));
+    db[2] = 0x03;
+    TEST_ASSERT_NOT_EQUAL(before, gatt_cache_fingerprint(db, sizeof(db)));
+}
+
+// ============================================================================
+// BOOT TESTS
+// ============================================================================
+
+void test_same_database_keeps_record(void) {
+    stored.pending = 0x04;
+    TEST_ASSERT_FALSE(gatt_cache_boot(&cache, &stored, 0x11111111u, 0x07));
+    TEST_ASSERT_EQUAL_HEX32(0x04, cache.pending);
+}
+
+void test_changed_database_tells_every_bond(void) {
+    TEST_ASSERT_TRUE(gatt_cache_boot(&cache, &stored, 0x22222222u, 0x05));
+    TEST_ASSERT_EQUAL_HEX32(0x22222222u, cache.db_fingerprint);
+    TEST_ASSERT_TRUE(gatt_cache_changed_for(&cache, 0));
+    TEST_ASSERT_FALSE(gatt_cache_changed_for(&cache, 1));
+    TEST_ASSERT_TRUE(gatt_cache_changed_for(&cache, 2));
+}
+
+void test_deleted_bond_dropped(void) {
+    stored.pending = 0x06;
+    TEST_ASSERT_TRUE(gatt_cache_boot(&cache, &stored, 0x11111111u, 0x02));
+    TEST_ASSERT_EQUAL_HEX32(0x02, cache.pending);
+}
+
+void test_missing_record_tells_every_bond(void) {
+    TEST_ASSERT_TRUE(gatt_cache_boot(&cache, NULL, 0x33333333u, 0x03));
+    TEST_ASSERT_EQUAL_HEX32(0x03, cache.pending);
+
+    // First boot with no bonds: just the fingerprint to store
+    TEST_ASSERT_TRUE(gatt_cache_boot(&cache, NULL, 0x33333333u, 0));
+    TEST_ASSERT_EQUAL_HEX32(0, cache.pending);
+}
+
+// ============================================================================
+// CLIENT TESTS
+// ============================================================================
+
+void test_told_client_is_current(void) {
+    gatt_cache_boot(&cache, &stored, 0x22222222u, 0x03);
+
+    TEST_ASSERT_TRUE(gatt_cache_client_current(&cache, 1));
+    TEST_ASSERT_FALSE(gatt_cache_changed_for(&cache, 1));
+    TEST_ASSERT_TRUE(gatt_cache_changed_for(&cache, 0));
+
+    // Nothing more to store the second time
+    TEST_ASSERT_FALSE(gatt_cache_client_current(&cache, 1));
+}
+
+void test_out_of_range_index_ignored(void) {
+    gatt_cache_boot(&cache, &stored, 0x22222222u, 0xFFFFFFFFu);
+
+    TEST_ASSERT_FALSE(gatt_cache_changed_for(&cache, -1));
+    TEST_ASSERT_FALSE(gatt_cache_changed_for(&cache, GATT_CACHE_MAX_CLIENTS));
+    TEST_ASSERT_FALSE(gatt_cache_client_current(&cache, -1));
+    TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFFu, cache.pending);
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Fingerprint
+    RUN_TEST(test_fingerprint_is_crc32);
+    RUN_TEST(test_fingerprint_changes_with_a_handle);
+
+    // Boot
+    RUN_TEST(test_same_database_keeps_record);
+    RUN_TEST(test_changed_database_tells_every_bond);
+    RUN_TEST(test_deleted_bond_dropped);
+    RUN_TEST(test_missing_record_tells_every_bond);
+
+    // Clients
+    RUN_TEST(test_told_client_is_current);
+    RUN_TEST(test_out_of_range_index_ignored);
+
+    return UNITY_END();
+}
@@ -0,0 +1,291 @@
+/**
+ * Unit tests for log_binary.h (LOG_BINARY=1 log_printf)
+ *
+ * Tests the record encoding:
+ * - Header layout and call site ID (LOG_FILE_ID, __LINE__)
+ * - Argument encoding by C type (32/64-bit integers, floats, strings)
+ * - Cutting a record short at an argument boundary
+ * - LOG_* level macros: run-time filtering and compiled-out levels
+ *
+ * When run with two file arguments it also writes a record dump and the text
+ * snprintf() produces for the same calls; the log_decode ctest feeds the dump
+ * through tools/log_decode.py and compares the result with that text.
+ */
+
+#include "unity.h"
+#include "logging.h"
+#include "log_strings.h" // Generated from this file by tools/log_strings.py
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#if !LOG_BINARY
+#error "test_log_binary must be built with LOG_BINARY=1"
+#endif
+
+uint8_t log_tag_levels[LOG_TAG_COUNT];
+
+static uint8_t last[LOG_BINARY_MAX_RECORD];
+static size_t last_len;
+static uint32_t fake_time_us;
+
+static uint8_t dump[8192];
+static size_t dump_len;
+static char expected[8192];
+static size_t expected_len;
+static int recording;
+
+// Stands in for the ring write in logging.c
+void log_binary_commit(log_binary_record_t *rec) {
+    last_len = log_binary_finish(rec, fake_time_us);
+    memcpy(last, rec->data, last_len);
+    fake_time_us += 1500;
+
+    if (recording && dump_len + last_len <= sizeof(dump)) {
+        memcpy(&dump[dump_len], rec->data, last_len);
+        dump_len += last_len;
+    }
+}
+
+// What the text-mode log_printf would have printed
+static void expect(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    expected_len += vsnprintf(&expected[expected_len], sizeof(expected) - expected_len, format, args);
+    va_end(args);
+}
+
+static uint32_t u32_at(size_t offset) {
+    return last[offset] | (last[offset + 1] << 8) | (last[offset + 2] << 16) | ((uint32_t)last[offset + 3] << 24);
+}
+
+void setUp(void) {
+    last_len = 0;
+    fake_time_us = 0x12345678;
+    memset(log_tag_levels, LOG_LEVEL_INFO, sizeof(log_tag_levels));
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// HEADER TESTS
+// ============================================================================
+
+void test_header_layout(void) {
+    log_printf("no arguments\n"); int line = __LINE__;
+
+    TEST_ASSERT_EQUAL(LOG_BINARY_HEADER_SIZE, last_len);
+    TEST_ASSERT_EQUAL_HEX8(LOG_BINARY_SYNC, last[0]);
+    TEST_ASSERT_EQUAL(LOG_BINARY_HEADER_SIZE, last[1]);
+    TEST_ASSERT_EQUAL(LOG_FILE_ID, last[2]);
+    TEST_ASSERT_EQUAL(line, last[3] | (last[4] << 8));
+    TEST_ASSERT_EQUAL_HEX32(0x12345678, u32_at(5));
+}
+
+// The ID is the line of the log_printf token, as tools/log_strings.py assumes
+void test_multi_line_call_uses_first_line(void) {
+    int line = __LINE__ + 1;
+    log_printf("spans %d %d\n",
+               1,
+               2);
+    TEST_ASSERT_EQUAL(line, last[3] | (last[4] << 8));
+}
+
+// ============================================================================
+// ARGUMENT ENCODING TESTS
+// ============================================================================
+
+void test_integers_are_four_bytes(void) {
+    uint8_t small = 200;
+    int negative = -2;
+    uint32_t big = 0xDEADBEEF;
+    log_printf("%u %d %lu %c\n", small, negative, (unsigned long)big, 'x');
+
+    TEST_ASSERT_EQUAL(LOG_BINARY_HEADER_SIZE + 16, last_len);
+    TEST_ASSERT_EQUAL_HEX32(200, u32_at(9));
+    TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFE, u32_at(13));
+    TEST_ASSERT_EQUAL_HEX32(0xDEADBEEF, u32_at(17));
+    TEST_ASSERT_EQUAL_HEX32('x', u32_at(21));
+}
+
+void test_long_long_is_eight_bytes(void) {
+    unsigned long long value = 0x0102030405060708ull;
+    log_printf("%llu\n", value);
+
+    TEST_ASSERT_EQUAL(LOG_BINARY_HEADER_SIZE + 8, last_len);
+    TEST_ASSERT_EQUAL_HEX32(0x05060708, u32_at(9));
+    TEST_ASSERT_EQUAL_HEX32(0x01020304, u32_at(13));
+}
+
+void test_float_and_double_are_float_bits(void) {
+    float speed = 2.5f;
+    double hours = 0.1;
+    log_printf("%.2f %.1f\n", speed, hours);
+
+    float a, b;
+    uint32_t bits = u32_at(9);
+    memcpy(&a, &bits, sizeof(a));
+    bits = u32_at(13);
+    memcpy(&b, &bits, sizeof(b));
+
+    TEST_ASSERT_EQUAL(LOG_BINARY_HEADER_SIZE + 8, last_len);
+    TEST_ASSERT_EQUAL_FLOAT(2.5f, a);
+    TEST_ASSERT_EQUAL_FLOAT(0.1f, b);
+}
+
+void test_strings_are_length_prefixed(void) {
+    int metric = 1;
+    log_printf("%s|%s\n", metric ? "YES (km)" : "NO (miles)", (const char *)NULL);
+
+    TEST_ASSERT_EQUAL(LOG_BINARY_HEADER_SIZE + 1 + 8 + 1 + 6, last_len);
+    TEST_ASSERT_EQUAL(8, last[9]);
+    TEST_ASSERT_EQUAL_MEMORY("YES (km)", &last[10], 8);
+    TEST_ASSERT_EQUAL(6, last[18]);
+    TEST_ASSERT_EQUAL_MEMORY("(null)", &last[19], 6);
+}
+
+void test_long_string_truncated(void) {
+    char text[LOG_BINARY_MAX_STRING + 10];
+    memset(text, 'a', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+    log_printf("%s\n", text);
+
+    TEST_ASSERT_EQUAL(LOG_BINARY_MAX_STRING, last[9]);
+    TEST_ASSERT_EQUAL(LOG_BINARY_HEADER_SIZE + 1 + LOG_BINARY_MAX_STRING, last_len);
+}
+
+// ============================================================================
+// OVERFLOW TESTS
+// ============================================================================
+
+void test_full_record_stops_at_argument_boundary(void) {
+    const char *s = "0123456789012345678901234567890123456789";
+    // 9 + 3 * 25 = 84 bytes, the next string needs 33 more than the 96 available
+    log_printf("%s %s %s %s %d\n", s + 16, s + 16, s + 16, s, 7);
+
+    TEST_ASSERT_EQUAL(LOG_BINARY_HEADER_SIZE + 3 * 25, last_len);
+    TEST_ASSERT_TRUE(last_len <= LOG_BINARY_MAX_RECORD);
+}
+
+void test_sixteen_arguments(void) {
+    log_printf("%d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d\n",
+               1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16);
+
+    TEST_ASSERT_EQUAL(LOG_BINARY_HEADER_SIZE + 64, last_len);
+    TEST_ASSERT_EQUAL_HEX32(16, u32_at(LOG_BINARY_HEADER_SIZE + 60));
+}
+
+// ============================================================================
+// LEVEL TESTS
+// ============================================================================
+
+static int evaluated;
+
+static int count_evaluation(void) {
+    return ++evaluated;
+}
+
+void test_level_filtered_at_run_time(void) {
+    evaluated = 0;
+    LOG_DEBUG(LOG_TAG_FLASH, "dump %d\n", count_evaluation());
+    TEST_ASSERT_EQUAL(0, last_len);
+    TEST_ASSERT_EQUAL(0, evaluated); // Arguments are not evaluated when filtered
+
+    LOG_INFO(LOG_TAG_FLASH, "info %d\n", count_evaluation()); int line = __LINE__;
+    TEST_ASSERT_EQUAL(LOG_BINARY_HEADER_SIZE + 4, last_len);
+    TEST_ASSERT_EQUAL(line, last[3] | (last[4] << 8));
+
+    last_len = 0;
+    log_tag_levels[LOG_TAG_FLASH] = LOG_LEVEL_DEBUG;
+    LOG_DEBUG(LOG_TAG_FLASH, "dump %d\n", count_evaluation());
+    TEST_ASSERT_EQUAL(LOG_BINARY_HEADER_SIZE + 4, last_len);
+    LOG_DEBUG(LOG_TAG_BLE, "other tag %d\n", count_evaluation());
+    TEST_ASSERT_EQUAL(2, evaluated);
+}
+
+// LOG_LEVEL_MAX defaults to DEBUG: VERBOSE is not in the build at all
+void test_level_above_max_compiled_out(void) {
+    evaluated = 0;
+    memset(log_tag_levels, LOG_LEVEL_VERBOSE, sizeof(log_tag_levels));
+    LOG_VERBOSE(LOG_TAG_SYSTEM, "status %d\n", count_evaluation());
+    TEST_ASSERT_EQUAL(0, last_len);
+    TEST_ASSERT_EQUAL(0, evaluated);
+}
+
+// ============================================================================
+// DECODER ROUND TRIP (checked by the log_decode ctest)
+// ============================================================================
+
+static void record_round_trip(void) {
+    uint32_t rotations = 123456;
+    float speed = 3.14159f;
+    const char *title = "Session save";
+
+    recording = 1;
+    memset(log_tag_levels, LOG_LEVEL_INFO, sizeof(log_tag_levels));
+    log_binary_record_t rec;
+    log_binary_begin(&rec, 0, LOG_BINARY_SITE_BOOT);
+    log_binary_put_u32(&rec, LOG_STRINGS_HASH);
+    log_binary_commit(&rec);
+    expect("=== boot (string table OK) ===\n");
+
+    log_printf("[FLASH WRITE] %s:\n", title); expect("[FLASH WRITE] %s:\n", title);
+    log_printf("  Rotations: %lu, speed %.2f mph\n", (unsigned long)rotations, speed);
+    expect("  Rotations: %lu, speed %.2f mph\n", (unsigned long)rotations, speed);
+    log_printf("CCCD 0x%04x %s %d%%\n", 0x1A, "on", -5); expect("CCCD 0x%04x %s %d%%\n", 0x1A, "on", -5);
+    log_printf("[%08lX] ", (unsigned long)0xBEEFu); expect("[%08lX] ", (unsigned long)0xBEEFu);
+    log_printf("same line\n"); expect("same line\n");
+    LOG_WARN(LOG_TAG_BLE, "[BLE] level macro %u\n", 42u); expect("[BLE] level macro %u\n", 42u);
+    log_printf("Uptime %.1f sec, %llu us\n", 12.25f, 5000000000ull);
+    expect("Uptime %.1f sec, %llu us\n", 12.25f, 5000000000ull);
+    recording = 0;
+}
+
+static int write_file(const char *path, const void *data, size_t len) {
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) {
+        return 0;
+    }
+    size_t written = fwrite(data, 1, len, f);
+    fclose(f);
+    return written == len;
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Header
+    RUN_TEST(test_header_layout);
+    RUN_TEST(test_multi_line_call_uses_first_line);
+
+    // Argument encoding
+    RUN_TEST(test_integers_are_four_bytes);
+    RUN_TEST(test_long_long_is_eight_bytes);
+    RUN_TEST(test_float_and_double_are_float_bits);
+    RUN_TEST(test_strings_are_length_prefixed);
+    RUN_TEST(test_long_string_truncated);
+
+    // Overflow
+    RUN_TEST(test_full_record_stops_at_argument_boundary);
+    RUN_TEST(test_sixteen_arguments);
+
+    // Levels
+    RUN_TEST(test_level_filtered_at_run_time);
+    RUN_TEST(test_level_above_max_compiled_out);
+
+    int failures = UNITY_END();
+
+    if (argc == 3) {
+        record_round_trip();
+        if (!write_file(argv[1], dump, dump_len) || !write_file(argv[2], expected, expected_len)) {
+            fprintf(stderr, "Could not write %s / %s\n", argv[1], argv[2]);
+            return 1;
+        }
+    }
+    return failures;
+}
@@ -0,0 +1,279 @@
+/**
+ * Unit tests for log_persist.c module
+ *
+ * Tests log retention across resets:
+ * - Garbage headers and mismatched rings start an empty log
+ * - An intact log is kept, the boot counted and the crash record handed over
+ * - Rewinding to the previous boot's last lines at a message boundary
+ * - Binary resync not fooled by 0xFE inside a record
+ * - Seeking to a client's resume point only while it is still buffered
+ */
+
+#include "unity.h"
+#include "log_persist.h"
+#include <stdio.h>
+#include <string.h>
+
+#define RING_SIZE 32
+
+static char storage[RING_SIZE];
+static log_persist_t persist;
+static log_crash_t crash;
+
+// Fresh power-on: SRAM holds whatever it powered up with
+void setUp(void) {
+    memset(storage, 0xA5, sizeof(storage));
+    memset(&persist, 0xA5, sizeof(persist));
+    memset(&crash, 0xA5, sizeof(crash));
+    TEST_ASSERT_FALSE(log_persist_restore(&persist, storage, RING_SIZE, &crash));
+}
+
+void tearDown(void) {
+}
+
+static void put(const char *text) {
+    log_ring_write(&persist.ring, text, strlen(text));
+}
+
+// Unread data as a string
+static const char *unread(void) {
+    static char out[RING_SIZE + 1];
+    log_ring_spans_t spans;
+    size_t total = log_ring_peek(&persist.ring, &spans);
+    memcpy(out, spans.data[0], spans.len[0]);
+    memcpy(out + spans.len[0], spans.data[1], spans.len[1]);
+    out[total] = '\0';
+    return out;
+}
+
+static void consume_all(void) {
+    log_ring_consume(&persist.ring, log_ring_available(&persist.ring));
+}
+
+// ============================================================================
+// RESTORE TESTS
+// ============================================================================
+
+void test_garbage_starts_empty(void) {
+    TEST_ASSERT_EQUAL(0, log_ring_available(&persist.ring));
+    TEST_ASSERT_EQUAL(RING_SIZE, log_ring_free(&persist.ring));
+    TEST_ASSERT_EQUAL_UINT32(1, persist.boot_count);
+    TEST_ASSERT_EQUAL_UINT32(0, log_ring_dropped(&persist.ring));
+    TEST_ASSERT_EQUAL_UINT32(0, crash.magic);
+}
+
+void test_intact_log_is_kept(void) {
+    put("one\n");
+    consume_all();
+    put("two\n");
+    persist.ring.dropped = 5; // The old boot's reader had lost some
+
+    TEST_ASSERT_TRUE(log_persist_restore(&persist, storage, RING_SIZE, &crash));
+    TEST_ASSERT_EQUAL_STRING("two\n", unread());
+    TEST_ASSERT_EQUAL_UINT32(2, persist.boot_count);
+    TEST_ASSERT_EQUAL_UINT32(0, log_ring_dropped(&persist.ring));
+}
+
+void test_other_buffer_starts_empty(void) {
+    static char other[RING_SIZE];
+    put("one\n");
+
+    TEST_ASSERT_FALSE(log_persist_restore(&persist, other, RING_SIZE, &crash));
+    TEST_ASSERT_EQUAL(0, log_ring_available(&persist.ring));
+    TEST_ASSERT_EQUAL_UINT32(1, persist.boot_count);
+
+    // A different ring size (new firmware) is not trusted either
+    put("one\n");
+    TEST_ASSERT_FALSE(log_persist_restore(&persist, other, RING_SIZE / 2, &crash));
+}
+
+void test_inconsistent_indices_start_empty(void) {
+    put("one\n");
+    persist.ring.tail = persist.ring.head + 1; // Tail ahead of head
+    TEST_ASSERT_FALSE(log_persist_restore(&persist, storage, RING_SIZE, &crash));
+
+    put("one\n");
+    persist.ring.tail = persist.origin - 1; // Tail before the first byte
+    TEST_ASSERT_FALSE(log_persist_restore(&persist, storage, RING_SIZE, &crash));
+
+    persist.check = 0;
+    TEST_ASSERT_FALSE(log_persist_restore(&persist, storage, RING_SIZE, &crash));
+    TEST_ASSERT_EQUAL_UINT32(1, persist.boot_count);
+}
+
+void test_crash_record_handed_over_once(void) {
+    persist.crash.magic = LOG_CRASH_MAGIC;
+    persist.crash.pc = 0x10001234;
+    persist.crash.depth = 1;
+    persist.crash.backtrace[0] = 0x10005678;
+
+    TEST_ASSERT_TRUE(log_persist_restore(&persist, storage, RING_SIZE, &crash));
+    TEST_ASSERT_EQUAL_HEX32(LOG_CRASH_MAGIC, crash.magic);
+    TEST_ASSERT_EQUAL_HEX32(0x10001234, crash.pc);
+    TEST_ASSERT_EQUAL_HEX32(0x10005678, crash.backtrace[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, persist.crash.magic);
+
+    TEST_ASSERT_TRUE(log_persist_restore(&persist, storage, RING_SIZE, &crash));
+    TEST_ASSERT_EQUAL_UINT32(0, crash.magic);
+}
+
+// ============================================================================
+// REWIND TESTS
+// ============================================================================
+
+void test_rewind_from_start_of_log(void) {
+    put("one\ntwo\n");
+    consume_all();
+    log_persist_restore(&persist, storage, RING_SIZE, &crash);
+
+    TEST_ASSERT_EQUAL(8, log_persist_rewind(&persist, 64, false));
+    TEST_ASSERT_EQUAL_STRING("one\ntwo\n", unread());
+}
+
+void test_rewind_starts_after_newline(void) {
+    put("one\ntwo\nthree\n");
+    consume_all();
+    log_persist_restore(&persist, storage, RING_SIZE, &crash);
+
+    // The last 8 bytes start inside "two"
+    TEST_ASSERT_EQUAL(6, log_persist_rewind(&persist, 8, false));
+    TEST_ASSERT_EQUAL_STRING("three\n", unread());
+}
+
+// A binary record of `len` bytes: sync, length, then `fill`
+static void put_record(uint8_t len, char fill) {
+    char rec[96];
+    memset(rec, fill, sizeof(rec));
+    rec[0] = (char)0xFE;
+    rec[1] = (char)len;
+    log_ring_write(&persist.ring, rec, len);
+}
+
+void test_rewind_binary_starts_at_sync(void) {
+    put_record(10, 'a');
+    put_record(9, 'b');
+    consume_all();
+    log_persist_restore(&persist, storage, RING_SIZE, &crash);
+
+    TEST_ASSERT_EQUAL(9, log_persist_rewind(&persist, 12, true));
+    TEST_ASSERT_EQUAL_STRING("\xFE\x09" "bbbbbbb", unread());
+}
+
+// 0xFE inside a record's time or arguments is not a record start
+void test_rewind_binary_skips_false_sync(void) {
+    put_record(9, 'a');
+    put_record(12, 'b');
+    persist.ring.buffer[(persist.ring.head - 8) & persist.ring.mask] = (char)0xFE;
+    persist.ring.buffer[(persist.ring.head - 7) & persist.ring.mask] = 20; // Runs past head
+    persist.ring.buffer[(persist.ring.head - 5) & persist.ring.mask] = (char)0xFE;
+    persist.ring.buffer[(persist.ring.head - 4) & persist.ring.mask] = 9;  // Ends inside the next record
+    put_record(9, 'c');
+    consume_all();
+    log_persist_restore(&persist, storage, RING_SIZE, &crash);
+
+    TEST_ASSERT_EQUAL(9, log_persist_rewind(&persist, 19, true));
+    TEST_ASSERT_EQUAL_STRING("\xFE\x09" "ccccccc", unread());
+}
+
+void test_rewind_skips_older_unread_data(void) {
+    put("one\n");
+    consume_all();
+    put("two\nthree\n");
+    log_persist_restore(&persist, storage, RING_SIZE, &crash);
+
+    // Only the newest lines are replayed, read or not
+    TEST_ASSERT_EQUAL(6, log_persist_rewind(&persist, 8, false));
+    TEST_ASSERT_EQUAL_STRING("three\n", unread());
+}
+
+// The previous boot's reader stopped long ago and the ring wrapped many times
+void test_full_ring_at_reset_keeps_last_lines(void) {
+    char line[8];
+    for (int i = 0; i < 10; i++) {
+        snprintf(line, sizeof(line), "line%02d\n", i);
+        put(line);
+    }
+    log_persist_restore(&persist, storage, RING_SIZE, &crash);
+
+    TEST_ASSERT_EQUAL(14, log_persist_rewind(&persist, 16, false));
+    put("[BOOT]\n");
+    TEST_ASSERT_EQUAL_STRING("line08\nline09\n[BOOT]\n", unread());
+    TEST_ASSERT_EQUAL_UINT32(0, log_ring_dropped(&persist.ring));
+}
+
+void test_rewind_limited_to_ring_after_wrap(void) {
+    put("0123456789abcdef0123456789\n");
+    consume_all();
+    put("0123456789\n");
+    consume_all();
+    log_persist_restore(&persist, storage, RING_SIZE, &crash);
+
+    // Only the last 32 bytes are still in the buffer; the first whole line there
+    TEST_ASSERT_EQUAL(11, log_persist_rewind(&persist, 1024, false));
+    TEST_ASSERT_EQUAL_STRING("0123456789\n", unread());
+}
+
+void test_rewind_without_boundary_replays_nothing(void) {
+    put("one\n");
+    put("no newline at all");
+    consume_all();
+    log_persist_restore(&persist, storage, RING_SIZE, &crash);
+
+    TEST_ASSERT_EQUAL(0, log_persist_rewind(&persist, 10, false));
+    TEST_ASSERT_EQUAL(0, log_ring_available(&persist.ring));
+}
+
+// ============================================================================
+// SEEK TESTS
+// ============================================================================
+
+void test_seek_back_to_buffered_data(void) {
+    put("one\ntwo\n");
+    consume_all();
+
+    TEST_ASSERT_EQUAL_UINT32(4, log_persist_seek(&persist, 4));
+    TEST_ASSERT_EQUAL_STRING("two\n", unread());
+}
+
+void test_seek_outside_buffer_keeps_position(void) {
+    put("0123456789abcdef0123456789\n");
+    consume_all();
+    put("0123456789\n");
+    consume_all(); // 38 bytes written, the first 6 overwritten
+
+    TEST_ASSERT_EQUAL_UINT32(38, log_persist_seek(&persist, 5));
+    TEST_ASSERT_EQUAL_UINT32(38, log_persist_seek(&persist, 39));
+    TEST_ASSERT_EQUAL_UINT32(6, log_persist_seek(&persist, 6));
+    TEST_ASSERT_EQUAL(32, log_ring_available(&persist.ring));
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Restore
+    RUN_TEST(test_garbage_starts_empty);
+    RUN_TEST(test_intact_log_is_kept);
+    RUN_TEST(test_other_buffer_starts_empty);
+    RUN_TEST(test_inconsistent_indices_start_empty);
+    RUN_TEST(test_crash_record_handed_over_once);
+
+    // Rewind
+    RUN_TEST(test_rewind_from_start_of_log);
+    RUN_TEST(test_rewind_starts_after_newline);
+    RUN_TEST(test_rewind_binary_starts_at_sync);
+    RUN_TEST(test_rewind_binary_skips_false_sync);
+    RUN_TEST(test_rewind_skips_older_unread_data);
+    RUN_TEST(test_full_ring_at_reset_keeps_last_lines);
+    RUN_TEST(test_rewind_limited_to_ring_after_wrap);
+    RUN_TEST(test_rewind_without_boundary_replays_nothing);
+
+    // Seek
+    RUN_TEST(test_seek_back_to_buffered_data);
+    RUN_TEST(test_seek_outside_buffer_keeps_position);
+
+    return UNITY_END();
+}
@@ -0,0 +1,261 @@
+/**
+ * Unit tests for log_ring.c module
+ *
+ * Tests the lock-free log ring:
+ * - Power-of-two sizing
+ * - Keep-newest writes and the reader's dropped-bytes counter
+ * - Two-span zero-copy reads across the wrap point
+ * - Free-running counters wrapping past 2^32
+ */
+
+#include "unity.h"
+#include "log_ring.h"
+#include <string.h>
+
+#define RING_SIZE 16
+
+static char storage[RING_SIZE];
+static log_ring_t ring;
+
+void setUp(void) {
+    memset(storage, 0, sizeof(storage));
+    TEST_ASSERT_TRUE(log_ring_init(&ring, storage, RING_SIZE));
+}
+
+void tearDown(void) {
+}
+
+// Read everything through the span API into a string
+static size_t drain(char *out, size_t size) {
+    log_ring_spans_t spans;
+    size_t total = log_ring_peek(&ring, &spans);
+    TEST_ASSERT_TRUE(total < size);
+    memcpy(out, spans.data[0], spans.len[0]);
+    memcpy(out + spans.len[0], spans.data[1], spans.len[1]);
+    out[total] = '\0';
+    log_ring_consume(&ring, total);
+    return total;
+}
+
+// ============================================================================
+// INITIALIZATION TESTS
+// ============================================================================
+
+void test_init_rejects_non_power_of_two(void) {
+    log_ring_t other;
+    TEST_ASSERT_FALSE(log_ring_init(&other, storage, 0));
+    TEST_ASSERT_FALSE(log_ring_init(&other, storage, 12));
+    TEST_ASSERT_TRUE(log_ring_init(&other, storage, 8));
+}
+
+void test_init_is_empty(void) {
+    log_ring_spans_t spans;
+    TEST_ASSERT_EQUAL(0, log_ring_available(&ring));
+    TEST_ASSERT_EQUAL(RING_SIZE, log_ring_free(&ring));
+    TEST_ASSERT_EQUAL(0, log_ring_peek(&ring, &spans));
+    TEST_ASSERT_EQUAL(0, spans.len[0]);
+    TEST_ASSERT_EQUAL(0, spans.len[1]);
+    TEST_ASSERT_EQUAL_UINT32(0, log_ring_dropped(&ring));
+}
+
+// ============================================================================
+// WRITE / READ TESTS
+// ============================================================================
+
+void test_write_then_read(void) {
+    char out[32];
+    log_ring_write(&ring, "hello\n", 6);
+    TEST_ASSERT_EQUAL(6, log_ring_available(&ring));
+    TEST_ASSERT_EQUAL(6, log_ring_read(&ring, out, sizeof(out)));
+    out[6] = '\0';
+    TEST_ASSERT_EQUAL_STRING("hello\n", out);
+    TEST_ASSERT_EQUAL(0, log_ring_available(&ring));
+}
+
+void test_fill_to_exact_capacity(void) {
+    char out[32];
+    log_ring_write(&ring, "0123456789ABCDEF", RING_SIZE);
+    TEST_ASSERT_EQUAL(0, log_ring_free(&ring));
+    TEST_ASSERT_EQUAL(RING_SIZE, drain(out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("0123456789ABCDEF", out);
+}
+
+void test_partial_read_respects_max_len(void) {
+    char out[32] = {0};
+    log_ring_write(&ring, "abcdef", 6);
+    TEST_ASSERT_EQUAL(4, log_ring_read(&ring, out, 4));
+    TEST_ASSERT_EQUAL_STRING("abcd", out);
+    TEST_ASSERT_EQUAL(2, log_ring_available(&ring));
+}
+
+void test_wrapped_data_spans_two_segments(void) {
+    char out[32];
+    log_ring_spans_t spans;
+
+    log_ring_write(&ring, "0123456789", 10);
+    log_ring_consume(&ring, 10);
+
+    // 6 bytes fit before the end, 4 wrap to the start
+    log_ring_write(&ring, "abcdefghij", 10);
+    TEST_ASSERT_EQUAL(10, log_ring_peek(&ring, &spans));
+    TEST_ASSERT_EQUAL(6, spans.len[0]);
+    TEST_ASSERT_EQUAL(4, spans.len[1]);
+    TEST_ASSERT_EQUAL_PTR(&storage[10], spans.data[0]);
+    TEST_ASSERT_EQUAL_PTR(storage, spans.data[1]);
+
+    drain(out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("abcdefghij", out);
+}
+
+void test_read_across_wrap_with_copy(void) {
+    char out[32] = {0};
+    log_ring_write(&ring, "0123456789012", 13);
+    log_ring_consume(&ring, 13);
+    log_ring_write(&ring, "WXYZ1234", 8);
+
+    TEST_ASSERT_EQUAL(5, log_ring_read(&ring, out, 5));
+    TEST_ASSERT_EQUAL_STRING("WXYZ1", out);
+    TEST_ASSERT_EQUAL(3, log_ring_read(&ring, out, sizeof(out)));
+    out[3] = '\0';
+    TEST_ASSERT_EQUAL_STRING("234", out);
+}
+
+// ============================================================================
+// OVERRUN TESTS
+// ============================================================================
+
+void test_full_ring_overwrites_oldest(void) {
+    char out[32];
+    log_ring_write(&ring, "0123456789", 10);
+    log_ring_write(&ring, "abcdefghij", 10);
+
+    TEST_ASSERT_EQUAL(RING_SIZE, log_ring_available(&ring));
+    TEST_ASSERT_EQUAL(0, log_ring_free(&ring));
+    TEST_ASSERT_EQUAL(RING_SIZE, drain(out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("456789abcdefghij", out);
+    TEST_ASSERT_EQUAL_UINT32(4, log_ring_dropped(&ring));
+}
+
+void test_oversized_message_keeps_end(void) {
+    char out[32];
+    log_ring_write(&ring, "abc", 3);
+    log_ring_write(&ring, "0123456789ABCDEFGHIJ", 20);
+
+    TEST_ASSERT_EQUAL(RING_SIZE, drain(out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("456789ABCDEFGHIJ", out);
+    TEST_ASSERT_EQUAL_UINT32(7, log_ring_dropped(&ring));
+}
+
+// The writer does not touch tail: the reader finds out it was lapped
+void test_catch_up_skips_overwritten(void) {
+    log_ring_write(&ring, "0123456789ABCDEF", 16);
+    log_ring_write(&ring, "xyz", 3);
+    TEST_ASSERT_EQUAL_UINT32(0, ring.tail);
+    TEST_ASSERT_EQUAL_UINT32(0, log_ring_dropped(&ring));
+
+    TEST_ASSERT_EQUAL_UINT32(3, log_ring_catch_up(&ring));
+    TEST_ASSERT_EQUAL_UINT32(3, log_ring_dropped(&ring));
+    TEST_ASSERT_EQUAL_UINT32(3, log_ring_catch_up(&ring)); // Counted once
+    TEST_ASSERT_EQUAL_UINT32(3, log_ring_dropped(&ring));
+}
+
+// A writer interrupting the reader may overwrite bytes it is still using
+void test_overwritten_under_reader(void) {
+    char out[32];
+    log_ring_spans_t spans;
+    log_ring_write(&ring, "0123456789", 10);
+    TEST_ASSERT_EQUAL(10, log_ring_peek(&ring, &spans));
+
+    log_ring_write(&ring, "abcdefgh", 8); // Overwrites "01"
+    log_ring_consume(&ring, 10);
+    TEST_ASSERT_EQUAL_UINT32(2, log_ring_dropped(&ring));
+
+    TEST_ASSERT_EQUAL(8, drain(out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("abcdefgh", out);
+    TEST_ASSERT_EQUAL_UINT32(2, log_ring_dropped(&ring));
+}
+
+void test_consume_clamped_to_available(void) {
+    log_ring_write(&ring, "abc", 3);
+    log_ring_consume(&ring, 100);
+    TEST_ASSERT_EQUAL(0, log_ring_available(&ring));
+    TEST_ASSERT_EQUAL(RING_SIZE, log_ring_free(&ring));
+}
+
+// Counters are free-running and wrap; size math must still hold
+void test_counters_wrap_past_32_bits(void) {
+    char out[32];
+    ring.head = 0xFFFFFFF8u;
+    ring.tail = 0xFFFFFFF8u;
+
+    log_ring_write(&ring, "0123456789AB", 12);
+    TEST_ASSERT_EQUAL(12, log_ring_available(&ring));
+    TEST_ASSERT_EQUAL(4, log_ring_free(&ring));
+    TEST_ASSERT_EQUAL(12, drain(out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("0123456789AB", out);
+    TEST_ASSERT_EQUAL_UINT32(4, ring.head);
+}
+
+// Long interleaved run against a simple reference model: everything read is
+// in order, and every byte written is either read, still unread or dropped
+void test_stream_matches_reference(void) {
+    static char written[16384];
+    char chunk[16];
+    uint32_t total = 0, read_total = 0;
+    uint32_t seed = 12345;
+
+    for (int i = 0; i < 2000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        size_t len = (seed >> 16) % 9;
+        char msg[8];
+        for (size_t j = 0; j < len; j++) {
+            msg[j] = (char)('a' + (i + j) % 26);
+        }
+
+        log_ring_write(&ring, msg, len);
+        TEST_ASSERT_TRUE(total + len <= sizeof(written));
+        memcpy(&written[total], msg, len);
+        total += (uint32_t)len;
+
+        if ((seed >> 8) % 3 == 0) {
+            uint32_t from = log_ring_catch_up(&ring);
+            size_t n = log_ring_read(&ring, chunk, (seed >> 20) % 12);
+            TEST_ASSERT_TRUE(memcmp(&written[from], chunk, n) == 0);
+            read_total += (uint32_t)n;
+        }
+    }
+
+    TEST_ASSERT_TRUE(read_total > 0);
+    TEST_ASSERT_TRUE(log_ring_dropped(&ring) > 0);
+    TEST_ASSERT_EQUAL_UINT32(total, read_total + log_ring_available(&ring) + log_ring_dropped(&ring));
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Initialization
+    RUN_TEST(test_init_rejects_non_power_of_two);
+    RUN_TEST(test_init_is_empty);
+
+    // Write / read
+    RUN_TEST(test_write_then_read);
+    RUN_TEST(test_fill_to_exact_capacity);
+    RUN_TEST(test_partial_read_respects_max_len);
+    RUN_TEST(test_wrapped_data_spans_two_segments);
+    RUN_TEST(test_read_across_wrap_with_copy);
+
+    // Overrun
+    RUN_TEST(test_full_ring_overwrites_oldest);
+    RUN_TEST(test_oversized_message_keeps_end);
+    RUN_TEST(test_catch_up_skips_overwritten);
+    RUN_TEST(test_overwritten_under_reader);
+    RUN_TEST(test_consume_clamped_to_available);
+    RUN_TEST(test_counters_wrap_past_32_bits);
+    RUN_TEST(test_stream_matches_reference);
+
+    return UNITY_END();
+}
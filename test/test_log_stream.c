@@ -0,0 +1,179 @@
+/**
+ * Unit tests for log_stream.c module
+ *
+ * Tests the BLE log stream:
+ * - Credits: granted by the client, one per notification, cleared on disable
+ * - Notification framing: cursor header, both ring spans, size limit
+ * - Throughput accounting over drain bursts
+ */
+
+#include "unity.h"
+#include "log_stream.h"
+#include <string.h>
+
+static log_stream_t stream;
+static uint8_t packet[64];
+
+void setUp(void) {
+    log_stream_init(&stream);
+    memset(packet, 0, sizeof(packet));
+}
+
+void tearDown(void) {
+}
+
+static log_ring_spans_t spans_of(const char *first, const char *second) {
+    log_ring_spans_t spans;
+    spans.data[0] = first;
+    spans.len[0] = strlen(first);
+    spans.data[1] = second;
+    spans.len[1] = strlen(second);
+    return spans;
+}
+
+// ============================================================================
+// CREDIT TESTS
+// ============================================================================
+
+void test_needs_enable_credits_and_data(void) {
+    TEST_ASSERT_FALSE(log_stream_ready(&stream, 10));
+
+    log_stream_enable(&stream, true);
+    TEST_ASSERT_FALSE(log_stream_ready(&stream, 10));
+
+    log_stream_grant(&stream, 2);
+    TEST_ASSERT_TRUE(log_stream_ready(&stream, 10));
+    TEST_ASSERT_FALSE(log_stream_ready(&stream, 0));
+}
+
+void test_each_notification_takes_a_credit(void) {
+    log_stream_enable(&stream, true);
+    log_stream_grant(&stream, 2);
+
+    log_stream_sent(&stream, 20);
+    TEST_ASSERT_EQUAL_UINT16(1, stream.credits);
+    log_stream_sent(&stream, 20);
+    TEST_ASSERT_FALSE(log_stream_ready(&stream, 10));
+    log_stream_sent(&stream, 20);
+    TEST_ASSERT_EQUAL_UINT16(0, stream.credits);
+}
+
+void test_grant_saturates(void) {
+    log_stream_grant(&stream, 60000);
+    log_stream_grant(&stream, 60000);
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, stream.credits);
+}
+
+void test_disable_drops_credits(void) {
+    log_stream_enable(&stream, true);
+    log_stream_grant(&stream, 5);
+    log_stream_enable(&stream, false);
+    TEST_ASSERT_EQUAL_UINT16(0, stream.credits);
+
+    log_stream_enable(&stream, true);
+    TEST_ASSERT_FALSE(log_stream_ready(&stream, 10));
+}
+
+// ============================================================================
+// FRAMING TESTS
+// ============================================================================
+
+void test_build_header_and_both_spans(void) {
+    log_ring_spans_t spans = spans_of("abc", "de");
+    log_stream_enable(&stream, true);
+    log_stream_grant(&stream, 1);
+
+    size_t len = log_stream_build(&stream, &spans, 0x12345678, packet, sizeof(packet));
+
+    TEST_ASSERT_EQUAL(LOG_STREAM_HEADER_SIZE + 5, len);
+    TEST_ASSERT_EQUAL_HEX8(0x78, packet[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x56, packet[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x34, packet[2]);
+    TEST_ASSERT_EQUAL_HEX8(0x12, packet[3]);
+    TEST_ASSERT_EQUAL_MEMORY("abcde", &packet[LOG_STREAM_HEADER_SIZE], 5);
+}
+
+void test_build_limited_to_max_len(void) {
+    log_ring_spans_t spans = spans_of("abc", "defgh");
+    log_stream_enable(&stream, true);
+    log_stream_grant(&stream, 1);
+
+    TEST_ASSERT_EQUAL(LOG_STREAM_HEADER_SIZE + 2, log_stream_build(&stream, &spans, 0, packet, LOG_STREAM_HEADER_SIZE + 2));
+    TEST_ASSERT_EQUAL_MEMORY("ab", &packet[LOG_STREAM_HEADER_SIZE], 2);
+
+    TEST_ASSERT_EQUAL(LOG_STREAM_HEADER_SIZE + 6, log_stream_build(&stream, &spans, 0, packet, LOG_STREAM_HEADER_SIZE + 6));
+    TEST_ASSERT_EQUAL_MEMORY("abcdef", &packet[LOG_STREAM_HEADER_SIZE], 6);
+
+    TEST_ASSERT_EQUAL(0, log_stream_build(&stream, &spans, 0, packet, LOG_STREAM_HEADER_SIZE));
+}
+
+void test_build_nothing_without_credit(void) {
+    log_ring_spans_t spans = spans_of("abc", "");
+    log_stream_enable(&stream, true);
+    TEST_ASSERT_EQUAL(0, log_stream_build(&stream, &spans, 0, packet, sizeof(packet)));
+}
+
+// ============================================================================
+// THROUGHPUT TESTS
+// ============================================================================
+
+void test_throughput_over_completed_bursts(void) {
+    log_throughput_t t;
+    memset(&t, 0, sizeof(t));
+
+    log_throughput_record(&t, 1000, false, 1000000);
+    TEST_ASSERT_EQUAL_UINT32(0, log_throughput_bytes_per_sec(&t)); // Burst still open
+    log_throughput_record(&t, 1000, true, 1500000);
+    TEST_ASSERT_EQUAL_UINT32(4000, log_throughput_bytes_per_sec(&t));
+
+    // Idle time between bursts does not count
+    log_throughput_record(&t, 0, true, 9000000);
+    log_throughput_record(&t, 500, false, 10000000);
+    log_throughput_record(&t, 500, true, 10500000);
+    TEST_ASSERT_EQUAL_UINT32(3000, log_throughput_bytes_per_sec(&t)); // 3000 B in 1 s
+}
+
+void test_single_packet_burst_ignored(void) {
+    log_throughput_t t;
+    memset(&t, 0, sizeof(t));
+
+    log_throughput_record(&t, 100, true, 5000);
+    TEST_ASSERT_EQUAL_UINT32(0, t.bytes);
+    TEST_ASSERT_EQUAL_UINT32(0, log_throughput_bytes_per_sec(&t));
+}
+
+void test_throughput_across_timer_wrap(void) {
+    log_throughput_t t;
+    memset(&t, 0, sizeof(t));
+
+    log_throughput_record(&t, 100, false, 0xFFFFFF00u);
+    log_throughput_record(&t, 100, true, 0x00000100u);
+    TEST_ASSERT_EQUAL_UINT32(0x200, t.busy_us);
+    TEST_ASSERT_EQUAL_UINT32(200, t.bytes);
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Credits
+    RUN_TEST(test_needs_enable_credits_and_data);
+    RUN_TEST(test_each_notification_takes_a_credit);
+    RUN_TEST(test_grant_saturates);
+    RUN_TEST(test_disable_drops_credits);
+
+    // Framing
+    RUN_TEST(test_build_header_and_both_spans);
+    RUN_TEST(test_build_limited_to_max_len);
+    RUN_TEST(test_build_nothing_without_credit);
+
+    // Throughput
+    RUN_TEST(test_throughput_over_completed_bursts);
+    RUN_TEST(test_single_packet_burst_ignored);
+    RUN_TEST(test_throughput_across_timer_wrap);
+
+    return UNITY_END();
+}
@@ -0,0 +1,195 @@
+/**
+ * Unit tests for odo_packet.c module
+ *
+ * Tests the compact (v2) odometer notifications:
+ * - Keyframes: first packet, keepalive, after a reset
+ * - Change detection: nothing sent when unchanged, speed/voltage thresholds
+ * - Wire format: bitmap, varints, zigzag deltas; decoder round trip
+ */
+
+#include "unity.h"
+#include "odo_packet.h"
+#include <string.h>
+
+static odo_encoder_t enc;
+static odo_values_t values;
+static odo_values_t decoded;
+static bool have_keyframe;
+static uint8_t packet[ODO_PACKET_MAX_SIZE];
+
+void setUp(void) {
+    odo_encoder_reset(&enc);
+    memset(&values, 0, sizeof(values));
+    memset(&decoded, 0, sizeof(decoded));
+    have_keyframe = false;
+
+    values.field[ODO_FIELD_SESSION_ROTATIONS] = 1500;
+    values.field[ODO_FIELD_TOTAL_ROTATIONS] = 2000000;
+    values.field[ODO_FIELD_SESSION_TIME] = 900;
+    values.field[ODO_FIELD_TOTAL_TIME] = 360000;
+    values.field[ODO_FIELD_RUNNING_SPEED] = 250;
+    values.field[ODO_FIELD_SESSION_SPEED] = 230;
+    values.field[ODO_FIELD_VOLTAGE] = 4100;
+    values.field[ODO_FIELD_SESSION_ID] = 1760000000;
+    values.field[ODO_FIELD_METRIC] = 0;
+}
+
+void tearDown(void) {
+}
+
+static uint16_t bitmap_of(const uint8_t *p) {
+    return (uint16_t)(p[1] | (p[2] << 8));
+}
+
+// Encode, check it decodes to the encoder's values, return the length
+static size_t send(uint32_t now_ms) {
+    size_t len = odo_packet_encode(&enc, &values, now_ms, packet);
+    if (len > 0) {
+        TEST_ASSERT_TRUE(odo_packet_decode(packet, len, &decoded, &have_keyframe));
+        TEST_ASSERT_EQUAL_MEMORY(&values, &decoded, sizeof(values));
+    }
+    return len;
+}
+
+// ============================================================================
+// KEYFRAME TESTS
+// ============================================================================
+
+void test_first_packet_is_keyframe(void) {
+    size_t len = send(1000);
+
+    TEST_ASSERT_EQUAL_UINT8(ODO_PACKET_VERSION, packet[0]);
+    TEST_ASSERT_EQUAL_HEX16(ODO_PACKET_KEYFRAME | 0x01FF, bitmap_of(packet));
+    TEST_ASSERT_TRUE(len < 33); // Smaller than the v1 odometer_data_t
+}
+
+void test_keepalive_keyframe(void) {
+    send(1000);
+    TEST_ASSERT_EQUAL(0, send(1000 + ODO_PACKET_KEEPALIVE_MS - 1));
+
+    TEST_ASSERT_TRUE(send(1000 + ODO_PACKET_KEEPALIVE_MS) > 0);
+    TEST_ASSERT_EQUAL_HEX16(ODO_PACKET_KEYFRAME | 0x01FF, bitmap_of(packet));
+}
+
+void test_reset_forces_keyframe(void) {
+    send(1000);
+    odo_encoder_reset(&enc);
+    TEST_ASSERT_TRUE(send(1100) > 0);
+    TEST_ASSERT_TRUE(bitmap_of(packet) & ODO_PACKET_KEYFRAME);
+}
+
+// ============================================================================
+// CHANGE TESTS
+// ============================================================================
+
+void test_only_changed_fields_sent(void) {
+    send(1000);
+    values.field[ODO_FIELD_SESSION_ROTATIONS] += 3;
+    values.field[ODO_FIELD_TOTAL_ROTATIONS] += 3;
+    values.field[ODO_FIELD_SESSION_TIME] += 1;
+
+    size_t len = send(2000);
+    TEST_ASSERT_EQUAL_HEX16(0x0007, bitmap_of(packet));
+    TEST_ASSERT_EQUAL(6, len); // Header + three 1-byte deltas
+    TEST_ASSERT_EQUAL_HEX8(6, packet[3]); // zigzag(+3)
+}
+
+void test_speed_threshold_against_last_sent(void) {
+    send(1000);
+    values.field[ODO_FIELD_RUNNING_SPEED] = 253;
+    TEST_ASSERT_EQUAL(0, send(2000));
+
+    // Drift adds up against the value last sent
+    values.field[ODO_FIELD_RUNNING_SPEED] = 245;
+    TEST_ASSERT_EQUAL(4, send(3000));
+    TEST_ASSERT_EQUAL_HEX16(1 << ODO_FIELD_RUNNING_SPEED, bitmap_of(packet));
+    TEST_ASSERT_EQUAL_HEX8(9, packet[3]); // zigzag(-5)
+}
+
+void test_stop_always_sent(void) {
+    values.field[ODO_FIELD_RUNNING_SPEED] = 3;
+    send(1000);
+    values.field[ODO_FIELD_RUNNING_SPEED] = 0;
+    TEST_ASSERT_TRUE(send(2000) > 0);
+}
+
+void test_voltage_threshold(void) {
+    send(1000);
+    values.field[ODO_FIELD_VOLTAGE] = 4060;
+    TEST_ASSERT_EQUAL(0, send(2000));
+    values.field[ODO_FIELD_VOLTAGE] = 4050;
+    TEST_ASSERT_TRUE(send(3000) > 0);
+    TEST_ASSERT_EQUAL_HEX16(1 << ODO_FIELD_VOLTAGE, bitmap_of(packet));
+}
+
+void test_new_session_and_unit_change(void) {
+    send(1000);
+    values.field[ODO_FIELD_SESSION_ROTATIONS] = 0;
+    values.field[ODO_FIELD_SESSION_TIME] = 0;
+    values.field[ODO_FIELD_SESSION_ID] = 0;
+    values.field[ODO_FIELD_METRIC] = 1;
+    TEST_ASSERT_TRUE(send(2000) > 0);
+}
+
+// ============================================================================
+// DECODER TESTS
+// ============================================================================
+
+void test_decode_rejects_delta_before_keyframe(void) {
+    send(1000);
+    values.field[ODO_FIELD_SESSION_TIME] += 1;
+    size_t len = odo_packet_encode(&enc, &values, 2000, packet);
+
+    bool fresh = false;
+    odo_values_t other;
+    memset(&other, 0, sizeof(other));
+    TEST_ASSERT_FALSE(odo_packet_decode(packet, len, &other, &fresh));
+    TEST_ASSERT_FALSE(fresh);
+}
+
+void test_decode_rejects_truncated_and_other_version(void) {
+    size_t len = odo_packet_encode(&enc, &values, 1000, packet);
+    odo_values_t before = decoded;
+
+    TEST_ASSERT_FALSE(odo_packet_decode(packet, len - 1, &decoded, &have_keyframe));
+    TEST_ASSERT_EQUAL_MEMORY(&before, &decoded, sizeof(decoded));
+
+    packet[0] = 1;
+    TEST_ASSERT_FALSE(odo_packet_decode(packet, len, &decoded, &have_keyframe));
+    TEST_ASSERT_FALSE(odo_packet_decode(packet, 2, &decoded, &have_keyframe));
+}
+
+void test_large_values_round_trip(void) {
+    values.field[ODO_FIELD_TOTAL_ROTATIONS] = 0xFFFFFFFFu;
+    send(1000);
+    values.field[ODO_FIELD_TOTAL_ROTATIONS] = 0;
+    values.field[ODO_FIELD_SESSION_ID] = 0x80000000u;
+    TEST_ASSERT_TRUE(send(2000) > 0);
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Keyframes
+    RUN_TEST(test_first_packet_is_keyframe);
+    RUN_TEST(test_keepalive_keyframe);
+    RUN_TEST(test_reset_forces_keyframe);
+
+    // Changes
+    RUN_TEST(test_only_changed_fields_sent);
+    RUN_TEST(test_speed_threshold_against_last_sent);
+    RUN_TEST(test_stop_always_sent);
+    RUN_TEST(test_voltage_threshold);
+    RUN_TEST(test_new_session_and_unit_change);
+
+    // Decoder
+    RUN_TEST(test_decode_rejects_delta_before_keyframe);
+    RUN_TEST(test_decode_rejects_truncated_and_other_version);
+    RUN_TEST(test_large_values_round_trip);
+
+    return UNITY_END();
+}
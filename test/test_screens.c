@@ -0,0 +1,310 @@
+/**
+ * Golden-image tests for the OLED screens
+ *
+ * Renders the session and totals screens (with the shared status bar) through
+ * the real oled.c / ui.c / screens.c code into the in-memory SH1106 model and
+ * compares what the panel shows with the images in test/golden/.
+ *
+ * Every render also writes <name>.png and <name>.pbm to the snapshots directory
+ * in the build tree. After an intentional layout change, regenerate the golden
+ * images with:
+ *
+ *   UPDATE_GOLDEN=1 ./build/test_screens
+ *
+ * and review the new .pbm files in test/golden (or the PNG snapshots) before
+ * committing them.
+ */
+
+#include "unity.h"
+#include "sh1106_model.h"
+#include "oled.h"
+#include "screens.h"
+#include "font.h"
+#include "fmt.h"
+#include "hardware/i2c.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifndef GOLDEN_DIR
+#define GOLDEN_DIR "golden"
+#endif
+
+#ifndef SNAPSHOT_DIR
+#define SNAPSHOT_DIR "snapshots"
+#endif
+
+// Rotation counts for the distances each screen is checked at
+#define ROTATIONS_9_99_MI 46520    // 9.9899 mi
+#define ROTATIONS_10_0_MI 46567    // 10.0003 mi
+#define ROTATIONS_100_PLUS_MI 500000 // 107.38 mi
+#define ROTATIONS_9_99_KM 28906    // 9.9899 km
+#define ROTATIONS_10_0_KM 28936    // 10.0003 km
+#define ROTATIONS_100_PLUS_KM 300000 // 103.68 km
+
+typedef struct {
+    const char *name;
+    screen_id_t screen;
+    screen_model_t model;
+} golden_case_t;
+
+// Status bar: no clock, 4.95 V, Bluetooth idle (icon hidden)
+#define STATUS_IDLE .voltage_mv = 4950
+// Status bar: clock 9:05 PM, 4.2 V, Bluetooth connected (icon shown)
+#define STATUS_CONNECTED .voltage_mv = 4200, .clock_valid = true, .clock_seconds = 21 * 3600 + 5 * 60, \
+                         .ble_connected = true
+
+static const golden_case_t session_cases[] = {
+    {"session_0_mi", SCREEN_SESSION, {.session_rotations = 0, .session_time_seconds = 0, STATUS_IDLE}},
+    {"session_9_99_mi", SCREEN_SESSION, {.session_rotations = ROTATIONS_9_99_MI, .session_time_seconds = 1234, STATUS_CONNECTED}},
+    {"session_10_0_mi", SCREEN_SESSION, {.session_rotations = ROTATIONS_10_0_MI, .session_time_seconds = 3725, STATUS_CONNECTED}},
+    {"session_100_plus_mi", SCREEN_SESSION, {.session_rotations = ROTATIONS_100_PLUS_MI, .session_time_seconds = 97200, STATUS_CONNECTED}},
+    {"session_0_km", SCREEN_SESSION, {.session_rotations = 0, .session_time_seconds = 0, .metric = true, STATUS_IDLE}},
+    {"session_9_99_km", SCREEN_SESSION, {.session_rotations = ROTATIONS_9_99_KM, .session_time_seconds = 1234, .metric = true, STATUS_CONNECTED}},
+    {"session_10_0_km", SCREEN_SESSION, {.session_rotations = ROTATIONS_10_0_KM, .session_time_seconds = 3725, .metric = true, STATUS_CONNECTED}},
+    {"session_100_plus_km", SCREEN_SESSION, {.session_rotations = ROTATIONS_100_PLUS_KM, .session_time_seconds = 97200, .metric = true, STATUS_CONNECTED}},
+};
+
+static const golden_case_t totals_cases[] = {
+    {"totals_0_mi", SCREEN_TOTALS, {.total_rotations = 0, .total_time_seconds = 0, STATUS_IDLE}},
+    {"totals_9_99_mi", SCREEN_TOTALS, {.total_rotations = ROTATIONS_9_99_MI, .total_time_seconds = 3 * 3600, STATUS_CONNECTED}},
+    {"totals_10_0_mi", SCREEN_TOTALS, {.total_rotations = ROTATIONS_10_0_MI, .total_time_seconds = 3 * 3600 + 59, STATUS_CONNECTED}},
+    {"totals_100_plus_mi", SCREEN_TOTALS, {.total_rotations = ROTATIONS_100_PLUS_MI, .total_time_seconds = 123 * 3600, STATUS_CONNECTED}},
+    {"totals_0_km", SCREEN_TOTALS, {.total_rotations = 0, .total_time_seconds = 0, .metric = true, STATUS_IDLE}},
+    {"totals_9_99_km", SCREEN_TOTALS, {.total_rotations = ROTATIONS_9_99_KM, .total_time_seconds = 3 * 3600, .metric = true, STATUS_CONNECTED}},
+    {"totals_10_0_km", SCREEN_TOTALS, {.total_rotations = ROTATIONS_10_0_KM, .total_time_seconds = 3 * 3600 + 59, .metric = true, STATUS_CONNECTED}},
+    {"totals_100_plus_km", SCREEN_TOTALS, {.total_rotations = ROTATIONS_100_PLUS_KM, .total_time_seconds = 123 * 3600, .metric = true, STATUS_CONNECTED}},
+};
+
+// Status bar variants, all on the session screen at 0 distance
+static const golden_case_t status_cases[] = {
+    {"status_idle", SCREEN_SESSION, {STATUS_IDLE}},
+    {"status_connected", SCREEN_SESSION, {STATUS_CONNECTED}},
+    // Advertising: the icon blinks on for the first 250 ms of every 500 ms
+    {"status_advertising_on", SCREEN_SESSION, {.voltage_mv = 3700, .clock_valid = true, .clock_seconds = 0,
+                                                .ble_advertising = true, .now_ms = 1000}},
+    {"status_advertising_off", SCREEN_SESSION, {.voltage_mv = 3700, .clock_valid = true, .clock_seconds = 12 * 3600 + 59 * 60,
+                                                 .ble_advertising = true, .now_ms = 1250}},
+};
+
+#define CASE_COUNT(cases) (sizeof(cases) / sizeof(cases[0]))
+
+void setUp(void) {
+    sh1106_model_reset();
+    oled_init(i2c0, 4, 5, 0x3C);
+    screens_invalidate();
+}
+
+void tearDown(void) {
+}
+
+// Write snapshots of the panel and compare it with the golden image for this
+// name. With UPDATE_GOLDEN set, full redraws (allow_update) store it instead
+static void check_golden(const char *name, bool allow_update) {
+    char path[512];
+    char message[160];
+
+    mkdir(SNAPSHOT_DIR, 0755);
+    snprintf(path, sizeof(path), "%s/%s.png", SNAPSHOT_DIR, name);
+    sh1106_model_save_png(path, 4);
+    snprintf(path, sizeof(path), "%s/%s.pbm", SNAPSHOT_DIR, name);
+    sh1106_model_save_pbm(path);
+
+    snprintf(path, sizeof(path), "%s/%s.pbm", GOLDEN_DIR, name);
+    const char *update = getenv("UPDATE_GOLDEN");
+    if (allow_update && update && update[0] && strcmp(update, "0") != 0) {
+        TEST_ASSERT_TRUE_MESSAGE(sh1106_model_save_pbm(path), "Could not write golden image");
+    }
+
+    int x = 0, y = 0;
+    int diffs = sh1106_model_compare_pbm(path, &x, &y);
+    if (diffs < 0) {
+        snprintf(message, sizeof(message), "%s: missing golden image (run with UPDATE_GOLDEN=1)", name);
+        TEST_FAIL_MESSAGE(message);
+    }
+    snprintf(message, sizeof(message), "%s: %d pixels differ, first at (%d, %d); see %s/%s.png", name, diffs, x, y,
+             SNAPSHOT_DIR, name);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, diffs, message);
+}
+
+// Each case rendered from scratch (full redraw)
+static void check_cases(const golden_case_t *cases, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        screens_invalidate();
+        TEST_ASSERT_TRUE(screens_render(cases[i].screen, &cases[i].model));
+        oled_update();
+        check_golden(cases[i].name, true);
+    }
+}
+
+// ============================================================================
+// GOLDEN IMAGE TESTS
+// ============================================================================
+
+void test_session_screen_golden(void) {
+    check_cases(session_cases, CASE_COUNT(session_cases));
+}
+
+void test_totals_screen_golden(void) {
+    check_cases(totals_cases, CASE_COUNT(totals_cases));
+}
+
+void test_status_bar_golden(void) {
+    check_cases(status_cases, CASE_COUNT(status_cases));
+}
+
+// Stepping through the cases without invalidating exercises the incremental
+// path (changed widgets only, dirty-span transfers); the panel must end up
+// identical to a full redraw every time
+void test_incremental_updates_match_golden(void) {
+    const golden_case_t *groups[] = {session_cases, totals_cases, status_cases};
+    const size_t counts[] = {CASE_COUNT(session_cases), CASE_COUNT(totals_cases), CASE_COUNT(status_cases)};
+
+    for (size_t g = 0; g < 3; g++) {
+        for (size_t i = 0; i < counts[g]; i++) {
+            screens_render(groups[g][i].screen, &groups[g][i].model);
+            oled_update();
+            check_golden(groups[g][i].name, false);
+        }
+    }
+}
+
+// ============================================================================
+// FONT SUBSET TESTS
+// ============================================================================
+
+// Every character the layouts draw over their value ranges is in the font
+// subset, so FONT_GLYPHS in tools/font_subset.py cannot fall behind screens.c
+void test_font_subset_covers_screens(void) {
+    static const uint32_t rotations[] = {0, ROTATIONS_9_99_KM, ROTATIONS_10_0_MI, ROTATIONS_100_PLUS_MI, 123456789};
+    static const uint32_t seconds[] = {0, 59, 3599, 3600 + 23 * 60 + 45, 99 * 3600 + 59 * 60 + 59, 1234567};
+    static const uint32_t clock_seconds[] = {0, 9 * 3600 + 5 * 60, 12 * 3600, 23 * 3600 + 59 * 60};
+    static const uint16_t voltages_mv[] = {0, 3700, 4950, 5500};
+    uint32_t missing = oled_missing_glyphs();
+
+    for (size_t i = 0; i < CASE_COUNT(rotations); i++) {
+        for (size_t j = 0; j < CASE_COUNT(seconds); j++) {
+            screen_model_t model = {
+                .session_rotations = rotations[i], .session_time_seconds = seconds[j],
+                .total_rotations = rotations[i], .total_time_seconds = seconds[j] * 100,
+                .metric = (j % 2) == 1, .voltage_mv = voltages_mv[j % CASE_COUNT(voltages_mv)],
+                .clock_valid = true, .clock_seconds = clock_seconds[i % CASE_COUNT(clock_seconds)],
+            };
+            screens_render(SCREEN_SESSION, &model);
+            screens_render(SCREEN_TOTALS, &model);
+        }
+    }
+
+    // Startup screen (walkolution-odometer.c): name and voltage with 2 decimals
+    char voltage[16];
+    oled_draw_text_centered(OLED_WIDTH / 2, 28, "Walkolution", &FreeSans12pt7b);
+    for (size_t i = 0; i < CASE_COUNT(voltages_mv); i++) {
+        fmt_voltage(voltage, sizeof(voltage), voltages_mv[i], 2);
+        oled_draw_text_centered(OLED_WIDTH / 2, 48, voltage, &FreeSans9pt7b);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(missing, oled_missing_glyphs(),
+                                     "Characters missing from the font subset (FONT_GLYPHS in tools/font_subset.py)");
+}
+
+// ============================================================================
+// BUS TRAFFIC TESTS
+// ============================================================================
+
+// A full frame is 8 pages of: page, column low, column high, one data burst
+void test_full_frame_traffic(void) {
+    oled_update(); // Initial full frame
+    sh1106_model_reset_stats();
+
+    oled_clear();
+    oled_update();
+
+    sh1106_stats_t stats = sh1106_model_stats();
+    TEST_ASSERT_EQUAL_UINT32(8 * 4, stats.transactions);
+    TEST_ASSERT_EQUAL_UINT32(8 * 3, stats.commands);
+    TEST_ASSERT_EQUAL_UINT32(OLED_WIDTH * OLED_HEIGHT / 8, stats.data_bytes);
+    TEST_ASSERT_EQUAL_UINT32(8 * (3 * 2 + 1 + OLED_WIDTH), stats.bytes);
+}
+
+void test_unchanged_frame_sends_nothing(void) {
+    screen_model_t model = {.session_rotations = 1000, .session_time_seconds = 60, STATUS_CONNECTED};
+    screens_render(SCREEN_SESSION, &model);
+    oled_update();
+    sh1106_model_reset_stats();
+
+    TEST_ASSERT_FALSE(screens_render(SCREEN_SESSION, &model));
+    oled_update();
+
+    TEST_ASSERT_EQUAL_UINT32(0, sh1106_model_stats().transactions);
+}
+
+// One-second tick of the session time only touches the pages under that text
+void test_time_tick_traffic(void) {
+    screen_model_t model = {.session_rotations = 1000, .session_time_seconds = 60, STATUS_CONNECTED};
+    screens_render(SCREEN_SESSION, &model);
+    oled_update();
+    sh1106_model_reset_stats();
+
+    model.session_time_seconds++;
+    TEST_ASSERT_TRUE(screens_render(SCREEN_SESSION, &model));
+    oled_update();
+
+    sh1106_stats_t stats = sh1106_model_stats();
+    TEST_ASSERT_TRUE(stats.transactions > 0);
+    TEST_ASSERT_TRUE(stats.transactions < 8 * 4);
+    TEST_ASSERT_TRUE(stats.data_bytes < OLED_WIDTH * 2);
+}
+
+// A failed data burst stays dirty and is resent by the next update
+void test_failed_transfer_is_retried(void) {
+    oled_update();
+    oled_fill_rect(10, 10, 20, 4, true);
+
+    sh1106_model_fail_writes(4); // Page 1: three commands and the data burst
+    oled_update();
+    TEST_ASSERT_FALSE(sh1106_model_pixel(10, 10));
+
+    oled_update();
+    TEST_ASSERT_TRUE(sh1106_model_pixel(10, 10));
+    TEST_ASSERT_TRUE(sh1106_model_pixel(29, 13));
+    TEST_ASSERT_FALSE(sh1106_model_pixel(30, 13));
+}
+
+void test_display_power(void) {
+    oled_update();
+    TEST_ASSERT_TRUE(sh1106_model_display_on());
+    TEST_ASSERT_EQUAL_HEX8(0xCF, sh1106_model_contrast());
+
+    oled_display_off();
+    TEST_ASSERT_FALSE(sh1106_model_display_on());
+
+    oled_display_on();
+    TEST_ASSERT_TRUE(sh1106_model_display_on());
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Golden images
+    RUN_TEST(test_session_screen_golden);
+    RUN_TEST(test_totals_screen_golden);
+    RUN_TEST(test_status_bar_golden);
+    RUN_TEST(test_incremental_updates_match_golden);
+
+    // Font subset
+    RUN_TEST(test_font_subset_covers_screens);
+
+    // Bus traffic
+    RUN_TEST(test_full_frame_traffic);
+    RUN_TEST(test_unchanged_frame_sends_nothing);
+    RUN_TEST(test_time_tick_traffic);
+    RUN_TEST(test_failed_transfer_is_retried);
+    RUN_TEST(test_display_power);
+
+    return UNITY_END();
+}
@@ -0,0 +1,189 @@
+/**
+ * Unit tests for trace_buffer.c module
+ *
+ * Tests the trace event ring:
+ * - Records keep their fields and order
+ * - A full ring overwrites the oldest records and counts them as lost
+ * - Clear starts a new window; indices survive counter wrap
+ *
+ * With a file argument it also writes a dump in the firmware's log format
+ * (trace.c) for the tools/trace_export.py golden test.
+ */
+
+#include "unity.h"
+#include "trace_buffer.h"
+#include <stdio.h>
+#include <string.h>
+
+static trace_record_t records[8];
+static trace_buffer_t buf;
+
+void setUp(void) {
+    memset(records, 0, sizeof(records));
+    TEST_ASSERT_TRUE(trace_buffer_init(&buf, records, 8));
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// BASIC TESTS
+// ============================================================================
+
+void test_init_rejects_non_power_of_two(void) {
+    trace_buffer_t other;
+    TEST_ASSERT_FALSE(trace_buffer_init(&other, records, 6));
+    TEST_ASSERT_FALSE(trace_buffer_init(&other, records, 0));
+}
+
+void test_empty_has_nothing(void) {
+    trace_record_t rec;
+    TEST_ASSERT_EQUAL_UINT32(0, trace_buffer_oldest(&buf));
+    TEST_ASSERT_EQUAL_UINT32(0, trace_buffer_lost(&buf));
+    TEST_ASSERT_FALSE(trace_buffer_get(&buf, 0, &rec));
+}
+
+void test_put_and_get(void) {
+    trace_record_t rec;
+    trace_buffer_put(&buf, TRACE_PHASE_BEGIN, 3, 0, 100);
+    trace_buffer_put(&buf, TRACE_PHASE_END, 3, 0xABCD, 250);
+
+    TEST_ASSERT_TRUE(trace_buffer_get(&buf, 0, &rec));
+    TEST_ASSERT_EQUAL_UINT32(100, rec.time_us);
+    TEST_ASSERT_EQUAL_UINT8(TRACE_PHASE_BEGIN, rec.phase);
+    TEST_ASSERT_EQUAL_UINT8(3, rec.event);
+
+    TEST_ASSERT_TRUE(trace_buffer_get(&buf, 1, &rec));
+    TEST_ASSERT_EQUAL_UINT32(250, rec.time_us);
+    TEST_ASSERT_EQUAL_UINT16(0xABCD, rec.arg);
+    TEST_ASSERT_FALSE(trace_buffer_get(&buf, 2, &rec));
+}
+
+void test_record_word(void) {
+    trace_record_t rec = {.time_us = 1, .phase = TRACE_PHASE_END, .event = 0x12, .arg = 0x3456};
+    TEST_ASSERT_EQUAL_HEX32(0x34561245, trace_record_word(&rec));
+}
+
+// ============================================================================
+// OVERWRITE TESTS
+// ============================================================================
+
+void test_full_ring_keeps_latest(void) {
+    trace_record_t rec;
+    for (uint32_t i = 0; i < 11; i++) {
+        trace_buffer_put(&buf, TRACE_PHASE_INSTANT, 1, (uint16_t)i, i * 10);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(3, trace_buffer_oldest(&buf));
+    TEST_ASSERT_EQUAL_UINT32(3, trace_buffer_lost(&buf));
+    TEST_ASSERT_FALSE(trace_buffer_get(&buf, 2, &rec));
+    TEST_ASSERT_TRUE(trace_buffer_get(&buf, 3, &rec));
+    TEST_ASSERT_EQUAL_UINT16(3, rec.arg);
+    TEST_ASSERT_TRUE(trace_buffer_get(&buf, 10, &rec));
+    TEST_ASSERT_EQUAL_UINT16(10, rec.arg);
+}
+
+void test_clear_starts_new_window(void) {
+    trace_record_t rec;
+    for (uint32_t i = 0; i < 10; i++) {
+        trace_buffer_put(&buf, TRACE_PHASE_INSTANT, 1, (uint16_t)i, i);
+    }
+    trace_buffer_clear(&buf);
+
+    TEST_ASSERT_EQUAL_UINT32(10, trace_buffer_oldest(&buf));
+    TEST_ASSERT_EQUAL_UINT32(0, trace_buffer_lost(&buf));
+    TEST_ASSERT_FALSE(trace_buffer_get(&buf, 9, &rec));
+
+    trace_buffer_put(&buf, TRACE_PHASE_INSTANT, 2, 7, 99);
+    TEST_ASSERT_TRUE(trace_buffer_get(&buf, 10, &rec));
+    TEST_ASSERT_EQUAL_UINT8(2, rec.event);
+}
+
+void test_indices_across_counter_wrap(void) {
+    trace_record_t rec;
+    buf.head = 0xFFFFFFFEu;
+    buf.first = 0xFFFFFFFEu;
+    for (uint32_t i = 0; i < 12; i++) {
+        trace_buffer_put(&buf, TRACE_PHASE_INSTANT, 1, (uint16_t)i, i);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(10, buf.head);
+    TEST_ASSERT_EQUAL_UINT32(2, trace_buffer_oldest(&buf));
+    TEST_ASSERT_EQUAL_UINT32(4, trace_buffer_lost(&buf));
+    TEST_ASSERT_TRUE(trace_buffer_get(&buf, 2, &rec));
+    TEST_ASSERT_EQUAL_UINT16(4, rec.arg);
+    TEST_ASSERT_FALSE(trace_buffer_get(&buf, 0xFFFFFFFFu, &rec));
+}
+
+// ============================================================================
+// DUMP FOR THE EXPORT TOOL
+// ============================================================================
+
+// The ring wrapped (an end whose begin was overwritten comes first), the
+// device timer wraps in the middle and an IRQ lands inside a span
+static void write_dump(const char *path) {
+    static const struct {
+        uint8_t phase;
+        uint8_t event;
+        uint16_t arg;
+        uint32_t time_us;
+    } sequence[] = {
+        {TRACE_PHASE_BEGIN, 0, 0, 0xFFFFF000u},     // Overwritten
+        {TRACE_PHASE_BEGIN, 4, 0, 0xFFFFF010u},     // Overwritten
+        {TRACE_PHASE_END, 4, 0, 0xFFFFF100u},       // Overwritten
+        {TRACE_PHASE_END, 0, 0, 0xFFFFF180u},       // Orphan end
+        {TRACE_PHASE_BEGIN, 1, 0, 0xFFFFF200u},
+        {TRACE_PHASE_END, 1, 0, 0xFFFFFF00u},
+        {TRACE_PHASE_BEGIN, 0, 0, 0xFFFFFF10u},
+        {TRACE_PHASE_BEGIN, 10, 0, 0x00000010u},    // Timer wrapped
+        {TRACE_PHASE_BEGIN, 14, 4, 0x00000020u},
+        {TRACE_PHASE_END, 14, 4, 0x00000024u},
+        {TRACE_PHASE_END, 10, 132, 0x00000400u},
+    };
+    trace_record_t small[8];
+    trace_buffer_t dump;
+    trace_record_t rec;
+
+    FILE *f = fopen(path, "w");
+    TEST_ASSERT_NOT_NULL(f);
+    trace_buffer_init(&dump, small, 8);
+    for (size_t i = 0; i < sizeof(sequence) / sizeof(sequence[0]); i++) {
+        trace_buffer_put(&dump, sequence[i].phase, sequence[i].event, sequence[i].arg, sequence[i].time_us);
+    }
+
+    // Same lines as trace_dump_start / trace_dump_step, among other log output
+    fprintf(f, "[  1.000] [BOOT] unrelated line\n");
+    uint32_t index = trace_buffer_oldest(&dump);
+    fprintf(f, "[TRACE] begin %lu records, %lu lost\n",
+            (unsigned long)(dump.head - index), (unsigned long)trace_buffer_lost(&dump));
+    while (trace_buffer_get(&dump, index++, &rec)) {
+        fprintf(f, "[TRACE] %08lx %08lx\n", (unsigned long)rec.time_us, (unsigned long)trace_record_word(&rec));
+    }
+    fprintf(f, "[TRACE] end\n");
+    fclose(f);
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Basics
+    RUN_TEST(test_init_rejects_non_power_of_two);
+    RUN_TEST(test_empty_has_nothing);
+    RUN_TEST(test_put_and_get);
+    RUN_TEST(test_record_word);
+
+    // Overwriting
+    RUN_TEST(test_full_ring_keeps_latest);
+    RUN_TEST(test_clear_starts_new_window);
+    RUN_TEST(test_indices_across_counter_wrap);
+
+    if (argc > 1) {
+        write_dump(argv[1]);
+    }
+
+    return UNITY_END();
+}
@@ -0,0 +1,52 @@
+/**
+ * Device time service implementation
+ */
+
+#include "timebase.h"
+#include "clock_sync.h"
+#include "logging.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+static clock_sync_t wall_clock;
+
+uint64_t timebase_us(void)
+{
+    return time_us_64();
+}
+
+uint32_t timebase_ms(void)
+{
+    return (uint32_t)(time_us_64() / 1000);
+}
+
+void timebase_sync(uint64_t unix_ms)
+{
+    uint32_t ints = save_and_disable_interrupts();
+    clock_sync_update(&wall_clock, time_us_64(), unix_ms * 1000);
+    clock_sync_t state = wall_clock;
+    restore_interrupts(ints);
+
+    LOG_INFO(LOG_TAG_TIME, "[TIME] Sync %lu: device was %ld ms %s, drift %ld ppb%s\n",
+                           state.syncs, (long)(state.last_error_us < 0 ? -state.last_error_us : state.last_error_us) / 1000,
+                           state.last_error_us < 0 ? "ahead" : "behind", (long)state.drift_ppb,
+                           state.slew_us < 0 ? " (slewing back)" : "");
+}
+
+bool timebase_has_time(void)
+{
+    return wall_clock.synced;
+}
+
+uint64_t timebase_unix_us(void)
+{
+    uint32_t ints = save_and_disable_interrupts();
+    uint64_t unix_us = clock_sync_unix_us(&wall_clock, time_us_64());
+    restore_interrupts(ints);
+    return unix_us;
+}
+
+uint32_t timebase_unix_seconds(void)
+{
+    return (uint32_t)(timebase_unix_us() / 1000000);
+}
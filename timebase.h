@@ -0,0 +1,36 @@
+/**
+ * Device time service
+ *
+ * One place for every module's time:
+ * - timebase_us(): monotonic uptime in microseconds, 64-bit, never wraps
+ * - timebase_ms(): uptime in milliseconds for interval bookkeeping. Only its
+ *   low 32 bits are kept, so it wraps after 49.7 days like to_ms_since_boot();
+ *   use it only in unsigned differences (now - then), which stay correct
+ * - timebase_unix_us(): wall time from the phone's time syncs, corrected for
+ *   the crystal's drift and never going backwards (clock_sync.h)
+ *
+ * The wall clock is shared with the BLE callbacks, which may run from an
+ * interrupt (BLE_BACKGROUND), so it is read and synced with interrupts off.
+ */
+
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+uint64_t timebase_us(void);
+
+uint32_t timebase_ms(void);
+
+// Set the wall clock from a time sync (Unix time in milliseconds)
+void timebase_sync(uint64_t unix_ms);
+
+// Whether there has been a time sync since boot
+bool timebase_has_time(void);
+
+// Unix time, 0 before the first sync
+uint64_t timebase_unix_us(void);
+uint32_t timebase_unix_seconds(void);
+
+#endif // TIMEBASE_H
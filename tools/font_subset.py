@@ -0,0 +1,237 @@
+#!/usr/bin/env python3
+"""
+Build-time font subsetting for the SH1106 OLED renderer.
+
+Reads the Adafruit GFX font tables in adafruit_fonts.c, keeps only the glyphs
+the UI actually draws (see FONT_GLYPHS below) and re-packs each glyph bitmap
+from Adafruit's row-major bit stream into the SH1106 page-major layout:
+
+    byte[band * width + column], bit n = pixel (column, band * 8 + n)
+
+so oled_draw_text() can OR whole 8-pixel columns into the display buffer
+instead of setting one pixel at a time.
+
+Usage:
+    font_subset.py adafruit_fonts.c fonts_subset.c [--report font_size_report.txt]
+"""
+
+import argparse
+import re
+import sys
+
+# Glyphs rendered by the UI, per font.
+# Keep in sync with the screen layouts in screens.c (and the startup screen in
+# walkolution-odometer.c) - a character that is missing here renders as nothing
+# (same as a character outside the font). test_screens renders the layouts over
+# their value ranges and fails on any character these sets do not cover.
+FONT_GLYPHS = {
+    # Session distance: "0.00 mi", "12.3 km"
+    "FreeSans18pt7b": "0123456789. kmi",
+    # Totals: "123 total mi", "45 total hr"; startup: "Walkolution"
+    "FreeSans12pt7b": "0123456789. totalkmihr" + "Walkolution",
+    # Session time "1:02:03"; startup voltage "4.95V"
+    "FreeSans9pt7b": "0123456789:.V",
+    # Status bar: clock "12:34 PM", voltage "4.9V"
+    "Font5x7Fixed": "0123456789:. AMPV",
+}
+
+# sizeof() of the structures in font.h on a 32-bit target
+SIZEOF_GLYPH = 8  # uint16_t + 5 x uint8_t, padded to 2-byte alignment
+SIZEOF_FONT = 12  # 2 pointers + 3 x uint8_t, padded to 4-byte alignment
+
+NUM = r"(-?(?:0x[0-9A-Fa-f]+|\d+))"
+
+
+class Font:
+    def __init__(self, name, bitmap, glyphs, first, last, y_advance):
+        self.name = name
+        self.bitmap = bitmap
+        self.glyphs = glyphs  # list of (offset, width, height, x_advance, x_offset, y_offset)
+        self.first = first
+        self.last = last
+        self.y_advance = y_advance
+
+    def size_bytes(self):
+        return len(self.bitmap) + len(self.glyphs) * SIZEOF_GLYPH + SIZEOF_FONT
+
+
+def parse_fonts(source):
+    """Parse every GFXfont defined in an Adafruit-style font source file."""
+    source = re.sub(r"//[^\n]*", "", source)
+    source = re.sub(r"/\*.*?\*/", "", source, flags=re.S)
+
+    bitmaps = {}
+    for m in re.finditer(r"const\s+uint8_t\s+(\w+)Bitmaps\s*\[\]\s*=\s*\{(.*?)\}\s*;", source, re.S):
+        bitmaps[m.group(1)] = [int(v, 0) for v in re.findall(NUM, m.group(2))]
+
+    glyphs = {}
+    for m in re.finditer(r"const\s+GFXglyph\s+(\w+)Glyphs\s*\[\]\s*=\s*\{((?:\s*,?\s*\{[^}]*\})*)\s*\}\s*;", source, re.S):
+        entries = []
+        for g in re.finditer(r"\{([^}]*)\}", m.group(2)):
+            values = [int(v, 0) for v in re.findall(NUM, g.group(1))]
+            if len(values) != 6:
+                raise ValueError("%s: malformed glyph entry '%s'" % (m.group(1), g.group(1)))
+            entries.append(tuple(values))
+        glyphs[m.group(1)] = entries
+
+    fonts = {}
+    for m in re.finditer(r"const\s+GFXfont\s+(\w+)\s*=\s*\{(.*?)\}\s*;", source, re.S):
+        name = m.group(1)
+        # Last three numeric fields are first, last, y_advance (the pointers come first)
+        tail = re.sub(r"\([^)]*\)\s*\w+", "", m.group(2))
+        values = [int(v, 0) for v in re.findall(NUM, tail)]
+        if len(values) < 3 or name not in bitmaps or name not in glyphs:
+            raise ValueError("%s: could not parse font definition" % name)
+        first, last, y_advance = values[-3:]
+        if len(glyphs[name]) != last - first + 1:
+            raise ValueError("%s: glyph count %d does not match range 0x%02X-0x%02X"
+                             % (name, len(glyphs[name]), first, last))
+        fonts[name] = Font(name, bitmaps[name], glyphs[name], first, last, y_advance)
+
+    return fonts
+
+
+def glyph_pixels(font, glyph):
+    """Decode an Adafruit row-major bit stream into a height x width matrix."""
+    offset, width, height = glyph[0], glyph[1], glyph[2]
+    pixels = [[0] * width for _ in range(height)]
+    bit = 0
+    for y in range(height):
+        for x in range(width):
+            byte = font.bitmap[offset + (bit >> 3)]
+            pixels[y][x] = (byte >> (7 - (bit & 7))) & 1
+            bit += 1
+    return pixels
+
+
+def to_page_major(pixels, width, height):
+    """Pack a pixel matrix into SH1106 page-major column bytes."""
+    bands = (height + 7) // 8
+    out = []
+    for band in range(bands):
+        for x in range(width):
+            column = 0
+            for n in range(8):
+                y = band * 8 + n
+                if y < height and pixels[y][x]:
+                    column |= 1 << n
+            out.append(column)
+    return out
+
+
+def from_page_major(data, width, height):
+    """Inverse of to_page_major() - used to self-check the conversion."""
+    pixels = [[0] * width for _ in range(height)]
+    for y in range(height):
+        for x in range(width):
+            pixels[y][x] = (data[(y // 8) * width + x] >> (y & 7)) & 1
+    return pixels
+
+
+def subset_font(font, chars):
+    codes = sorted({ord(c) for c in chars})
+    for c in codes:
+        if c < font.first or c > font.last:
+            raise ValueError("%s: character %r is outside the font range" % (font.name, chr(c)))
+
+    first, last = codes[0], codes[-1]
+    bitmap = []
+    glyphs = []
+    for code in range(first, last + 1):
+        if code not in codes:
+            glyphs.append((0, 0, 0, 0, 0, 0))
+            continue
+        glyph = font.glyphs[code - font.first]
+        _, width, height, x_advance, x_offset, y_offset = glyph
+        pixels = glyph_pixels(font, glyph)
+        packed = to_page_major(pixels, width, height)
+        if from_page_major(packed, width, height) != pixels:
+            raise AssertionError("%s: page-major round trip failed for %r" % (font.name, chr(code)))
+        glyphs.append((len(bitmap), width, height, x_advance, x_offset, y_offset))
+        bitmap.extend(packed)
+
+    if not bitmap:
+        bitmap = [0]  # Keep the array non-empty for the C compiler
+    return Font(font.name, bitmap, glyphs, first, last, font.y_advance)
+
+
+def char_comment(code):
+    c = chr(code)
+    return "0x%02X '%s'" % (code, "\\\\" if c == "\\" else c)
+
+
+def emit_c(subsets, source_name):
+    lines = [
+        "// Generated by tools/font_subset.py from %s - DO NOT EDIT" % source_name,
+        "// Glyph bitmaps are pre-rasterized in SH1106 page-major layout:",
+        "//   byte[band * width + column], bit n = pixel row (band * 8 + n)",
+        "// Tables are read for every glyph drawn, so they follow the hot path placement",
+        "// (SRAM when built with HOT_PATH_IN_RAM, see hot_path.h)",
+        "",
+        '#include "font.h"',
+        '#include "hot_path.h"',
+        "",
+    ]
+    for font in subsets:
+        lines.append("// %s subset: %d glyph(s), %d bytes" % (
+            font.name, sum(1 for g in font.glyphs if g[1] or g[3]), font.size_bytes()))
+        lines.append("static const uint8_t %sBitmaps[] HOT_DATA(\"fonts\") = {" % font.name)
+        for i in range(0, len(font.bitmap), 12):
+            row = ", ".join("0x%02X" % b for b in font.bitmap[i:i + 12])
+            lines.append("    %s," % row)
+        lines.append("};")
+        lines.append("")
+        lines.append("static const GFXglyph %sGlyphs[] HOT_DATA(\"fonts\") = {" % font.name)
+        for i, g in enumerate(font.glyphs):
+            lines.append("    {%d, %d, %d, %d, %d, %d}, // %s" % (g + (char_comment(font.first + i),)))
+        lines.append("};")
+        lines.append("")
+        lines.append("const GFXfont %s HOT_DATA(\"fonts\") = {%sBitmaps, %sGlyphs, 0x%02X, 0x%02X, %d};" % (
+            font.name, font.name, font.name, font.first, font.last, font.y_advance))
+        lines.append("")
+    return "\n".join(lines)
+
+
+def size_report(fonts, subsets):
+    before = sum(f.size_bytes() for f in fonts.values())
+    after = sum(f.size_bytes() for f in subsets)
+    lines = ["Font size report (bitmap + glyph table + font header, bytes)", ""]
+    lines.append("%-22s %8s %8s" % ("Font", "Before", "After"))
+    for name in sorted(fonts):
+        subset = next((s for s in subsets if s.name == name), None)
+        lines.append("%-22s %8d %8s" % (name, fonts[name].size_bytes(),
+                                         subset.size_bytes() if subset else "-"))
+    lines.append("%-22s %8d %8d" % ("Total", before, after))
+    lines.append("")
+    lines.append("Saved %d bytes (%.1f%%)" % (before - after, 100.0 * (before - after) / before))
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("source", help="Adafruit GFX font source (adafruit_fonts.c)")
+    parser.add_argument("output", help="Generated C file")
+    parser.add_argument("--report", help="Write the before/after size report to this file")
+    args = parser.parse_args()
+
+    with open(args.source) as f:
+        fonts = parse_fonts(f.read())
+
+    subsets = []
+    for name, chars in FONT_GLYPHS.items():
+        if name not in fonts:
+            sys.exit("font_subset.py: font %s not found in %s" % (name, args.source))
+        subsets.append(subset_font(fonts[name], chars))
+
+    with open(args.output, "w") as f:
+        f.write(emit_c(subsets, args.source.replace("\\", "/").split("/")[-1]))
+
+    report = size_report(fonts, subsets)
+    if args.report:
+        with open(args.report, "w") as f:
+            f.write(report)
+    print(report, end="")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,215 @@
+#!/usr/bin/env python3
+"""
+Decode binary log records (LOG_BINARY=1 firmware) into text.
+
+Input is the raw byte stream read from the log buffer - a dump of the BLE logs
+characteristic, or a capture of the USB output - in the record format
+described in log_binary.h. Formatting uses the string table tools/log_strings.py
+wrote for the same build (log_strings.json in the build directory).
+
+Each line is prefixed with the device time in seconds. Records the table does
+not know, bytes between records and partial records at the ends of the input
+are reported rather than silently skipped.
+
+Usage:
+    log_decode.py log_strings.json [dump.bin] [--no-time]   (reads stdin without a file)
+    log_decode.py log_strings.json /dev/ttyACM0             (live USB serial output)
+"""
+
+import argparse
+import json
+import re
+import struct
+import sys
+
+SYNC = 0xFE
+HEADER_SIZE = 9
+SITE_BOOT = 1
+SITE_DROPPED = 2
+
+CONVERSION = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?(hh|h|ll|l|j|z|t|L)?([diouxXeEfFgGaAcsp%])")
+
+
+class Args:
+    """Reads encoded arguments in order; None once the record runs out."""
+
+    def __init__(self, payload):
+        self.payload = payload
+        self.pos = 0
+
+    def take(self, n):
+        if self.pos + n > len(self.payload):
+            self.pos = len(self.payload)
+            return None
+        data = self.payload[self.pos:self.pos + n]
+        self.pos += n
+        return data
+
+    def word(self, signed=False):
+        data = self.take(4)
+        return None if data is None else struct.unpack("<i" if signed else "<I", data)[0]
+
+    def dword(self, signed=False):
+        data = self.take(8)
+        return None if data is None else struct.unpack("<q" if signed else "<Q", data)[0]
+
+    def float(self):
+        data = self.take(4)
+        return None if data is None else struct.unpack("<f", data)[0]
+
+    def string(self):
+        n = self.take(1)
+        data = None if n is None else self.take(n[0])
+        return None if data is None else data.decode("utf-8", errors="replace")
+
+
+def format_record(fmt, payload):
+    """printf-style formatting of one record's arguments."""
+    args = Args(payload)
+
+    def convert(m):
+        flags, width, precision, length, conv = m.groups()
+        if conv == "%":
+            return "%"
+        if width == "*":
+            width = args.word(signed=True)
+            width = "" if width is None else str(width)
+        if precision == "*":
+            precision = args.word(signed=True)
+            precision = "" if precision is None else str(precision)
+        spec = "%" + flags + (width or "") + ("." + precision if precision is not None else "")
+
+        if conv == "s":
+            value = args.string()
+        elif conv in "eEfFgGaA":
+            value = args.float()
+            conv = "f" if conv in "aA" else conv
+        elif conv == "p":
+            value = args.word()
+            spec, conv = "0x%08", "x"
+        elif length == "ll":
+            value = args.dword(signed=conv in "di")
+        else:
+            value = args.word(signed=conv in "di")
+            if value is not None and length == "hh":
+                value = value & 0xFF if conv not in "di" else (value + 0x80 & 0xFF) - 0x80
+            elif value is not None and length == "h":
+                value = value & 0xFFFF if conv not in "di" else (value + 0x8000 & 0xFFFF) - 0x8000
+
+        if value is None:
+            return "?"
+        if conv == "u":
+            conv = "d"
+        try:
+            return (spec + conv) % value
+        except (TypeError, ValueError, OverflowError):
+            return "?"
+
+    return CONVERSION.sub(convert, fmt)
+
+
+class Decoder:
+    """Turns a byte stream into text; keeps state between feed() calls."""
+
+    def __init__(self, table, timestamps=True):
+        self.timestamps = timestamps
+        self.files = table["files"]
+        self.sites = table["sites"]
+        self.table_hash = table["hash"]
+        self.pending = b""
+        self.last_raw = None
+        self.time_base = 0
+        self.at_line_start = True
+
+    def timestamp(self, raw):
+        # time_us_32() wraps every ~71.6 minutes; records are much closer
+        if self.last_raw is not None and raw < self.last_raw:
+            self.time_base += 1 << 32
+        self.last_raw = raw
+        return (self.time_base + raw) / 1e6
+
+    def line(self, seconds, text):
+        out = []
+        for piece in text.splitlines(keepends=True):
+            if self.at_line_start and self.timestamps:
+                out.append(f"[{seconds:12.6f}] ")
+            out.append(piece)
+            self.at_line_start = piece.endswith("\n")
+        return "".join(out)
+
+    def record(self, rec):
+        file_id, line, raw_time = struct.unpack_from("<BHI", rec, 2)
+        payload = rec[HEADER_SIZE:]
+
+        if file_id == 0 and line == SITE_BOOT:
+            self.time_base, self.last_raw = 0, None
+            seconds = self.timestamp(raw_time)
+            table_hash = Args(payload).word()
+            status = "string table OK" if table_hash == self.table_hash else \
+                f"STRING TABLE MISMATCH: firmware 0x{table_hash or 0:08X}, table 0x{self.table_hash:08X}"
+            prefix = "" if self.at_line_start else "\n"
+            return prefix + self.line(seconds, f"=== boot ({status}) ===\n")
+
+        seconds = self.timestamp(raw_time)
+        if file_id == 0 and line == SITE_DROPPED:
+            return self.line(seconds, f"[LOG] {Args(payload).word()} bytes dropped\n")
+
+        fmt = self.sites.get(f"{file_id}:{line}")
+        if fmt is None:
+            name = self.files.get(str(file_id), f"file {file_id}")
+            return self.line(seconds, f"<unknown log site {name}:{line}, {len(payload)} arg bytes>\n")
+        return self.line(seconds, format_record(fmt, payload))
+
+    def feed(self, data):
+        buf = self.pending + data
+        out = []
+        pos = 0
+        while pos < len(buf):
+            if buf[pos] != SYNC:
+                # Not at a record boundary (e.g. the stream started mid-record)
+                nxt = buf.find(bytes([SYNC]), pos)
+                nxt = len(buf) if nxt < 0 else nxt
+                out.append(f"<skipped {nxt - pos} bytes>\n")
+                self.at_line_start = True
+                pos = nxt
+                continue
+            if pos + 2 > len(buf) or pos + buf[pos + 1] > len(buf):
+                break
+            length = buf[pos + 1]
+            if length < HEADER_SIZE:
+                pos += 1
+                continue
+            out.append(self.record(buf[pos:pos + length]))
+            pos += length
+        self.pending = buf[pos:]
+        return "".join(out)
+
+    def finish(self):
+        if self.pending:
+            return f"<{len(self.pending)} bytes of an incomplete record>\n"
+        return ""
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("table", help="log_strings.json from the firmware build")
+    parser.add_argument("input", nargs="?", help="Binary log dump (default: stdin)")
+    parser.add_argument("--no-time", action="store_true", help="Leave out the timestamps")
+    args = parser.parse_args()
+
+    with open(args.table, encoding="utf-8") as f:
+        decoder = Decoder(json.load(f), timestamps=not args.no_time)
+
+    stream = open(args.input, "rb") if args.input else sys.stdin.buffer
+    with stream:
+        while True:
+            chunk = stream.read1(4096)  # Whatever has arrived, for live streams
+            if not chunk:
+                break
+            sys.stdout.write(decoder.feed(chunk))
+            sys.stdout.flush()
+    sys.stdout.write(decoder.finish())
+
+
+if __name__ == "__main__":
+    main()
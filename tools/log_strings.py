@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+"""
+Build-time string table for deferred binary logging (LOG_BINARY=1).
+
+Scans the firmware sources for log_printf() and LOG_ERROR/WARN/INFO/DEBUG/
+VERBOSE(tag, ...) calls and writes the table the host-side decoders use to turn
+binary log records back into text. A call site is identified by (file id,
+line): file ids are the 1-based positions of the sources on the command line,
+which CMake also passes to the compiler as LOG_FILE_ID, and the line is the
+line of the call's first token (what GCC reports as __LINE__ for a macro call
+that spans several lines).
+
+Outputs:
+    log_strings.json  {"version", "hash", "files": {id: name}, "sites": {"id:line": format}}
+    log_strings.h     LOG_STRINGS_HASH, logged at boot so a decoder can tell
+                      whether its table matches the firmware
+
+Usage:
+    log_strings.py --json log_strings.json --header log_strings.h a.c b.c ...
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+SIMPLE_ESCAPES = {
+    "n": "\n", "t": "\t", "r": "\r", "0": "\0", "\\": "\\", "'": "'", '"': '"',
+    "?": "?", "a": "\a", "b": "\b", "f": "\f", "v": "\v",
+}
+
+
+def decode_literal(body):
+    """Decode the contents of a C string literal (without the quotes)."""
+    out = bytearray()
+    i = 0
+    while i < len(body):
+        c = body[i]
+        if c != "\\":
+            out += c.encode("utf-8")
+            i += 1
+            continue
+        nxt = body[i + 1]
+        if nxt == "x":
+            m = re.match(r"[0-9A-Fa-f]+", body[i + 2:])
+            out.append(int(m.group(0), 16) & 0xFF)
+            i += 2 + len(m.group(0))
+        elif nxt in "01234567":
+            m = re.match(r"[0-7]{1,3}", body[i + 1:])
+            out.append(int(m.group(0), 8) & 0xFF)
+            i += 1 + len(m.group(0))
+        else:
+            out += SIMPLE_ESCAPES[nxt].encode("utf-8")
+            i += 2
+    return out.decode("utf-8", errors="replace")
+
+
+class Scanner:
+    """Minimal C lexer: skips comments and literals, tracks line numbers."""
+
+    def __init__(self, text):
+        self.text = text
+        self.pos = 0
+        self.line = 1
+
+    def advance(self, n):
+        self.line += self.text.count("\n", self.pos, self.pos + n)
+        self.pos += n
+
+    def skip_space(self):
+        while self.pos < len(self.text):
+            if self.text.startswith("//", self.pos):
+                end = self.text.find("\n", self.pos)
+                self.advance((end if end >= 0 else len(self.text)) - self.pos)
+            elif self.text.startswith("/*", self.pos):
+                end = self.text.find("*/", self.pos + 2)
+                self.advance(end + 2 - self.pos)
+            elif self.text[self.pos].isspace():
+                self.advance(1)
+            else:
+                break
+
+    def quoted(self, quote):
+        """Length of the quoted literal starting at pos."""
+        i = self.pos + 1
+        while self.text[i] != quote:
+            i += 2 if self.text[i] == "\\" else 1
+        return i + 1 - self.pos
+
+    def string_literals(self):
+        """Concatenated string literals at pos, or None if there are none."""
+        parts = []
+        while True:
+            self.skip_space()
+            if not self.text.startswith('"', self.pos):
+                break
+            n = self.quoted('"')
+            parts.append(decode_literal(self.text[self.pos + 1:self.pos + n - 1]))
+            self.advance(n)
+        return "".join(parts) if parts else None
+
+
+# Level macros from logging.h: the format follows the tag argument
+LEVEL_MACROS = {"LOG_ERROR", "LOG_WARN", "LOG_INFO", "LOG_DEBUG", "LOG_VERBOSE"}
+
+
+def scan_calls(path):
+    """Yield (line, format) for every log call in a source file."""
+    with open(path, encoding="utf-8") as f:
+        scanner = Scanner(f.read())
+    ident = re.compile(r"[A-Za-z_]\w*")
+    text = scanner.text
+
+    while True:
+        scanner.skip_space()
+        if scanner.pos >= len(text):
+            return
+        c = text[scanner.pos]
+        if c in "\"'":
+            scanner.advance(scanner.quoted(c))
+            continue
+        m = ident.match(text, scanner.pos)
+        if not m:
+            scanner.advance(1)
+            continue
+        line = scanner.line
+        scanner.advance(len(m.group(0)))
+        if m.group(0) != "log_printf" and m.group(0) not in LEVEL_MACROS:
+            continue
+        scanner.skip_space()
+        if not text.startswith("(", scanner.pos):
+            continue
+        scanner.advance(1)
+        if m.group(0) in LEVEL_MACROS:
+            comma = text.index(",", scanner.pos)  # Tags are plain identifiers
+            scanner.advance(comma + 1 - scanner.pos)
+        fmt = scanner.string_literals()
+        if fmt is not None:
+            yield line, fmt
+        elif not re.match(r"(const|char)\b", text[scanner.pos:scanner.pos + 5]):
+            # Not the declaration: the decoder could never show this call
+            sys.exit(f"{path}:{line}: log_printf format must be a string literal")
+
+
+def fnv1a(data):
+    h = 0x811C9DC5
+    for b in data:
+        h = ((h ^ b) * 0x01000193) & 0xFFFFFFFF
+    return h
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("sources", nargs="+", help="Sources in LOG_FILE_ID order (first = 1)")
+    parser.add_argument("--json", required=True, help="String table for the decoders")
+    parser.add_argument("--header", required=True, help="Generated C header")
+    args = parser.parse_args()
+
+    if len(args.sources) > 255:
+        sys.exit("too many sources for an 8-bit file id")
+
+    files = {}
+    sites = {}
+    for file_id, path in enumerate(args.sources, start=1):
+        files[str(file_id)] = os.path.basename(path)
+        for line, fmt in scan_calls(path):
+            key = f"{file_id}:{line}"
+            if key in sites and sites[key] != fmt:
+                sys.exit(f"{path}:{line}: two log_printf calls on one line")
+            sites[key] = fmt
+
+    table = {"files": files, "sites": sites}
+    table_hash = fnv1a(json.dumps(table, sort_keys=True).encode("utf-8"))
+
+    with open(args.json, "w", encoding="utf-8") as f:
+        json.dump({"version": 1, "hash": table_hash, **table}, f, indent=1, ensure_ascii=False)
+        f.write("\n")
+
+    with open(args.header, "w") as f:
+        f.write("// Generated by tools/log_strings.py - do not edit\n")
+        f.write("#ifndef LOG_STRINGS_H\n#define LOG_STRINGS_H\n\n")
+        f.write(f"#define LOG_STRINGS_HASH 0x{table_hash:08X}u\n")
+        f.write(f"#define LOG_STRINGS_COUNT {len(sites)}\n\n")
+        f.write("#endif // LOG_STRINGS_H\n")
+
+    print(f"log_strings: {len(sites)} call sites in {len(files)} files, hash 0x{table_hash:08X}")
+
+
+if __name__ == "__main__":
+    main()
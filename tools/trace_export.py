@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+"""
+Convert a trace dump in the device log into Chrome trace-event JSON.
+
+Input is log text containing a dump written by trace.h ("[TRACE] begin",
+one "[TRACE] <time> <word>" line per event, "[TRACE] end"): the logs saved by
+the Android app, a capture of USB serial, or tools/log_decode.py output for
+LOG_BINARY=1 firmware. Other lines are ignored, so the whole log can be given.
+
+Event names come from the trace_event_t enum in trace.h. Open the output in
+Perfetto (ui.perfetto.dev) or chrome://tracing. Timestamps are microseconds
+since boot, with wraps of the 32-bit device timer undone. An end whose begin
+was overwritten in the ring is dropped.
+
+Usage:
+    trace_export.py [log.txt] [-o trace.json] [--dump N]   (reads stdin without a file)
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+TRACE_H = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "trace.h")
+
+BEGIN = re.compile(r"\[TRACE\] begin (\d+) records, (\d+) lost")
+RECORD = re.compile(r"\[TRACE\] ([0-9a-fA-F]{8}) ([0-9a-fA-F]{8})")
+END = re.compile(r"\[TRACE\] end")
+
+MAIN_TID = 1
+IRQ_TID = 2
+IRQ_EVENTS = {"sensor_irq"}
+
+
+def load_event_names(path):
+    """Map event numbers to names from the trace_event_t enum."""
+    with open(path, encoding="utf-8") as f:
+        source = f.read()
+    body = re.search(r"typedef enum \{(.*?)\} trace_event_t;", source, re.S)
+    if not body:
+        sys.exit(f"trace_event_t not found in {path}")
+    return {int(value): name.lower()
+            for name, value in re.findall(r"TRACE_(\w+)\s*=\s*(\d+)", body.group(1))}
+
+
+def read_dumps(lines):
+    """Collect (records, lost, complete) for every dump in the log."""
+    dumps = []
+    current = None
+    for line in lines:
+        match = BEGIN.search(line)
+        if match:
+            current = {"records": [], "lost": int(match.group(2)), "complete": False}
+            dumps.append(current)
+            continue
+        if current is None:
+            continue
+        match = RECORD.search(line)
+        if match:
+            current["records"].append((int(match.group(1), 16), int(match.group(2), 16)))
+        elif END.search(line):
+            current["complete"] = True
+            current = None
+    return dumps
+
+
+def convert(dump, names):
+    """Build the trace-event list for one dump."""
+    events = [
+        {"name": "thread_name", "ph": "M", "pid": 1, "tid": MAIN_TID, "args": {"name": "main loop"}},
+        {"name": "thread_name", "ph": "M", "pid": 1, "tid": IRQ_TID, "args": {"name": "interrupts"}},
+    ]
+    open_spans = {}
+    time = None
+    last = 0
+    for time_us, word in dump["records"]:
+        # Unwrap the 32-bit microsecond counter
+        time = time_us if time is None else time + ((time_us - last) & 0xFFFFFFFF)
+        last = time_us
+
+        phase = chr(word & 0xFF)
+        event = (word >> 8) & 0xFF
+        arg = word >> 16
+        name = names.get(event, f"event_{event}")
+        tid = IRQ_TID if name in IRQ_EVENTS else MAIN_TID
+
+        key = (tid, name)
+        if phase == "B":
+            open_spans[key] = open_spans.get(key, 0) + 1
+        elif phase == "E":
+            if not open_spans.get(key):
+                continue  # Its begin was overwritten before the dump
+            open_spans[key] -= 1
+        elif phase != "i":
+            print(f"warning: unknown phase {word & 0xFF:#04x} at {time} us", file=sys.stderr)
+            continue
+
+        entry = {"name": name, "ph": phase, "ts": time, "pid": 1, "tid": tid, "args": {"arg": arg}}
+        if phase == "i":
+            entry["s"] = "t"
+        events.append(entry)
+    return events
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("input", nargs="?", help="Log text (default: stdin)")
+    parser.add_argument("-o", "--output", help="JSON file to write (default: stdout)")
+    parser.add_argument("--dump", type=int, default=0,
+                        help="Which dump to export when the log has several (1 = first, default: last)")
+    parser.add_argument("--trace-h", default=TRACE_H, help="trace.h with the event names")
+    args = parser.parse_args()
+
+    names = load_event_names(args.trace_h)
+    stream = open(args.input, encoding="utf-8", errors="replace") if args.input else sys.stdin
+    with stream:
+        dumps = read_dumps(stream)
+
+    if not dumps:
+        sys.exit("no trace dump found (no \"[TRACE] begin\" line)")
+    if args.dump < 0 or args.dump > len(dumps):
+        sys.exit(f"dump {args.dump} requested, the log has {len(dumps)}")
+    dump = dumps[args.dump - 1] if args.dump else dumps[-1]
+
+    if not dump["complete"]:
+        print("warning: dump has no end line, it may be cut short", file=sys.stderr)
+    if dump["lost"]:
+        print(f"warning: {dump['lost']} older events were overwritten before the dump", file=sys.stderr)
+
+    trace = {"traceEvents": convert(dump, names), "displayTimeUnit": "ms",
+             "otherData": {"lost_events": dump["lost"]}}
+    output = open(args.output, "w", encoding="utf-8") if args.output else sys.stdout
+    with output:
+        json.dump(trace, output, indent=1)
+        output.write("\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,88 @@
+/**
+ * Event tracing implementation
+ *
+ * The ring has several writers (main loop and IRQ handlers), so each put runs
+ * with interrupts masked; everything happens on core 0. Dumps go through
+ * log_printf, paced so a dump does not overrun the USB copy of the log.
+ */
+
+#include "trace.h"
+#include "logging.h"
+
+#if TRACE_EVENTS
+#include "hot_path.h"
+#include "pico/time.h"
+#include "hardware/sync.h"
+
+// Records per dump step: with a 100 ms main loop this stays well under what
+// USB serial drains per pass (LOG_USB_BUFFER_SIZE)
+#ifndef TRACE_DUMP_BATCH
+#define TRACE_DUMP_BATCH 32
+#endif
+
+static trace_record_t trace_records[TRACE_BUFFER_RECORDS];
+static trace_buffer_t trace_buffer;
+static volatile bool trace_recording = false;
+static bool trace_dumping = false;
+static uint32_t trace_dump_next;
+
+void HOT_FUNC(trace_emit)(uint8_t phase, uint8_t event, uint16_t arg) {
+    if (!trace_recording) {
+        return;
+    }
+    uint32_t ints = save_and_disable_interrupts();
+    trace_buffer_put(&trace_buffer, phase, event, arg, time_us_32());
+    restore_interrupts(ints);
+}
+
+void trace_init(void) {
+    trace_buffer_init(&trace_buffer, trace_records, TRACE_BUFFER_RECORDS);
+    trace_recording = true;
+    LOG_INFO(LOG_TAG_PERF, "[TRACE] Recording the last %u events\n", TRACE_BUFFER_RECORDS);
+}
+
+bool trace_dump_start(void) {
+    if (trace_dumping) {
+        return false;
+    }
+    trace_recording = false;
+    trace_dumping = true;
+    trace_dump_next = trace_buffer_oldest(&trace_buffer);
+
+    log_printf("[TRACE] begin %lu records, %lu lost\n",
+               trace_buffer.head - trace_dump_next, trace_buffer_lost(&trace_buffer));
+    return true;
+}
+
+void trace_dump_step(void) {
+    if (!trace_dumping) {
+        return;
+    }
+
+    trace_record_t rec;
+    for (int i = 0; i < TRACE_DUMP_BATCH; i++) {
+        if (!trace_buffer_get(&trace_buffer, trace_dump_next, &rec)) {
+            log_printf("[TRACE] end\n");
+            trace_buffer_clear(&trace_buffer);
+            trace_dumping = false;
+            trace_recording = true;
+            return;
+        }
+        log_printf("[TRACE] %08lx %08lx\n", rec.time_us, trace_record_word(&rec));
+        trace_dump_next++;
+    }
+}
+
+#else
+
+void trace_init(void) {
+}
+
+bool trace_dump_start(void) {
+    return false;
+}
+
+void trace_dump_step(void) {
+}
+
+#endif
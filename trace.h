@@ -0,0 +1,80 @@
+/**
+ * Event tracing (TRACE_EVENTS=1, CMake option of the same name)
+ *
+ * TRACE_BEGIN / TRACE_END / TRACE_INSTANT(event, arg) record a timestamped
+ * event (time_us_32, one 16-bit argument) in a dedicated ring that keeps the
+ * latest TRACE_BUFFER_RECORDS events (trace_buffer.h). A record costs an
+ * interrupt mask, a timer read and four stores, so the main loop phases,
+ * display transfers, flash writes and the sensor IRQ can stay instrumented.
+ * Without the option the macros compile to nothing.
+ *
+ * The ring is dumped on request (BLE ...DEFA, see walkolution-odometer.gatt)
+ * into the log, a few records per main loop pass, as lines
+ *   [TRACE] <time_us hex> <phase | event << 8 | arg << 16 hex>
+ * framed by "[TRACE] begin" / "[TRACE] end" lines, so it reaches both the BLE
+ * logs characteristic and USB serial, in text or binary log mode. Recording
+ * pauses while a dump runs. tools/trace_export.py turns a captured log into
+ * Chrome trace-event JSON for Perfetto (ui.perfetto.dev) or chrome://tracing.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "trace_buffer.h"
+
+#ifndef TRACE_EVENTS
+#define TRACE_EVENTS 0
+#endif
+
+#ifndef TRACE_BUFFER_RECORDS
+#define TRACE_BUFFER_RECORDS 1024   // 8 KB: several seconds of main loop
+#endif
+
+// Values appear in dumps and tools/trace_export.py takes the names from this
+// enum: only append
+typedef enum {
+    TRACE_MAIN_LOOP = 0,        // One pass, sleep excluded
+    TRACE_SLEEP = 1,            // Main loop delay on the crystal oscillator
+    TRACE_ODOMETER_PROCESS = 2, // End arg: rotation detected
+    TRACE_PERIPHERAL_CHECK = 3,
+    TRACE_CYW43_POLL = 4,
+    TRACE_LOG_NOTIFY = 5,       // End arg: notifications sent
+    TRACE_SPEED_UPDATE = 6,
+    TRACE_PERF_REPORT = 7,
+    TRACE_BLE_UPDATE = 8,
+    TRACE_DISPLAY_UPDATE = 9,   // Arg: screen_id_t
+    TRACE_OLED_RENDER = 10,     // End arg: bytes sent
+    TRACE_FLASH_ERASE = 11,     // Arg: sector
+    TRACE_FLASH_PROGRAM = 12,   // Arg: sector
+    TRACE_FLASH_VERIFY = 13,    // End arg: passed
+    TRACE_SENSOR_IRQ = 14,      // Arg: GPIO event mask
+    TRACE_USB_DRAIN = 15,
+    TRACE_EVENT_COUNT
+} trace_event_t;
+
+#if TRACE_EVENTS
+// Record one event; any context on core 0, interrupts included
+void trace_emit(uint8_t phase, uint8_t event, uint16_t arg);
+
+#define TRACE_BEGIN(event, arg) trace_emit(TRACE_PHASE_BEGIN, (event), (uint16_t)(arg))
+#define TRACE_END(event, arg) trace_emit(TRACE_PHASE_END, (event), (uint16_t)(arg))
+#define TRACE_INSTANT(event, arg) trace_emit(TRACE_PHASE_INSTANT, (event), (uint16_t)(arg))
+#else
+#define TRACE_BEGIN(event, arg) ((void)0)
+#define TRACE_END(event, arg) ((void)0)
+#define TRACE_INSTANT(event, arg) ((void)0)
+#endif
+
+// Set up the ring and start recording (no-op without TRACE_EVENTS)
+void trace_init(void);
+
+// Start dumping the ring into the log; recording pauses until it is done
+// Returns false if tracing is not built in or a dump is already running
+bool trace_dump_start(void);
+
+// Write the next few records of a running dump; call once per main loop pass
+void trace_dump_step(void);
+
+#endif // TRACE_H
@@ -0,0 +1,52 @@
+/**
+ * Trace event ring implementation
+ */
+
+#include "trace_buffer.h"
+#include "hot_path.h"
+
+bool trace_buffer_init(trace_buffer_t *buf, trace_record_t *records, size_t count) {
+    if (count == 0 || (count & (count - 1)) != 0 || count > 0x80000000u) {
+        return false;
+    }
+    buf->records = records;
+    buf->mask = (uint32_t)count - 1;
+    buf->head = 0;
+    buf->first = 0;
+    return true;
+}
+
+void HOT_FUNC(trace_buffer_put)(trace_buffer_t *buf, uint8_t phase, uint8_t event, uint16_t arg, uint32_t time_us) {
+    trace_record_t *rec = &buf->records[buf->head & buf->mask];
+    rec->time_us = time_us;
+    rec->phase = phase;
+    rec->event = event;
+    rec->arg = arg;
+    buf->head++;
+}
+
+uint32_t trace_buffer_oldest(const trace_buffer_t *buf) {
+    uint32_t written = buf->head - buf->first;
+    return (written > buf->mask + 1) ? buf->head - (buf->mask + 1) : buf->first;
+}
+
+uint32_t trace_buffer_lost(const trace_buffer_t *buf) {
+    return trace_buffer_oldest(buf) - buf->first;
+}
+
+bool trace_buffer_get(const trace_buffer_t *buf, uint32_t index, trace_record_t *out) {
+    uint32_t oldest = trace_buffer_oldest(buf);
+    if (index - oldest >= buf->head - oldest) {
+        return false;
+    }
+    *out = buf->records[index & buf->mask];
+    return true;
+}
+
+void trace_buffer_clear(trace_buffer_t *buf) {
+    buf->first = buf->head;
+}
+
+uint32_t trace_record_word(const trace_record_t *rec) {
+    return (uint32_t)rec->phase | ((uint32_t)rec->event << 8) | ((uint32_t)rec->arg << 16);
+}
@@ -0,0 +1,63 @@
+/**
+ * Fixed-size ring of trace events
+ *
+ * Flight recorder for trace.h: each event is one 8-byte record and a full
+ * ring overwrites its oldest records, so it always holds the latest window.
+ *
+ * - The size is a power of two; head is a free-running record counter.
+ * - first marks where the retained window starts (moved by clear), so a dump
+ *   knows how many records were overwritten before it got to them.
+ * - No locking here: the caller keeps writers from interleaving (trace.c
+ *   masks interrupts around each put).
+ */
+
+#ifndef TRACE_BUFFER_H
+#define TRACE_BUFFER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Phases use the Chrome trace-event "ph" letters
+#define TRACE_PHASE_BEGIN 'B'
+#define TRACE_PHASE_END 'E'
+#define TRACE_PHASE_INSTANT 'i'
+
+typedef struct {
+    uint32_t time_us;   // time_us_32() when recorded
+    uint8_t phase;      // TRACE_PHASE_*
+    uint8_t event;      // trace_event_t (trace.h)
+    uint16_t arg;       // Event-specific value, 0 if unused
+} trace_record_t;
+
+typedef struct {
+    trace_record_t *records;
+    uint32_t mask;      // count - 1
+    uint32_t head;      // Records ever written
+    uint32_t first;     // head when last cleared
+} trace_buffer_t;
+
+// Use `records` (count must be a power of two) as an empty ring
+// Returns false if count is not a power of two
+bool trace_buffer_init(trace_buffer_t *buf, trace_record_t *records, size_t count);
+
+// Append one record, overwriting the oldest if the ring is full
+void trace_buffer_put(trace_buffer_t *buf, uint8_t phase, uint8_t event, uint16_t arg, uint32_t time_us);
+
+// Index (in head counts) of the oldest record still held
+uint32_t trace_buffer_oldest(const trace_buffer_t *buf);
+
+// Records written since the last clear that have been overwritten
+uint32_t trace_buffer_lost(const trace_buffer_t *buf);
+
+// Copy the record at `index` into out; false if it is not held (any more)
+bool trace_buffer_get(const trace_buffer_t *buf, uint32_t index, trace_record_t *out);
+
+// Forget everything recorded so far
+void trace_buffer_clear(trace_buffer_t *buf);
+
+// Second dump word of a record: phase | event << 8 | arg << 16
+// (the first is time_us; tools/trace_export.py reads them back)
+uint32_t trace_record_word(const trace_record_t *rec);
+
+#endif // TRACE_BUFFER_H
@@ -0,0 +1,188 @@
+/**
+ * Retained-mode widget layer implementation
+ */
+
+#include "ui.h"
+#include "oled.h"
+#include <string.h>
+
+// Screen currently shown in the OLED buffer (NULL = buffer contents unknown)
+static ui_screen_t *active_screen = NULL;
+
+void ui_invalidate(void) {
+    active_screen = NULL;
+}
+
+static bool rect_is_empty(const ui_rect_t *r) {
+    return r->width <= 0 || r->height <= 0;
+}
+
+static bool rects_intersect(const ui_rect_t *a, const ui_rect_t *b) {
+    if (rect_is_empty(a) || rect_is_empty(b)) {
+        return false;
+    }
+    return a->x < b->x + b->width && b->x < a->x + a->width &&
+           a->y < b->y + b->height && b->y < a->y + a->height;
+}
+
+// Pixel bounds actually inked by oled_draw_text(x, baseline, text, font)
+// Unlike oled_measure_text() this includes glyph x offsets, so it covers
+// glyphs that overhang their advance width
+static ui_rect_t text_bounds(int x, int baseline, const char *text, const GFXfont *font) {
+    ui_rect_t bounds = {0, 0, 0, 0};
+    int left = 0, top = 0, right = 0, bottom = 0;
+    bool any = false;
+    int cursor_x = x;
+
+    while (*text) {
+        char c = *text++;
+        if (c < font->first || c > font->last) {
+            continue;
+        }
+
+        const GFXglyph *glyph = &font->glyph[c - font->first];
+        if (glyph->width > 0 && glyph->height > 0) {
+            int glyph_left = cursor_x + glyph->x_offset;
+            int glyph_top = baseline + glyph->y_offset;
+            int glyph_right = glyph_left + glyph->width;
+            int glyph_bottom = glyph_top + glyph->height;
+
+            if (!any || glyph_left < left) left = glyph_left;
+            if (!any || glyph_top < top) top = glyph_top;
+            if (!any || glyph_right > right) right = glyph_right;
+            if (!any || glyph_bottom > bottom) bottom = glyph_bottom;
+            any = true;
+        }
+        cursor_x += glyph->x_advance;
+    }
+
+    if (any) {
+        bounds.x = left;
+        bounds.y = top;
+        bounds.width = right - left;
+        bounds.height = bottom - top;
+    }
+    return bounds;
+}
+
+// Evaluate a widget's data source into buf (UI_TEXT_MAX bytes)
+static void widget_value(const ui_widget_t *widget, const void *model, char *buf) {
+    buf[0] = '\0';
+
+    switch (widget->type) {
+    case UI_WIDGET_TEXT:
+        widget->text(model, buf, UI_TEXT_MAX);
+        break;
+    case UI_WIDGET_ICON:
+        if (widget->visible == NULL || widget->visible(model)) {
+            strcpy(buf, "1");
+        }
+        break;
+    case UI_WIDGET_FILL:
+        strcpy(buf, "1");
+        break;
+    }
+}
+
+// Draw a widget's cached value and record the pixels it covers
+static void widget_draw(ui_widget_t *widget) {
+    ui_rect_t empty = {0, 0, 0, 0};
+    widget->bounds = empty;
+
+    if (widget->value[0] == '\0') {
+        return; // Hidden
+    }
+
+    switch (widget->type) {
+    case UI_WIDGET_TEXT: {
+        int x = widget->x;
+        if (widget->align != UI_ALIGN_LEFT) {
+            // Align on advance width, matching oled_draw_text_centered()
+            int text_width;
+            oled_measure_text(widget->value, widget->font, &text_width, NULL, NULL);
+            x -= (widget->align == UI_ALIGN_CENTER) ? (text_width / 2) : text_width;
+        }
+        oled_draw_text(x, widget->y, widget->value, widget->font);
+        widget->bounds = text_bounds(x, widget->y, widget->value, widget->font);
+        break;
+    }
+    case UI_WIDGET_ICON:
+        oled_draw_bitmap(widget->x, widget->y, widget->icon->bitmap, widget->icon->width, widget->icon->height);
+        widget->bounds.x = widget->x;
+        widget->bounds.y = widget->y;
+        widget->bounds.width = widget->icon->width;
+        widget->bounds.height = widget->icon->height;
+        break;
+    case UI_WIDGET_FILL:
+        oled_fill_rect(widget->x, widget->y, widget->width, widget->height, true);
+        widget->bounds.x = widget->x;
+        widget->bounds.y = widget->y;
+        widget->bounds.width = widget->width;
+        widget->bounds.height = widget->height;
+        break;
+    }
+}
+
+bool ui_render(ui_screen_t *screen, const void *model) {
+    size_t count = (screen->count < UI_MAX_WIDGETS) ? screen->count : UI_MAX_WIDGETS;
+
+    // Different screen (or unknown buffer contents) - full redraw
+    if (screen != active_screen) {
+        oled_clear();
+        for (size_t i = 0; i < count; i++) {
+            ui_widget_t *widget = &screen->widgets[i];
+            widget_value(widget, model, widget->value);
+            widget_draw(widget);
+        }
+        active_screen = screen;
+        return true;
+    }
+
+    // Pass 1: find widgets whose value changed and erase what they used to cover
+    uint32_t redraw = 0;
+    ui_rect_t erased[UI_MAX_WIDGETS];
+    size_t erased_count = 0;
+    char value[UI_TEXT_MAX];
+
+    for (size_t i = 0; i < count; i++) {
+        ui_widget_t *widget = &screen->widgets[i];
+        widget_value(widget, model, value);
+        if (strcmp(value, widget->value) == 0) {
+            continue;
+        }
+
+        strcpy(widget->value, value);
+        redraw |= (1u << i);
+
+        if (!rect_is_empty(&widget->bounds)) {
+            oled_fill_rect(widget->bounds.x, widget->bounds.y, widget->bounds.width, widget->bounds.height, false);
+            erased[erased_count++] = widget->bounds;
+        }
+    }
+
+    if (redraw == 0) {
+        return false; // Nothing changed - buffer untouched
+    }
+
+    // Pass 2: unchanged widgets overlapping an erased area lost pixels - redraw them too
+    for (size_t i = 0; i < count; i++) {
+        if (redraw & (1u << i)) {
+            continue;
+        }
+        for (size_t j = 0; j < erased_count; j++) {
+            if (rects_intersect(&screen->widgets[i].bounds, &erased[j])) {
+                redraw |= (1u << i);
+                break;
+            }
+        }
+    }
+
+    // Pass 3: draw
+    for (size_t i = 0; i < count; i++) {
+        if (redraw & (1u << i)) {
+            widget_draw(&screen->widgets[i]);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,89 @@
+/**
+ * Retained-mode widget layer for the OLED display
+ *
+ * Screens are declared as arrays of widgets (text, icon or filled rectangle)
+ * bound to a data source. Each widget remembers the value it last rendered and
+ * its bounding box, so a refresh only erases and redraws widgets whose value
+ * changed. The OLED module then transfers only the dirty part of the buffer.
+ */
+
+#ifndef UI_H
+#define UI_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "font.h"
+#include "icons.h"
+
+// Longest text a widget can display (including terminator)
+#define UI_TEXT_MAX 24
+
+// Maximum number of widgets on one screen
+#define UI_MAX_WIDGETS 32
+
+typedef struct
+{
+    int16_t x;
+    int16_t y;
+    int16_t width;
+    int16_t height;
+} ui_rect_t;
+
+typedef enum
+{
+    UI_ALIGN_LEFT,   // x is the left edge of the text
+    UI_ALIGN_CENTER, // x is the horizontal center of the text
+    UI_ALIGN_RIGHT,  // x is the right edge of the text
+} ui_align_t;
+
+typedef enum
+{
+    UI_WIDGET_TEXT, // Text from a data source, drawn with a font at a baseline
+    UI_WIDGET_ICON, // Icon shown while a data source returns true
+    UI_WIDGET_FILL, // Static filled rectangle (separators, frames)
+} ui_widget_type_t;
+
+// Data source for a text widget: format the current value from model into buf
+// An empty string hides the widget
+typedef void (*ui_text_source_t)(const void *model, char *buf, size_t size);
+
+// Data source for an icon widget: return true while the icon should be visible
+typedef bool (*ui_visible_source_t)(const void *model);
+
+typedef struct
+{
+    // Declaration
+    ui_widget_type_t type;
+    int16_t x;      // TEXT: anchor x (see align); ICON/FILL: left edge
+    int16_t y;      // TEXT: baseline; ICON/FILL: top edge
+    int16_t width;  // FILL only
+    int16_t height; // FILL only
+    const GFXfont *font;         // TEXT only
+    ui_align_t align;            // TEXT only
+    ui_text_source_t text;       // TEXT only
+    const Icon *icon;            // ICON only
+    ui_visible_source_t visible; // ICON only (NULL = always visible)
+
+    // Retained state (managed by ui.c, zero-initialize)
+    char value[UI_TEXT_MAX]; // Last rendered value ("1" for a visible icon)
+    ui_rect_t bounds;        // Pixels covered by the last render (empty if hidden)
+} ui_widget_t;
+
+typedef struct
+{
+    ui_widget_t *widgets;
+    size_t count;
+} ui_screen_t;
+
+// Render a screen into the OLED buffer from the given model
+// If the screen differs from the last one rendered (or ui_invalidate() was called),
+// the buffer is cleared and every widget is drawn. Otherwise only widgets whose
+// value changed are redrawn, along with any widget overlapping an erased area.
+// Returns true if the buffer changed and oled_update() should be called
+bool ui_render(ui_screen_t *screen, const void *model);
+
+// Force the next ui_render() to redraw the whole screen
+void ui_invalidate(void);
+
+#endif // UI_H
@@ -85,7 +85,7 @@ static bool load_settings_from_flash(void)
     // Check magic number first
     if (magic != SETTINGS_MAGIC_NUMBER)
     {
-        log_printf("[SETTINGS] No valid settings in flash (bad magic) - using defaults\n");
+        LOG_WARN(LOG_TAG_SETTINGS, "[SETTINGS] No valid settings in flash (bad magic) - using defaults\n");
         return false;
     }
 
@@ -97,15 +97,15 @@ static bool load_settings_from_flash(void)
 
         if (flash_settings->checksum != calculate_checksum(flash_settings))
         {
-            log_printf("[SETTINGS] v%d settings checksum invalid - using defaults\n", SETTINGS_VERSION);
+            LOG_WARN(LOG_TAG_SETTINGS, "[SETTINGS] v%d settings checksum invalid - using defaults\n", SETTINGS_VERSION);
             return false;
         }
 
         // Valid v3 settings found - copy to RAM
         memcpy(&current_settings, flash_settings, sizeof(user_settings_t));
-        log_printf("[SETTINGS] Loaded v%d settings from flash:\n", SETTINGS_VERSION);
-        log_printf("  - Metric: %s\n", current_settings.metric ? "YES (km)" : "NO (miles)");
-        log_printf("  - Timezone offset: %ld seconds (%.1f hours)\n",
+        LOG_INFO(LOG_TAG_SETTINGS, "[SETTINGS] Loaded v%d settings from flash:\n", SETTINGS_VERSION);
+        LOG_INFO(LOG_TAG_SETTINGS, "  - Metric: %s\n", current_settings.metric ? "YES (km)" : "NO (miles)");
+        LOG_INFO(LOG_TAG_SETTINGS, "  - Timezone offset: %ld seconds (%.1f hours)\n",
                current_settings.timezone_offset_seconds,
                current_settings.timezone_offset_seconds / 3600.0f);
         return true;
@@ -113,14 +113,14 @@ static bool load_settings_from_flash(void)
     else if (version == 2)
     {
         // Migrate v2 to v3 (remove WiFi fields)
-        log_printf("[SETTINGS] Found v2 settings, migrating to v%d...\n", SETTINGS_VERSION);
+        LOG_INFO(LOG_TAG_SETTINGS, "[SETTINGS] Found v2 settings, migrating to v%d...\n", SETTINGS_VERSION);
 
         const user_settings_v2_t *v2_settings = (const user_settings_v2_t *)(XIP_BASE + SETTINGS_FLASH_OFFSET);
 
         // Validate v2 checksum
         if (v2_settings->checksum != calculate_checksum_v2(v2_settings))
         {
-            log_printf("[SETTINGS] v2 settings checksum invalid - using defaults\n");
+            LOG_WARN(LOG_TAG_SETTINGS, "[SETTINGS] v2 settings checksum invalid - using defaults\n");
             return false;
         }
 
@@ -131,30 +131,30 @@ static bool load_settings_from_flash(void)
         current_settings.metric = v2_settings->metric;
         current_settings.timezone_offset_seconds = v2_settings->timezone_offset_seconds;
 
-        log_printf("[SETTINGS] Migrated v2 settings:\n");
-        log_printf("  - Metric: %s\n", current_settings.metric ? "YES (km)" : "NO (miles)");
-        log_printf("  - Timezone offset: %ld seconds (%.1f hours)\n",
+        LOG_INFO(LOG_TAG_SETTINGS, "[SETTINGS] Migrated v2 settings:\n");
+        LOG_INFO(LOG_TAG_SETTINGS, "  - Metric: %s\n", current_settings.metric ? "YES (km)" : "NO (miles)");
+        LOG_INFO(LOG_TAG_SETTINGS, "  - Timezone offset: %ld seconds (%.1f hours)\n",
                current_settings.timezone_offset_seconds,
                current_settings.timezone_offset_seconds / 3600.0f);
-        log_printf("  - WiFi settings removed\n");
+        LOG_INFO(LOG_TAG_SETTINGS, "  - WiFi settings removed\n");
 
         // Save migrated settings as v3
         save_settings_to_flash();
-        log_printf("[SETTINGS] Migration complete, saved as v%d\n", SETTINGS_VERSION);
+        LOG_INFO(LOG_TAG_SETTINGS, "[SETTINGS] Migration complete, saved as v%d\n", SETTINGS_VERSION);
 
         return true;
     }
     else if (version == 1)
     {
         // Migrate v1 to v3 (drop WiFi fields)
-        log_printf("[SETTINGS] Found v1 settings, migrating to v%d...\n", SETTINGS_VERSION);
+        LOG_INFO(LOG_TAG_SETTINGS, "[SETTINGS] Found v1 settings, migrating to v%d...\n", SETTINGS_VERSION);
 
         const user_settings_v1_t *v1_settings = (const user_settings_v1_t *)(XIP_BASE + SETTINGS_FLASH_OFFSET);
 
         // Validate v1 checksum
         if (v1_settings->checksum != calculate_checksum_v1(v1_settings))
         {
-            log_printf("[SETTINGS] v1 settings checksum invalid - using defaults\n");
+            LOG_WARN(LOG_TAG_SETTINGS, "[SETTINGS] v1 settings checksum invalid - using defaults\n");
             return false;
         }
 
@@ -165,20 +165,20 @@ static bool load_settings_from_flash(void)
         current_settings.metric = v1_settings->metric;
         current_settings.timezone_offset_seconds = 0; // Default to UTC for migrated settings
 
-        log_printf("[SETTINGS] Migrated v1 settings:\n");
-        log_printf("  - Metric: %s\n", current_settings.metric ? "YES (km)" : "NO (miles)");
-        log_printf("  - Timezone offset: %ld seconds (default UTC)\n", current_settings.timezone_offset_seconds);
-        log_printf("  - WiFi settings removed\n");
+        LOG_INFO(LOG_TAG_SETTINGS, "[SETTINGS] Migrated v1 settings:\n");
+        LOG_INFO(LOG_TAG_SETTINGS, "  - Metric: %s\n", current_settings.metric ? "YES (km)" : "NO (miles)");
+        LOG_INFO(LOG_TAG_SETTINGS, "  - Timezone offset: %ld seconds (default UTC)\n", current_settings.timezone_offset_seconds);
+        LOG_INFO(LOG_TAG_SETTINGS, "  - WiFi settings removed\n");
 
         // Save migrated settings as v3
         save_settings_to_flash();
-        log_printf("[SETTINGS] Migration complete, saved as v%d\n", SETTINGS_VERSION);
+        LOG_INFO(LOG_TAG_SETTINGS, "[SETTINGS] Migration complete, saved as v%d\n", SETTINGS_VERSION);
 
         return true;
     }
     else
     {
-        log_printf("[SETTINGS] Unknown settings version %lu - using defaults\n", version);
+        LOG_WARN(LOG_TAG_SETTINGS, "[SETTINGS] Unknown settings version %lu - using defaults\n", version);
         return false;
     }
 }
@@ -192,7 +192,7 @@ static void create_default_settings(void)
     current_settings.timezone_offset_seconds = 0; // Default to UTC
     current_settings.checksum = calculate_checksum(&current_settings);
 
-    log_printf("[SETTINGS] Created default v%d settings (miles, UTC timezone)\n", SETTINGS_VERSION);
+    LOG_INFO(LOG_TAG_SETTINGS, "[SETTINGS] Created default v%d settings (miles, UTC timezone)\n", SETTINGS_VERSION);
 }
 
 static bool save_settings_to_flash(void)
@@ -211,7 +211,7 @@ static bool save_settings_to_flash(void)
     flash_range_program(SETTINGS_FLASH_OFFSET, write_buffer, FLASH_PAGE_SIZE);
     restore_interrupts(ints);
 
-    log_printf("[SETTINGS] Saved to flash\n");
+    LOG_INFO(LOG_TAG_SETTINGS, "[SETTINGS] Saved to flash\n");
     return true;
 }
 
@@ -222,7 +222,7 @@ void user_settings_init(void)
         return;
     }
 
-    log_printf("[SETTINGS] Initializing...\n");
+    LOG_INFO(LOG_TAG_SETTINGS, "[SETTINGS] Initializing...\n");
 
     // Try to load from flash
     if (!load_settings_from_flash())
@@ -254,8 +254,8 @@ bool user_settings_update(bool metric)
         user_settings_init();
     }
 
-    log_printf("[SETTINGS] Updating settings:\n");
-    log_printf("  - Metric: %s\n", metric ? "YES (km)" : "NO (miles)");
+    LOG_INFO(LOG_TAG_SETTINGS, "[SETTINGS] Updating settings:\n");
+    LOG_INFO(LOG_TAG_SETTINGS, "  - Metric: %s\n", metric ? "YES (km)" : "NO (miles)");
 
     // Update settings in RAM
     current_settings.metric = metric;
@@ -294,7 +294,7 @@ void user_settings_set_timezone_offset(int32_t offset_seconds)
     // Only save if changed
     if (current_settings.timezone_offset_seconds != offset_seconds)
     {
-        log_printf("[SETTINGS] Updating timezone offset: %ld seconds (%.1f hours)\n",
+        LOG_INFO(LOG_TAG_SETTINGS, "[SETTINGS] Updating timezone offset: %ld seconds (%.1f hours)\n",
                offset_seconds, offset_seconds / 3600.0f);
 
         current_settings.timezone_offset_seconds = offset_seconds;
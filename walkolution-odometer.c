@@ -17,9 +17,22 @@
 #include "oled.h"
 #include "font.h"
 #include "icons.h"
+#include "screens.h"
+#include "fmt.h"
+#include "perf.h"
+#include "diag.h"
 #include "user_settings.h"
 #include "logging.h"
+#include "log_stream.h"
+#include "odo_packet.h"
+#include "link_policy.h"
+#include "bonding.h"
+#include "bulk_channel.h"
+#include "adv_broadcast.h"
+#include "adv_schedule.h"
 #include "speed.h"
+#include "trace.h"
+#include "timebase.h"
 #include <string.h>
 #include <stdio.h>
 
@@ -69,11 +82,17 @@
 #define OLED_SCL_PIN 27
 #define OLED_ADDR 0x3C
 
+#ifndef PERF_REPORT_INTERVAL_MS
+#define PERF_REPORT_INTERVAL_MS 60000 // Log render/IRQ latency stats once a minute
+#endif
+
 #ifndef PERIPHERAL_STATUS_CHECK_INTERVAL_MS
 #define PERIPHERAL_STATUS_CHECK_INTERVAL_MS 1000
 #endif
 
 #define BLE_UPDATE_INTERVAL_MS 1000        // Send data to phone every second
+#define BLE_HIGH_RATE_INTERVAL_MS 250      // v2 high-rate mode (watch UI open); limited by MAIN_LOOP_DELAY_MS
+#define BLE_VOLTAGE_SAMPLE_MS 10000        // v2 notifications reuse a voltage reading this long
 
 // Perform initialisation
 int pico_led_init(void)
@@ -102,49 +121,20 @@ void pico_set_led(bool led_on)
 #endif
 }
 
-// Convert rotations to distance
-// Each rotation = 34.56 cm = 0.3456 meters = 0.0002147 miles = 0.0003456 km
-#define CM_PER_ROTATION 34.56f
-#define METERS_PER_MILE 1609.344f
-#define METERS_PER_KM 1000.0f
-#define MILES_PER_ROTATION (CM_PER_ROTATION / 100.0f / METERS_PER_MILE)
-#define KM_PER_ROTATION (CM_PER_ROTATION / 100.0f / METERS_PER_KM)
-
-float rotations_to_distance(uint32_t rotations, bool metric)
-{
-    if (metric)
-    {
-        return (float)rotations * KM_PER_ROTATION;
-    }
-    else
-    {
-        return (float)rotations * MILES_PER_ROTATION;
-    }
-}
-
-// Legacy function for compatibility
-float rotations_to_miles(uint32_t rotations)
-{
-    return (float)rotations * MILES_PER_ROTATION;
-}
-
-// Get current clock time as string (12-hour format with AM/PM)
-void get_clock_time_str(char *buffer, size_t size)
+// Local time of day for the status bar clock
+// Returns false if time has not been synced yet
+static bool get_clock_seconds(uint32_t *seconds_since_midnight)
 {
     if (!odometer_has_time())
     {
-        buffer[0] = '\0'; // No time available
-        return;
+        return false; // No time available
     }
 
     // Get current Unix timestamp (UTC)
-    uint32_t current_boot_ms = to_ms_since_boot(get_absolute_time());
     uint32_t unix_time = odometer_get_current_unix_time();
-
     if (unix_time == 0)
     {
-        buffer[0] = '\0';
-        return;
+        return false;
     }
 
     // Apply timezone offset to convert from UTC to local time
@@ -157,220 +147,183 @@ void get_clock_time_str(char *buffer, size_t size)
         local_time += 86400;
     }
 
-    // Convert to hours and minutes
-    uint32_t seconds_since_midnight = (uint32_t)(local_time % 86400); // Seconds in a day
-    uint32_t hours = seconds_since_midnight / 3600;
-    uint32_t minutes = (seconds_since_midnight % 3600) / 60;
-
-    // Convert to 12-hour format
-    const char *am_pm = (hours >= 12) ? "PM" : "AM";
-    if (hours == 0)
-        hours = 12;
-    else if (hours > 12)
-        hours -= 12;
-
-    snprintf(buffer, size, "%lu:%02lu %s", hours, minutes, am_pm);
+    *seconds_since_midnight = (uint32_t)(local_time % 86400); // Seconds in a day
+    return true;
 }
 
-// Draw common status bar at bottom of display
-// Shows: Clock (left) | Voltage (center) | Connection icon (right)
-static void draw_status_bar(bool ble_connected, bool ble_advertising)
+// Say why the previous boot ended, with the fault registers if it crashed
+// Map the pc, lr and backtrace addresses with: arm-none-eabi-addr2line -e walkolution-odometer.elf
+static void log_boot_info(void)
 {
-    // Get voltage
-    uint16_t voltage_mv = odometer_read_voltage();
-    float voltage_v = voltage_mv / 1000.0f;
-    char voltage_str[16];
-    snprintf(voltage_str, sizeof(voltage_str), "%.1fV", voltage_v);
+    static const char *const reset_names[] = {"power-on", "RUN pin", "debugger", "watchdog", "software", "hard fault"};
+    const logging_boot_info_t *info = logging_get_boot_info();
 
-    // Get clock time
-    char clock_str[16];
-    get_clock_time_str(clock_str, sizeof(clock_str));
+    LOG_INFO(LOG_TAG_SYSTEM, "[BOOT] boot #%lu, previous reset: %s, %lu bytes of its log retained\n",
+                             info->boot_count, reset_names[info->reset], (unsigned long)info->retained_bytes);
 
-    const int SEPARATOR_Y = 51;
-    const int TEXT_BASELINE_Y = 63;
-    oled_fill_rect(0, SEPARATOR_Y, OLED_WIDTH, 1, true);
-
-    // Clock on left (if available)
-    if (clock_str[0] != '\0')
+    const log_crash_t *crash = info->crash;
+    if (crash == NULL)
     {
-        oled_draw_text(1, TEXT_BASELINE_Y, clock_str, &Font5x7Fixed);
-    }
-
-    // Voltage centered
-    oled_draw_text_centered(OLED_WIDTH / 2, TEXT_BASELINE_Y, voltage_str, &Font5x7Fixed);
-
-    // Connection icon on right
-    if (ble_connected)
-    {
-        oled_draw_bitmap(OLED_WIDTH - icon_bluetooth.width, OLED_HEIGHT - icon_bluetooth.height,
-                         icon_bluetooth.bitmap, icon_bluetooth.width, icon_bluetooth.height);
+        return;
     }
-    else if (ble_advertising)
+    LOG_ERROR(LOG_TAG_SYSTEM, "[CRASH] hard fault at pc=0x%08lx lr=0x%08lx sp=0x%08lx xpsr=0x%08lx\n",
+                              crash->pc, crash->lr, crash->sp, crash->xpsr);
+    LOG_ERROR(LOG_TAG_SYSTEM, "[CRASH] r0=0x%08lx r1=0x%08lx r2=0x%08lx r3=0x%08lx r12=0x%08lx\n",
+                              crash->r[0], crash->r[1], crash->r[2], crash->r[3], crash->r12);
+    LOG_ERROR(LOG_TAG_SYSTEM, "[CRASH] exc_return=0x%08lx icsr=0x%08lx, %lu possible return addresses:\n",
+                              crash->exc_return, crash->icsr, crash->depth);
+    for (uint32_t i = 0; i < crash->depth; i++)
     {
-        // BLE advertising - flash icon every 250ms
-        uint32_t current_time_ms = to_ms_since_boot(get_absolute_time());
-        bool show_icon = ((current_time_ms / 250) % 2) == 0;
-        if (show_icon)
-        {
-            oled_draw_bitmap(OLED_WIDTH - icon_bluetooth.width, OLED_HEIGHT - icon_bluetooth.height,
-                             icon_bluetooth.bitmap, icon_bluetooth.width, icon_bluetooth.height);
-        }
+        LOG_ERROR(LOG_TAG_SYSTEM, "[CRASH]   #%lu 0x%08lx\n", i, crash->backtrace[i]);
     }
 }
 
-void update_oled_session(bool ble_connected_state, bool ble_advertising_state)
+// Snapshot the values shown on the OLED screens. Reads odometer state and the
+// ADC (which borrows the CYW43 SPI clock pin): call under ble_lock()
+static void build_screen_model(screen_model_t *model, bool ble_connected_state, bool ble_advertising_state)
 {
-    uint32_t session = odometer_get_session_count();
-    uint32_t session_time = odometer_get_session_active_time_seconds();
-
-    // Get metric setting
-    bool metric = user_settings_is_metric();
+    model->session_rotations = odometer_get_session_count();
+    model->session_time_seconds = odometer_get_session_active_time_seconds();
+    model->total_rotations = odometer_get_count();
+    model->total_time_seconds = odometer_get_active_time_seconds();
+    model->metric = user_settings_is_metric();
+    model->voltage_mv = odometer_read_voltage();
+    model->clock_valid = get_clock_seconds(&model->clock_seconds);
+    model->ble_connected = ble_connected_state;
+    model->ble_advertising = ble_advertising_state;
+    model->now_ms = timebase_ms();
+}
 
-    // Convert to distance (miles or km)
-    float session_distance = rotations_to_distance(session, metric);
-    const char *unit = metric ? "km" : "mi";
+// Timing of the last update_oled_screen, until record_display_diag takes it
+static bool frame_pending = false;
+static uint32_t frame_render_us = 0;
+static uint32_t frame_transfer_us = 0;
 
-    // Format distance with appropriate precision
-    char distance_str[32];
-    if (session_distance >= 10.0f)
-    {
-        snprintf(distance_str, sizeof(distance_str), "%.1f %s", session_distance, unit);
-    }
-    else
-    {
-        snprintf(distance_str, sizeof(distance_str), "%.2f %s", session_distance, unit);
-    }
+// Refresh a screen from a snapshot - only widgets whose value changed are
+// redrawn and sent to the display. Needs no lock: touches only the OLED
+static void update_oled_screen(screen_id_t screen, const screen_model_t *model)
+{
+    TRACE_BEGIN(TRACE_DISPLAY_UPDATE, screen);
 
-    // Format clock time
-    char clock_str[16];
-    get_clock_time_str(clock_str, sizeof(clock_str));
+    uint32_t render_start = perf_cycles_now();
+    bool changed = screens_render(screen, model);
+    uint32_t render_cycles = perf_cycles_since(render_start);
 
-    // Format session time (HH:MM:SS or MM:SS)
-    char session_time_str[16];
-    if (session_time >= 3600)
+    uint32_t transfer_us = 0;
+    if (changed)
     {
-        uint32_t hours = session_time / 3600;
-        uint32_t minutes = (session_time % 3600) / 60;
-        uint32_t seconds = session_time % 60;
-        snprintf(session_time_str, sizeof(session_time_str), "%lu:%02lu:%02lu", hours, minutes, seconds);
+        uint32_t transfer_start = time_us_32();
+        oled_update();
+        transfer_us = time_us_32() - transfer_start;
     }
-    else
-    {
-        uint32_t minutes = session_time / 60;
-        uint32_t seconds = session_time % 60;
-        snprintf(session_time_str, sizeof(session_time_str), "%lu:%02lu", minutes, seconds);
-    }
-
-    // Clear display
-    oled_clear();
-
-    // Layout: Main content area (0-52), separator (53), status bar (54-63)
-    // Display height: 64px, Font5x7Fixed height: ~8px
-
-    // SESSION CONTENT AREA: Distance (large) and session time (small)
-
-    // Large centered distance (FreeSans18pt, baseline at y=24)
-    oled_draw_text_centered(OLED_WIDTH / 2, 24, distance_str, &FreeSans18pt7b);
-
-    // Centered session time below (FreeSans9pt7b, baseline at y=42)
-    oled_draw_text_centered(OLED_WIDTH / 2, 42, session_time_str, &FreeSans9pt7b);
-
-    // Draw status bar (clock, voltage, connection icon)
-    draw_status_bar(ble_connected_state, ble_advertising_state);
-
-    // Request display update
-    oled_update();
+    perf_record_frame(render_cycles, transfer_us);
+    frame_render_us = render_cycles / (clock_get_hz(clk_sys) / 1000000);
+    frame_transfer_us = transfer_us;
+    frame_pending = true;
+    TRACE_END(TRACE_DISPLAY_UPDATE, screen);
 }
 
-void update_oled_totals(bool ble_connected_state, bool ble_advertising_state)
+// Pass the display's frame timing and I2C errors on to diag (call under
+// ble_lock(): the ATT callbacks snapshot and reset the counters)
+static void record_display_diag(void)
 {
-    uint32_t total = odometer_get_count();
-    uint32_t total_time = odometer_get_active_time_seconds();
-
-    // Get metric setting
-    bool metric = user_settings_is_metric();
-
-    // Convert to distance (miles or km)
-    float total_distance = rotations_to_distance(total, metric);
-    const char *unit = metric ? "km" : "mi";
-
-    // Convert to hours
-    uint32_t total_hours = total_time / 3600;
-
-    // Get voltage
-    uint16_t voltage_mv = odometer_read_voltage();
-    float voltage_v = voltage_mv / 1000.0f;
-
-    // Format strings
-    char distance_str[32];
-    if (total_distance >= 100.0f)
-    {
-        snprintf(distance_str, sizeof(distance_str), "%.0f %s", total_distance, unit);
-    }
-    else if (total_distance >= 10.0f)
-    {
-        snprintf(distance_str, sizeof(distance_str), "%.1f %s", total_distance, unit);
-    }
-    else
-    {
-        snprintf(distance_str, sizeof(distance_str), "%.2f %s", total_distance, unit);
-    }
-
-    // Format totals with "total" label
-    char distance_total_str[32];
-    if (total_distance >= 100.0f)
-    {
-        snprintf(distance_total_str, sizeof(distance_total_str), "%.0f total %s", total_distance, unit);
-    }
-    else if (total_distance >= 10.0f)
-    {
-        snprintf(distance_total_str, sizeof(distance_total_str), "%.1f total %s", total_distance, unit);
-    }
-    else
+    if (frame_pending)
     {
-        snprintf(distance_total_str, sizeof(distance_total_str), "%.2f total %s", total_distance, unit);
+        diag_record_frame(frame_render_us, frame_transfer_us);
+        frame_pending = false;
     }
+    uint32_t i2c_errors, i2c_recoveries;
+    oled_take_i2c_counts(&i2c_errors, &i2c_recoveries);
+    diag_count_i2c(i2c_errors, i2c_recoveries);
+}
 
-    char hours_total_str[32];
-    snprintf(hours_total_str, sizeof(hours_total_str), "%lu total hr", total_hours);
-
-    // Format clock time for status bar
-    char clock_str[16];
-    get_clock_time_str(clock_str, sizeof(clock_str));
-
-    char voltage_str[16];
-    snprintf(voltage_str, sizeof(voltage_str), "%.1fV", voltage_v);
-
-    // Clear display
-    oled_clear();
+// Bluetooth LE state
+static bool ble_advertising = false;
+static adv_schedule_t adv_schedule;    // Advertising interval (adv_schedule.h)
+static bool ble_connected = false;     // At least one central connected
+static uint32_t odometer_voltage_mv = 0;
+static uint32_t odometer_voltage_ms = 0;
 
-    // Layout: Main content area (0-52), separator (53), status bar (54-63)
-    // Display height: 64px, FreeSans12pt y_advance: 29px
+// Centrals connected at once, e.g. the phone and the watch (btstack_config.h)
+#define BLE_MAX_CONNECTIONS MAX_NR_HCI_CONNECTIONS
 
-    // TOTALS CONTENT AREA: Distance and hours (both medium, centered)
+// Sessions list snapshot size, per connection
+#define SESSIONS_SNAPSHOT_MAX 64
 
-    // Total distance centered (FreeSans12pt, baseline at y=18)
-    oled_draw_text_centered(OLED_WIDTH / 2, 18, distance_total_str, &FreeSans12pt7b);
+// Log notifications per turn to send while another central is
+// connected, so a log backlog does not hold up its notifications
+#define LOG_NOTIFY_BURST 4
 
-    // Total hours centered below (FreeSans12pt, baseline at y=42)
-    oled_draw_text_centered(OLED_WIDTH / 2, 42, hours_total_str, &FreeSans12pt7b);
+// One connected central: what it subscribed to and what is waiting to be sent to it
+typedef struct
+{
+    bool connected;                        // Slot in use
+    hci_con_handle_t handle;
+    uint16_t mtu;                          // ATT MTU this client negotiated
+    btstack_context_callback_registration_t can_send_now;
+    bool can_send_requested;               // can_send_now registered, not called yet
+    uint32_t can_send_requested_us;        // When it was registered
+    uint32_t connected_ms;
+    bool first_notification_sent;          // Connection to first notification measured
+
+    // Odometer notifications, in the format this client chose (odo_packet.h for v2)
+    bool odometer_notify;                  // CCCD
+    bool odometer_notify_pending;
+    uint8_t odometer_format;
+    bool odometer_high_rate;
+    odo_encoder_t odometer_encoder;
+    uint32_t last_odometer_ms;
+
+    // Sessions list as served to this client. A long read takes one callback
+    // per MTU-sized chunk; every chunk comes from the same copy, and the flash
+    // is only scanned again once the list has changed (generation)
+    session_record_t sessions_snapshot[SESSIONS_SNAPSHOT_MAX];
+    uint32_t sessions_snapshot_count;
+    uint32_t sessions_snapshot_generation;
+    bool sessions_snapshot_valid;
+
+    // Sessions list notifications: one session_record_t per session saved to flash
+    bool sessions_notify;                  // CCCD
+    bool session_notify_pending;
+    session_record_t session_notify_record;
+
+    // Last batch this client wrote to the mark reported characteristic, with the result per ID
+    uint8_t mark_results[ODOMETER_MARK_BATCH_MAX * 5];
+    uint16_t mark_results_len;
+} ble_connection_t;
+
+static ble_connection_t connections[BLE_MAX_CONNECTIONS];
+static uint8_t ble_connection_count = 0;
+
+// BLE event handling. With BLE_BACKGROUND (CMakeLists.txt) the cyw43 driver
+// and BTstack run from the async context's low-priority IRQ as soon as the
+// radio has an event; otherwise they run when the main loop polls, once per
+// MAIN_LOOP_DELAY_MS. The main loop holds the async context lock while it
+// uses BTstack or state the ATT callbacks share (odometer, sessions,
+// connections), so in the background case events wait only for that.
+// Both are measured the same way: the time from asking BTstack to send on a
+// connection to its can_send_now callback. The longest is logged with the
+// [PERF] report
+#ifndef BLE_BACKGROUND
+#define BLE_BACKGROUND 0
+#endif
+static uint32_t ble_send_wait_max_us = 0;
 
-    // Draw status bar (clock, voltage, connection icon)
-    draw_status_bar(ble_connected_state, ble_advertising_state);
+// Running speed (mph) that counts as walking for the advertising schedule
+#define ADV_WALKING_MPH 1.5f
 
-    // Request display update
-    oled_update();
-}
+// Log backlog that makes the link switch to bulk parameters (link_policy.h)
+#define LOG_BACKLOG_BULK_BYTES 1024
 
-// Bluetooth LE state
-static bool ble_advertising = false;
-static bool ble_connected = false;
-static bool ble_notification_enabled = false;
-static hci_con_handle_t connection_handle;
+// Log notifications on the logs characteristic (see log_stream.h). There is
+// one log, so one connection streams it: the first to subscribe
+static log_stream_t log_stream;
+static ble_connection_t *log_stream_connection = NULL;
+static log_throughput_t log_read_throughput; // Polling model, for comparison
 // Note: odometer_characteristic_handle is defined in the generated header as:
 // ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF1_01_VALUE_HANDLE
 
-// Connection status is now integrated into update_oled_session() and update_oled_totals()
+// Connection status is shown by the status bar (screens.c)
 
 // Define custom UUIDs for our service
 // Service UUID: 12345678-1234-5678-1234-56789abcdef0
@@ -392,6 +345,141 @@ typedef struct __attribute__((packed))
     uint8_t metric;                // 1 byte (0=miles, 1=km)
 } odometer_data_t;
 
+// Format 1 value: used for reads, and for notifications unless the client asks for v2
+static void build_odometer_data(odometer_data_t *data)
+{
+    data->session_rotations = odometer_get_session_count();
+    data->total_rotations = odometer_get_count();
+    data->session_time_seconds = odometer_get_session_active_time_seconds();
+    data->total_time_seconds = odometer_get_active_time_seconds();
+    data->running_avg_speed = speed_get_running_avg(user_settings_is_metric());
+    data->session_avg_speed = speed_get_session_avg(odometer_get_session_count(), odometer_get_session_active_time_seconds(), user_settings_is_metric());
+    data->voltage_mv = odometer_read_voltage();
+    data->session_id = odometer_get_current_session_id();
+
+    // Add current settings to data packet
+    const user_settings_t *settings = user_settings_get();
+    data->metric = settings->metric ? 1 : 0;
+}
+
+static uint32_t speed_to_centi(float speed)
+{
+    return (speed > 0.0f) ? (uint32_t)(speed * 100.0f + 0.5f) : 0;
+}
+
+// Format 2 values. Voltage moves slowly, so the ADC is read every BLE_VOLTAGE_SAMPLE_MS at most
+static void build_odo_values(odo_values_t *values, uint32_t now_ms)
+{
+    bool metric = user_settings_is_metric();
+
+    if (odometer_voltage_ms == 0 || (now_ms - odometer_voltage_ms) >= BLE_VOLTAGE_SAMPLE_MS)
+    {
+        odometer_voltage_mv = odometer_read_voltage();
+        odometer_voltage_ms = now_ms ? now_ms : 1;
+    }
+
+    values->field[ODO_FIELD_SESSION_ROTATIONS] = odometer_get_session_count();
+    values->field[ODO_FIELD_TOTAL_ROTATIONS] = odometer_get_count();
+    values->field[ODO_FIELD_SESSION_TIME] = odometer_get_session_active_time_seconds();
+    values->field[ODO_FIELD_TOTAL_TIME] = odometer_get_active_time_seconds();
+    values->field[ODO_FIELD_RUNNING_SPEED] = speed_to_centi(speed_get_running_avg(metric));
+    values->field[ODO_FIELD_SESSION_SPEED] = speed_to_centi(speed_get_session_avg(odometer_get_session_count(), odometer_get_session_active_time_seconds(), metric));
+    values->field[ODO_FIELD_VOLTAGE] = odometer_voltage_mv;
+    values->field[ODO_FIELD_SESSION_ID] = odometer_get_current_session_id();
+    values->field[ODO_FIELD_METRIC] = metric ? 1 : 0;
+}
+
+// Notification interval for the format the client chose
+static uint32_t odometer_update_interval_ms(const ble_connection_t *conn)
+{
+    return (conn->odometer_format == ODO_PACKET_VERSION && conn->odometer_high_rate) ? BLE_HIGH_RATE_INTERVAL_MS : BLE_UPDATE_INTERVAL_MS;
+}
+
+static ble_connection_t *find_connection(hci_con_handle_t handle)
+{
+    for (int i = 0; i < BLE_MAX_CONNECTIONS; i++)
+    {
+        if (connections[i].connected && connections[i].handle == handle)
+        {
+            return &connections[i];
+        }
+    }
+    return NULL;
+}
+
+// Slot for a new connection, in the default state (format 1, nothing subscribed)
+static ble_connection_t *add_connection(hci_con_handle_t handle)
+{
+    for (int i = 0; i < BLE_MAX_CONNECTIONS; i++)
+    {
+        ble_connection_t *conn = &connections[i];
+        if (!conn->connected)
+        {
+            memset(conn, 0, sizeof(*conn));
+            conn->connected = true;
+            conn->handle = handle;
+            conn->connected_ms = timebase_ms();
+            conn->mtu = ATT_DEFAULT_MTU;
+            conn->odometer_format = 1;
+            odo_encoder_reset(&conn->odometer_encoder);
+            ble_connection_count++;
+            return conn;
+        }
+    }
+    return NULL;
+}
+
+// The log has a single read position: while one connection streams it, or
+// fetches it over the bulk channel, no other may read it or move it
+static bool log_reader_taken(const ble_connection_t *conn)
+{
+    return (log_stream_connection != NULL && log_stream_connection != conn) ||
+           (conn != NULL && bulk_channel_reading_logs(conn->handle));
+}
+
+static void set_log_stream_connection(ble_connection_t *conn)
+{
+    log_stream_connection = conn;
+    bulk_channel_set_log_owner(conn != NULL ? conn->handle : HCI_CON_HANDLE_INVALID);
+}
+
+static void remove_connection(ble_connection_t *conn)
+{
+    if (log_stream_connection == conn)
+    {
+        log_stream_enable(&log_stream, false);
+        set_log_stream_connection(NULL);
+    }
+    conn->connected = false;
+    conn->can_send_requested = false;
+    ble_connection_count--;
+}
+
+static void ble_lock(void)
+{
+    async_context_acquire_lock_blocking(cyw43_arch_async_context());
+}
+
+static void ble_unlock(void)
+{
+    async_context_release_lock(cyw43_arch_async_context());
+}
+
+// Poll mode: run the cyw43 driver and BTstack, which MUST happen regularly
+// for BLE to work. Events that arrived since the last poll waited for this
+static void ble_poll(void)
+{
+#if !BLE_BACKGROUND
+    cyw43_arch_poll();
+#endif
+}
+
+// BTstack stops advertising once every connection slot is taken
+static bool ble_accepting_connections(void)
+{
+    return ble_connection_count < BLE_MAX_CONNECTIONS;
+}
+
 // Bluetooth LE advertisement data - minimal, just flags (3 bytes)
 // Note: BTstack on Pico W has issues transmitting advertisement data properly,
 // but scan response data works correctly. So we put all discoverable data
@@ -404,6 +492,30 @@ static const uint8_t adv_data[] = {
 };
 static const uint8_t adv_data_len = sizeof(adv_data);
 
+#if ADV_BROADCAST
+// Advertising data with the live broadcast after the flags (adv_broadcast.h).
+// BTstack sends from this buffer, so it stays allocated
+static uint8_t adv_broadcast_data[sizeof(adv_data) + ADV_BROADCAST_AD_SIZE];
+static uint8_t adv_broadcast_sequence = 0;
+
+static void update_adv_broadcast(void)
+{
+    bool metric = user_settings_is_metric();
+    uint32_t speed_centi = speed_to_centi(speed_get_running_avg(metric));
+    adv_broadcast_t data;
+
+    data.sequence = adv_broadcast_sequence++;
+    data.session_rotations = odometer_get_session_count();
+    data.session_time_seconds = odometer_get_session_active_time_seconds();
+    data.running_speed_centi = (speed_centi > 0xFFFF) ? 0xFFFF : (uint16_t)speed_centi;
+    data.metric = metric;
+
+    memcpy(adv_broadcast_data, adv_data, sizeof(adv_data));
+    size_t len = sizeof(adv_data) + adv_broadcast_encode(&data, &adv_broadcast_data[sizeof(adv_data)]);
+    gap_advertisements_set_data((uint8_t)len, adv_broadcast_data);
+}
+#endif
+
 // Scan response data with shortened name AND UUID (27 bytes total)
 // This is sent when Android actively scans (which it always does)
 static const uint8_t scan_rsp_data[] = {
@@ -440,6 +552,235 @@ static const uint8_t scan_rsp_data[] = {
 };
 static const uint8_t scan_rsp_data_len = sizeof(scan_rsp_data);
 
+static void connection_can_send_now(void *context);
+
+// Have connection_can_send_now() called once this connection can take a
+// notification. Each connection has its own registration: BTstack serves the
+// waiting connections in turn
+static void request_can_send_now(ble_connection_t *conn)
+{
+    if (conn->can_send_requested)
+    {
+        return;
+    }
+    conn->can_send_now.callback = &connection_can_send_now;
+    conn->can_send_now.context = conn;
+    conn->can_send_requested = att_server_register_can_send_now_callback(&conn->can_send_now, conn->handle) == ERROR_CODE_SUCCESS;
+    conn->can_send_requested_us = time_us_32();
+}
+
+// Time from the connection to the first values the client gets, the
+// latency a user sees; a bonded client skips discovery and should be quicker
+static void record_first_notification(ble_connection_t *conn, uint32_t now_ms)
+{
+    if (conn->first_notification_sent)
+    {
+        return;
+    }
+    conn->first_notification_sent = true;
+
+    bool bonded = bonding_is_reconnect(conn->handle);
+    uint32_t latency_ms = now_ms - conn->connected_ms;
+    diag_record_first_notification(bonded, latency_ms * 1000);
+    LOG_INFO(LOG_TAG_BLE, "[BLE] First notification to 0x%04x %lu ms after connecting (%s)\n",
+                          conn->handle, latency_ms, bonded ? "bonded" : "new or unbonded");
+}
+
+// Notify the odometer values in the format this client chose
+static void send_odometer_notification(ble_connection_t *conn)
+{
+    if (!att_server_can_send_packet_now(conn->handle))
+    {
+        request_can_send_now(conn);
+        return;
+    }
+
+    conn->odometer_notify_pending = false;
+    uint32_t now_ms = timebase_ms();
+    if (conn->odometer_format == ODO_PACKET_VERSION)
+    {
+        // Only what changed; nothing at all if nothing did (keepalive aside)
+        uint8_t packet[ODO_PACKET_MAX_SIZE];
+        odo_values_t values;
+        build_odo_values(&values, now_ms);
+        size_t len = odo_packet_encode(&conn->odometer_encoder, &values, now_ms, packet);
+        if (len > 0)
+        {
+            int result = att_server_notify(conn->handle, ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF1_01_VALUE_HANDLE, packet, (uint16_t)len);
+            diag_count_notify(result == ERROR_CODE_SUCCESS);
+            if (result != ERROR_CODE_SUCCESS)
+            {
+                odo_encoder_reset(&conn->odometer_encoder); // Client missed it: resync with a keyframe
+            }
+            else
+            {
+                record_first_notification(conn, now_ms);
+            }
+        }
+    }
+    else
+    {
+        odometer_data_t data;
+        build_odometer_data(&data);
+
+        int result = att_server_notify(conn->handle, ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF1_01_VALUE_HANDLE, (uint8_t *)&data, sizeof(data));
+        diag_count_notify(result == ERROR_CODE_SUCCESS);
+        if (result == ERROR_CODE_SUCCESS)
+        {
+            record_first_notification(conn, now_ms);
+        }
+    }
+}
+
+// Push log notifications until BTstack runs out of buffers, the client out of
+// credits or the log is empty. With another central connected, stop after
+// LOG_NOTIFY_BURST and wait for the next turn.
+// Must not log: every message would make more to send.
+static void send_log_notifications(ble_connection_t *conn)
+{
+    static uint8_t packet[LOG_STREAM_MAX_PACKET];
+    uint32_t sent_count = 0;
+
+    while (log_stream_ready(&log_stream, logging_get_available_bytes()))
+    {
+        if (!att_server_can_send_packet_now(conn->handle) ||
+            (ble_connection_count > 1 && sent_count == LOG_NOTIFY_BURST))
+        {
+            request_can_send_now(conn);
+            return;
+        }
+
+        logging_spans_t spans;
+        logging_peek_logs(&spans);
+        size_t max_len = conn->mtu - 3;
+        if (max_len > sizeof(packet))
+        {
+            max_len = sizeof(packet);
+        }
+        size_t len = log_stream_build(&log_stream, &spans, logging_get_read_cursor(), packet, max_len);
+        if (len == 0)
+        {
+            return;
+        }
+        bool sent = att_server_notify(conn->handle, ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF8_01_VALUE_HANDLE, packet, len) == ERROR_CODE_SUCCESS;
+        diag_count_notify(sent);
+        if (!sent)
+        {
+            return;
+        }
+
+        logging_consume_logs(len - LOG_STREAM_HEADER_SIZE);
+        log_stream_sent(&log_stream, len);
+        log_throughput_record(&log_stream.throughput, len - LOG_STREAM_HEADER_SIZE, logging_get_available_bytes() == 0, time_us_32());
+        sent_count++;
+    }
+}
+
+// Notify the session saved to flash, once there is room
+static void send_session_notification(ble_connection_t *conn)
+{
+    if (!att_server_can_send_packet_now(conn->handle))
+    {
+        request_can_send_now(conn);
+        return;
+    }
+
+    conn->session_notify_pending = false;
+    int result = att_server_notify(conn->handle, ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF2_01_VALUE_HANDLE,
+                                   (uint8_t *)&conn->session_notify_record, sizeof(conn->session_notify_record));
+    diag_count_notify(result == ERROR_CODE_SUCCESS);
+    LOG_DEBUG(LOG_TAG_BLE, "[BLE] Session %lu notified to 0x%04x: result=%d\n", conn->session_notify_record.session_id, conn->handle, result);
+}
+
+// BTstack can send on this connection: whatever is waiting for it, odometer first
+static void connection_can_send_now(void *context)
+{
+    ble_connection_t *conn = (ble_connection_t *)context;
+
+    uint32_t waited_us = time_us_32() - conn->can_send_requested_us;
+    if (waited_us > ble_send_wait_max_us)
+    {
+        ble_send_wait_max_us = waited_us;
+    }
+    conn->can_send_requested = false;
+    if (!conn->connected)
+    {
+        return;
+    }
+    if (conn->odometer_notify && conn->odometer_notify_pending)
+    {
+        send_odometer_notification(conn);
+    }
+    if (conn->sessions_notify && conn->session_notify_pending)
+    {
+        send_session_notification(conn);
+    }
+    if (conn == log_stream_connection)
+    {
+        uint16_t credits = log_stream.credits;
+        TRACE_BEGIN(TRACE_LOG_NOTIFY, 0);
+        send_log_notifications(conn);
+        TRACE_END(TRACE_LOG_NOTIFY, credits - log_stream.credits);
+    }
+}
+
+// Odometer values to each subscribed client at the rate it asked for (main loop)
+static void request_odometer_notifications(uint32_t now_ms)
+{
+    for (int i = 0; i < BLE_MAX_CONNECTIONS; i++)
+    {
+        ble_connection_t *conn = &connections[i];
+        if (conn->connected && conn->odometer_notify && (now_ms - conn->last_odometer_ms) >= odometer_update_interval_ms(conn))
+        {
+            TRACE_BEGIN(TRACE_BLE_UPDATE, 0);
+            conn->odometer_notify_pending = true;
+            conn->last_odometer_ms = now_ms;
+            request_can_send_now(conn);
+            TRACE_END(TRACE_BLE_UPDATE, 0);
+        }
+    }
+}
+
+// Pass a session just saved to flash on to every subscribed client (main loop).
+// Without a subscriber it is dropped: a client reads the list when it subscribes
+static void request_session_notification(void)
+{
+    session_record_t record;
+    if (!odometer_take_saved_session(&record))
+    {
+        return;
+    }
+
+    for (int i = 0; i < BLE_MAX_CONNECTIONS; i++)
+    {
+        ble_connection_t *conn = &connections[i];
+        if (conn->connected && conn->sessions_notify)
+        {
+            conn->session_notify_record = record; // A newer save of the same session replaces it
+            conn->session_notify_pending = true;
+            request_can_send_now(conn);
+        }
+    }
+}
+
+// Ask to send when there are logs to push (main loop)
+static void request_log_notifications(void)
+{
+    ble_connection_t *conn = log_stream_connection;
+    if (conn == NULL)
+    {
+        return;
+    }
+    if (logging_get_available_bytes() >= LOG_BACKLOG_BULK_BYTES)
+    {
+        link_policy_bulk(conn->handle, timebase_ms());
+    }
+    if (log_stream_ready(&log_stream, logging_get_available_bytes()))
+    {
+        request_can_send_now(conn);
+    }
+}
+
 // Packet handler for HCI and GAP events
 static void packet_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size)
 {
@@ -449,111 +790,185 @@ static void packet_handler(uint8_t packet_type, uint16_t channel, uint8_t *packe
     if (packet_type != HCI_EVENT_PACKET)
         return;
 
+    link_policy_packet_handler(packet);
+
+    ble_connection_t *conn;
     switch (hci_event_packet_get_type(packet))
     {
     case BTSTACK_EVENT_STATE:
         if (btstack_event_state_get_state(packet) == HCI_STATE_WORKING)
         {
-            log_printf("BTstack initialized\n");
+            LOG_INFO(LOG_TAG_BLE, "BTstack initialized\n");
         }
         break;
 
     case HCI_EVENT_DISCONNECTION_COMPLETE:
-        ble_connected = false;
-        ble_notification_enabled = false;
-        log_printf("[BLE] Disconnected (reason=0x%02x)\n", hci_event_disconnection_complete_get_reason(packet));
-        log_printf("  - Time acquired before disconnect: %s\n", odometer_has_time() ? "YES" : "NO");
+        conn = find_connection(hci_event_disconnection_complete_get_connection_handle(packet));
+        if (conn == NULL)
+        {
+            break;
+        }
+        if (ble_advertising)
+        {
+            // Back to fast advertising on every disconnect: the phone that left
+            // may be looking to reconnect
+            if (ble_accepting_connections())
+            {
+                adv_schedule_kick(&adv_schedule, timebase_ms()); // Still advertising for a free slot
+            }
+            else
+            {
+                adv_schedule_start(&adv_schedule, timebase_ms()); // BTstack resumes advertising
+            }
+        }
+        remove_connection(conn);
+        ble_connected = ble_connection_count > 0;
+        LOG_INFO(LOG_TAG_BLE, "[BLE] Disconnected 0x%04x (reason=0x%02x), %u connected\n",
+                              conn->handle, hci_event_disconnection_complete_get_reason(packet), ble_connection_count);
+        LOG_INFO(LOG_TAG_BLE, "  - Time acquired before disconnect: %s\n", odometer_has_time() ? "YES" : "NO");
         break;
 
     case HCI_EVENT_LE_META:
         switch (hci_event_le_meta_get_subevent_code(packet))
         {
         case HCI_SUBEVENT_LE_CONNECTION_COMPLETE:
-            connection_handle = hci_subevent_le_connection_complete_get_connection_handle(packet);
+            conn = add_connection(hci_subevent_le_connection_complete_get_connection_handle(packet));
+            if (conn == NULL)
+            {
+                LOG_ERROR(LOG_TAG_BLE, "[BLE] ERROR: No room for connection 0x%04x\n",
+                                       hci_subevent_le_connection_complete_get_connection_handle(packet));
+                break;
+            }
             ble_connected = true;
-            log_printf("[BLE] *** CONNECTED! ***\n");
-            log_printf("  - Handle: 0x%04x\n", connection_handle);
-            log_printf("  - Time already acquired: %s\n", odometer_has_time() ? "YES" : "NO");
-            log_printf("  - Waiting for Android app to send time sync...\n");
+            if (!ble_accepting_connections())
+            {
+                adv_schedule_stop(&adv_schedule, timebase_ms());
+            }
+            LOG_INFO(LOG_TAG_BLE, "[BLE] *** CONNECTED! ***\n");
+            LOG_INFO(LOG_TAG_BLE, "  - Handle: 0x%04x (%u of %u connections)\n", conn->handle, ble_connection_count, BLE_MAX_CONNECTIONS);
+            LOG_INFO(LOG_TAG_BLE, "  - Time already acquired: %s\n", odometer_has_time() ? "YES" : "NO");
+            LOG_INFO(LOG_TAG_BLE, "  - Waiting for Android app to send time sync...\n");
             break;
         default:
-            log_printf("[BLE] LE Meta event: subevent=0x%02x\n", hci_event_le_meta_get_subevent_code(packet));
+            LOG_DEBUG(LOG_TAG_BLE, "[BLE] LE Meta event: subevent=0x%02x\n", hci_event_le_meta_get_subevent_code(packet));
             break;
         }
         break;
 
-    case ATT_EVENT_CAN_SEND_NOW:
-        // Send notification when BTstack is ready
-        // log_printf("ATT_EVENT_CAN_SEND_NOW: connected=%d, notify_enabled=%d\n", ble_connected, ble_notification_enabled);
-        if (ble_connected && ble_notification_enabled)
-        {
-            odometer_data_t data;
-            data.session_rotations = odometer_get_session_count();
-            data.total_rotations = odometer_get_count();
-            data.session_time_seconds = odometer_get_session_active_time_seconds();
-            data.total_time_seconds = odometer_get_active_time_seconds();
-            data.running_avg_speed = speed_get_running_avg(user_settings_is_metric());
-            data.session_avg_speed = speed_get_session_avg(odometer_get_session_count(), odometer_get_session_active_time_seconds(), user_settings_is_metric());
-            data.voltage_mv = odometer_read_voltage();
-            data.session_id = odometer_get_current_session_id();
-
-            // Add current settings to data packet
-            const user_settings_t *settings = user_settings_get();
-            data.metric = settings->metric ? 1 : 0;
-
-            int result = att_server_notify(connection_handle, ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF1_01_VALUE_HANDLE, (uint8_t *)&data, sizeof(data));
-            // log_printf("Sent notification: result=%d, sess_rot=%lu, total_rot=%lu, speed=%.2f, voltage=%lu mV, session_id=%lu\n",
-            //            result, data.session_rotations, data.total_rotations, data.running_avg_speed, data.voltage_mv, data.session_id);
+    case ATT_EVENT_MTU_EXCHANGE_COMPLETE:
+        conn = find_connection(att_event_mtu_exchange_complete_get_handle(packet));
+        if (conn != NULL)
+        {
+            conn->mtu = att_event_mtu_exchange_complete_get_MTU(packet);
         }
         break;
     }
 }
 
+// Advertise every interval (0.625 ms units); BTstack applies it while advertising too
+static void apply_adv_interval(uint16_t interval)
+{
+    bd_addr_t null_addr;
+    memset(null_addr, 0, 6);
+
+    uint8_t adv_type = 0; // ADV_IND
+    gap_advertisements_set_params(interval, interval, adv_type, 0, null_addr, 0x07, 0x00);
+    LOG_INFO(LOG_TAG_BLE, "[ADV] Advertising interval %lu ms\n", (uint32_t)interval * 5 / 8);
+}
+
+// Back off the advertising interval while nobody connects, and speed it up
+// again on events that make a connection likely (every second)
+static void update_adv_schedule(uint32_t now_ms)
+{
+    // Passed on while connected too (no kick then), so a session that ended
+    // while connected does not kick once advertising resumes
+    adv_schedule_sessions(&adv_schedule, odometer_get_sessions_closed(), now_ms);
+
+    if (ble_advertising && ble_accepting_connections())
+    {
+        adv_schedule_walking(&adv_schedule, speed_get_running_avg(false) >= ADV_WALKING_MPH, now_ms);
+        if (adv_schedule_update(&adv_schedule, now_ms))
+        {
+            apply_adv_interval(adv_schedule_interval(&adv_schedule));
+        }
+    }
+}
+
 void start_ble_advertising(void)
 {
     if (ble_advertising)
         return;
 
-    bd_addr_t null_addr;
-    memset(null_addr, 0, 6);
-
-    // Setup advertisement
-    uint16_t adv_int_min = 0x0030; // 30ms
-    uint16_t adv_int_max = 0x0030; // 30ms
-    uint8_t adv_type = 0;          // ADV_IND
-    gap_advertisements_set_params(adv_int_min, adv_int_max, adv_type, 0, null_addr, 0x07, 0x00);
+    // Setup advertisement: fastest interval first
+    uint32_t now_ms = timebase_ms();
+    adv_schedule_start(&adv_schedule, now_ms);
+    adv_schedule_update(&adv_schedule, now_ms);
+    apply_adv_interval(adv_schedule_interval(&adv_schedule));
+#if ADV_BROADCAST
+    update_adv_broadcast();
+#else
     gap_advertisements_set_data(adv_data_len, (uint8_t *)adv_data);
+#endif
     gap_scan_response_set_data(scan_rsp_data_len, (uint8_t *)scan_rsp_data);
     gap_advertisements_enable(1);
 
     ble_advertising = true;
-    log_printf("BLE advertising started\n");
+    LOG_INFO(LOG_TAG_BLE, "BLE advertising started\n");
 }
 
 // GATT database is now generated from walkolution-odometer.gatt
 // The profile_data array and characteristic handles are defined in the generated header
 
+// Characteristic of a value or CCCD handle, for the ATT counters
+// Returns DIAG_ATT_COUNT (not counted) for anything else
+static diag_att_t diag_att_for_handle(uint16_t att_handle)
+{
+    switch (att_handle)
+    {
+    case ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF1_01_VALUE_HANDLE:
+    case ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF1_01_CLIENT_CONFIGURATION_HANDLE:
+        return DIAG_ATT_ODOMETER;
+    case ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF2_01_VALUE_HANDLE:
+    case ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF2_01_CLIENT_CONFIGURATION_HANDLE:
+        return DIAG_ATT_SESSIONS;
+    case ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF3_01_VALUE_HANDLE:
+        return DIAG_ATT_MARK_REPORTED;
+    case ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF4_01_VALUE_HANDLE:
+        return DIAG_ATT_TIME_SYNC;
+    case ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF5_01_VALUE_HANDLE:
+        return DIAG_ATT_SETTINGS;
+    case ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF7_01_VALUE_HANDLE:
+        return DIAG_ATT_LIFETIME;
+    case ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF8_01_VALUE_HANDLE:
+    case ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF8_01_CLIENT_CONFIGURATION_HANDLE:
+        return DIAG_ATT_LOGS;
+    case ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF9_01_VALUE_HANDLE:
+        return DIAG_ATT_LOG_LEVELS;
+    case ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEFA_01_VALUE_HANDLE:
+        return DIAG_ATT_TRACE;
+    case ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEFB_01_VALUE_HANDLE:
+        return DIAG_ATT_DIAGNOSTICS;
+    default:
+        return DIAG_ATT_COUNT;
+    }
+}
+
 // ATT Read callback
 static uint16_t att_read_callback(hci_con_handle_t con_handle, uint16_t att_handle, uint16_t offset, uint8_t *buffer, uint16_t buffer_size)
 {
-    UNUSED(con_handle);
+    ble_connection_t *conn = find_connection(con_handle);
+
+    // A long value is read in several requests; count the first
+    if (offset == 0 && buffer != NULL)
+    {
+        diag_count_att(diag_att_for_handle(att_handle), false);
+    }
 
     // Main odometer data characteristic
     if (att_handle == ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF1_01_VALUE_HANDLE)
     {
         odometer_data_t data;
-        data.session_rotations = odometer_get_session_count();
-        data.total_rotations = odometer_get_count();
-        data.session_time_seconds = odometer_get_session_active_time_seconds();
-        data.total_time_seconds = odometer_get_active_time_seconds();
-        data.running_avg_speed = speed_get_running_avg(user_settings_is_metric());
-        data.session_avg_speed = speed_get_session_avg(odometer_get_session_count(), odometer_get_session_active_time_seconds(), user_settings_is_metric());
-        data.voltage_mv = odometer_read_voltage();
-        data.session_id = odometer_get_current_session_id();
-
-        // Add current settings to data packet
-        const user_settings_t *settings = user_settings_get();
-        data.metric = settings->metric ? 1 : 0;
+        build_odometer_data(&data);
 
         return att_read_callback_handle_blob((uint8_t *)&data, sizeof(data), offset, buffer, buffer_size);
     }
@@ -561,14 +976,38 @@ static uint16_t att_read_callback(hci_con_handle_t con_handle, uint16_t att_hand
     // Sessions list characteristic
     if (att_handle == ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF2_01_VALUE_HANDLE)
     {
-        // Read unreported sessions from flash
-        static session_record_t sessions[64]; // Max 64 sessions
-        uint32_t session_count = odometer_get_unreported_sessions(sessions, 64);
-        uint32_t data_size = session_count * sizeof(session_record_t);
+        // A read starts at offset 0: scan flash again only if the list changed since the last one.
+        // Later chunks always come from the snapshot, even if the list changed meanwhile
+        // Each connection has its own snapshot, so two clients reading at once do not mix
+        if (conn == NULL)
+        {
+            return 0;
+        }
+        uint32_t generation = odometer_get_sessions_generation();
+        if (!conn->sessions_snapshot_valid || (offset == 0 && generation != conn->sessions_snapshot_generation))
+        {
+            conn->sessions_snapshot_count = odometer_get_unreported_sessions(conn->sessions_snapshot, SESSIONS_SNAPSHOT_MAX);
+            conn->sessions_snapshot_generation = generation;
+            conn->sessions_snapshot_valid = true;
+            LOG_DEBUG(LOG_TAG_BLE, "Reading sessions list: %lu unreported sessions (generation %lu)\n", conn->sessions_snapshot_count, generation);
+        }
+        uint32_t data_size = conn->sessions_snapshot_count * sizeof(session_record_t);
+        if (offset == 0 && data_size > buffer_size)
+        {
+            link_policy_bulk(con_handle, timebase_ms()); // A long read follows
+        }
 
-        log_printf("Reading sessions list: %lu unreported sessions, %lu bytes\n", session_count, data_size);
+        return att_read_callback_handle_blob((uint8_t *)conn->sessions_snapshot, data_size, offset, buffer, buffer_size);
+    }
 
-        return att_read_callback_handle_blob((uint8_t *)sessions, data_size, offset, buffer, buffer_size);
+    // Mark reported characteristic: results of the last batch this client wrote
+    if (att_handle == ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF3_01_VALUE_HANDLE)
+    {
+        if (conn == NULL)
+        {
+            return 0;
+        }
+        return att_read_callback_handle_blob(conn->mark_results, conn->mark_results_len, offset, buffer, buffer_size);
     }
 
     // User settings characteristic
@@ -581,7 +1020,7 @@ static uint16_t att_read_callback(hci_con_handle_t con_handle, uint16_t att_hand
         const user_settings_t *settings = user_settings_get();
         settings_buffer[0] = settings->metric ? 1 : 0;
 
-        log_printf("Reading user settings: metric=%d\n", settings_buffer[0]);
+        LOG_DEBUG(LOG_TAG_BLE, "Reading user settings: metric=%d\n", settings_buffer[0]);
 
         return att_read_callback_handle_blob(settings_buffer, sizeof(settings_buffer), offset, buffer, buffer_size);
     }
@@ -590,17 +1029,46 @@ static uint16_t att_read_callback(hci_con_handle_t con_handle, uint16_t att_hand
     if (att_handle == ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF8_01_VALUE_HANDLE)
     {
         // Read new logs from circular buffer (limited by buffer_size which respects MTU)
-        // BLE MTU is typically 185 bytes, minus 3 bytes overhead = 182 bytes max payload
+        // The MTU is up to LINK_POLICY_ATT_MTU, minus 3 bytes overhead
         // buffer_size is provided by BTstack and already accounts for MTU
-        static uint8_t log_buffer[182]; // Max one MTU worth of logs per read
+        static uint8_t log_buffer[LINK_POLICY_ATT_MTU - 3]; // Max one MTU worth of logs per read
+        if (log_reader_taken(conn))
+        {
+            return 0; // Read by another connection
+        }
         size_t max_read = (buffer_size < sizeof(log_buffer)) ? buffer_size : sizeof(log_buffer);
         size_t bytes_read = logging_get_new_logs((char *)log_buffer, max_read);
+        if (bytes_read == max_read && logging_get_available_bytes() >= LOG_BACKLOG_BULK_BYTES)
+        {
+            link_policy_bulk(con_handle, timebase_ms());
+        }
+        log_throughput_record(&log_read_throughput, bytes_read, bytes_read < max_read, time_us_32());
 
         // Note: It's okay to return 0 bytes if no new logs available
         // Don't log here - it would create a feedback loop!
         return att_read_callback_handle_blob(log_buffer, bytes_read, offset, buffer, buffer_size);
     }
 
+    // Log levels characteristic
+    if (att_handle == ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF9_01_VALUE_HANDLE)
+    {
+        static uint8_t levels[LOG_TAG_COUNT];
+        size_t len = logging_get_tag_levels(levels, sizeof(levels));
+        return att_read_callback_handle_blob(levels, len, offset, buffer, buffer_size);
+    }
+
+    // Diagnostics characteristic
+    if (att_handle == ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEFB_01_VALUE_HANDLE)
+    {
+        // Snapshot once per read so the parts of a long read match
+        static diag_snapshot_t snapshot;
+        if (offset == 0)
+        {
+            diag_snapshot(&snapshot, timebase_ms());
+        }
+        return att_read_callback_handle_blob((uint8_t *)&snapshot, sizeof(snapshot), offset, buffer, buffer_size);
+    }
+
     return 0;
 }
 
@@ -610,16 +1078,103 @@ static int att_write_callback(hci_con_handle_t con_handle, uint16_t att_handle,
     UNUSED(transaction_mode);
     UNUSED(offset);
 
-    log_printf("ATT write: handle=0x%04x, size=%u\n", att_handle, buffer_size);
+    LOG_VERBOSE(LOG_TAG_BLE, "ATT write: handle=0x%04x, size=%u\n", att_handle, buffer_size);
+    diag_count_att(diag_att_for_handle(att_handle), true);
+
+    ble_connection_t *conn = find_connection(con_handle);
+    if (conn == NULL)
+    {
+        return ATT_ERROR_UNLIKELY_ERROR; // Not a connection we know
+    }
 
     // CCCD for main odometer data characteristic
     if (att_handle == ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF1_01_CLIENT_CONFIGURATION_HANDLE)
     {
         uint16_t config_value = little_endian_read_16(buffer, 0);
-        ble_notification_enabled = (config_value == GATT_CLIENT_CHARACTERISTICS_CONFIGURATION_NOTIFICATION);
-        connection_handle = con_handle;
-        log_printf("CCCD write: value=0x%04x, notifications %s (handle=0x%04x)\n",
-                   config_value, ble_notification_enabled ? "ENABLED" : "disabled", connection_handle);
+        conn->odometer_notify = (config_value == GATT_CLIENT_CHARACTERISTICS_CONFIGURATION_NOTIFICATION);
+        LOG_DEBUG(LOG_TAG_BLE, "CCCD write: value=0x%04x, notifications %s (handle=0x%04x)\n",
+                               config_value, conn->odometer_notify ? "ENABLED" : "disabled", con_handle);
+    }
+
+    // CCCD for the sessions list characteristic: notify sessions as they are saved
+    if (att_handle == ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF2_01_CLIENT_CONFIGURATION_HANDLE)
+    {
+        uint16_t config_value = little_endian_read_16(buffer, 0);
+        conn->sessions_notify = (config_value == GATT_CLIENT_CHARACTERISTICS_CONFIGURATION_NOTIFICATION);
+        LOG_DEBUG(LOG_TAG_BLE, "Sessions CCCD write: value=0x%04x, notifications %s (handle=0x%04x)\n",
+                               config_value, conn->sessions_notify ? "ENABLED" : "disabled", con_handle);
+    }
+
+    // Odometer data characteristic: notification format [version u8][flags u8]
+    // Version 1 is the full odometer_data_t, version 2 the compact odo_packet.h format.
+    // Flag bit 0 (v2 only): high rate, for a client showing live values
+    if (att_handle == ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF1_01_VALUE_HANDLE)
+    {
+        if ((buffer_size == 1 || buffer_size == 2) && (buffer[0] == 1 || buffer[0] == ODO_PACKET_VERSION))
+        {
+            conn->odometer_format = buffer[0];
+            conn->odometer_high_rate = (conn->odometer_format == ODO_PACKET_VERSION && buffer_size == 2 && (buffer[1] & 0x01));
+            odo_encoder_reset(&conn->odometer_encoder); // Next v2 packet is a keyframe
+            LOG_INFO(LOG_TAG_BLE, "[BLE] Odometer notifications (0x%04x): format %u, %lu ms\n",
+                                  con_handle, conn->odometer_format, odometer_update_interval_ms(conn));
+        }
+        else
+        {
+            LOG_ERROR(LOG_TAG_BLE, "[BLE] ERROR: Invalid odometer format write: %u bytes (expected version 1 or 2, optional flags)\n", buffer_size);
+            return ATT_ERROR_VALUE_NOT_ALLOWED;
+        }
+    }
+
+    // CCCD for the logs characteristic: notifications stream the log (log_stream.h).
+    // Reading consumes the log, so only one connection streams it at a time
+    if (att_handle == ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF8_01_CLIENT_CONFIGURATION_HANDLE)
+    {
+        uint16_t config_value = little_endian_read_16(buffer, 0);
+        bool enable = (config_value == GATT_CLIENT_CHARACTERISTICS_CONFIGURATION_NOTIFICATION);
+        if (log_reader_taken(conn))
+        {
+            if (enable)
+            {
+                LOG_WARN(LOG_TAG_BLE, "[BLE] Logs already read by another connection, stream refused for 0x%04x\n", con_handle);
+                return ATT_ERROR_WRITE_NOT_PERMITTED;
+            }
+            return 0;
+        }
+        log_stream_enable(&log_stream, enable);
+        set_log_stream_connection(enable ? conn : NULL);
+        LOG_DEBUG(LOG_TAG_BLE, "Logs CCCD write: value=0x%04x, streaming %s (handle=0x%04x)\n",
+                               config_value, log_stream.enabled ? "ENABLED" : "disabled", con_handle);
+    }
+
+    // Logs characteristic: credits for the log stream, optionally with a resume cursor
+    if (att_handle == ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF8_01_VALUE_HANDLE)
+    {
+        if (log_reader_taken(conn))
+        {
+            LOG_WARN(LOG_TAG_BLE, "[BLE] Logs read by another connection, credits from 0x%04x refused\n", con_handle);
+            return ATT_ERROR_WRITE_NOT_PERMITTED;
+        }
+        if (buffer_size == 2 || buffer_size == 6)
+        {
+            if (buffer_size == 6)
+            {
+                uint32_t cursor = little_endian_read_32(buffer, 2);
+                if (cursor != LOG_STREAM_CURSOR_CURRENT)
+                {
+                    uint32_t position = logging_seek_logs(cursor);
+                    LOG_INFO(LOG_TAG_BLE, "[BLE] Log stream resume at %lu: %s\n", cursor, position == cursor ? "OK" : "no longer buffered");
+                }
+            }
+            if (conn == log_stream_connection)
+            {
+                log_stream_grant(&log_stream, little_endian_read_16(buffer, 0));
+                request_log_notifications();
+            }
+        }
+        else
+        {
+            LOG_ERROR(LOG_TAG_BLE, "[BLE] ERROR: Invalid write size for logs: %u bytes (expected 2 or 6)\n", buffer_size);
+        }
     }
 
     // Mark session reported characteristic
@@ -629,22 +1184,44 @@ static int att_write_callback(hci_con_handle_t con_handle, uint16_t att_handle,
         {
             // Read session_id (little-endian uint32_t)
             uint32_t session_id = little_endian_read_32(buffer, 0);
-            log_printf("Mark session reported: session_id=%lu\n", session_id);
+            LOG_INFO(LOG_TAG_BLE, "Mark session reported: session_id=%lu\n", session_id);
 
             // Mark the session as reported
             bool success = odometer_mark_session_reported(session_id);
             if (success)
             {
-                log_printf("Session %lu marked as reported successfully\n", session_id);
+                LOG_INFO(LOG_TAG_BLE, "Session %lu marked as reported successfully\n", session_id);
             }
             else
             {
-                log_printf("Failed to mark session %lu as reported (not found)\n", session_id);
+                LOG_WARN(LOG_TAG_BLE, "Failed to mark session %lu as reported (not found)\n", session_id);
+            }
+        }
+        else if (buffer_size >= 8 && buffer_size % 4 == 0 && buffer_size / 4 <= ODOMETER_MARK_BATCH_MAX)
+        {
+            // Batch: all IDs with one flash scan and one flash write; results readable afterwards
+            uint32_t session_ids[ODOMETER_MARK_BATCH_MAX];
+            uint8_t results[ODOMETER_MARK_BATCH_MAX];
+            uint32_t count = buffer_size / 4;
+
+            for (uint32_t i = 0; i < count; i++)
+            {
+                session_ids[i] = little_endian_read_32(buffer, i * 4);
+            }
+            uint32_t marked = odometer_mark_sessions_reported(session_ids, count, results);
+            LOG_INFO(LOG_TAG_BLE, "Mark sessions reported: %lu of %lu marked\n", marked, count);
+
+            for (uint32_t i = 0; i < count; i++)
+            {
+                little_endian_store_32(conn->mark_results, i * 5, session_ids[i]);
+                conn->mark_results[i * 5 + 4] = results[i];
             }
+            conn->mark_results_len = (uint16_t)(count * 5);
         }
         else
         {
-            log_printf("Invalid write size for mark reported: %u bytes (expected 4)\n", buffer_size);
+            LOG_WARN(LOG_TAG_BLE, "Invalid write size for mark reported: %u bytes (expected 4, or up to %u session IDs)\n",
+                                  buffer_size, ODOMETER_MARK_BATCH_MAX);
         }
     }
 
@@ -655,20 +1232,20 @@ static int att_write_callback(hci_con_handle_t con_handle, uint16_t att_handle,
         {
             // Backward compatibility: 4 bytes = timestamp only (assume UTC)
             uint32_t unix_timestamp = little_endian_read_32(buffer, 0);
-            log_printf("[BLE] Time sync received from Android app (old format - UTC assumed)!\n");
-            log_printf("  - Raw timestamp: %lu\n", unix_timestamp);
+            LOG_INFO(LOG_TAG_TIME, "[BLE] Time sync received from Android app (old format - UTC assumed)!\n");
+            LOG_INFO(LOG_TAG_TIME, "  - Raw timestamp: %lu\n", unix_timestamp);
 
             // Set the time reference
-            odometer_set_time_reference(unix_timestamp);
+            odometer_set_time_reference((uint64_t)unix_timestamp * 1000);
 
             // Validate the timestamp looks reasonable
             if (unix_timestamp > 1700000000 && unix_timestamp < 2000000000)
             {
-                log_printf("[BLE] Time sync SUCCESS - timestamp looks valid\n");
+                LOG_INFO(LOG_TAG_TIME, "[BLE] Time sync SUCCESS - timestamp looks valid\n");
             }
             else
             {
-                log_printf("[BLE] WARNING: Timestamp may be invalid (expected 2023-2033 range)\n");
+                LOG_WARN(LOG_TAG_TIME, "[BLE] WARNING: Timestamp may be invalid (expected 2023-2033 range)\n");
             }
         }
         else if (buffer_size == 8)
@@ -677,12 +1254,12 @@ static int att_write_callback(hci_con_handle_t con_handle, uint16_t att_handle,
             uint32_t unix_timestamp = little_endian_read_32(buffer, 0);
             int32_t timezone_offset = (int32_t)little_endian_read_32(buffer, 4);
 
-            log_printf("[BLE] Time sync received from Android app (with timezone)!\n");
-            log_printf("  - UTC timestamp: %lu\n", unix_timestamp);
-            log_printf("  - Timezone offset: %ld seconds (%.1f hours)\n", timezone_offset, timezone_offset / 3600.0f);
+            LOG_INFO(LOG_TAG_TIME, "[BLE] Time sync received from Android app (with timezone)!\n");
+            LOG_INFO(LOG_TAG_TIME, "  - UTC timestamp: %lu\n", unix_timestamp);
+            LOG_INFO(LOG_TAG_TIME, "  - Timezone offset: %ld seconds (%.1f hours)\n", timezone_offset, timezone_offset / 3600.0f);
 
             // Set the time reference (still in UTC)
-            odometer_set_time_reference(unix_timestamp);
+            odometer_set_time_reference((uint64_t)unix_timestamp * 1000);
 
             // Update timezone offset in settings if changed
             user_settings_set_timezone_offset(timezone_offset);
@@ -690,16 +1267,33 @@ static int att_write_callback(hci_con_handle_t con_handle, uint16_t att_handle,
             // Validate the timestamp looks reasonable
             if (unix_timestamp > 1700000000 && unix_timestamp < 2000000000)
             {
-                log_printf("[BLE] Time sync SUCCESS - timestamp looks valid\n");
+                LOG_INFO(LOG_TAG_TIME, "[BLE] Time sync SUCCESS - timestamp looks valid\n");
             }
             else
             {
-                log_printf("[BLE] WARNING: Timestamp may be invalid (expected 2023-2033 range)\n");
+                LOG_WARN(LOG_TAG_TIME, "[BLE] WARNING: Timestamp may be invalid (expected 2023-2033 range)\n");
+            }
+        }
+        else if (buffer_size == 12)
+        {
+            // Millisecond format: 8 bytes Unix time in ms + 4 bytes timezone offset
+            uint64_t unix_ms = little_endian_read_32(buffer, 0) | ((uint64_t)little_endian_read_32(buffer, 4) << 32);
+            int32_t timezone_offset = (int32_t)little_endian_read_32(buffer, 8);
+
+            LOG_INFO(LOG_TAG_TIME, "[BLE] Time sync received from Android app (ms, with timezone)!\n");
+            LOG_INFO(LOG_TAG_TIME, "  - UTC timestamp: %lu.%03lu\n", (uint32_t)(unix_ms / 1000), (uint32_t)(unix_ms % 1000));
+
+            odometer_set_time_reference(unix_ms);
+            user_settings_set_timezone_offset(timezone_offset);
+
+            if (unix_ms / 1000 < 1700000000 || unix_ms / 1000 > 2000000000)
+            {
+                LOG_WARN(LOG_TAG_TIME, "[BLE] WARNING: Timestamp may be invalid (expected 2023-2033 range)\n");
             }
         }
         else
         {
-            log_printf("[BLE] ERROR: Invalid write size for time sync: %u bytes (expected 4 or 8)\n", buffer_size);
+            LOG_ERROR(LOG_TAG_BLE, "[BLE] ERROR: Invalid write size for time sync: %u bytes (expected 4, 8 or 12)\n", buffer_size);
         }
     }
 
@@ -711,14 +1305,14 @@ static int att_write_callback(hci_con_handle_t con_handle, uint16_t att_handle,
             // Parse settings (1 byte metric only, no WiFi)
             bool metric = (buffer[0] != 0);
 
-            log_printf("[BLE] Settings write received:\n");
-            log_printf("  - Metric: %s\n", metric ? "YES (km)" : "NO (miles)");
+            LOG_INFO(LOG_TAG_BLE, "[BLE] Settings write received:\n");
+            LOG_INFO(LOG_TAG_BLE, "  - Metric: %s\n", metric ? "YES (km)" : "NO (miles)");
 
             user_settings_update(metric);
         }
         else
         {
-            log_printf("[BLE] ERROR: Invalid write size for settings: %u bytes (expected 1)\n", buffer_size);
+            LOG_ERROR(LOG_TAG_BLE, "[BLE] ERROR: Invalid write size for settings: %u bytes (expected 1)\n", buffer_size);
         }
     }
 
@@ -732,9 +1326,9 @@ static int att_write_callback(hci_con_handle_t con_handle, uint16_t att_handle,
             memcpy(&hours, &buffer[0], 4);
             memcpy(&distance, &buffer[4], 4);
 
-            log_printf("[BLE] Set lifetime totals received:\n");
-            log_printf("  - Hours: %.2f\n", hours);
-            log_printf("  - Distance: %.2f miles\n", distance);
+            LOG_INFO(LOG_TAG_BLE, "[BLE] Set lifetime totals received:\n");
+            LOG_INFO(LOG_TAG_BLE, "  - Hours: %.2f\n", hours);
+            LOG_INFO(LOG_TAG_BLE, "  - Distance: %.2f miles\n", distance);
 
             // Get current metric setting to determine if we need to convert
             const user_settings_t *settings = user_settings_get();
@@ -746,7 +1340,7 @@ static int att_write_callback(hci_con_handle_t con_handle, uint16_t att_handle,
             {
                 // Convert km to miles (1 km = 0.621371 miles)
                 distance_miles = distance * 0.621371f;
-                log_printf("  - Converted from %.2f km to %.2f miles\n", distance, distance_miles);
+                LOG_INFO(LOG_TAG_BLE, "  - Converted from %.2f km to %.2f miles\n", distance, distance_miles);
             }
 
             // Set the lifetime totals
@@ -754,24 +1348,75 @@ static int att_write_callback(hci_con_handle_t con_handle, uint16_t att_handle,
         }
         else
         {
-            log_printf("[BLE] ERROR: Invalid write size for set lifetime totals: %u bytes (expected 8)\n", buffer_size);
+            LOG_ERROR(LOG_TAG_BLE, "[BLE] ERROR: Invalid write size for set lifetime totals: %u bytes (expected 8)\n", buffer_size);
         }
     }
 
-    return 0;
-}
+    // Log levels characteristic
+    if (att_handle == ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEF9_01_VALUE_HANDLE)
+    {
+        if (buffer_size == 2)
+        {
+            uint8_t tag = buffer[0];
+            uint8_t level = buffer[1];
+            bool ok = true;
+            if (tag == 0xFF)
+            {
+                for (uint8_t t = 0; t < LOG_TAG_COUNT; t++)
+                {
+                    ok = logging_set_tag_level(t, level) && ok;
+                }
+            }
+            else
+            {
+                ok = logging_set_tag_level(tag, level);
+            }
+            if (ok)
+            {
+                LOG_INFO(LOG_TAG_BLE, "[BLE] Log level of tag %u set to %u\n", tag, level);
+            }
+            else
+            {
+                LOG_WARN(LOG_TAG_BLE, "[BLE] Invalid log level write: tag %u, level %u\n", tag, level);
+            }
+        }
+        else
+        {
+            LOG_ERROR(LOG_TAG_BLE, "[BLE] ERROR: Invalid write size for log levels: %u bytes (expected 2)\n", buffer_size);
+        }
+    }
 
-void send_odometer_data(void)
-{
-    if (!ble_connected || !ble_notification_enabled)
+    // Trace dump characteristic
+    if (att_handle == ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEFA_01_VALUE_HANDLE)
     {
-        log_printf("send_odometer_data skipped: connected=%d, notify=%d\n", ble_connected, ble_notification_enabled);
-        return;
+        if (buffer_size == 1 && buffer[0] == 1)
+        {
+            if (!trace_dump_start())
+            {
+                LOG_WARN(LOG_TAG_PERF, "[TRACE] Dump not started (tracing %s)\n", TRACE_EVENTS ? "busy" : "not built in");
+            }
+        }
+        else
+        {
+            LOG_ERROR(LOG_TAG_BLE, "[BLE] ERROR: Invalid trace dump write: %u bytes (expected 1 byte = 1)\n", buffer_size);
+        }
+    }
+
+    // Diagnostics characteristic: reset command
+    if (att_handle == ATT_CHARACTERISTIC_12345678_1234_5678_1234_56789ABCDEFB_01_VALUE_HANDLE)
+    {
+        if (buffer_size == 1 && buffer[0] == 1)
+        {
+            diag_reset(timebase_ms());
+            LOG_INFO(LOG_TAG_PERF, "[DIAG] Counters reset\n");
+        }
+        else
+        {
+            LOG_ERROR(LOG_TAG_BLE, "[BLE] ERROR: Invalid diagnostics write: %u bytes (expected 1 byte = 1)\n", buffer_size);
+        }
     }
 
-    // Request ATT_EVENT_CAN_SEND_NOW which will trigger notification send in packet_handler
-    // log_printf("Requesting CAN_SEND_NOW event...\n");
-    att_server_request_can_send_now_event(connection_handle);
+    return 0;
 }
 
 int main()
@@ -781,69 +1426,77 @@ int main()
 
     // Underclock to 68 MHz for power savings (default is 125 MHz)
     // Going lower than 68 MHz may cause issues with USB/BLE/I2C peripherals
-    log_printf("\n\n=== WALKOLUTION ODOMETER STARTING ===\n");
-    log_printf("Underclocking system from 125 MHz to 68 MHz...\n");
+    LOG_INFO(LOG_TAG_SYSTEM, "\n\n=== WALKOLUTION ODOMETER STARTING ===\n");
+    log_boot_info();
+    LOG_INFO(LOG_TAG_SYSTEM, "Underclocking system from 125 MHz to 68 MHz...\n");
     set_sys_clock_khz(68000, true); // 68 MHz = 68000 kHz, true = required
-    log_printf("System clock: %lu Hz (%.1f MHz)\n", clock_get_hz(clk_sys), clock_get_hz(clk_sys) / 1000000.0f);
+    LOG_INFO(LOG_TAG_SYSTEM, "System clock: %lu Hz (%.1f MHz)\n", clock_get_hz(clk_sys), clock_get_hz(clk_sys) / 1000000.0f);
 
     int rc = pico_led_init();
     hard_assert(rc == PICO_OK);
-    log_printf("LED init OK\n");
+    LOG_INFO(LOG_TAG_SYSTEM, "LED init OK\n");
 
     // Initialize Bluetooth with async context
-    log_printf("Initializing Bluetooth stack...\n");
+    LOG_INFO(LOG_TAG_BLE, "Initializing Bluetooth stack...\n");
     btstack_packet_callback_registration_t hci_event_callback_registration;
     hci_event_callback_registration.callback = &packet_handler;
     hci_add_event_handler(&hci_event_callback_registration);
-    log_printf("HCI event handler registered\n");
+    LOG_INFO(LOG_TAG_BLE, "HCI event handler registered\n");
 
     // Initialize L2CAP
     l2cap_init();
-    log_printf("L2CAP initialized\n");
+    LOG_INFO(LOG_TAG_BLE, "L2CAP initialized\n");
 
     // Initialize LE Security Manager
     sm_init();
-    log_printf("Security Manager initialized\n");
+    LOG_INFO(LOG_TAG_BLE, "Security Manager initialized\n");
 
     // Setup ATT server with our GATT database (generated from .gatt file)
     att_server_init(profile_data, att_read_callback, att_write_callback);
     att_server_register_packet_handler(packet_handler);
-    log_printf("ATT server initialized\n");
+    gap_set_max_number_peripheral_connections(BLE_MAX_CONNECTIONS); // Keep advertising while a slot is free
+    bonding_init(profile_data, sizeof(profile_data), ATT_CHARACTERISTIC_GATT_SERVICE_CHANGED_01_VALUE_HANDLE);
+    bulk_channel_init();
+    log_stream_init(&log_stream);
+    adv_schedule_init(&adv_schedule);
+    LOG_INFO(LOG_TAG_BLE, "ATT server initialized\n");
 
     // Turn on Bluetooth stack
     hci_power_control(HCI_POWER_ON);
-    log_printf("HCI powered on\n");
+    LOG_INFO(LOG_TAG_BLE, "HCI powered on\n");
 
     // Initialize user settings
-    log_printf("Initializing user settings...\n");
+    LOG_INFO(LOG_TAG_SYSTEM, "Initializing user settings...\n");
     user_settings_init();
 
     // Initialize OLED display
-    log_printf("Initializing OLED display...\n");
+    LOG_INFO(LOG_TAG_DISPLAY, "Initializing OLED display...\n");
     oled_init(OLED_I2C_PORT, OLED_SDA_PIN, OLED_SCL_PIN, OLED_ADDR);
 
     // Initialize odometer (loads flash data, initializes ADC)
-    log_printf("Initializing odometer...\n");
+    LOG_INFO(LOG_TAG_SYSTEM, "Initializing odometer...\n");
     odometer_init();
 
     // Initialize speed tracking
-    log_printf("Initializing speed tracking...\n");
+    LOG_INFO(LOG_TAG_SYSTEM, "Initializing speed tracking...\n");
     speed_init();
 
     // Initialize rotation detection IRQ
-    log_printf("Initializing rotation detection on pin %d...\n", SENSOR_PIN);
+    LOG_INFO(LOG_TAG_SYSTEM, "Initializing rotation detection on pin %d...\n", SENSOR_PIN);
     irq_init(SENSOR_PIN);
 
     // Show startup message (centered, 12pt to fit on screen)
     oled_clear();
     oled_draw_text_centered(OLED_WIDTH / 2, 28, "Walkolution", &FreeSans12pt7b);
 
-    // Read and display voltage
-    log_printf("Reading voltage...\n");
+    // Read and display voltage (BLE is already running: see build_screen_model())
+    LOG_INFO(LOG_TAG_SYSTEM, "Reading voltage...\n");
+    ble_lock();
     uint16_t voltage_mv = odometer_read_voltage();
-    log_printf("Voltage: %u mV\n", voltage_mv);
-    char voltage_str[32];
-    snprintf(voltage_str, sizeof(voltage_str), "%.2fV", voltage_mv / 1000.0f);
+    ble_unlock();
+    LOG_INFO(LOG_TAG_SYSTEM, "Voltage: %u mV\n", voltage_mv);
+    char voltage_str[16];
+    fmt_voltage(voltage_str, sizeof(voltage_str), voltage_mv, 2);
     oled_draw_text_centered(OLED_WIDTH / 2, 48, voltage_str, &FreeSans9pt7b);
     oled_update();
 
@@ -851,13 +1504,14 @@ int main()
 
     // Display state tracking
     bool showing_session = true; // True = session screen, False = totals screen
-    uint32_t last_display_switch_ms = to_ms_since_boot(get_absolute_time());
+    uint32_t last_display_switch_ms = timebase_ms();
     uint32_t last_update_ms = 0;
     uint32_t last_peripheral_status_check_ms = 0;
     bool oled_is_on = true; // Track OLED power state
 
-    // BLE data update tracking
-    uint32_t last_ble_update_ms = 0;
+#if ADV_BROADCAST
+    uint32_t last_adv_broadcast_ms = 0;
+#endif
     uint32_t last_speed_window_update_ms = 0;
 
 #if DEBUG_FAKE_ROTATIONS
@@ -866,14 +1520,34 @@ int main()
 #endif
 
     // Initial display
-    log_printf("Updating initial OLED display...\n");
-    update_oled_session(ble_connected, ble_advertising);
+    LOG_INFO(LOG_TAG_DISPLAY, "Updating initial OLED display...\n");
+    screen_model_t screen_model;
+    ble_lock();
+    build_screen_model(&screen_model, ble_connected, ble_advertising);
+    ble_unlock();
+    update_oled_screen(SCREEN_SESSION, &screen_model);
+
+    // Initialize performance counters
+    perf_init();
+    uint32_t last_perf_report_ms = timebase_ms();
+    trace_init();
 
-    log_printf("=== ENTERING MAIN LOOP ===\n");
+    LOG_INFO(LOG_TAG_SYSTEM, "=== ENTERING MAIN LOOP ===\n");
 
     while (true)
     {
-        uint32_t current_time_ms = to_ms_since_boot(get_absolute_time());
+        TRACE_BEGIN(TRACE_MAIN_LOOP, 0);
+        uint32_t loop_start_us = time_us_32();
+        uint32_t current_time_ms = timebase_ms();
+
+        // Poll cyw43 for BLE (unless it runs in the background)
+        TRACE_BEGIN(TRACE_CYW43_POLL, 0);
+        ble_poll();
+        TRACE_END(TRACE_CYW43_POLL, 0);
+
+        // Odometer, sessions and BLE state below are shared with the ATT callbacks
+        ble_lock();
+        bool refresh_display = false;
 
 #if DEBUG_FAKE_ROTATIONS
         // Debug: simulate rotations at 2 MPH
@@ -886,16 +1560,19 @@ int main()
 
         // Process sensor readings (handles IRQ-detected rotations)
         // LED control is handled directly in the GPIO IRQ handler
+        TRACE_BEGIN(TRACE_ODOMETER_PROCESS, 0);
         bool rotation_detected = odometer_process();
+        TRACE_END(TRACE_ODOMETER_PROCESS, rotation_detected);
 
         // Check peripheral status periodically and control BLE and OLED
         if ((current_time_ms - last_peripheral_status_check_ms) >= PERIPHERAL_STATUS_CHECK_INTERVAL_MS)
         {
+            TRACE_BEGIN(TRACE_PERIPHERAL_CHECK, 0);
             uint16_t voltage_mv = odometer_read_voltage();
             float current_speed = speed_get_running_avg(user_settings_is_metric());
 
-            log_printf("[%lu] %u mV, Speed: %.2f, BLE: adv=%d con=%d, OLED=%d\n",
-                       current_time_ms, voltage_mv, current_speed, ble_advertising, ble_connected, oled_is_on);
+            LOG_VERBOSE(LOG_TAG_SYSTEM, "[%lu] %u mV, Speed: %.2f, BLE: adv=%d con=%d, OLED=%d\n",
+                                        current_time_ms, voltage_mv, current_speed, ble_advertising, ble_connected, oled_is_on);
 
             // Check if speed allows OLED to be on
             // Speed module handles slow walking detection (turns off OLED only after 5 seconds of continuous slow walking at <1.5 mph)
@@ -906,71 +1583,90 @@ int main()
             // Turn on when: speed NOT in slow walking range for 5+ seconds
             if (oled_is_on && !speed_allows_oled)
             {
-                log_printf("*** TURNING OFF OLED (speed %.2f in slow walking range for 5+ seconds) ***\n",
-                           current_speed);
+                LOG_INFO(LOG_TAG_DISPLAY, "*** TURNING OFF OLED (speed %.2f in slow walking range for 5+ seconds) ***\n",
+                                          current_speed);
                 oled_display_off();
                 oled_is_on = false;
             }
             else if (!oled_is_on && speed_allows_oled)
             {
-                log_printf("*** TURNING ON OLED (speed %.2f allows display) ***\n",
-                           current_speed);
+                LOG_INFO(LOG_TAG_DISPLAY, "*** TURNING ON OLED (speed %.2f allows display) ***\n",
+                                          current_speed);
                 oled_display_on();
                 oled_is_on = true;
-                // Force a display update to refresh the screen
-                if (showing_session)
-                {
-                    update_oled_session(ble_connected, ble_advertising);
-                }
-                else
-                {
-                    update_oled_totals(ble_connected, ble_advertising);
-                }
+                // Force a full redraw to refresh the screen
+                screens_invalidate();
+                refresh_display = true;
             }
 
             // Start BLE advertising based on walking speed (not voltage)
             // BLE will be activated after walking faster than slow walking threshold (1.5 mph) for 15 seconds
             if (!ble_advertising && speed_allows_ble())
             {
-                log_printf("*** STARTING BLE ADVERTISING (walking speed triggered activation) ***\n");
+                LOG_INFO(LOG_TAG_BLE, "*** STARTING BLE ADVERTISING (walking speed triggered activation) ***\n");
                 start_ble_advertising();
             }
 
             last_peripheral_status_check_ms = current_time_ms;
+            TRACE_END(TRACE_PERIPHERAL_CHECK, 0);
         }
 
-        // Poll cyw43 for BLE - MUST be called regularly for BLE to work
-        cyw43_arch_poll();
+        // Stream new logs to a subscribed client
+        request_log_notifications();
+
+        // Tell a subscribed client about a session just saved to flash
+        request_session_notification();
+
+        // Connection parameters for the traffic there is (bulk or idle)
+        link_policy_poll(current_time_ms);
 
         // Update speed window every second
         if ((current_time_ms - last_speed_window_update_ms) >= 1000)
         {
+            TRACE_BEGIN(TRACE_SPEED_UPDATE, 0);
             speed_update(odometer_get_session_count(), current_time_ms);
             last_speed_window_update_ms = current_time_ms;
+            TRACE_END(TRACE_SPEED_UPDATE, 0);
+            update_adv_schedule(current_time_ms);
+            perf_probe_irq_latency();
         }
 
-        // Send BLE data every second when connected
-        if (ble_connected && (current_time_ms - last_ble_update_ms) >= BLE_UPDATE_INTERVAL_MS)
+        if ((current_time_ms - last_perf_report_ms) >= PERF_REPORT_INTERVAL_MS)
+        {
+            TRACE_BEGIN(TRACE_PERF_REPORT, 0);
+            perf_report();
+            LOG_INFO(LOG_TAG_PERF, "[PERF] ble logs: notify %lu B at %lu B/s, read %lu B at %lu B/s\n",
+                                   log_stream.throughput.bytes, log_throughput_bytes_per_sec(&log_stream.throughput),
+                                   log_read_throughput.bytes, log_throughput_bytes_per_sec(&log_read_throughput));
+            uint32_t adv_ms[ADV_SCHEDULE_STEP_COUNT];
+            adv_schedule_time_in_step(&adv_schedule, current_time_ms, adv_ms);
+            LOG_INFO(LOG_TAG_PERF, "[PERF] advertising time at 30/100/500/1280 ms: %lu/%lu/%lu/%lu s, %lu speed-ups\n",
+                                   adv_ms[0] / 1000, adv_ms[1] / 1000, adv_ms[2] / 1000, adv_ms[3] / 1000, adv_schedule.kicks);
+            LOG_INFO(LOG_TAG_PERF, "[PERF] BLE sends waited up to %lu us for can_send_now (%s)\n",
+                                   ble_send_wait_max_us, BLE_BACKGROUND ? "background" : "polled");
+            ble_send_wait_max_us = 0;
+            last_perf_report_ms = current_time_ms;
+            TRACE_END(TRACE_PERF_REPORT, 0);
+        }
+
+        // Send BLE data to each subscribed client, every second or faster if it asked
+        request_odometer_notifications(current_time_ms);
+
+#if ADV_BROADCAST
+        // Refresh the live values in the advertising data for scanners
+        if (ble_advertising && ble_accepting_connections() && (current_time_ms - last_adv_broadcast_ms) >= ADV_BROADCAST_INTERVAL_MS)
         {
-            send_odometer_data();
-            last_ble_update_ms = current_time_ms;
+            update_adv_broadcast();
+            last_adv_broadcast_ms = current_time_ms;
         }
+#endif
 
         // Switch display mode every 5 seconds (only if OLED is on)
         if (oled_is_on && (current_time_ms - last_display_switch_ms) >= DISPLAY_SWITCH_INTERVAL_MS)
         {
             showing_session = !showing_session;
             last_display_switch_ms = current_time_ms;
-
-            if (showing_session)
-            {
-                update_oled_session(ble_connected, ble_advertising);
-            }
-            else
-            {
-                update_oled_totals(ble_connected, ble_advertising);
-            }
-            last_update_ms = current_time_ms;
+            refresh_display = true;
         }
         // Update display frequently when advertising (250ms for smooth flashing animation)
         // Otherwise update every 1 second for power savings (clock still updates smoothly)
@@ -978,25 +1674,52 @@ int main()
         else if (oled_is_on)
         {
             uint32_t update_interval = (ble_advertising && !ble_connected) ? 250 : OLED_UPDATE_INTERVAL_MS;
-
             if ((current_time_ms - last_update_ms) >= update_interval)
             {
-                if (showing_session)
-                {
-                    update_oled_session(ble_connected, ble_advertising);
-                }
-                else
-                {
-                    update_oled_totals(ble_connected, ble_advertising);
-                }
-                last_update_ms = current_time_ms;
+                refresh_display = true;
             }
         }
 
+        // The screen values are taken under the lock; drawing and the I2C
+        // transfer happen after it
+        if (refresh_display)
+        {
+            build_screen_model(&screen_model, ble_connected, ble_advertising);
+            last_update_ms = current_time_ms;
+        }
+
+        ble_unlock();
+
+        if (refresh_display)
+        {
+            update_oled_screen(showing_session ? SCREEN_SESSION : SCREEN_TOTALS, &screen_model);
+        }
+
+        // Next part of a requested trace dump, before it is drained to USB
+        trace_dump_step();
+
+        // Hand this pass's log output to USB serial without waiting on the host
+        TRACE_BEGIN(TRACE_USB_DRAIN, 0);
+        logging_drain_usb();
+        TRACE_END(TRACE_USB_DRAIN, 0);
+        TRACE_END(TRACE_MAIN_LOOP, 0);
+        uint32_t loop_us = time_us_32() - loop_start_us;
+
+        TRACE_BEGIN(TRACE_SLEEP, 0);
+        // Clock switches under the lock, so background BLE work never runs
+        // halfway through one (it does run while sleeping, from XOSC)
+        // The diag counters are shared with the ATT callbacks too
+        ble_lock();
+        diag_record_loop(loop_us);
+        record_display_diag();
         sleep_run_from_xosc();
+        ble_unlock();
         sleep_ms(MAIN_LOOP_DELAY_MS);
         // Re-enable ring oscillator (ROSC) and clocks
+        ble_lock();
         rosc_write(&rosc_hw->ctrl, ROSC_CTRL_ENABLE_BITS);
         clocks_init();
+        ble_unlock();
+        TRACE_END(TRACE_SLEEP, 0);
     }
 }